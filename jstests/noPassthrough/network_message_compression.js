@@ -0,0 +1,68 @@
+// Tests that replica set members which enable a common network message compressor negotiate it
+// through isMaster and compress the traffic between them, and that nothing is compressed when
+// they have no compressor in common.
+(function() {
+    "use strict";
+
+    // Returns the number of bytes 'conn' has compressed and decompressed with 'compressor'.
+    function compressedBytes(conn, compressor) {
+        var status = conn.adminCommand({serverStatus: 1});
+        assert.commandWorked(status);
+        var stats = status.network.compression[compressor];
+        return Number(stats.compressor.bytesIn) + Number(stats.decompressor.bytesIn);
+    }
+
+    function runTest(primaryCompressors, secondaryCompressors, expectedCompressor) {
+        var rst = new ReplSetTest({
+            nodes: [
+                {setParameter: "networkMessageCompressors=" + primaryCompressors},
+                {setParameter: "networkMessageCompressors=" + secondaryCompressors}
+            ]
+        });
+        rst.startSet();
+        rst.initiate();
+
+        var primary = rst.getPrimary();
+        var secondary = rst.getSecondary();
+        secondary.setSlaveOk();
+
+        var isMaster = primary.adminCommand({isMaster: 1});
+        if (primaryCompressors === "disabled") {
+            assert(!isMaster.hasOwnProperty("compression"), tojson(isMaster));
+        } else {
+            assert.eq(primaryCompressors.split(","), isMaster.compression, tojson(isMaster));
+        }
+
+        // Large, repetitive documents so that the oplog batches are worth compressing.
+        var padding = new Array(4096).join("x");
+        var bulk = primary.getDB("test").compressed.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({_id: i, padding: padding});
+        }
+        assert.writeOK(bulk.execute({w: 2}));
+        assert.eq(1000, secondary.getDB("test").compressed.count());
+
+        if (expectedCompressor) {
+            // The oplog fetched by the secondary is compressed by the primary and decompressed by
+            // the secondary. Connections the primary opens may use its own preferred compressor.
+            assert.gt(compressedBytes(primary, expectedCompressor), 0);
+            assert.gt(compressedBytes(secondary, expectedCompressor), 0);
+        } else {
+            ["snappy", "zlib"].forEach(function(compressor) {
+                assert.eq(0, compressedBytes(primary, compressor), compressor);
+                assert.eq(0, compressedBytes(secondary, compressor), compressor);
+            });
+        }
+
+        rst.stopSet();
+    }
+
+    // The secondary requests the first of its own compressors which the primary also lists.
+    runTest("snappy,zlib", "zlib,snappy", "zlib");
+    runTest("snappy", "zlib,snappy", "snappy");
+
+    // Without a compressor in common, or with compression disabled on either side, nothing is
+    // compressed.
+    runTest("snappy", "zlib", null);
+    runTest("disabled", "snappy", null);
+})();
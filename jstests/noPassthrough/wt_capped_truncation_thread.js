@@ -0,0 +1,51 @@
+/**
+ * Tests that with 'wiredTigerCappedTruncationThread' enabled, capped collections capped by size
+ * are truncated in the background and their indexes stay consistent with the documents.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var conn = MongoRunner.runMongod(
+        {storageEngine: 'wiredTiger', setParameter: 'wiredTigerCappedTruncationThread=true'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+
+    var cappedSize = 1024 * 1024;
+    assert.commandWorked(testDB.createCollection('capped', {capped: true, size: cappedSize}));
+    assert.commandWorked(
+        testDB.createCollection('maxDocs', {capped: true, size: cappedSize, max: 10}));
+    var capped = testDB.capped;
+    var maxDocs = testDB.maxDocs;
+    assert.commandWorked(capped.ensureIndex({x: 1}));
+
+    var padding = new Array(1024).join('x');
+    for (var i = 0; i < 5000; i++) {
+        assert.writeOK(capped.insert({_id: i, x: i, padding: padding}));
+        assert.writeOK(maxDocs.insert({_id: i}));
+    }
+
+    assert.eq(true, capped.stats().truncatedInBackground, tojson(capped.stats()));
+
+    // The background thread brings the collection back to roughly its size.
+    assert.soon(function() {
+        return capped.stats().size <= cappedSize * 1.2;
+    }, 'capped collection was not truncated: ' + tojson(capped.stats()));
+
+    // The oldest documents are gone from both the collection and its index.
+    assert.eq(null, capped.findOne({_id: 0}));
+    assert.eq(capped.find().itcount(), capped.find().hint({x: 1}).itcount());
+    assert.eq(4999, capped.find().sort({$natural: -1}).limit(1).next()._id);
+    assert.commandWorked(capped.validate(true));
+
+    // Collections capped by number of documents are still exact.
+    assert.eq(false, maxDocs.stats().truncatedInBackground);
+    assert.eq(10, maxDocs.count());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,92 @@
+/**
+ * Tests that collection scans of a WiredTiger collection created with 'columnGroups' read only
+ * the projected column group when the query needs nothing else, and return the same results as
+ * scans of whole documents.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    function getCollScan(explain) {
+        var stage = explain.executionStats.executionStages;
+        while (stage.stage !== 'COLLSCAN') {
+            stage = stage.inputStage;
+        }
+        return stage;
+    }
+
+    var conn = MongoRunner.runMongod({storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+
+    assert.commandFailedWithCode(
+        testDB.createCollection('bad', {storageEngine: {wiredTiger: {columnGroups: ['a.b']}}}),
+        ErrorCodes.BadValue);
+    assert.commandFailed(testDB.createCollection(
+        'cappedBad',
+        {capped: true, size: 4096, storageEngine: {wiredTiger: {columnGroups: ['a']}}}));
+
+    assert.commandWorked(testDB.createCollection(
+        'columnar', {storageEngine: {wiredTiger: {columnGroups: ['a', 'b']}}}));
+    var columnar = testDB.columnar;
+    var plain = testDB.plain;
+
+    var padding = new Array(1024).join('x');
+    for (var i = 0; i < 200; i++) {
+        var doc = {_id: i, a: i % 10, b: {c: i}, padding: padding};
+        if (i % 7 === 0) {
+            delete doc.a;
+        }
+        assert.writeOK(columnar.insert(doc));
+        assert.writeOK(plain.insert(doc));
+    }
+    assert.writeOK(columnar.update({_id: 5}, {$set: {a: 50, padding: 'y'}}));
+    assert.writeOK(plain.update({_id: 5}, {$set: {a: 50, padding: 'y'}}));
+    assert.writeOK(columnar.remove({_id: 6}));
+    assert.writeOK(plain.remove({_id: 6}));
+
+    function checkQuery(filter, projection, sort, expectProjectedOnly) {
+        var cursor = columnar.find(filter, projection).sort(sort);
+        var explain = cursor.explain('executionStats');
+        assert.eq(expectProjectedOnly,
+                  getCollScan(explain).projectedFieldsOnly === true,
+                  tojson(explain));
+        assert.eq(plain.find(filter, projection).sort(sort).toArray(),
+                  columnar.find(filter, projection).sort(sort).toArray());
+    }
+
+    checkQuery({}, {a: 1}, {}, true);
+    checkQuery({a: {$gte: 5}}, {_id: 0, a: 1, b: 1}, {}, true);
+    checkQuery({'b.c': {$lt: 50}}, {a: 1}, {a: -1, _id: 1}, true);
+    checkQuery({$or: [{a: 3}, {a: {$exists: false}}]}, {b: 1}, {}, true);
+
+    // Queries which need other fields read whole documents.
+    checkQuery({}, {a: 1, padding: 1}, {}, false);
+    checkQuery({padding: 'y'}, {a: 1}, {}, false);
+    checkQuery({a: 1}, {}, {}, false);
+    checkQuery({a: 1}, {a: 1}, {padding: 1}, false);
+
+    var agg = columnar.aggregate([{$group: {_id: '$a', n: {$sum: 1}}}, {$sort: {_id: 1}}]);
+    assert.eq(plain.aggregate([{$group: {_id: '$a', n: {$sum: 1}}}, {$sort: {_id: 1}}]).toArray(),
+              agg.toArray());
+
+    // The projected fields are recorded in the table, so they survive a restart.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: true, port: conn.port, cleanData: false, storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+    columnar = testDB.columnar;
+    plain = testDB.plain;
+
+    checkQuery({a: {$gte: 5}}, {_id: 0, a: 1, b: 1}, {}, true);
+    assert.eq('a,b', columnar.stats().wiredTiger.metadata.projectedFields);
+    assert.commandWorked(columnar.validate(true));
+
+    MongoRunner.stopMongod(conn);
+})();
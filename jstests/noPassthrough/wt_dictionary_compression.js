@@ -0,0 +1,94 @@
+/**
+ * Tests that a WiredTiger collection created with 'dictionaryCompression' trains dictionaries
+ * from its documents as they are inserted, and that its documents stay readable across retraining
+ * and restarts.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var conn = MongoRunner.runMongod(
+        {storageEngine: 'wiredTiger', setParameter: 'wiredTigerDictionaryRetrainInterval=2000'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+
+    assert.commandFailedWithCode(
+        testDB.createCollection('bad', {storageEngine: {wiredTiger: {dictionaryCompression: 1}}}),
+        ErrorCodes.TypeMismatch);
+    assert.commandFailed(testDB.createCollection(
+        'cappedBad',
+        {capped: true, size: 4096, storageEngine: {wiredTiger: {dictionaryCompression: true}}}));
+    assert.commandFailed(testDB.createCollection(
+        'columnsBad',
+        {storageEngine: {wiredTiger: {dictionaryCompression: true, columnGroups: ['a']}}}));
+
+    assert.commandWorked(testDB.createCollection(
+        'compressed', {storageEngine: {wiredTiger: {dictionaryCompression: true}}}));
+    var compressed = testDB.compressed;
+    var plain = testDB.plain;
+
+    function makeDoc(i) {
+        return {
+            _id: i,
+            customerName: 'customer' + (i % 50),
+            accountStatus: i % 3 ? 'active' : 'suspended',
+            shippingAddress: {streetName: 'Main Street', postalCode: i % 100}
+        };
+    }
+
+    function getCompressionStats() {
+        return compressed.stats().wiredTiger.dictionaryCompression;
+    }
+
+    for (var i = 0; i < 1000; i++) {
+        assert.writeOK(compressed.insert(makeDoc(i)));
+        assert.writeOK(plain.insert(makeDoc(i)));
+    }
+    assert.eq(1, getCompressionStats().currentDictionary, tojson(getCompressionStats()));
+
+    // Records compressed with the first dictionary are still readable after retraining.
+    for (i = 1000; i < 3000; i++) {
+        assert.writeOK(compressed.insert(makeDoc(i)));
+        assert.writeOK(plain.insert(makeDoc(i)));
+    }
+    assert.eq(2, getCompressionStats().currentDictionary, tojson(getCompressionStats()));
+
+    assert.writeOK(compressed.update({_id: 5}, {$set: {accountStatus: 'closed'}}));
+    assert.writeOK(plain.update({_id: 5}, {$set: {accountStatus: 'closed'}}));
+    assert.writeOK(compressed.remove({_id: 6}));
+    assert.writeOK(plain.remove({_id: 6}));
+
+    function checkContents() {
+        assert.eq(plain.find().sort({_id: 1}).toArray(),
+                  compressed.find().sort({_id: 1}).toArray());
+        assert.eq(plain.findOne({_id: 2500}), compressed.findOne({_id: 2500}));
+        assert.eq(plain.stats().size, compressed.stats().size);
+        assert.commandWorked(compressed.validate(true));
+    }
+    checkContents();
+
+    // The dictionaries are stored in the catalog, so they survive a restart.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: true, port: conn.port, cleanData: false, storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+    compressed = testDB.compressed;
+    plain = testDB.plain;
+
+    assert.eq(true, compressed.stats().wiredTiger.metadata.dictionaryCompression);
+    assert.eq(2, getCompressionStats().currentDictionary, tojson(getCompressionStats()));
+    checkContents();
+
+    // Renaming the collection keeps its dictionaries.
+    assert.commandWorked(compressed.renameCollection('renamed'));
+    compressed = testDB.renamed;
+    checkContents();
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,79 @@
+/**
+ * Tests that unique WiredTiger indexes created with 'bloomFilter' answer lookups of missing keys
+ * from the filter, and that the filter is rebuilt from the index on restart.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var conn = MongoRunner.runMongod({storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+
+    var bloomFilterOptions = {storageEngine: {wiredTiger: {bloomFilter: true}}};
+    assert.commandWorked(
+        testDB.createCollection('filtered', {indexOptionDefaults: bloomFilterOptions}));
+    var coll = testDB.filtered;
+
+    assert.commandWorked(
+        coll.createIndex({a: 1}, Object.extend({unique: true}, bloomFilterOptions)));
+    assert.commandFailedWithCode(coll.createIndex({b: 1}, bloomFilterOptions),
+                                 ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        coll.createIndex({b: 1}, {storageEngine: {wiredTiger: {bloomFilter: 'yes'}}}),
+        ErrorCodes.TypeMismatch);
+    // The collection's default doesn't apply to indexes which are not unique.
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: -i, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: 10}));
+
+    function bloomFilterStats(indexName) {
+        return coll.stats().indexDetails[indexName].bloomFilter;
+    }
+
+    function checkLookups() {
+        for (var i = 0; i < 1000; i++) {
+            assert.eq(i === 10 ? null : i, (coll.findOne({_id: i}) || {_id: null})._id);
+        }
+        var before = bloomFilterStats('_id_');
+        for (var i = 1000; i < 2000; i++) {
+            assert.eq(null, coll.findOne({_id: i}));
+        }
+        var after = bloomFilterStats('_id_');
+        assert.gt(after.negatives - before.negatives, 900, tojson(after));
+        assert.eq(999, coll.find({a: {$lte: 0}}).hint({a: 1}).itcount());
+    }
+
+    checkLookups();
+    assert.eq(undefined, bloomFilterStats('b_1'));
+    assert.writeError(coll.insert({_id: 2000, a: -1}));
+    assert.writeOK(coll.update({_id: 3000}, {$set: {a: 3000}}, {upsert: true}));
+    assert.eq(3000, coll.findOne({_id: 3000}).a);
+
+    // The filter is built from the index when it is opened.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: true, port: conn.port, cleanData: false, storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+    coll = testDB.filtered;
+
+    var stats = bloomFilterStats('_id_');
+    assert.eq(1000, stats.keys, tojson(stats));
+    assert.eq(1000, bloomFilterStats('a_1').keys);
+    assert.eq(true, coll.stats().indexDetails._id_.metadata.bloomFilter);
+    checkLookups();
+    assert.commandWorked(coll.validate(true));
+
+    MongoRunner.stopMongod(conn);
+})();
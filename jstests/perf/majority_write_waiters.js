@@ -0,0 +1,45 @@
+/**
+ * Measures the throughput of many concurrent w:majority writers against a 3 node replica set.
+ * Each writer blocks in awaitReplication, so this exercises how the primary wakes large numbers
+ * of write concern waiters as secondaries report progress. Runs until at least 10000 majority
+ * writes have been acknowledged.
+ */
+(function() {
+    "use strict";
+
+    var numWrites = 10000;
+    var numWriters = 256;
+
+    var replTest = new ReplSetTest({name: "majorityWriteWaiters", nodes: 3});
+    replTest.startSet();
+    replTest.initiate();
+    var primary = replTest.getPrimary();
+    var coll = primary.getDB("test").majority_write_waiters;
+    assert.commandWorked(coll.getDB().createCollection(coll.getName()));
+
+    var totalInserts = 0;
+    var totalSeconds = 0;
+    while (totalInserts < numWrites) {
+        var res = benchRun({
+            ops: [{
+                ns: coll.getFullName(),
+                op: "insert",
+                doc: {x: 1},
+                writeCmd: true,
+                writeConcern: {w: "majority"}
+            }],
+            parallel: numWriters,
+            seconds: 5,
+            host: primary.host
+        });
+        assert.eq(0, res.errCount, tojson(res));
+        totalInserts += res.insert * 5;
+        totalSeconds += 5;
+    }
+
+    print("majority writes/sec with " + numWriters + " concurrent writers: " +
+          (totalInserts / totalSeconds));
+    assert.gte(coll.count(), numWrites);
+
+    replTest.stopSet();
+}());
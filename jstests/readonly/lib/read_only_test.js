@@ -8,11 +8,10 @@ function runReadOnlyTest(test) {
     assert.eq(typeof(test.load), 'function');
     assert.eq(typeof(test.name), 'string');
 
-    // TODO: read storageEngine from testData when read-only mode is supported in WiredTiger.
-    var options = {
-        storageEngine: 'mmapv1',
-        nopreallocj: ''
-    };
+    var options = {storageEngine: jsTest.options().storageEngine || 'wiredTiger'};
+    if (options.storageEngine === 'mmapv1') {
+        options.nopreallocj = '';
+    }
 
     var writableMongod = MongoRunner.runMongod(options);
     var dbpath = writableMongod.dbpath;
@@ -28,12 +27,55 @@ function runReadOnlyTest(test) {
                                          dbpath: dbpath,
                                          noCleanData: true});
 
+    var isWiredTiger = (options.storageEngine === 'wiredTiger');
+    var userFileChecksums;
+    if (isWiredTiger) {
+        // WiredTiger opens every file for writing and updates its own metadata files even in
+        // read-only mode, so it refuses to start on a dbpath which is not writable.
+        if (!_isWindows()) {
+            makeDirectoryReadOnly(dbpath);
+            // Permissions don't stop root, so there is nothing to check when running as root.
+            if (run('test', '-w', dbpath) !== 0) {
+                assert.isnull(MongoRunner.runMongod(readOnlyOptions),
+                              'read-only WiredTiger started on a dbpath without write access');
+            }
+            makeDirectoryWritable(dbpath);
+        }
+        userFileChecksums = checksumUserFiles(dbpath);
+    }
+
     var readOnlyMongod = MongoRunner.runMongod(readOnlyOptions);
 
     jsTest.log('starting execution phase for test: ' + test.name);
     test.exec(readOnlyMongod.getDB('test')[test.name]);
 
     MongoRunner.stopMongod(readOnlyMongod);
+
+    if (isWiredTiger) {
+        // Only the collections and indexes are guaranteed not to be written to.
+        assert.eq(userFileChecksums,
+                  checksumUserFiles(dbpath),
+                  'collection or index files were modified in read-only mode');
+    }
+}
+
+function makeDirectoryReadOnly(dir) {
+    assert.eq(0, run('chmod', '-R', 'a-w', dir));
+}
+
+function makeDirectoryWritable(dir) {
+    assert.eq(0, run('chmod', '-R', 'u+w', dir));
+}
+
+// Returns the checksums of the collection and index files of a WiredTiger dbpath by file name.
+function checksumUserFiles(dbpath) {
+    var checksums = {};
+    listFiles(dbpath).forEach(function(file) {
+        if (!file.isDirectory && /^(collection|index)-.*\.wt$/.test(file.baseName)) {
+            checksums[file.baseName] = md5sumFile(file.name);
+        }
+    });
+    return checksums;
 }
 
 function* cycleN(arr, N) {
@@ -0,0 +1,50 @@
+// Test that secondaries can replicate by streaming the oplog over an exhaust cursor
+// (bgSyncOplogFetcherExhaust) and keep up after the sync source stalls and resumes.
+(function() {
+    "use strict";
+    var name = "oplogFetcherExhaust";
+    var replTest = new ReplSetTest({name: name,
+                                    nodes: 3,
+                                    nodeOptions: {setParameter: "bgSyncOplogFetcherExhaust=true"}});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 },
+                           { "_id": 2, "host": nodes[2], priority: 0 }],
+                       // Streaming is only used under protocol version 0.
+                       protocolVersion: 0});
+
+    var master = replTest.getPrimary();
+    var coll = master.getDB("test").exhaust;
+
+    jsTestLog("Inserting documents in several bursts");
+    for (var burst = 0; burst < 5; burst++) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({burst: burst, i: i, pad: new Array(512).join("x")});
+        }
+        assert.writeOK(bulk.execute());
+        // Leave the stream idle long enough for empty awaitData batches to be pushed.
+        sleep(1500);
+    }
+    assert.writeOK(coll.insert({last: true}, {writeConcern: {w: 3, wtimeout: 60 * 1000}}));
+
+    replTest.awaitReplication();
+    replTest.liveNodes.slaves.forEach(function(slave) {
+        slave.setSlaveOk();
+        assert.eq(5001, slave.getDB("test").exhaust.count(), slave.host);
+    });
+
+    // The secondaries must have streamed the oplog rather than fallen back to the Fetcher.
+    var msg = "streaming remote oplog on ";
+    replTest.liveNodes.slaves.forEach(function(slave) {
+        var logMessages = assert.commandWorked(slave.adminCommand({getLog: "global"})).log;
+        assert(logMessages.some(function(line) {
+            return line.indexOf(msg) != -1;
+        }), "did not see '" + msg + "' in the log of " + slave.host);
+    });
+
+    replTest.stopSet();
+}());
@@ -0,0 +1,44 @@
+// Test that with replPrefetchAllStorageEngines set, secondaries prefetch every batch before
+// applying it regardless of storage engine, and report apply times for prefetched batches.
+(function() {
+    "use strict";
+    var name = "prefetchAllStorageEngines";
+    var replTest = new ReplSetTest({name: name,
+                                    nodes: 2,
+                                    nodeOptions: {setParameter: "replPrefetchAllStorageEngines=true"}});
+    replTest.startSet();
+    replTest.initiate();
+
+    var master = replTest.getPrimary();
+    var coll = master.getDB("test").prefetch;
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        if (i % 2) {
+            bulk.find({_id: i}).updateOne({$set: {a: -i}});
+        } else {
+            bulk.find({_id: i}).removeOne();
+        }
+    }
+    assert.writeOK(bulk.execute({w: 2, wtimeout: 60 * 1000}));
+
+    var slave = replTest.liveNodes.slaves[0];
+    slave.setSlaveOk();
+    var slaveColl = slave.getDB("test").prefetch;
+    assert.eq(500, slaveColl.count());
+    assert.eq(500, slaveColl.find({a: {$lt: 0}}).hint({a: 1}).itcount());
+
+    var metrics = slave.getDB("admin").serverStatus().metrics.repl;
+    assert.gt(metrics.preload.batches.num, 0, tojson(metrics));
+    assert.gt(metrics.apply.prefetchedBatches.num, 0, tojson(metrics));
+    assert.eq(0, metrics.apply.nonPrefetchedBatches.num, tojson(metrics));
+
+    replTest.stopSet();
+}());
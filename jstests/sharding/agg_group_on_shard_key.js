@@ -0,0 +1,63 @@
+//
+// Tests that a sharded aggregation whose $group is on the shard key completes the $group on the
+// shards, and returns the same results as when partial groups are merged.
+//
+(function() {
+"use strict";
+
+var st = new ShardingTest({shards: 2, mongos: 1});
+st.stopBalancer();
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var dbName = "aggShardKeyGroup";
+var ns = dbName + ".foo";
+var coll = mongos.getCollection(ns);
+
+assert.commandWorked(admin.runCommand({enableSharding: dbName}));
+st.ensurePrimaryShard(dbName, st.shard0.shardName);
+assert.commandWorked(admin.runCommand({shardCollection: ns, key: {sk: 1}}));
+assert.commandWorked(admin.runCommand({split: ns, middle: {sk: 50}}));
+assert.commandWorked(admin.runCommand({moveChunk: ns,
+                                       find: {sk: 50},
+                                       to: st.shard1.shardName,
+                                       _waitForDelete: true}));
+
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < 2000; i++) {
+    bulk.insert({sk: i % 100, x: i % 7, v: i});
+}
+assert.writeOK(bulk.execute());
+
+var pipeline = [{$group: {_id: "$sk", total: {$sum: "$v"}, avg: {$avg: "$v"}, n: {$sum: 1}}},
+                {$sort: {total: -1}}];
+
+// Shard key groups are only completed on the shards once every shard understands it.
+assert.commandWorked(
+    admin.runCommand({setParameter: 1, internalQueryCompleteShardKeyGroupsOnShards: true}));
+
+// The $group runs to completion on the shards and only the $sort is merged.
+var explain = coll.aggregate(pipeline, {explain: true});
+assert.eq(true, explain.splitPipeline.shardsPart[0].$group.$completeOnShard, tojson(explain));
+assert.eq(1, explain.splitPipeline.mergerPart.length, tojson(explain));
+
+var completed = coll.aggregate(pipeline).toArray();
+assert.eq(100, completed.length);
+
+// Compare with merging partial groups from every shard.
+assert.commandWorked(
+    admin.runCommand({setParameter: 1, internalQueryCompleteShardKeyGroupsOnShards: false}));
+explain = coll.aggregate(pipeline, {explain: true});
+assert.eq(undefined, explain.splitPipeline.shardsPart[0].$group.$completeOnShard, tojson(explain));
+var merged = coll.aggregate(pipeline).toArray();
+assert.eq(merged, completed);
+
+// A $group which is not on the shard key is still merged.
+assert.commandWorked(
+    admin.runCommand({setParameter: 1, internalQueryCompleteShardKeyGroupsOnShards: true}));
+explain = coll.aggregate([{$group: {_id: "$x", n: {$sum: 1}}}], {explain: true});
+assert.eq(undefined, explain.splitPipeline.shardsPart[0].$group.$completeOnShard, tojson(explain));
+assert.eq(true, explain.splitPipeline.mergerPart[0].$group.$doingMerge, tojson(explain));
+
+st.stop();
+})();
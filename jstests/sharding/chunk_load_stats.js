@@ -0,0 +1,68 @@
+//
+// Tests that shards report the sampled load and estimated size of their chunks through
+// getChunkLoadStats, which the balancer uses when it balances on bytes or load.
+//
+(function() {
+"use strict";
+
+var st = new ShardingTest({shards: 2,
+                           mongos: 1,
+                           other: {shardOptions: {setParameter: "chunkLoadSamplingInterval=1"}}});
+st.stopBalancer();
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var dbName = "chunkLoadStats";
+var ns = dbName + ".foo";
+var coll = mongos.getCollection(ns);
+
+assert.commandWorked(admin.runCommand({enableSharding: dbName}));
+st.ensurePrimaryShard(dbName, st.shard0.shardName);
+assert.commandWorked(admin.runCommand({shardCollection: ns, key: {_id: 1}}));
+assert.commandWorked(admin.runCommand({split: ns, middle: {_id: 100}}));
+
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < 200; i++) {
+    bulk.insert({_id: i, x: i});
+}
+assert.writeOK(bulk.execute());
+
+// Only the upper chunk is read
+assert.eq(50, coll.find({_id: {$gte: 150}}).itcount());
+
+var res = st.shard0.getDB("admin").runCommand({getChunkLoadStats: ns});
+assert.commandWorked(res);
+assert.eq(2, res.chunks.length, tojson(res));
+
+var lower = res.chunks[0];
+var upper = res.chunks[1];
+assert.eq({_id: 100}, lower.max, tojson(res));
+assert.eq(100, lower.writes, tojson(res));
+assert.eq(0, lower.reads, tojson(res));
+assert.eq(100, upper.writes, tojson(res));
+assert.eq(50, upper.reads, tojson(res));
+assert.gt(lower.bytes, 0, tojson(res));
+
+// Reporting the operation counts does not decay them
+res = st.shard0.getDB("admin").runCommand({getChunkLoadStats: ns});
+assert.commandWorked(res);
+assert.eq(100, res.chunks[0].writes, tojson(res));
+assert.eq(50, res.chunks[1].reads, tojson(res));
+
+// Splitting a chunk spreads its statistics across the new chunks
+assert.commandWorked(admin.runCommand({split: ns, middle: {_id: 150}}));
+res = st.shard0.getDB("admin").runCommand({getChunkLoadStats: ns});
+assert.commandWorked(res);
+assert.eq(3, res.chunks.length, tojson(res));
+assert.eq({_id: 150}, res.chunks[2].min, tojson(res));
+assert.eq(50, res.chunks[1].writes, tojson(res));
+assert.eq(25, res.chunks[1].reads, tojson(res));
+assert.eq(50, res.chunks[2].writes, tojson(res));
+assert.eq(25, res.chunks[2].reads, tojson(res));
+
+// The balancer accepts load and size weights
+assert.commandWorked(mongos.adminCommand({setParameter: 1, balancerLoadWeight: 1}));
+assert.commandWorked(mongos.adminCommand({setParameter: 1, balancerBytesWeight: 0.5}));
+
+st.stop();
+})();
@@ -0,0 +1,68 @@
+//
+// Tests that with connPoolMaxShardedInUseConnsPerHost set, concurrent operations through mongos
+// share a bounded number of connections to each shard, and that connPoolStats reports the
+// requests which had to wait for one.
+//
+(function() {
+"use strict";
+
+var maxInUse = 2;
+var st = new ShardingTest({shards: 2,
+                           mongos: 1,
+                           other: {mongosOptions: {
+                               setParameter: "connPoolMaxShardedInUseConnsPerHost=" + maxInUse
+                           }}});
+st.stopBalancer();
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var dbName = "connPoolInUseLimit";
+var ns = dbName + ".foo";
+var coll = mongos.getCollection(ns);
+
+assert.commandWorked(admin.runCommand({enableSharding: dbName}));
+st.ensurePrimaryShard(dbName, st.shard0.shardName);
+assert.commandWorked(admin.runCommand({shardCollection: ns, key: {_id: 1}}));
+assert.commandWorked(admin.runCommand({split: ns, middle: {_id: 0}}));
+assert.commandWorked(admin.runCommand({moveChunk: ns,
+                                       find: {_id: 0},
+                                       to: st.shard1.shardName,
+                                       _waitForDelete: true}));
+
+// Many more concurrent clients than the limit, each issuing legacy operations which target a
+// single shard at a time.
+var numClients = 8;
+var shells = [];
+for (var i = 0; i < numClients; i++) {
+    shells.push(startParallelShell(
+        "var coll = db.getSiblingDB('" + dbName + "').foo;" +
+        "for (var j = 0; j < 200; j++) {" +
+        "    coll.insert({_id: " + i + " * 1000 + j - 500});" +
+        "    assert.gleSuccess(db);" +
+        "    coll.find({_id: {$gte: 0}}).limit(5).itcount();" +
+        "}",
+        mongos.port));
+}
+shells.forEach(function(join) {
+    join();
+});
+
+assert.eq(numClients * 200, coll.count());
+
+var stats = admin.runCommand({shardConnPoolStats: 1});
+assert.commandWorked(stats);
+assert("totalWaited" in stats, tojson(stats));
+assert("totalWaitTimeouts" in stats, tojson(stats));
+assert.eq(0, stats.totalWaitTimeouts, tojson(stats));
+for (var host in stats.hosts) {
+    assert.lte(stats.hosts[host].inUse, maxInUse, tojson(stats));
+}
+
+// The legacy shard connections are also reported by connPoolStats.
+stats = admin.runCommand({connPoolStats: 1});
+assert.commandWorked(stats);
+assert("totalWaited" in stats, tojson(stats));
+assert.lte(stats.totalInUse + stats.totalAvailable, stats.totalCreated, tojson(stats));
+
+st.stop();
+})();
@@ -0,0 +1,51 @@
+//
+// Tests that a chunk migration whose recipient clones over several concurrent _migrateClone
+// streams copies every document, and that the clone throughput is recorded in the changelog.
+//
+(function() {
+"use strict";
+
+var st = new ShardingTest({shards: 2,
+                           mongos: 1,
+                           other: {shardOptions: {setParameter: "migrateCloneConcurrency=3"}}});
+st.stopBalancer();
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var dbName = "testDB";
+var ns = dbName + ".foo";
+var coll = mongos.getCollection(ns);
+
+assert.commandWorked(admin.runCommand({enableSharding: dbName}));
+st.ensurePrimaryShard(dbName, st.shard0.shardName);
+assert.commandWorked(admin.runCommand({shardCollection: ns, key: {_id: 1}}));
+assert.commandWorked(coll.ensureIndex({x: 1}));
+
+// Enough data for the donor to need several _migrateClone batches.
+var padding = new Array(16 * 1024).join("x");
+var numDocs = 4000;
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < numDocs; i++) {
+    bulk.insert({_id: i, x: i, padding: padding});
+}
+assert.writeOK(bulk.execute());
+
+assert.commandWorked(admin.runCommand({moveChunk: ns,
+                                       find: {_id: 0},
+                                       to: st.shard1.shardName,
+                                       _waitForDelete: true}));
+
+var recipientColl = st.shard1.getCollection(ns);
+assert.eq(numDocs, recipientColl.count());
+assert.eq(numDocs, recipientColl.find().hint({x: 1}).itcount());
+assert.eq(0, st.shard0.getCollection(ns).count());
+
+var change = mongos.getDB("config").changelog.findOne({what: "moveChunk.to", ns: ns});
+assert.neq(null, change);
+assert.eq("success", change.details.note, tojson(change));
+assert.eq(numDocs, change.details.clonedDocs, tojson(change));
+assert.gt(change.details.clonedBytes, 0, tojson(change));
+assert.gt(change.details.cloneBytesPerSec, 0, tojson(change));
+
+st.stop();
+})();
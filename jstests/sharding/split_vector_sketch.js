@@ -0,0 +1,72 @@
+//
+// Tests that splitVector builds a sketch of a chunk the first time it scans it, and answers later
+// requests for the chunk, including inserts made since, from the sketch.
+//
+(function() {
+"use strict";
+
+var st = new ShardingTest({
+    shards: 1,
+    mongos: 1,
+    other: {
+        mongosOptions: {noAutoSplit: ""},
+        shardOptions: {setParameter: "chunkSplitSketchSamplingInterval=1"}
+    }
+});
+st.stopBalancer();
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var dbName = "splitVectorSketch";
+var ns = dbName + ".foo";
+var coll = mongos.getCollection(ns);
+
+assert.commandWorked(admin.runCommand({enableSharding: dbName}));
+assert.commandWorked(admin.runCommand({shardCollection: ns, key: {_id: 1}}));
+
+var padding = new Array(1024).join("x");
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < 4000; i++) {
+    bulk.insert({_id: i, padding: padding});
+}
+assert.writeOK(bulk.execute());
+
+var shardAdmin = st.shard0.getDB("admin");
+var splitVector = {splitVector: ns,
+                   keyPattern: {_id: 1},
+                   min: {_id: MinKey},
+                   max: {_id: MaxKey},
+                   maxChunkSizeBytes: 1024 * 1024};
+
+// The first request scans the index
+var scanned = shardAdmin.runCommand(splitVector);
+assert.commandWorked(scanned);
+assert.neq(true, scanned.fromSketch, tojson(scanned));
+assert.gt(scanned.splitKeys.length, 0, tojson(scanned));
+
+// The second one is answered from the sketch, with about as many split points
+var sketched = shardAdmin.runCommand(splitVector);
+assert.commandWorked(sketched);
+assert.eq(true, sketched.fromSketch, tojson(sketched));
+assert.lte(Math.abs(sketched.splitKeys.length - scanned.splitKeys.length), 2, tojson(sketched));
+
+// Inserts are reflected in the sketch
+bulk = coll.initializeUnorderedBulkOp();
+for (var i = 4000; i < 8000; i++) {
+    bulk.insert({_id: i, padding: padding});
+}
+assert.writeOK(bulk.execute());
+
+var grown = shardAdmin.runCommand(splitVector);
+assert.commandWorked(grown);
+assert.eq(true, grown.fromSketch, tojson(grown));
+assert.gt(grown.splitKeys.length, sketched.splitKeys.length, tojson(grown));
+
+// Sketches can be turned off
+assert.commandWorked(shardAdmin.runCommand({setParameter: 1, splitVectorUseSketches: false}));
+var unsketched = shardAdmin.runCommand(splitVector);
+assert.commandWorked(unsketched);
+assert.neq(true, unsketched.fromSketch, tojson(unsketched));
+
+st.stop();
+})();
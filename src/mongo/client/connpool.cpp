@@ -36,6 +36,7 @@
 
 #include "mongo/client/connpool.h"
 
+#include <limits>
 #include <string>
 
 #include "mongo/client/connection_string.h"
@@ -45,6 +46,7 @@
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -174,6 +176,25 @@ void PoolForHost::createdOne(DBClientBase* base) {
     // _checkedOut is used to indicate the number of in-use connections so
     // though we didn't actually check this connection out, we bump it here.
     ++_checkedOut;
+    if (_pendingCreates > 0)
+        --_pendingCreates;
+}
+
+bool PoolForHost::reserveCreate(int inUseForHost) {
+    if (_maxInUse >= 0 && inUseForHost >= _maxInUse)
+        return false;
+    ++_pendingCreates;
+    return true;
+}
+
+void PoolForHost::decrementEgress() {
+    if (_checkedOut > 0)
+        --_checkedOut;
+}
+
+void PoolForHost::cancelCreate() {
+    verify(_pendingCreates > 0);
+    --_pendingCreates;
 }
 
 void PoolForHost::initializeHostName(const std::string& hostName) {
@@ -189,15 +210,46 @@ const int PoolForHost::kPoolSizeUnlimited(-1);
 DBConnectionPool::DBConnectionPool()
     : _name("dbconnectionpool"),
       _maxPoolSize(PoolForHost::kPoolSizeUnlimited),
+      _maxInUse(PoolForHost::kPoolSizeUnlimited),
+      _maxInUseWaitTimeout(Seconds(20)),
       _hooks(new list<DBConnectionHook*>()) {}
 
 DBClientBase* DBConnectionPool::_get(const string& ident, double socketTimeout) {
     uassert(17382, "Can't use connection pool during shutdown", !inShutdown());
-    stdx::lock_guard<stdx::mutex> L(_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
     PoolForHost& p = _pools[PoolKey(ident, socketTimeout)];
     p.setMaxPoolSize(_maxPoolSize);
+    p.setMaxInUse(_maxInUse);
     p.initializeHostName(ident);
-    return p.get(this, socketTimeout);
+
+    const Date_t deadline = Date_t::now() + _maxInUseWaitTimeout;
+    bool waited = false;
+    while (true) {
+        DBClientBase* c = p.get(this, socketTimeout);
+        if (c)
+            return c;
+
+        // Returning NULL tells the caller to create a connection, which holds the slot reserved
+        // here until it either succeeds or gives up.
+        if (p.reserveCreate(_numInUseForHost_inlock(ident)))
+            return NULL;
+
+        if (Date_t::now() >= deadline) {
+            p.noteWaitTimedOut();
+            uasserted(ErrorCodes::ExceededTimeLimit,
+                      str::stream() << _name << ": timed out after " << _maxInUseWaitTimeout
+                                    << " waiting for one of the " << _maxInUse
+                                    << " connections in use to " << ident
+                                    << " to be returned");
+        }
+
+        if (!waited) {
+            p.noteWaited();
+            waited = true;
+        }
+
+        _inUseReleased.wait_until(lk, deadline.toSystemTimePoint());
+    }
 }
 
 DBClientBase* DBConnectionPool::_finishCreate(const string& host,
@@ -215,6 +267,7 @@ DBClientBase* DBConnectionPool::_finishCreate(const string& host,
         onCreate(conn);
         onHandedOut(conn);
     } catch (std::exception&) {
+        decrementEgress(host, conn);
         delete conn;
         throw;
     }
@@ -222,22 +275,46 @@ DBClientBase* DBConnectionPool::_finishCreate(const string& host,
     return conn;
 }
 
+int DBConnectionPool::_numInUseForHost_inlock(const string& ident) const {
+    int inUse = 0;
+    for (PoolMap::const_iterator i =
+             _pools.lower_bound(PoolKey(ident, -std::numeric_limits<double>::infinity()));
+         i != _pools.end() && !serverNameCompare()(ident, i->first.ident);
+         ++i) {
+        inUse += i->second.numInUseOrPending();
+    }
+    return inUse;
+}
+
+void DBConnectionPool::_cancelCreate(const string& host, double socketTimeout) {
+    {
+        stdx::lock_guard<stdx::mutex> L(_mutex);
+        _pools[PoolKey(host, socketTimeout)].cancelCreate();
+    }
+    _inUseReleased.notify_all();
+}
+
 DBClientBase* DBConnectionPool::get(const ConnectionString& url, double socketTimeout) {
     DBClientBase* c = _get(url.toString(), socketTimeout);
     if (c) {
         try {
             onHandedOut(c);
         } catch (std::exception&) {
+            decrementEgress(url.toString(), c);
             delete c;
             throw;
         }
         return c;
     }
 
+    ScopeGuard reservation =
+        MakeGuard([&] { _cancelCreate(url.toString(), socketTimeout); });
+
     string errmsg;
     c = url.connect(errmsg, socketTimeout);
     uassert(13328, _name + ": connect failed " + url.toString() + " : " + errmsg, c);
 
+    reservation.Dismiss();
     return _finishCreate(url.toString(), socketTimeout, c);
 }
 
@@ -247,12 +324,15 @@ DBClientBase* DBConnectionPool::get(const string& host, double socketTimeout) {
         try {
             onHandedOut(c);
         } catch (std::exception&) {
+            decrementEgress(host, c);
             delete c;
             throw;
         }
         return c;
     }
 
+    ScopeGuard reservation = MakeGuard([&] { _cancelCreate(host, socketTimeout); });
+
     const ConnectionString cs(uassertStatusOK(ConnectionString::parse(host)));
 
     string errmsg;
@@ -262,6 +342,8 @@ DBClientBase* DBConnectionPool::get(const string& host, double socketTimeout) {
                               host,
                               11002,
                               str::stream() << _name << " error: " << errmsg);
+
+    reservation.Dismiss();
     return _finishCreate(host, socketTimeout, c);
 }
 
@@ -278,8 +360,19 @@ void DBConnectionPool::onRelease(DBClientBase* conn) {
 void DBConnectionPool::release(const string& host, DBClientBase* c) {
     onRelease(c);
 
-    stdx::lock_guard<stdx::mutex> L(_mutex);
-    _pools[PoolKey(host, c->getSoTimeout())].done(this, c);
+    {
+        stdx::lock_guard<stdx::mutex> L(_mutex);
+        _pools[PoolKey(host, c->getSoTimeout())].done(this, c);
+    }
+    _inUseReleased.notify_all();
+}
+
+void DBConnectionPool::decrementEgress(const string& host, DBClientBase* c) {
+    {
+        stdx::lock_guard<stdx::mutex> L(_mutex);
+        _pools[PoolKey(host, c->getSoTimeout())].decrementEgress();
+    }
+    _inUseReleased.notify_all();
 }
 
 
@@ -365,6 +458,8 @@ void DBConnectionPool::appendConnectionStats(executor::ConnectionPoolStats* stat
                 static_cast<size_t>(i->second.numInUse()),
                 static_cast<size_t>(i->second.numAvailable()),
                 static_cast<size_t>(i->second.numCreated())};
+            hostStats.waited = static_cast<size_t>(i->second.numWaited());
+            hostStats.waitTimeouts = static_cast<size_t>(i->second.numWaitTimeouts());
             stats->updateStatsForHost(host, hostStats);
         }
     }
@@ -499,6 +594,14 @@ ScopedDbConnection::~ScopedDbConnection() {
     }
 }
 
+void ScopedDbConnection::kill() {
+    if (_conn) {
+        globalConnPool.decrementEgress(_host, _conn);
+        delete _conn;
+        _conn = 0;
+    }
+}
+
 void ScopedDbConnection::clearPool() {
     globalConnPool.clear();
 }
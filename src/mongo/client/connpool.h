@@ -34,8 +34,10 @@
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -60,14 +62,22 @@ public:
           _minValidCreationTimeMicroSec(0),
           _type(ConnectionString::INVALID),
           _maxPoolSize(kPoolSizeUnlimited),
-          _checkedOut(0) {}
+          _maxInUse(kPoolSizeUnlimited),
+          _checkedOut(0),
+          _pendingCreates(0),
+          _numWaited(0),
+          _numWaitTimeouts(0) {}
 
     PoolForHost(const PoolForHost& other)
         : _created(other._created),
           _minValidCreationTimeMicroSec(other._minValidCreationTimeMicroSec),
           _type(other._type),
           _maxPoolSize(other._maxPoolSize),
-          _checkedOut(other._checkedOut) {
+          _maxInUse(other._maxInUse),
+          _checkedOut(other._checkedOut),
+          _pendingCreates(other._pendingCreates),
+          _numWaited(other._numWaited),
+          _numWaitTimeouts(other._numWaitTimeouts) {
         verify(_created == 0);
         verify(other._pool.size() == 0);
     }
@@ -96,6 +106,52 @@ public:
         return _checkedOut;
     }
 
+    /**
+     * Returns the number of connections checked out of, or being created for, this pool.
+     */
+    int numInUseOrPending() const {
+        return _checkedOut + _pendingCreates;
+    }
+
+    /**
+     * Sets the maximum number of connections which may be checked out of, or being created
+     * for, this host at once. kPoolSizeUnlimited means no limit.
+     */
+    void setMaxInUse(int maxInUse) {
+        _maxInUse = maxInUse;
+    }
+
+    /**
+     * Reserves room for a new connection to this host. 'inUseForHost' is the number of
+     * connections checked out or being created for the host across the pools for all of its
+     * socket timeouts, which is what the in-use limit applies to. Returns false if the limit
+     * has been reached, in which case the caller has to wait for a connection to be returned.
+     * A successful reservation is consumed by createdOne() or given back by cancelCreate().
+     */
+    bool reserveCreate(int inUseForHost);
+    void cancelCreate();
+
+    /**
+     * Accounts for a checked out connection which was destroyed instead of being returned.
+     */
+    void decrementEgress();
+
+    void noteWaited() {
+        ++_numWaited;
+    }
+
+    void noteWaitTimedOut() {
+        ++_numWaitTimeouts;
+    }
+
+    long long numWaited() const {
+        return _numWaited;
+    }
+
+    long long numWaitTimeouts() const {
+        return _numWaitTimeouts;
+    }
+
     void createdOne(DBClientBase* base);
     long long numCreated() const {
         return _created;
@@ -157,8 +213,19 @@ private:
     // The maximum number of connections we'll save in the pool
     int _maxPoolSize;
 
+    // The maximum number of connections checked out or being created at once
+    int _maxInUse;
+
     // The number of currently active connections from this pool
     int _checkedOut;
+
+    // The number of connections reserved by reserveCreate() which are still being established
+    int _pendingCreates;
+
+    // The number of get() calls which had to wait for the in-use limit, and how many of those
+    // gave up
+    long long _numWaited;
+    long long _numWaitTimeouts;
 };
 
 class DBConnectionHook {
@@ -215,6 +282,29 @@ public:
         _maxPoolSize = maxPoolSize;
     }
 
+    /**
+     * Sets the maximum number of connections per-host which may be in use at once. Callers of
+     * get() beyond this limit wait up to the in-use wait timeout for a connection to be
+     * released, rather than opening another socket, and fail with ExceededTimeLimit after it.
+     * The limit covers the connections to a host for every socket timeout together, although an
+     * idle connection pooled for the requested timeout is always handed out, since reusing it
+     * opens no socket. PoolForHost::kPoolSizeUnlimited, the default, means no limit.
+     */
+    void setMaxInUse(int maxInUse) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _maxInUse = maxInUse;
+    }
+
+    int getMaxInUse() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _maxInUse;
+    }
+
+    void setMaxInUseWaitTimeout(Milliseconds timeout) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _maxInUseWaitTimeout = timeout;
+    }
+
     void onCreate(DBClientBase* conn);
     void onHandedOut(DBClientBase* conn);
     void onDestroy(DBClientBase* conn);
@@ -227,6 +317,12 @@ public:
 
     void release(const std::string& host, DBClientBase* c);
 
+    /**
+     * Tells the pool that a connection it handed out has been destroyed by the caller instead
+     * of being released, so that it no longer counts against the host's in-use limit.
+     */
+    void decrementEgress(const std::string& host, DBClientBase* c);
+
     void addHook(DBConnectionHook* hook);  // we take ownership
     void appendConnectionStats(executor::ConnectionPoolStats* stats) const;
 
@@ -266,6 +362,17 @@ private:
 
     DBClientBase* _finishCreate(const std::string& ident, double socketTimeout, DBClientBase* conn);
 
+    /**
+     * Gives back the reservation made by _get() for a connection which could not be created.
+     */
+    void _cancelCreate(const std::string& ident, double socketTimeout);
+
+    /**
+     * Returns the number of connections checked out of, or being created by, the pools for
+     * 'ident' across all socket timeouts.
+     */
+    int _numInUseForHost_inlock(const std::string& ident) const;
+
     struct PoolKey {
         PoolKey(const std::string& i, double t) : ident(i), timeout(t) {}
         std::string ident;
@@ -286,6 +393,15 @@ private:
     // 0 effectively disables the pool
     int _maxPoolSize;
 
+    // The maximum number of connections in use per-host, and how long get() waits for one to be
+    // released once the limit has been reached
+    int _maxInUse;
+    Milliseconds _maxInUseWaitTimeout;
+
+    // Signalled whenever a connection is returned or a pending creation is abandoned, so that
+    // callers waiting on the in-use limit can retry
+    stdx::condition_variable _inUseReleased;
+
     PoolMap _pools;
 
     // pointers owned by me, right now they leak on shutdown
@@ -377,10 +493,7 @@ public:
     /** Force closure of the connection.  You should call this if you leave it in
         a bad state.  Destructor will do this too, but it is verbose.
     */
-    void kill() {
-        delete _conn;
-        _conn = 0;
-    }
+    void kill();
 
     /** Call this when you are done with the connection.
 
@@ -63,6 +63,7 @@
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
@@ -935,6 +936,8 @@ Status DBClientConnection::connect(const HostAndPort& serverAddress) {
         return negotiatedProtocol.getStatus();
     }
 
+    _port->setCompressor(negotiateMessageCompressor(swIsMasterReply.getValue().data));
+
     if (_hook) {
         auto validationStatus = _hook(swIsMasterReply.getValue());
         if (!validationStatus.isOK()) {
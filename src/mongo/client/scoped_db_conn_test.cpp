@@ -35,6 +35,7 @@
 #include "mongo/client/connpool.h"
 #include "mongo/client/global_conn_pool.h"
 #include "mongo/db/wire_version.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/rpc/request_interface.h"
@@ -228,6 +229,23 @@ private:
 /**
  * Warning: cannot run in parallel
  */
+/**
+ * Connection hook which fails connections on demand.
+ */
+class FailingConnectionHook : public DBConnectionHook {
+public:
+    void onCreate(DBClientBase* conn) override {
+        uassert(ErrorCodes::InternalError, "failing connection creation", !failOnCreate);
+    }
+
+    void onHandedOut(DBClientBase* conn) override {
+        uassert(ErrorCodes::InternalError, "failing connection hand out", !failOnHandedOut);
+    }
+
+    bool failOnCreate = false;
+    bool failOnHandedOut = false;
+};
+
 class DummyServerFixture : public unittest::Test {
 public:
     void setUp() {
@@ -256,6 +274,7 @@ public:
         delete _dummyServer;
 
         globalConnPool.setMaxPoolSize(_maxPoolSizePerHost);
+        globalConnPool.setMaxInUse(PoolForHost::kPoolSizeUnlimited);
     }
 
 protected:
@@ -435,5 +454,112 @@ TEST_F(DummyServerFixture, DontReturnConnGoneBadToPool) {
     conn1Again.done();
 }
 
+TEST_F(DummyServerFixture, InUseLimitTimesOut) {
+    globalConnPool.setMaxInUse(2);
+    globalConnPool.setMaxInUseWaitTimeout(Milliseconds(100));
+
+    executor::ConnectionPoolStats before;
+    globalConnPool.appendConnectionStats(&before);
+
+    ScopedDbConnection conn1(TARGET_HOST);
+    ScopedDbConnection conn2(TARGET_HOST);
+    DBClientBase* conn1Ptr = conn1.get();
+
+    ASSERT_THROWS_CODE(
+        ScopedDbConnection(TARGET_HOST), UserException, ErrorCodes::ExceededTimeLimit);
+
+    executor::ConnectionPoolStats stats;
+    globalConnPool.appendConnectionStats(&stats);
+    ASSERT_EQUALS(before.totalInUse + 2, stats.totalInUse);
+    ASSERT_EQUALS(before.totalWaited + 1, stats.totalWaited);
+    ASSERT_EQUALS(before.totalWaitTimeouts + 1, stats.totalWaitTimeouts);
+
+    // Returning a connection makes room for the next caller.
+    conn1.done();
+    ScopedDbConnection conn3(TARGET_HOST);
+    ASSERT_EQUALS(conn1Ptr, conn3.get());
+
+    conn2.done();
+    conn3.done();
+}
+
+TEST_F(DummyServerFixture, InUseLimitWaitsForRelease) {
+    globalConnPool.setMaxInUse(1);
+    globalConnPool.setMaxInUseWaitTimeout(Seconds(20));
+
+    executor::ConnectionPoolStats before;
+    globalConnPool.appendConnectionStats(&before);
+
+    ScopedDbConnection conn1(TARGET_HOST);
+    DBClientBase* conn1Ptr = conn1.get();
+
+    stdx::thread releaser([&conn1] {
+        sleepmillis(100);
+        conn1.done();
+    });
+
+    ScopedDbConnection conn2(TARGET_HOST);
+    releaser.join();
+    ASSERT_EQUALS(conn1Ptr, conn2.get());
+
+    executor::ConnectionPoolStats stats;
+    globalConnPool.appendConnectionStats(&stats);
+    ASSERT_EQUALS(before.totalWaited + 1, stats.totalWaited);
+    ASSERT_EQUALS(before.totalWaitTimeouts, stats.totalWaitTimeouts);
+
+    conn2.done();
+}
+
+TEST_F(DummyServerFixture, InUseLimitCoversAllSocketTimeouts) {
+    globalConnPool.setMaxInUse(1);
+    globalConnPool.setMaxInUseWaitTimeout(Milliseconds(100));
+
+    ScopedDbConnection conn1(TARGET_HOST);
+
+    ASSERT_THROWS_CODE(
+        ScopedDbConnection(TARGET_HOST, 10), UserException, ErrorCodes::ExceededTimeLimit);
+
+    conn1.done();
+
+    ScopedDbConnection conn2(TARGET_HOST, 10);
+    conn2.done();
+}
+
+TEST_F(DummyServerFixture, KilledConnDoesNotCountAgainstInUseLimit) {
+    globalConnPool.setMaxInUse(1);
+    globalConnPool.setMaxInUseWaitTimeout(Milliseconds(100));
+
+    ScopedDbConnection conn1(TARGET_HOST);
+    conn1.kill();
+
+    ScopedDbConnection conn2(TARGET_HOST);
+    conn2.done();
+}
+
+TEST_F(DummyServerFixture, FailedConnectionHooksReleaseInUseLimit) {
+    DBConnectionPool pool;
+    pool.setMaxInUse(1);
+    pool.setMaxInUseWaitTimeout(Milliseconds(100));
+    FailingConnectionHook* hook = new FailingConnectionHook();
+    pool.addHook(hook);
+
+    // Each failure must give up its slot, or the next attempt would time out waiting for it.
+    hook->failOnCreate = true;
+    ASSERT_THROWS_CODE(pool.get(TARGET_HOST), UserException, ErrorCodes::InternalError);
+    ASSERT_THROWS_CODE(pool.get(TARGET_HOST), UserException, ErrorCodes::InternalError);
+    hook->failOnCreate = false;
+
+    DBClientBase* conn = pool.get(TARGET_HOST);
+    pool.release(TARGET_HOST, conn);
+
+    // The pooled connection is checked out before it is handed out.
+    hook->failOnHandedOut = true;
+    ASSERT_THROWS_CODE(pool.get(TARGET_HOST), UserException, ErrorCodes::InternalError);
+    hook->failOnHandedOut = false;
+
+    conn = pool.get(TARGET_HOST);
+    pool.release(TARGET_HOST, conn);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -239,6 +239,14 @@ std::unique_ptr<SeekableRecordCursor> Collection::getCursor(OperationContext* tx
     return _recordStore->getCursor(txn, forward);
 }
 
+std::unique_ptr<SeekableRecordCursor> Collection::getCursorForFields(
+    OperationContext* txn, const std::vector<std::string>& fields, bool forward) const {
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
+    invariant(ok());
+
+    return _recordStore->getCursorForFields(txn, fields, forward);
+}
+
 vector<std::unique_ptr<RecordCursor>> Collection::getManyCursors(OperationContext* txn) const {
     dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
 
@@ -237,6 +237,14 @@ public:
     std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* txn,
                                                     bool forward = true) const;
 
+    /**
+     * Returns a cursor whose records only hold the top-level 'fields' of each document, or
+     * nullptr if the record store can't provide them without reading whole documents.
+     */
+    std::unique_ptr<SeekableRecordCursor> getCursorForFields(OperationContext* txn,
+                                                             const std::vector<std::string>& fields,
+                                                             bool forward = true) const;
+
     /**
      * Returns many cursors that partition the Collection into many disjoint sets. Iterating
      * all returned cursors is equivalent to iterating the full collection.
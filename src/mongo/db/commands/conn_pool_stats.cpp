@@ -39,6 +39,7 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_interface_factory.h"
+#include "mongo/s/client/shard_connection.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 
@@ -83,6 +84,9 @@ public:
             replCoord->appendConnectionStats(&stats);
         }
 
+        // Legacy sharded connections, which is how mongos routes most operations to shards.
+        shardConnectionPool.appendConnectionStats(&stats);
+
         // Sharding connections, if we have any.
         auto registry = grid.shardRegistry();
         if (registry) {
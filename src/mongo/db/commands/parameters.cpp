@@ -44,6 +44,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/logger/parse_log_component_settings.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
 
@@ -581,6 +582,42 @@ public:
     }
 } clusterAuthModeSetting;
 
+class NetworkMessageCompressorsSetting : public ServerParameter {
+public:
+    NetworkMessageCompressorsSetting()
+        : ServerParameter(ServerParameterSet::getGlobal(),
+                          "networkMessageCompressors",
+                          true,  // allowedToChangeAtStartup
+                          true   // allowedToChangeAtRuntime
+                          ) {}
+
+    virtual void append(OperationContext* txn, BSONObjBuilder& b, const std::string& name) {
+        std::string names;
+        for (auto id : getEnabledMessageCompressors()) {
+            if (!names.empty()) {
+                names += ",";
+            }
+            names += messageCompressorName(id).toString();
+        }
+        b << name << (names.empty() ? "disabled" : names);
+    }
+
+    virtual Status set(const BSONElement& newValueElement) {
+        if (newValueElement.type() != String) {
+            return Status(ErrorCodes::BadValue,
+                          mongoutils::str::stream()
+                              << "Invalid value for networkMessageCompressors: "
+                              << newValueElement);
+        }
+        return setFromString(newValueElement.String());
+    }
+
+    // Only affects connections established after the change.
+    virtual Status setFromString(const std::string& str) {
+        return setEnabledMessageCompressors(str);
+    }
+} networkMessageCompressorsSetting;
+
 ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> QuietSetting(
     ServerParameterSet::getGlobal(), "quiet", &serverGlobalParams.quiet);
 
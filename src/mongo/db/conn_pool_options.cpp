@@ -30,6 +30,8 @@
 
 #include "mongo/db/conn_pool_options.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/global_conn_pool.h"
@@ -40,6 +42,9 @@ namespace mongo {
 
 int ConnPoolOptions::maxConnsPerHost(200);
 int ConnPoolOptions::maxShardedConnsPerHost(200);
+int ConnPoolOptions::maxInUseConnsPerHost(-1);
+int ConnPoolOptions::maxShardedInUseConnsPerHost(-1);
+int ConnPoolOptions::maxInUseWaitTimeoutMS(20000);
 
 namespace {
 
@@ -53,18 +58,41 @@ ExportedServerParameter<int, ServerParameterType::kStartupOnly>  //
                                     "connPoolMaxShardedConnsPerHost",
                                     &ConnPoolOptions::maxShardedConnsPerHost);
 
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>  //
+    maxInUseConnsPerHostParameter(ServerParameterSet::getGlobal(),
+                                  "connPoolMaxInUseConnsPerHost",
+                                  &ConnPoolOptions::maxInUseConnsPerHost);
+
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>  //
+    maxShardedInUseConnsPerHostParameter(ServerParameterSet::getGlobal(),
+                                         "connPoolMaxShardedInUseConnsPerHost",
+                                         &ConnPoolOptions::maxShardedInUseConnsPerHost);
+
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>  //
+    maxInUseWaitTimeoutMSParameter(ServerParameterSet::getGlobal(),
+                                   "connPoolMaxInUseWaitTimeoutMS",
+                                   &ConnPoolOptions::maxInUseWaitTimeoutMS);
+
 MONGO_INITIALIZER(InitializeConnectionPools)(InitializerContext* context) {
     // Initialize the sharded and unsharded outgoing connection pools
     // NOTES:
     // - All mongods and mongoses have both pools
     // - The connection hooks for sharding are added on startup (mongos) or on first sharded
     //   operation (mongod)
+    // - A negative in-use limit means connections to a host are not limited
+    const Milliseconds inUseWaitTimeout(ConnPoolOptions::maxInUseWaitTimeoutMS);
 
     globalConnPool.setName("connection pool");
     globalConnPool.setMaxPoolSize(ConnPoolOptions::maxConnsPerHost);
+    globalConnPool.setMaxInUse(std::max(ConnPoolOptions::maxInUseConnsPerHost,
+                                        PoolForHost::kPoolSizeUnlimited));
+    globalConnPool.setMaxInUseWaitTimeout(inUseWaitTimeout);
 
     shardConnectionPool.setName("sharded connection pool");
     shardConnectionPool.setMaxPoolSize(ConnPoolOptions::maxShardedConnsPerHost);
+    shardConnectionPool.setMaxInUse(std::max(ConnPoolOptions::maxShardedInUseConnsPerHost,
+                                             PoolForHost::kPoolSizeUnlimited));
+    shardConnectionPool.setMaxInUseWaitTimeout(inUseWaitTimeout);
 
     return Status::OK();
 }
@@ -48,5 +48,18 @@ struct ConnPoolOptions {
      * Maximum connections per host the sharded conn pool should use
      */
     static int maxShardedConnsPerHost;
+
+    /**
+     * Maximum connections per host which may be in use at once from the connection pool, and
+     * from the sharded conn pool. Negative means no limit.
+     */
+    static int maxInUseConnsPerHost;
+    static int maxShardedInUseConnsPerHost;
+
+    /**
+     * How long a request waits for a connection to be returned once a host's in-use limit has
+     * been reached, before failing
+     */
+    static int maxInUseWaitTimeoutMS;
 };
 }
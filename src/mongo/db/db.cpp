@@ -115,6 +115,7 @@
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/ntservice.h"
 #include "mongo/util/options_parser/startup_options.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/scopeguard.h"
@@ -124,6 +125,7 @@
 #include "mongo/util/static_observer.h"
 #include "mongo/util/text.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 #include "mongo/util/version.h"
 
 #if !defined(_WIN32)
@@ -333,6 +335,12 @@ static void repairDatabasesAndCheckVersion(OperationContext* txn) {
         !(checkIfReplMissingFromCommandLine(txn) || replSettings.usingReplSets() ||
           replSettings.isSlave());
 
+    // Opening every collection is most of the startup time and memory of nodes with many
+    // collections, so report them against the number of collections.
+    Timer openTimer;
+    const int residentMBBeforeOpen = ProcessInfo().getResidentSize();
+    size_t numCollections = 0;
+
     for (vector<string>::const_iterator i = dbNames.begin(); i != dbNames.end(); ++i) {
         const string dbName = *i;
         LOG(1) << "    Recovering database: " << dbName << endl;
@@ -340,6 +348,10 @@ static void repairDatabasesAndCheckVersion(OperationContext* txn) {
         Database* db = dbHolder().openDb(txn, dbName);
         invariant(db);
 
+        list<string> collections;
+        db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collections);
+        numCollections += collections.size();
+
         // First thing after opening the database is to check for file compatibility,
         // otherwise we might crash if this is a deprecated format.
         if (!db->getDatabaseCatalogEntry()->currentFilesCompatible(txn)) {
@@ -401,11 +413,16 @@ static void repairDatabasesAndCheckVersion(OperationContext* txn) {
             checkForIdIndexes(txn, db);
         }
 
-        if (shouldClearNonLocalTmpCollections || dbName == "local") {
+        if (!storageGlobalParams.readOnly &&
+            (shouldClearNonLocalTmpCollections || dbName == "local")) {
             db->clearTmpCollections(txn);
         }
     }
 
+    log() << "opened " << dbNames.size() << " databases with " << numCollections
+          << " collections in " << openTimer.millis() << "ms, resident memory went from "
+          << residentMBBeforeOpen << "MB to " << ProcessInfo().getResidentSize() << "MB";
+
     LOG(1) << "done repairDatabases" << endl;
 }
 
@@ -92,7 +92,14 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     try {
         if (needToMakeCursor) {
             const bool forward = _params.direction == CollectionScanParams::FORWARD;
-            _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            if (!_params.fields.empty()) {
+                _cursor =
+                    _params.collection->getCursorForFields(getOpCtx(), _params.fields, forward);
+                _specificStats.projectedFieldsOnly = static_cast<bool>(_cursor);
+            }
+            if (!_cursor) {
+                _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
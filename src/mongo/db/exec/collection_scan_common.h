@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -58,6 +61,11 @@ struct CollectionScanParams {
 
     // If non-zero, how many documents will we look at?
     size_t maxScan;
+
+    // If non-empty, only these top-level fields of each document are used by the caller, so the
+    // scan may return documents holding just these fields if the collection can provide them
+    // more cheaply than whole documents.
+    std::vector<std::string> fields;
 };
 
 }  // namespace mongo
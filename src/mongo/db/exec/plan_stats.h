@@ -193,7 +193,7 @@ struct CachedPlanStats : public SpecificStats {
 };
 
 struct CollectionScanStats : public SpecificStats {
-    CollectionScanStats() : docsTested(0), direction(1) {}
+    CollectionScanStats() : docsTested(0), direction(1), projectedFieldsOnly(false) {}
 
     SpecificStats* clone() const final {
         CollectionScanStats* specific = new CollectionScanStats(*this);
@@ -206,6 +206,9 @@ struct CollectionScanStats : public SpecificStats {
     // >0 if we're traversing the collection forwards. <0 if we're traversing it
     // backwards.
     int direction;
+
+    // True if the scan read only the fields the query needed rather than whole documents.
+    bool projectedFieldsOnly;
 };
 
 struct CountStats : public SpecificStats {
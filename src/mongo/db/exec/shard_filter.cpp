@@ -35,7 +35,10 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/chunk_load_tracker.h"
 #include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/sharding_state.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -51,10 +54,15 @@ using stdx::make_unique;
 const char* ShardFilterStage::kStageType = "SHARDING_FILTER";
 
 ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
+                                   const std::string& ns,
                                    const shared_ptr<CollectionMetadata>& metadata,
                                    WorkingSet* ws,
                                    PlanStage* child)
-    : PlanStage(kStageType, opCtx), _ws(ws), _metadata(metadata) {
+    : PlanStage(kStageType, opCtx),
+      _ws(ws),
+      _ns(ns),
+      _sampleReads(ChunkLoadTracker::shouldSample(opCtx->getOpID())),
+      _metadata(metadata) {
     _children.emplace_back(child);
 }
 
@@ -112,6 +120,11 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
             }
+
+            if (_sampleReads) {
+                ShardingState::get(getOpCtx())->chunkLoadTracker()->noteRead(
+                    _ns, *_metadata, shardKey);
+            }
         }
 
         // If we're here either we have shard state and our doc passed, or we have no shard
@@ -72,6 +72,7 @@ class CollectionMetadata;
 class ShardFilterStage final : public PlanStage {
 public:
     ShardFilterStage(OperationContext* opCtx,
+                     const std::string& ns,
                      const std::shared_ptr<CollectionMetadata>& metadata,
                      WorkingSet* ws,
                      PlanStage* child);
@@ -93,6 +94,12 @@ public:
 private:
     WorkingSet* _ws;
 
+    // The sharded collection, used to attribute sampled reads to chunks for the balancer
+    const std::string _ns;
+
+    // Whether the operation which built this stage was picked to have its reads recorded
+    const bool _sampleReads;
+
     // Stats
     ShardingFilterStats _specificStats;
 
@@ -101,6 +101,7 @@ OpObserver::DeleteState OpObserver::aboutToDelete(OperationContext* txn,
         deleteState.idDoc = idElement.wrap();
     }
     deleteState.isMigrating = isInMigratingChunk(txn, ns, doc);
+    deleteState.sampledShardKey = getSampledShardKeyForDelete(txn, ns, doc);
     return deleteState;
 }
 
@@ -114,8 +115,11 @@ void OpObserver::onDelete(OperationContext* txn,
     repl::logOp(txn, "d", ns.ns().c_str(), deleteState.idDoc, nullptr, fromMigrate);
     AuthorizationManager::get(txn->getServiceContext())
         ->logOp(txn, "d", ns.ns().c_str(), deleteState.idDoc, nullptr);
-    logDeleteOpForSharding(
-        txn, ns.ns().c_str(), deleteState.idDoc, fromMigrate || !deleteState.isMigrating);
+    logDeleteOpForSharding(txn,
+                           ns.ns().c_str(),
+                           deleteState.idDoc,
+                           deleteState.sampledShardKey,
+                           fromMigrate || !deleteState.isMigrating);
     logOpForDbHash(txn, ns.ns().c_str());
     if (ns.coll() == "system.js") {
         Scope::storedFuncMod(txn);
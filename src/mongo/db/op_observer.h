@@ -75,6 +75,10 @@ public:
         // True if doc being deleted is located in a currently migrating
         // chunk, where this is the chunk source.
         bool isMigrating = false;
+
+        // Shard key of the document being deleted, if the delete is sampled for the chunk split
+        // sketches.
+        BSONObj sampledShardKey;
     };
 
     void onCreateIndex(OperationContext* txn,
@@ -34,6 +34,7 @@
 #include <boost/intrusive_ptr.hpp>
 #include <deque>
 #include <list>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -442,6 +443,20 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Tell this source that each shard holds every document of the groups it produces, so that
+     * it outputs final rather than mergeable results when run on a shard. Defaults to false.
+     */
+    void setCompleteOnShard(bool completeOnShard) {
+        _completeOnShard = completeOnShard;
+    }
+
+    /**
+     * Returns true if each of 'fieldPaths' is grouped on directly, so that all the documents of
+     * a group have the same value for each of these fields.
+     */
+    bool groupsByFields(const std::set<std::string>& fieldPaths) const;
+
     /**
       Create a grouping DocumentSource from BSON.
 
@@ -518,7 +533,13 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+    /// Whether to output partial results for a merging $group rather than final results.
+    bool mergeableOutput() const {
+        return pExpCtx->inShard && !_completeOnShard;
+    }
+
     bool _doingMerge;
+    bool _completeOnShard;
     bool _spilled;
     const bool _extSortAllowed;
     const int _maxMemoryUsageBytes;
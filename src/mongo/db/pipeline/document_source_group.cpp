@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -98,14 +99,14 @@ boost::optional<Document> DocumentSourceGroup::getNext() {
             _firstPartOfNextGroup = _sorterIterator->next();
         }
 
-        return makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
+        return makeDocument(_currentId, _currentAccumulators, mergeableOutput());
 
     } else {
         if (groups.empty())
             return boost::none;
 
         Document out =
-            makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->inShard);
+            makeDocument(groupsIterator->first, groupsIterator->second, mergeableOutput());
 
         if (++groupsIterator == groups.end())
             dispose();
@@ -173,6 +174,10 @@ Value DocumentSourceGroup::serialize(bool explain) const {
         insides["$doingMerge"] = Value(true);
     }
 
+    if (_completeOnShard) {
+        insides["$completeOnShard"] = Value(true);
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
@@ -201,6 +206,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
     : DocumentSource(pExpCtx),
       populated(false),
       _doingMerge(false),
+      _completeOnShard(false),
       _spilled(false),
       _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
       _maxMemoryUsageBytes(100 * 1024 * 1024) {}
@@ -236,6 +242,10 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
             massert(17030, "$doingMerge should be true if present", groupField.Bool());
 
             pGroup->setDoingMerge(true);
+        } else if (str::equals(pFieldName, "$completeOnShard")) {
+            massert(34423, "$completeOnShard should be true if present", groupField.Bool());
+
+            pGroup->setCompleteOnShard(true);
         } else {
             /*
               Treat as a projection field with the additional ability to
@@ -545,6 +555,21 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
     return out.freeze();
 }
 
+bool DocumentSourceGroup::groupsByFields(const std::set<std::string>& fieldPaths) const {
+    std::set<std::string> idFieldPaths;
+    for (auto&& idExpression : _idExpressions) {
+        // Only a plain field path groups documents by that field's value.
+        if (auto fieldPathExpression = dynamic_cast<ExpressionFieldPath*>(idExpression.get())) {
+            DepsTracker deps;
+            fieldPathExpression->addDependencies(&deps);
+            idFieldPaths.insert(deps.fields.begin(), deps.fields.end());
+        }
+    }
+
+    return std::includes(
+        idFieldPaths.begin(), idFieldPaths.end(), fieldPaths.begin(), fieldPaths.end());
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
     return this;  // No modifications necessary when on shard
 }
@@ -250,7 +250,7 @@ Status Pipeline::checkAuthForCommand(ClientBasic* client,
     return Status(ErrorCodes::Unauthorized, "unauthorized");
 }
 
-intrusive_ptr<Pipeline> Pipeline::splitForSharded() {
+intrusive_ptr<Pipeline> Pipeline::splitForSharded(const BSONObj& shardKeyPattern) {
     // Create and initialize the shard spec we'll return. We start with an empty pipeline on the
     // shards and all work being done in the merger. Optimizations can move operations between
     // the pipelines to be more efficient.
@@ -260,6 +260,10 @@ intrusive_ptr<Pipeline> Pipeline::splitForSharded() {
     // The order in which optimizations are applied can have significant impact on the
     // efficiency of the final pipeline. Be Careful!
     Optimizations::Sharded::findSplitPoint(shardPipeline.get(), this);
+    if (!shardKeyPattern.isEmpty()) {
+        Optimizations::Sharded::completeShardKeyGroupOnShards(
+            shardPipeline.get(), this, shardKeyPattern);
+    }
     Optimizations::Sharded::moveFinalUnwindFromShardsToMerger(shardPipeline.get(), this);
     Optimizations::Sharded::limitFieldsSentFromShardsToMerger(shardPipeline.get(), this);
 
@@ -292,6 +296,35 @@ void Pipeline::Optimizations::Sharded::findSplitPoint(Pipeline* shardPipe, Pipel
     }
 }
 
+void Pipeline::Optimizations::Sharded::completeShardKeyGroupOnShards(
+    Pipeline* shardPipe, Pipeline* mergePipe, const BSONObj& shardKeyPattern) {
+    if (shardPipe->sources.empty() || mergePipe->sources.empty())
+        return;
+
+    auto group = dynamic_cast<DocumentSourceGroup*>(shardPipe->sources.back().get());
+    if (!group)
+        return;
+
+    // Stages other than $match could change the shard key fields before the $group sees them.
+    for (auto it = shardPipe->sources.begin(); *it != shardPipe->sources.back(); ++it) {
+        if (!dynamic_cast<DocumentSourceMatch*>(it->get()))
+            return;
+    }
+
+    std::set<string> shardKeyFields;
+    for (auto&& elem : shardKeyPattern) {
+        shardKeyFields.insert(elem.fieldName());
+    }
+    if (!group->groupsByFields(shardKeyFields))
+        return;
+
+    // Drop the merging $group and split the remaining stages instead.
+    invariant(dynamic_cast<DocumentSourceGroup*>(mergePipe->sources.front().get()));
+    mergePipe->sources.pop_front();
+    group->setCompleteOnShard(true);
+    findSplitPoint(shardPipe, mergePipe);
+}
+
 void Pipeline::Optimizations::Sharded::moveFinalUnwindFromShardsToMerger(Pipeline* shardPipe,
                                                                          Pipeline* mergePipe) {
     while (!shardPipe->sources.empty() &&
@@ -81,10 +81,14 @@ public:
 
       This permanently alters this pipeline for the merging operation.
 
+      If 'shardKeyPattern' is given, a $group on every shard key field
+      is completed on the shards, since each shard holds all of the
+      documents for the groups it produces.
+
       @returns the Spec for the pipeline command that should be sent
         to the shards
     */
-    boost::intrusive_ptr<Pipeline> splitForSharded();
+    boost::intrusive_ptr<Pipeline> splitForSharded(const BSONObj& shardKeyPattern = BSONObj());
 
     /** If the pipeline starts with a $match, return its BSON predicate.
      *  Returns empty BSON if the first stage isn't $match.
@@ -174,8 +174,12 @@ shared_ptr<PlanExecutor> createRandomCursorExecutor(Collection* collection,
 
     // If we're in a sharded environment, we need to filter out documents we don't own.
     if (shardingState->needCollectionMetadata(txn, txn->getNS())) {
-        auto shardFilterStage = stdx::make_unique<ShardFilterStage>(
-            txn, shardingState->getCollectionMetadata(txn->getNS()), ws.get(), stage.release());
+        auto shardFilterStage =
+            stdx::make_unique<ShardFilterStage>(txn,
+                                                txn->getNS(),
+                                                shardingState->getCollectionMetadata(txn->getNS()),
+                                                ws.get(),
+                                                stage.release());
         return uassertStatusOK(PlanExecutor::make(
             txn, std::move(ws), std::move(shardFilterStage), collection, PlanExecutor::YIELD_AUTO));
     }
@@ -53,6 +53,18 @@ public:
      */
     static void findSplitPoint(Pipeline* shardPipe, Pipeline* mergePipe);
 
+    /**
+     * If the split point is a $group on every field of 'shardKeyPattern', preceded only by
+     * $match stages, runs the whole $group on the shards and looks for the next split point
+     * after it. Each group's documents are on a single shard, so only final groups need to be
+     * sent to the merger rather than partial groups from every shard.
+     *
+     * Must be called right after findSplitPoint.
+     */
+    static void completeShardKeyGroupOnShards(Pipeline* shardPipe,
+                                              Pipeline* mergePipe,
+                                              const BSONObj& shardKeyPattern);
+
     /**
      * If the final stage on shards is to unwind an array, move that stage to the merger. This
      * cuts down on network traffic and allows us to take advantage of reduced copying in
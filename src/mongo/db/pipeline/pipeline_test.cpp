@@ -278,6 +278,11 @@ public:
     virtual string shardPipeJson() = 0;
     virtual string mergePipeJson() = 0;
 
+    // The shard key of the collection being aggregated, if the split should consider it
+    virtual BSONObj shardKeyPattern() {
+        return BSONObj();
+    }
+
     BSONObj pipelineFromJsonArray(const string& array) {
         return fromjson("{pipeline: " + array + "}");
     }
@@ -293,7 +298,7 @@ public:
         ASSERT_EQUALS(errmsg, "");
         ASSERT(mergePipe != NULL);
 
-        shardPipe = mergePipe->splitForSharded();
+        shardPipe = mergePipe->splitForSharded(shardKeyPattern());
         ASSERT(shardPipe != NULL);
 
         ASSERT_EQUALS(Value(shardPipe->writeExplainOps()), Value(shardPipeExpected["pipeline"]));
@@ -624,6 +629,122 @@ class LookUp : public needsPrimaryShardMergerBase {
 };
 
 }  // namespace needsPrimaryShardMerger
+
+namespace completeShardKeyGroupOnShards {
+
+class GroupOnShardKey : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$match: {x: 1}}, {$group: {_id: '$a', total: {$sum: '$b'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$match: {x: 1}}"
+               ",{$group: {_id: '$a', total: {$sum: '$b'}, $completeOnShard: true}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[]";
+    }
+};
+
+class GroupOnHashedShardKey : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << "hashed");
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$b'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$b'}, $completeOnShard: true}}]";
+    }
+    string mergePipeJson() {
+        return "[]";
+    }
+};
+
+class GroupOnCompoundShardKeyThenSort : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1 << "b" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: {x: '$b', y: '$a', z: '$c'}, total: {$sum: '$d'}}}"
+               ",{$sort: {total: -1}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {x: '$b', y: '$a', z: '$c'}, total: {$sum: '$d'}"
+               ",$completeOnShard: true}}"
+               ",{$sort: {sortKey: {total: -1}}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$sort: {sortKey: {total: -1}, mergePresorted: true}}]";
+    }
+};
+
+class GroupOnShardKeyThenOut : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a'}}, {$out: 'outColl'}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', $completeOnShard: true}}]";
+    }
+    string mergePipeJson() {
+        return "[{$out: 'outColl'}]";
+    }
+};
+
+class GroupOnPartOfShardKey : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1 << "b" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$c'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$c'}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', total: {$sum: '$$ROOT.total'}, $doingMerge: true}}]";
+    }
+};
+
+class GroupOnShardKeyExpression : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: {$toLower: '$a'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {$toLower: ['$a']}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}]";
+    }
+};
+
+class GroupOnShardKeyAfterProject : public Base {
+    BSONObj shardKeyPattern() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$project: {a: '$b'}}, {$group: {_id: '$a'}}]";
+    }
+    string shardPipeJson() {
+        return "[{$project: {a: '$b'}}, {$group: {_id: '$a'}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}]";
+    }
+};
+
+}  // namespace completeShardKeyGroupOnShards
 }  // namespace Sharded
 }  // namespace Optimizations
 
@@ -670,6 +791,14 @@ public:
         add<Optimizations::Sharded::needsPrimaryShardMerger::Out>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::Project>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::LookUp>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnShardKey>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnHashedShardKey>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::
+                GroupOnCompoundShardKeyThenSort>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnShardKeyThenOut>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnPartOfShardKey>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnShardKeyExpression>();
+        add<Optimizations::Sharded::completeShardKeyGroupOnShards::GroupOnShardKeyAfterProject>();
     }
 };
 
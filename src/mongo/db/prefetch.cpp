@@ -42,6 +42,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/util/log.h"
@@ -140,6 +141,37 @@ void prefetchRecordPages(OperationContext* txn, Database* db, const char* ns, co
         }
     }
 }
+
+// For engines other than MMAP V1, which cannot fault pages in directly: reads the current version
+// of the document through the _id index and then seeks the indexes to that version's keys, so the
+// pages the writer threads will need to update or delete it are already in cache.
+void prefetchDocAndIndexPages(OperationContext* txn,
+                              Database* db,
+                              Collection* collection,
+                              const BackgroundSync::IndexPrefetchConfig& prefetchConfig,
+                              const char* ns,
+                              const BSONObj& obj) {
+    BSONElement _id;
+    if (!obj.getObjectID(_id)) {
+        return;
+    }
+
+    BSONObj current;
+    {
+        TimerHolder timer(&prefetchDocStats);
+        BSONObjBuilder builder;
+        builder.append(_id);
+        try {
+            if (!Helpers::findById(txn, db, ns, builder.done(), current)) {
+                return;
+            }
+        } catch (const DBException& e) {
+            LOG(2) << "ignoring exception in prefetchDocAndIndexPages(): " << e.what();
+            return;
+        }
+    }
+    prefetchIndexPages(txn, collection, prefetchConfig, current);
+}
 }  // namespace
 
 // prefetch for an oplog operation
@@ -165,10 +197,10 @@ void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSO
     BSONObj obj = op.getObjectField(opField);
     const char* ns = op.getStringField("ns");
 
-    // This will have to change for engines other than MMAP V1, because they might not have
-    // means for directly prefetching pages from the collection. For this purpose, acquire S
-    // lock on the database, instead of optimizing with IS.
-    Lock::CollectionLock collLock(txn->lockState(), ns, MODE_S);
+    // MMAP V1 prefetches pages from the collection directly, so acquire S lock on the
+    // collection, instead of optimizing with IS. Other engines only read through cursors.
+    const bool isMmapV1 = getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1();
+    Lock::CollectionLock collLock(txn->lockState(), ns, isMmapV1 ? MODE_S : MODE_IS);
 
     Collection* collection = db->getCollection(ns);
     if (!collection) {
@@ -177,6 +209,14 @@ void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSO
 
     LOG(4) << "index prefetch for op " << *opType << endl;
 
+    if (!isMmapV1 && *opType != 'i') {
+        // Capped collections typically do not have an _id index for findById() to use.
+        if (!collection->isCapped()) {
+            prefetchDocAndIndexPages(txn, db, collection, prefetchConfig, ns, obj);
+        }
+        return;
+    }
+
     // should we prefetch index pages on updates? if the update is in-place and doesn't change
     // indexed values, it is actually slower - a lot slower if there are a dozen indexes or
     // lots of multikeys.  possible variations (not all mutually exclusive):
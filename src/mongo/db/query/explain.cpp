@@ -266,6 +266,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->append("direction", spec->direction > 0 ? "forward" : "backward");
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->projectedFieldsOnly) {
+                bob->appendBool("projectedFieldsOnly", true);
+            }
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
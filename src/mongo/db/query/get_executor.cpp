@@ -259,6 +259,7 @@ Status prepareExecution(OperationContext* opCtx,
         if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
             *rootOut = new ShardFilterStage(
                 opCtx,
+                collection->ns().ns(),
                 ShardingState::get(opCtx)->getCollectionMetadata(collection->ns().ns()),
                 ws,
                 *rootOut);
@@ -67,6 +67,57 @@ void getLeafNodes(QuerySolutionNode* root, vector<QuerySolutionNode*>* leafNodes
     }
 }
 
+/**
+ * Adds the top-level fields which 'node' reads to 'out'. Returns false if the expression may
+ * read other parts of the document, as a $where does.
+ */
+bool getTopLevelFields(const MatchExpression* node, std::set<string>* out) {
+    if (node->isLogical()) {
+        for (size_t i = 0; i < node->numChildren(); ++i) {
+            if (!getTopLevelFields(node->getChild(i), out)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const StringData path = node->path();
+    if (path.empty()) {
+        return false;
+    }
+    out->insert(path.substr(0, path.find('.')).toString());
+    return true;
+}
+
+/**
+ * Adds to 'out' the top-level fields which the stages answering 'query' read from the documents
+ * they are given, when 'query' has a projection which doesn't require the whole document.
+ * Returns false if some stage may read other parts of the document.
+ */
+bool getRequiredTopLevelFields(const CanonicalQuery& query,
+                               const QueryPlannerParams& params,
+                               std::set<string>* out) {
+    for (const string& field : query.getProj()->getRequiredFields()) {
+        out->insert(field.substr(0, field.find('.')));
+    }
+
+    BSONForEach(elem, query.getParsed().getSort()) {
+        const StringData field = elem.fieldNameStringData();
+        if (field != "$natural") {
+            out->insert(field.substr(0, field.find('.')).toString());
+        }
+    }
+
+    if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        BSONForEach(elem, params.shardKey) {
+            const StringData field = elem.fieldNameStringData();
+            out->insert(field.substr(0, field.find('.')).toString());
+        }
+    }
+
+    return getTopLevelFields(query.root(), out);
+}
+
 /**
  * Returns true if every interval in 'oil' is a point, false otherwise.
  */
@@ -780,6 +831,20 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(const CanonicalQuery& que
                 LOG(5) << "PROJECTION: needs $meta sortKey, using DEFAULT path instead";
             }
         }
+        // A collection scan whose documents are only used by this projection may be able to read
+        // just the fields the query needs, if the collection keeps those in a column group.
+        if (!query.getProj()->requiresDocument() && !query.getProj()->wantIndexKey()) {
+            vector<QuerySolutionNode*> leafNodes;
+            getLeafNodes(solnRoot, &leafNodes);
+
+            std::set<string> fields;
+            if (1 == leafNodes.size() && STAGE_COLLSCAN == leafNodes[0]->getType() &&
+                getRequiredTopLevelFields(query, params, &fields)) {
+                CollectionScanNode* csn = static_cast<CollectionScanNode*>(leafNodes[0]);
+                csn->fields.assign(fields.begin(), fields.end());
+            }
+        }
+
         // If we don't have a covered project, and we're not allowed to put an uncovered one in,
         // bail out.
         if (solnRoot->fetched() &&
@@ -66,4 +66,10 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStreamUnsortedShardResults, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryClusterCursorMaxBufferedBytes, int, 64 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompleteShardKeyGroupsOnShards, bool, false);
+
 }  // namespace mongo
@@ -105,6 +105,26 @@ extern std::atomic<int> internalQueryExecYieldIterations;  // NOLINT
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern std::atomic<int> internalQueryExecYieldPeriodMS;  // NOLINT
 
+//
+// Cluster query execution.
+//
+
+// Should mongos return results of an unsorted query from the shards which have responded before
+// every targeted shard has responded? Off by default: errors such as stale shard versions from
+// the shards which have not responded yet would then reach the client after some results, when
+// the query can no longer be retried.
+extern std::atomic<bool> internalQueryStreamUnsortedShardResults;  // NOLINT
+
+// Limit on the bytes of results which a mongos cursor buffers, including the projected size of
+// the batches it has requested, before it stops asking further shards for more results. Only
+// applies to unsorted queries.
+extern std::atomic<int> internalQueryClusterCursorMaxBufferedBytes;  // NOLINT
+
+// Should a sharded aggregation run a $group on the shard key to completion on the shards, rather
+// than merging partial groups from every shard? Off by default, because shards older than this
+// mongos reject a $group with $completeOnShard; only enable it once every shard is upgraded.
+extern std::atomic<bool> internalQueryCompleteShardKeyGroupsOnShards;  // NOLINT
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -116,6 +116,14 @@ void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent)
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
     }
+    if (!fields.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "fields = ";
+        for (const auto& field : fields) {
+            *ss << field << ' ';
+        }
+        *ss << '\n';
+    }
     addCommon(ss, indent);
 }
 
@@ -128,6 +136,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->tailable = this->tailable;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
+    copy->fields = this->fields;
 
     return copy;
 }
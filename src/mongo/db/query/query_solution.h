@@ -290,6 +290,9 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // maxScan option to .find() limits how many docs we look at.
     int maxScan;
+
+    // If non-empty, the top-level fields of each document which the rest of the plan uses.
+    std::vector<std::string> fields;
 };
 
 struct AndHashNode : public QuerySolutionNode {
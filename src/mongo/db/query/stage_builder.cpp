@@ -78,6 +78,7 @@ PlanStage* buildStages(OperationContext* txn,
         params.direction =
             (csn->direction == 1) ? CollectionScanParams::FORWARD : CollectionScanParams::BACKWARD;
         params.maxScan = csn->maxScan;
+        params.fields = csn->fields;
         return new CollectionScan(txn, params, ws, csn->filter.get());
     } else if (STAGE_IXSCAN == root->getType()) {
         const IndexScanNode* ixn = static_cast<const IndexScanNode*>(root);
@@ -282,6 +283,7 @@ PlanStage* buildStages(OperationContext* txn,
         }
         return new ShardFilterStage(
             txn,
+            collection->ns().ns(),
             ShardingState::get(txn)->getCollectionMetadata(collection->ns().ns()),
             ws,
             childStage);
@@ -52,6 +52,7 @@
 #include "mongo/db/repl/rollback_source_impl.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -63,6 +64,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -72,6 +74,15 @@ namespace repl {
 
 namespace {
 const char hashFieldName[] = "h";
+
+// Tail the sync source's oplog with an exhaust cursor so that it streams batches to us as they
+// become visible, rather than waiting for one getMore round trip per batch. Only takes effect
+// under protocol version 0; re-read whenever a new sync source is chosen.
+MONGO_EXPORT_SERVER_PARAMETER(bgSyncOplogFetcherExhaust, bool, false);
+
+// The awaitData timeout of the oplog query under protocol version 0.
+const Seconds kPV0OplogFetcherMaxTime(2);
+
 int SleepToAllowBatchingMillis = 2;
 const int BatchIsSmallish = 40000;  // bytes
 
@@ -312,65 +323,25 @@ void BackgroundSync::_produce(OperationContext* txn) {
     const Milliseconds oplogSocketTimeout(OplogReader::kSocketTimeout);
 
     const auto isV1ElectionProtocol = _replCoord->isV1ElectionProtocol();
-    // Under protocol version 1, make the awaitData timeout (maxTimeMS) dependent on the election
-    // timeout. This enables the sync source to communicate liveness of the primary to secondaries.
-    // Under protocol version 0, use a default timeout of 2 seconds for awaitData.
-    const Milliseconds fetcherMaxTimeMS(
-        isV1ElectionProtocol ? _replCoord->getConfig().getElectionTimeoutPeriod() / 2 : Seconds(2));
 
     // Prefer host in oplog reader to _syncSourceHost because _syncSourceHost may be cleared
     // if sync source feedback fails.
     const HostAndPort source = syncSourceReader.getHost();
-    syncSourceReader.resetConnection();
-    // no more references to oplog reader from here on.
 
     Status fetcherReturnStatus = Status::OK();
-    auto fetcherCallback = stdx::bind(&BackgroundSync::_fetcherCallback,
-                                      this,
-                                      stdx::placeholders::_1,
-                                      stdx::placeholders::_3,
-                                      stdx::cref(source),
-                                      lastOpTimeFetched,
-                                      lastHashFetched,
-                                      fetcherMaxTimeMS,
-                                      &fetcherReturnStatus);
-
-
-    BSONObjBuilder cmdBob;
-    cmdBob.append("find", nsToCollectionSubstring(rsOplogName));
-    cmdBob.append("filter", BSON("ts" << BSON("$gte" << lastOpTimeFetched.getTimestamp())));
-    cmdBob.append("tailable", true);
-    cmdBob.append("oplogReplay", true);
-    cmdBob.append("awaitData", true);
-    cmdBob.append("maxTimeMS", durationCount<Milliseconds>(Minutes(1)));  // 1 min initial find.
-
-    BSONObjBuilder metadataBob;
-    if (isV1ElectionProtocol) {
-        cmdBob.append("term", _replCoord->getTerm());
-        metadataBob.append(rpc::kReplSetMetadataFieldName, 1);
-    }
-
-    auto dbName = nsToDatabase(rsOplogName);
-    auto cmdObj = cmdBob.obj();
-    auto metadataObj = metadataBob.obj();
-    Fetcher fetcher(&_threadPoolTaskExecutor,
-                    source,
-                    dbName,
-                    cmdObj,
-                    fetcherCallback,
-                    metadataObj,
-                    _replCoord->getConfig().getElectionTimeoutPeriod());
-
-    LOG(1) << "scheduling fetcher to read remote oplog on " << source << " starting at "
-           << cmdObj["filter"];
-    auto scheduleStatus = fetcher.schedule();
-    if (!scheduleStatus.isOK()) {
-        warning() << "unable to schedule fetcher to read remote oplog on " << source << ": "
-                  << scheduleStatus;
-        return;
+    // Streaming relies on legacy OP_QUERY/OP_REPLY, which cannot carry the replica set metadata
+    // requested under protocol version 1, so it is only used under protocol version 0.
+    if (bgSyncOplogFetcherExhaust && !isV1ElectionProtocol) {
+        log() << "streaming remote oplog on " << source << " starting at "
+              << lastOpTimeFetched.getTimestamp();
+        fetcherReturnStatus =
+            _streamOplog(&syncSourceReader, source, lastOpTimeFetched, lastHashFetched);
+        LOG(1) << "stopped streaming remote oplog on " << source;
+    } else {
+        syncSourceReader.resetConnection();
+        // no more references to oplog reader from here on.
+        _runFetcher(source, lastOpTimeFetched, lastHashFetched, &fetcherReturnStatus);
     }
-    fetcher.wait();
-    LOG(1) << "fetcher stopped reading remote oplog on " << source;
 
     // If the background sync is stopped after the fetcher is started, we need to
     // re-evaluate our sync source and oplog common point.
@@ -440,6 +411,119 @@ void BackgroundSync::_produce(OperationContext* txn) {
     }
 }
 
+void BackgroundSync::_runFetcher(const HostAndPort& source,
+                                 OpTime lastOpTimeFetched,
+                                 long long lastFetchedHash,
+                                 Status* fetcherReturnStatus) {
+    const auto isV1ElectionProtocol = _replCoord->isV1ElectionProtocol();
+    // Under protocol version 1, make the awaitData timeout (maxTimeMS) dependent on the election
+    // timeout. This enables the sync source to communicate liveness of the primary to secondaries.
+    // Under protocol version 0, use a default timeout of 2 seconds for awaitData.
+    const Milliseconds fetcherMaxTimeMS(isV1ElectionProtocol
+                                            ? _replCoord->getConfig().getElectionTimeoutPeriod() / 2
+                                            : kPV0OplogFetcherMaxTime);
+
+    auto fetcherCallback = stdx::bind(&BackgroundSync::_fetcherCallback,
+                                      this,
+                                      stdx::placeholders::_1,
+                                      stdx::placeholders::_3,
+                                      stdx::cref(source),
+                                      lastOpTimeFetched,
+                                      lastFetchedHash,
+                                      fetcherMaxTimeMS,
+                                      fetcherReturnStatus);
+
+    BSONObjBuilder cmdBob;
+    cmdBob.append("find", nsToCollectionSubstring(rsOplogName));
+    cmdBob.append("filter", BSON("ts" << BSON("$gte" << lastOpTimeFetched.getTimestamp())));
+    cmdBob.append("tailable", true);
+    cmdBob.append("oplogReplay", true);
+    cmdBob.append("awaitData", true);
+    cmdBob.append("maxTimeMS", durationCount<Milliseconds>(Minutes(1)));  // 1 min initial find.
+
+    BSONObjBuilder metadataBob;
+    if (isV1ElectionProtocol) {
+        cmdBob.append("term", _replCoord->getTerm());
+        metadataBob.append(rpc::kReplSetMetadataFieldName, 1);
+    }
+
+    auto dbName = nsToDatabase(rsOplogName);
+    auto cmdObj = cmdBob.obj();
+    auto metadataObj = metadataBob.obj();
+    Fetcher fetcher(&_threadPoolTaskExecutor,
+                    source,
+                    dbName,
+                    cmdObj,
+                    fetcherCallback,
+                    metadataObj,
+                    _replCoord->getConfig().getElectionTimeoutPeriod());
+
+    LOG(1) << "scheduling fetcher to read remote oplog on " << source << " starting at "
+           << cmdObj["filter"];
+    auto scheduleStatus = fetcher.schedule();
+    if (!scheduleStatus.isOK()) {
+        warning() << "unable to schedule fetcher to read remote oplog on " << source << ": "
+                  << scheduleStatus;
+        return;
+    }
+    fetcher.wait();
+    LOG(1) << "fetcher stopped reading remote oplog on " << source;
+}
+
+Status BackgroundSync::_streamOplog(OplogReader* reader,
+                                    const HostAndPort& source,
+                                    OpTime lastOpTimeFetched,
+                                    long long lastFetchedHash) {
+    // The connection cannot be reused once the remote node has started pushing batches.
+    ON_BLOCK_EXIT([reader]() { reader->abandonExhaustCursor(); });
+
+    Status returnStatus = Status::OK();
+    try {
+        Timer batchTimer;
+        reader->exhaustTailingQueryGTE(rsOplogName.c_str(), lastOpTimeFetched.getTimestamp());
+        bool first = true;
+        while (true) {
+            Fetcher::QueryResponse batch;
+            batch.cursorId = reader->getCursorId();
+            batch.nss = NamespaceString(rsOplogName);
+            batch.first = first;
+            batch.elapsedMillis = Milliseconds(batchTimer.millis());
+            while (reader->moreInCurrentBatch()) {
+                batch.documents.push_back(reader->nextSafe().getOwned());
+            }
+            first = false;
+
+            // Batches are handled exactly like Fetcher responses, which lets _fetcherCallback()
+            // apply its rollback, ordering and flow control checks unchanged. Blocking in
+            // _buffer.waitForSpace() stops us from reading the socket, so a full buffer pushes
+            // back on the sync source through TCP flow control.
+            BSONObjBuilder bob;
+            _fetcherCallback(StatusWith<Fetcher::QueryResponse>(batch),
+                             batch.cursorId ? &bob : nullptr,
+                             source,
+                             lastOpTimeFetched,
+                             lastFetchedHash,
+                             kPV0OplogFetcherMaxTime,
+                             &returnStatus);
+            if (!batch.cursorId || bob.asTempObj().isEmpty()) {
+                break;
+            }
+
+            batchTimer.reset();
+            reader->receiveMoreExhaust();
+        }
+    } catch (const DBException& ex) {
+        _fetcherCallback(StatusWith<Fetcher::QueryResponse>(ex.toStatus()),
+                         nullptr,
+                         source,
+                         lastOpTimeFetched,
+                         lastFetchedHash,
+                         kPV0OplogFetcherMaxTime,
+                         &returnStatus);
+    }
+    return returnStatus;
+}
+
 void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>& result,
                                       BSONObjBuilder* bob,
                                       const HostAndPort& source,
@@ -47,6 +47,7 @@ class OperationContext;
 namespace repl {
 
 class Member;
+class OplogReader;
 class ReplicationCoordinator;
 
 // This interface exists to facilitate easier testing;
@@ -178,6 +179,25 @@ private:
      */
     void _signalNoNewDataForApplier();
 
+    /**
+     * Reads the remote oplog from 'source' with find/getMore commands scheduled by a Fetcher,
+     * until _fetcherCallback() stops asking for more data.
+     */
+    void _runFetcher(const HostAndPort& source,
+                     OpTime lastOpTimeFetched,
+                     long long lastFetchedHash,
+                     Status* fetcherReturnStatus);
+
+    /**
+     * Reads the remote oplog over an exhaust cursor on 'reader', which must be connected to
+     * 'source'. Every batch is handed to _fetcherCallback() as if returned by the Fetcher.
+     * Returns the status reported by _fetcherCallback(). 'reader' is disconnected on return.
+     */
+    Status _streamOplog(OplogReader* reader,
+                        const HostAndPort& source,
+                        OpTime lastOpTimeFetched,
+                        long long lastFetchedHash);
+
     /**
      * Processes query responses from fetcher.
      */
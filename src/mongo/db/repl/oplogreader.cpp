@@ -133,6 +133,25 @@ void OplogReader::tailingQueryGTE(const char* ns, Timestamp optime) {
     tailingQuery(ns, query.done());
 }
 
+void OplogReader::exhaustTailingQueryGTE(const char* ns, Timestamp optime) {
+    verify(!haveCursor());
+    BSONObj query = BSON("ts" << BSON("$gte" << optime));
+    LOG(2) << ns << ".find(" << query.toString() << ") exhaust" << endl;
+    cursor.reset(
+        _conn->query(ns, query, 0, 0, nullptr, _tailingQueryOptions | QueryOption_Exhaust)
+            .release());
+}
+
+void OplogReader::abandonExhaustCursor() {
+    if (cursor.get()) {
+        cursor->decouple();
+    }
+    if (_conn) {
+        _conn->port().shutdown();
+    }
+    resetConnection();
+}
+
 HostAndPort OplogReader::getHost() const {
     return _host;
 }
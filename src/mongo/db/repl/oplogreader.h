@@ -109,6 +109,34 @@ public:
 
     void tailingQueryGTE(const char* ns, Timestamp t);
 
+    /**
+     * Same as tailingQueryGTE() but opens the cursor with QueryOption_Exhaust, so the remote
+     * node keeps sending batches as they become available instead of waiting for a getMore
+     * per batch. The connection is dedicated to the cursor from then on; to stop the stream
+     * early, call abandonExhaustCursor().
+     */
+    void exhaustTailingQueryGTE(const char* ns, Timestamp t);
+
+    /**
+     * Blocks until the next batch pushed by the remote node on an exhaust cursor has arrived.
+     * Only valid once the current batch has been fully consumed.
+     */
+    void receiveMoreExhaust() {
+        uassert(34420, "Doesn't have cursor for reading oplog", cursor.get());
+        cursor->exhaustReceiveMore();
+    }
+
+    /**
+     * Drops the exhaust cursor and its connection. The remote node may still be writing to
+     * the socket, so the connection cannot be reused and no killCursors is sent.
+     */
+    void abandonExhaustCursor();
+
+    long long getCursorId() {
+        uassert(34421, "Doesn't have cursor for reading oplog", cursor.get());
+        return cursor->getCursorId();
+    }
+
     bool more() {
         uassert(15910, "Doesn't have cursor for reading oplog", cursor.get());
         return cursor->more();
@@ -121,7 +121,7 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
      * Constructor takes the list of waiters and enqueues itself on the list, removing itself
      * in the destructor.
      */
-    WaiterInfo(std::vector<WaiterInfo*>* _list,
+    WaiterInfo(WaiterList* _list,
                unsigned int _opID,
                const OpTime* _opTime,
                const WriteConcernOptions* _writeConcern,
@@ -132,14 +132,14 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
           opTime(_opTime),
           writeConcern(_writeConcern),
           condVar(_condVar) {
-        list->push_back(this);
+        list->add_inlock(this);
     }
 
     ~WaiterInfo() {
-        list->erase(std::remove(list->begin(), list->end(), this), list->end());
+        list->remove_inlock(this);
     }
 
-    std::vector<WaiterInfo*>* list;
+    WaiterList* list;
     bool master;  // Set to false to indicate that stepDown was called while waiting
     const unsigned int opID;
     const OpTime* opTime;
@@ -147,6 +147,58 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
     stdx::condition_variable* condVar;
 };
 
+bool ReplicationCoordinatorImpl::WaiterList::OpTimeLess::operator()(const WaiterInfo* lhs,
+                                                                    const WaiterInfo* rhs) const {
+    if (*lhs->opTime != *rhs->opTime) {
+        return *lhs->opTime < *rhs->opTime;
+    }
+    return std::less<const WaiterInfo*>()(lhs, rhs);
+}
+
+ReplicationCoordinatorImpl::WaiterList::GroupKey
+ReplicationCoordinatorImpl::WaiterList::_groupKey(const WaiterInfo* waiter) {
+    if (!waiter->writeConcern) {
+        return GroupKey();
+    }
+    return GroupKey(waiter->writeConcern->wMode,
+                    waiter->writeConcern->wNumNodes,
+                    static_cast<int>(waiter->writeConcern->syncMode));
+}
+
+void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterInfo* waiter) {
+    _groups[_groupKey(waiter)].insert(waiter);
+}
+
+void ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterInfo* waiter) {
+    auto group = _groups.find(_groupKey(waiter));
+    invariant(group != _groups.end());
+    invariant(group->second.erase(waiter) == 1U);
+    if (group->second.empty()) {
+        _groups.erase(group);
+    }
+}
+
+void ReplicationCoordinatorImpl::WaiterList::forEach_inlock(
+    const stdx::function<void(WaiterInfo*)>& func) {
+    for (auto& keyAndGroup : _groups) {
+        for (WaiterInfo* waiter : keyAndGroup.second) {
+            func(waiter);
+        }
+    }
+}
+
+void ReplicationCoordinatorImpl::WaiterList::notifyDone_inlock(
+    const stdx::function<bool(WaiterInfo*)>& isDone) {
+    for (auto& keyAndGroup : _groups) {
+        for (WaiterInfo* waiter : keyAndGroup.second) {
+            if (!isDone(waiter)) {
+                break;
+            }
+            waiter->condVar->notify_all();
+        }
+    }
+}
+
 namespace {
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
@@ -493,12 +545,8 @@ void ReplicationCoordinatorImpl::shutdown() {
             return;
         }
         fassert(18823, _rsConfigState != kConfigStartingUp);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* waiter = *it;
-            waiter->condVar->notify_all();
-        }
+        _replicationWaiterList.forEach_inlock(
+            [](WaiterInfo* waiter) { waiter->condVar->notify_all(); });
     }
 
     // joining the replication executor is blocking so it must be run outside of the mutex
@@ -945,11 +993,8 @@ void ReplicationCoordinatorImpl::_setMyLastAppliedOpTime_inlock(const OpTime& op
     invariant(isRollbackAllowed || mySlaveInfo->lastAppliedOpTime <= opTime);
     _updateSlaveInfoAppliedOpTime_inlock(mySlaveInfo, opTime);
 
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        if (*(opTimeWaiter->opTime) <= opTime) {
-            opTimeWaiter->condVar->notify_all();
-        }
-    }
+    _opTimeWaiterList.notifyDone_inlock(
+        [&opTime](WaiterInfo* waiter) { return *waiter->opTime <= opTime; });
 }
 
 void ReplicationCoordinatorImpl::_setMyLastDurableOpTime_inlock(const OpTime& opTime,
@@ -1228,21 +1273,17 @@ void ReplicationCoordinatorImpl::interrupt(unsigned opId) {
     // Wake ops waiting for a new committed snapshot.
     _currentCommittedSnapshotCond.notify_all();
 
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        if (info->opID == opId) {
-            info->condVar->notify_all();
-            return;
-        }
-    }
-
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        if (opTimeWaiter->opID == opId) {
-            opTimeWaiter->condVar->notify_all();
-            return;
+    bool found = false;
+    auto notifyIfOp = [opId, &found](WaiterInfo* waiter) {
+        if (waiter->opID == opId) {
+            waiter->condVar->notify_all();
+            found = true;
         }
+    };
+    _replicationWaiterList.forEach_inlock(notifyIfOp);
+    _opTimeWaiterList.forEach_inlock(notifyIfOp);
+    if (found) {
+        return;
     }
 
     _scheduleWork(stdx::bind(&ReplicationCoordinatorImpl::_signalStepDownWaiters, this));
@@ -1253,16 +1294,9 @@ void ReplicationCoordinatorImpl::interruptAll() {
     // Wake ops waiting for a new committed snapshot.
     _currentCommittedSnapshotCond.notify_all();
 
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        info->condVar->notify_all();
-    }
-
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        opTimeWaiter->condVar->notify_all();
-    }
+    auto notify = [](WaiterInfo* waiter) { waiter->condVar->notify_all(); };
+    _replicationWaiterList.forEach_inlock(notify);
+    _opTimeWaiterList.forEach_inlock(notify);
 
     _scheduleWork(stdx::bind(&ReplicationCoordinatorImpl::_signalStepDownWaiters, this));
 }
@@ -2473,13 +2507,10 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock() {
     PostMemberStateUpdateAction result;
     if (_memberState.primary() || newState.removed() || newState.rollback()) {
         // Wake up any threads blocked in awaitReplication, close connections, etc.
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* info = *it;
-            info->master = false;
-            info->condVar->notify_all();
-        }
+        _replicationWaiterList.forEach_inlock([](WaiterInfo* waiter) {
+            waiter->master = false;
+            waiter->condVar->notify_all();
+        });
         _canAcceptNonLocalWrites = false;
         result = kActionCloseAllConnections;
     } else {
@@ -2748,15 +2779,10 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        if (_doneWaitingForReplication_inlock(
-                *info->opTime, SnapshotName::min(), *info->writeConcern)) {
-            info->condVar->notify_all();
-        }
-    }
+    _replicationWaiterList.notifyDone_inlock([this](WaiterInfo* waiter) {
+        return _doneWaitingForReplication_inlock(
+            *waiter->opTime, SnapshotName::min(), *waiter->writeConcern);
+    });
 }
 
 Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(
@@ -28,9 +28,13 @@
 
 #pragma once
 
-#include <vector>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/timestamp.h"
@@ -52,6 +56,7 @@
 #include "mongo/platform/unordered_map.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/net/hostandport.h"
 
@@ -498,6 +503,41 @@ private:
     // Struct that holds information about clients waiting for replication.
     struct WaiterInfo;
 
+    /**
+     * Set of WaiterInfos, grouped by write concern and ordered by the OpTime waited for within
+     * each group. A write concern satisfied at some OpTime is also satisfied at every earlier
+     * OpTime, so waking satisfied waiters only has to look at the front of each group. Does *not*
+     * own the WaiterInfos.
+     */
+    class WaiterList {
+    public:
+        void add_inlock(WaiterInfo* waiter);
+        void remove_inlock(WaiterInfo* waiter);
+
+        /**
+         * Calls "func" on every waiter.
+         */
+        void forEach_inlock(const stdx::function<void(WaiterInfo*)>& func);
+
+        /**
+         * Within each write concern group, notifies waiters in OpTime order until "isDone" returns
+         * false.
+         */
+        void notifyDone_inlock(const stdx::function<bool(WaiterInfo*)>& isDone);
+
+    private:
+        struct OpTimeLess {
+            bool operator()(const WaiterInfo* lhs, const WaiterInfo* rhs) const;
+        };
+        // wMode, wNumNodes and syncMode of the waiters' write concern.
+        using GroupKey = std::tuple<std::string, int, int>;
+        using Group = std::set<WaiterInfo*, OpTimeLess>;
+
+        static GroupKey _groupKey(const WaiterInfo* waiter);
+
+        std::map<GroupKey, Group> _groups;
+    };
+
     // Struct that holds information about nodes in this replication group, mainly used for
     // tracking replication progress for write concern satisfaction.
     struct SlaveInfo {
@@ -593,6 +633,8 @@ private:
 
     /**
      * Helper to wake waiters in _replicationWaiterList that are doneWaitingForReplication.
+     * Only waiters whose write concern is satisfied and, per write concern, the first waiter
+     * that is not, are examined.
      */
     void _wakeReadyWaiters_inlock();
 
@@ -1294,11 +1336,11 @@ private:
     int _rbid;  // (M)
 
     // list of information about clients waiting on replication.  Does *not* own the WaiterInfos.
-    std::vector<WaiterInfo*> _replicationWaiterList;  // (M)
+    WaiterList _replicationWaiterList;  // (M)
 
     // list of information about clients waiting for a particular opTime.
     // Does *not* own the WaiterInfos.
-    std::vector<WaiterInfo*> _opTimeWaiterList;  // (M)
+    WaiterList _opTimeWaiterList;  // (M)
 
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
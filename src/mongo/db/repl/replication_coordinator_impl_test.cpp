@@ -1197,6 +1197,60 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesConcurrentWaitersWithDifferentWriteConcernsAsTheyAreSatisfied) {
+    OperationContextNoop txn;
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version" << 2 << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id" << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id" << 1) << BSON("host"
+                                                                         << "node3:12345"
+                                                                         << "_id" << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermZero(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermZero(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermZero time1(100, 1);
+    OpTimeWithTermZero time2(100, 2);
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+
+    WriteConcernOptions writeConcern2;
+    writeConcern2.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern2.wNumNodes = 2;
+    WriteConcernOptions writeConcern3 = writeConcern2;
+    writeConcern3.wNumNodes = 3;
+
+    // Waiters are registered out of OpTime order.
+    ReplicationAwaiter awaiter2Time2(getReplCoord(), &txn);
+    awaiter2Time2.setOpTime(time2);
+    awaiter2Time2.setWriteConcern(writeConcern2);
+    awaiter2Time2.start(&txn);
+    ReplicationAwaiter awaiter2Time1(getReplCoord(), &txn);
+    awaiter2Time1.setOpTime(time1);
+    awaiter2Time1.setWriteConcern(writeConcern2);
+    awaiter2Time1.start(&txn);
+    ReplicationAwaiter awaiter3Time1(getReplCoord(), &txn);
+    awaiter3Time1.setOpTime(time1);
+    awaiter3Time1.setWriteConcern(writeConcern3);
+    awaiter3Time1.start(&txn);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(awaiter2Time1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiter2Time2.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(awaiter3Time1.getResult().status);
+}
+
 TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBeforeBeingSatisified) {
     OperationContextNoop txn;
     assertStartSuccess(BSON("_id"
@@ -47,6 +47,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 
@@ -240,6 +241,7 @@ public:
         result.append("maxWireVersion", WireSpec::instance().maxWireVersionIncoming);
         result.append("minWireVersion", WireSpec::instance().minWireVersionIncoming);
         result.append("readOnly", storageGlobalParams.readOnly);
+        appendEnabledMessageCompressors(&result);
         return true;
     }
 } cmdismaster;
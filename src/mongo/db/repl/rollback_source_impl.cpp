@@ -30,6 +30,7 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
@@ -40,6 +41,13 @@
 
 namespace mongo {
 namespace repl {
+namespace {
+
+// Upper bounds on the size of the $in list sent in a single refetch query.
+const size_t kMaxIdsPerQuery = 1000;
+const int kMaxIdBytesPerQuery = 8 * 1024 * 1024;
+
+}  // namespace
 
 RollbackSourceImpl::RollbackSourceImpl(GetConnectionFn getConnection,
                                        const HostAndPort& source,
@@ -68,6 +76,37 @@ BSONObj RollbackSourceImpl::findOne(const NamespaceString& nss, const BSONObj& f
     return _getConnection()->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
 }
 
+std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    // Use a dedicated connection so that several collections can be refetched at once.
+    std::string errmsg;
+    DBClientConnection conn(false, durationCount<Seconds>(OplogReader::kSocketTimeout));
+    uassert(34431, errmsg, conn.connect(_source, errmsg) && replAuthenticate(&conn));
+
+    std::vector<BSONObj> docs;
+    auto it = ids.begin();
+    while (it != ids.end()) {
+        BSONArrayBuilder idsBuilder;
+        size_t idsInBatch = 0;
+        for (; it != ids.end() && idsInBatch < kMaxIdsPerQuery &&
+             idsBuilder.len() < kMaxIdBytesPerQuery;
+             ++it, ++idsInBatch) {
+            idsBuilder.append(*it);
+        }
+
+        const BSONObj filter = BSON("_id" << BSON("$in" << idsBuilder.arr()));
+        std::unique_ptr<DBClientCursor> cursor =
+            conn.query(nss.ns(), filter, 0, 0, nullptr, QueryOption_SlaveOk);
+        uassert(34422,
+                str::stream() << "replSet rollback error refetching documents from " << nss.ns(),
+                cursor.get());
+        while (cursor->more()) {
+            docs.push_back(cursor->nextSafe().getOwned());
+        }
+    }
+    return docs;
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -62,6 +62,8 @@
 #include "mongo/db/repl/roll_back_local_operations.h"
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/repl/rslog.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/old_thread_pool.h"
 #include "mongo/util/log.h"
 
 /* Scenarios
@@ -328,6 +330,26 @@ Status refetch(FixUpInfo& fixUpInfo, const BSONObj& ourObj) {
 }
 
 
+// Number of collections whose documents are refetched from the sync source concurrently.
+const int kRefetchThreads = 4;
+
+// The ids to refetch from a single collection and the documents the sync source returned.
+struct RefetchBatch {
+    std::vector<BSONElement> ids;
+    std::vector<BSONObj> docs;
+    Status status = Status::OK();
+};
+
+void refetchCollection(const RollbackSource& rollbackSource,
+                       const string& ns,
+                       RefetchBatch* batch) {
+    try {
+        batch->docs = rollbackSource.findByIds(NamespaceString(ns), batch->ids);
+    } catch (const DBException& e) {
+        batch->status = e.toStatus();
+    }
+}
+
 void syncFixUp(OperationContext* txn,
                FixUpInfo& fixUpInfo,
                const RollbackSource& rollbackSource,
@@ -341,27 +363,55 @@ void syncFixUp(OperationContext* txn,
 
     BSONObj newMinValid;
 
-    // fetch all the goodVersions of each document from current primary
-    DocID doc;
+    // fetch all the goodVersions of each document from current primary. Documents are fetched
+    // with batched _id queries per collection, and collections are fetched in parallel.
+    map<string, RefetchBatch> refetchBatches;
+    for (const DocID& doc : fixUpInfo.toRefetch) {
+        verify(!doc._id.eoo());
+        refetchBatches[doc.ns].ids.push_back(doc._id);
+    }
+
     unsigned long long numFetched = 0;
     try {
-        for (set<DocID>::iterator it = fixUpInfo.toRefetch.begin(); it != fixUpInfo.toRefetch.end();
-             it++) {
-            doc = *it;
+        if (refetchBatches.size() == 1) {
+            refetchCollection(
+                rollbackSource, refetchBatches.begin()->first, &refetchBatches.begin()->second);
+        } else if (!refetchBatches.empty()) {
+            OldThreadPool refetchPool(
+                std::min(kRefetchThreads, static_cast<int>(refetchBatches.size())), "rsRollback");
+            for (auto& nsAndBatch : refetchBatches) {
+                refetchPool.schedule(refetchCollection,
+                                     stdx::cref(rollbackSource),
+                                     nsAndBatch.first,
+                                     &nsAndBatch.second);
+            }
+            refetchPool.join();
+        }
 
-            verify(!doc._id.eoo());
+        // namespace -> _id -> doc, for the documents that still exist on the sync source
+        map<string, map<BSONElement, BSONObj>> fetchedById;
+        for (const auto& nsAndBatch : refetchBatches) {
+            const RefetchBatch& batch = nsAndBatch.second;
+            if (!batch.status.isOK()) {
+                error() << "rollback couldn't re-get documents in ns:" << nsAndBatch.first;
+                uassertStatusOK(batch.status);
+            }
 
-            {
-                // TODO : slow.  lots of round trips.
-                numFetched++;
-                BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
+            auto& docsById = fetchedById[nsAndBatch.first];
+            for (const BSONObj& good : batch.docs) {
                 totalSize += good.objsize();
                 uassert(13410, "replSet too much data to roll back", totalSize < 300 * 1024 * 1024);
-
-                // note good might be eoo, indicating we should delete it
-                goodVersions[doc.ns][doc] = good;
+                docsById[good["_id"]] = good;
             }
         }
+
+        for (const DocID& doc : fixUpInfo.toRefetch) {
+            numFetched++;
+            // a document missing from the source is left eoo, indicating we should delete it
+            const auto& docsById = fetchedById[doc.ns];
+            auto found = docsById.find(doc._id);
+            goodVersions[doc.ns][doc] = found == docsById.end() ? BSONObj() : found->second;
+        }
         newMinValid = rollbackSource.getLastOperation();
         if (newMinValid.isEmpty()) {
             error() << "rollback error newMinValid empty?";
@@ -369,8 +419,8 @@ void syncFixUp(OperationContext* txn,
         }
     } catch (const DBException& e) {
         LOG(1) << "rollback re-get objects: " << e.toString();
-        error() << "rollback couldn't re-get ns:" << doc.ns << " _id:" << doc._id << ' '
-                << numFetched << '/' << fixUpInfo.toRefetch.size();
+        error() << "rollback couldn't re-get objects " << numFetched << '/'
+                << fixUpInfo.toRefetch.size();
         throw e;
     }
 
@@ -610,14 +660,25 @@ void syncFixUp(OperationContext* txn,
     time_t lastProgressUpdate = time(0);
     time_t progressUpdateGap = 10;
     for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
+        const auto& ns = nsAndGoodVersionsByDocID.first;
+        if (fixUpInfo.collectionsToResyncData.count(ns)) {
+            // We just synced this entire collection.
+            continue;
+        }
+
         // Keep an archive of items rolled back if the collection has not been dropped
         // while rolling back createCollection operations.
-        const auto& ns = nsAndGoodVersionsByDocID.first;
         unique_ptr<Helpers::RemoveSaver> removeSaver;
         if (!fixUpInfo.toDrop.count(ns)) {
             removeSaver.reset(new Helpers::RemoveSaver("rollback", "", ns));
         }
 
+        // Take the lock and context once per collection rather than once per document.
+        const NamespaceString docNss(ns);
+        ScopedTransaction transaction(txn, MODE_IX);
+        Lock::DBLock docDbLock(txn->lockState(), docNss.db(), MODE_X);
+        OldClientContext ctx(txn, ns);
+
         const auto& goodVersionsByDocID = nsAndGoodVersionsByDocID.second;
         for (const auto& idAndDoc : goodVersionsByDocID) {
             time_t now = time(0);
@@ -631,17 +692,8 @@ void syncFixUp(OperationContext* txn,
             BSONObj pattern = doc._id.wrap();  // { _id : ... }
             try {
                 verify(doc.ns && *doc.ns);
-                if (fixUpInfo.collectionsToResyncData.count(doc.ns)) {
-                    // We just synced this entire collection.
-                    continue;
-                }
-
-                // TODO: Lots of overhead in context. This can be faster.
-                const NamespaceString docNss(doc.ns);
-                ScopedTransaction transaction(txn, MODE_IX);
-                Lock::DBLock docDbLock(txn->lockState(), docNss.db(), MODE_X);
-                OldClientContext ctx(txn, doc.ns);
 
+                // Looked up per document since an earlier delete may have dropped it.
                 Collection* collection = ctx.db()->getCollection(doc.ns);
 
                 // Add the doc to our rollback file if the collection was not dropped while
@@ -92,6 +92,8 @@ public:
     const OplogInterface& getOplog() const override;
     BSONObj getLastOperation() const override;
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
     void copyCollectionFromRemote(OperationContext* txn, const NamespaceString& nss) const override;
     StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
 
@@ -121,6 +123,18 @@ BSONObj RollbackSourceMock::findOne(const NamespaceString& nss, const BSONObj& f
     return BSONObj();
 }
 
+std::vector<BSONObj> RollbackSourceMock::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    std::vector<BSONObj> docs;
+    for (const auto& id : ids) {
+        BSONObj doc = findOne(nss, id.wrap());
+        if (!doc.isEmpty()) {
+            docs.push_back(doc);
+        }
+    }
+    return docs;
+}
+
 void RollbackSourceMock::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {}
 
@@ -385,6 +399,53 @@ TEST_F(RSRollbackTest, RollbackDeleteRestoreDocument) {
     ASSERT_EQUALS(1, _testRollbackDelete(_txn.get(), _coordinator, doc));
 }
 
+TEST_F(RSRollbackTest, RollbackDeletesRefetchesDocumentsFromSeveralCollections) {
+    createOplog(_txn.get());
+    const std::vector<std::string> namespaces = {"test.t1", "test.t2", "test2.t"};
+    auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    OplogInterfaceMock::Operations operations({commonOperation});
+    int seconds = 2;
+    for (const auto& ns : namespaces) {
+        _createCollection(_txn.get(), ns, CollectionOptions());
+        for (int id = 0; id < 3; id++) {
+            operations.push_front(std::make_pair(
+                BSON("ts" << Timestamp(Seconds(seconds), 0) << "h" << 1LL << "op"
+                          << "d"
+                          << "ns" << ns << "o" << BSON("_id" << id)),
+                RecordId(seconds)));
+            seconds++;
+        }
+    }
+
+    // Only documents with an even _id still exist on the sync source.
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+        BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const {
+            int id = filter.firstElement().numberInt();
+            return id % 2 == 0 ? BSON("_id" << id << "a" << 1) : BSONObj();
+        }
+    };
+    RollbackSourceLocal rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({
+        commonOperation,
+    })));
+    ASSERT_OK(syncRollback(
+        _txn.get(), OplogInterfaceMock(operations), rollbackSource, _coordinator, noSleep));
+
+    for (const auto& ns : namespaces) {
+        const NamespaceString nss(ns);
+        Lock::DBLock dbLock(_txn->lockState(), nss.db(), MODE_S);
+        Lock::CollectionLock collLock(_txn->lockState(), ns, MODE_S);
+        auto db = dbHolder().get(_txn.get(), nss.db());
+        ASSERT_TRUE(db);
+        auto collection = db->getCollection(ns);
+        ASSERT_TRUE(collection);
+        ASSERT_EQUALS(2LL, collection->getRecordStore()->numRecords(_txn.get()));
+    }
+}
+
 TEST_F(RSRollbackTest, RollbackInsertDocumentWithNoId) {
     createOplog(_txn.get());
     auto commonOperation =
@@ -116,6 +116,23 @@ MONGO_FP_DECLARE(rsSyncApplyStop);
 static TimerStats applyBatchStats;
 static ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches",
                                                                    &applyBatchStats);
+
+// Number and time of each batch prefetch, and of applying batches with and without a prefetch
+// beforehand, including waiting for the writer threads to finish.
+static TimerStats prefetchBatchStats;
+static ServerStatusMetricField<TimerStats> displayBatchesPrefetched("repl.preload.batches",
+                                                                    &prefetchBatchStats);
+static TimerStats applyPrefetchedBatchStats;
+static ServerStatusMetricField<TimerStats> displayPrefetchedBatchesApplied(
+    "repl.apply.prefetchedBatches", &applyPrefetchedBatchStats);
+static TimerStats applyNonPrefetchedBatchStats;
+static ServerStatusMetricField<TimerStats> displayNonPrefetchedBatchesApplied(
+    "repl.apply.nonPrefetchedBatches", &applyNonPrefetchedBatchStats);
+
+// When true, prefetch the pages each batch needs on every storage engine rather than only on
+// MMAP V1. On other engines this reads the documents updated or deleted by the batch, and seeks
+// the indexes to their keys, so the writer threads do not stall on cold cache reads.
+MONGO_EXPORT_SERVER_PARAMETER(replPrefetchAllStorageEngines, bool, false);
 void initializePrefetchThread() {
     if (!ClientBasic::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -420,6 +437,7 @@ void prefetchOp(const BSONObj& op) {
 // Doles out all the work to the reader pool threads and waits for them to complete
 void prefetchOps(const std::deque<SyncTail::OplogEntry>& ops, OldThreadPool* prefetcherPool) {
     invariant(prefetcherPool);
+    TimerHolder timer(&prefetchBatchStats);
     for (auto&& op : ops) {
         prefetcherPool->schedule(&prefetchOp, op.raw);
     }
@@ -527,7 +545,9 @@ void fillWriterVectors(OperationContext* txn,
 OpTime SyncTail::multiApply(OperationContext* txn, const OpQueue& ops) {
     invariant(_applyFunc);
 
-    if (getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+    const bool prefetch = replPrefetchAllStorageEngines ||
+        getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1();
+    if (prefetch) {
         // Use a ThreadPool to prefetch all the operations in a batch.
         prefetchOps(ops.getDeque(), &_prefetcherPool);
     }
@@ -550,6 +570,7 @@ OpTime SyncTail::multiApply(OperationContext* txn, const OpQueue& ops) {
         fassertFailed(28527);
     }
 
+    TimerHolder applyTimer(prefetch ? &applyPrefetchedBatchStats : &applyNonPrefetchedBatchStats);
     applyOps(writerVectors, &_writerPool, _applyFunc, this);
 
     OpTime lastOpTime;
@@ -0,0 +1,129 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_load_tracker.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/sharding_state.h"
+
+namespace mongo {
+
+using std::string;
+using std::stringstream;
+
+namespace {
+
+/**
+ * Mongod-side command which reports the sampled load and estimated size of every chunk of a
+ * collection owned by this shard. Used by the balancer when it balances on bytes or load.
+ */
+class GetChunkLoadStatsCommand : public Command {
+public:
+    GetChunkLoadStatsCommand() : Command("getChunkLoadStats") {}
+
+    virtual void help(stringstream& h) const {
+        h << "internal command for the balancer\n"
+          << "usage: { getChunkLoadStats : <ns> }\n"
+          << "returns { chunks : [ { min, max, reads, writes, bytes } ... ] }";
+    }
+
+    virtual Status checkAuthForCommand(ClientBasic* client,
+                                       const std::string& dbname,
+                                       const BSONObj& cmdObj) {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    virtual std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const {
+        return parseNsFullyQualified(dbname, cmdObj);
+    }
+
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool slaveOk() const {
+        return false;
+    }
+    virtual bool isWriteCommandForConfigServer() const {
+        return false;
+    }
+
+    bool run(OperationContext* txn,
+             const string& dbname,
+             BSONObj& cmdObj,
+             int,
+             string& errmsg,
+             BSONObjBuilder& result) {
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+        if (!nss.isValid()) {
+            errmsg = "invalid namespace specified";
+            return false;
+        }
+
+        ShardingState* const shardingState = ShardingState::get(txn);
+        if (!shardingState->enabled()) {
+            errmsg = "sharding is not enabled on this server";
+            return false;
+        }
+
+        long long collectionSize = 0;
+        {
+            AutoGetCollection autoColl(txn, nss, MODE_IS);
+            if (autoColl.getCollection()) {
+                collectionSize = autoColl.getCollection()->dataSize(txn);
+            }
+        }
+
+        BSONArrayBuilder chunks(result.subarrayStart("chunks"));
+
+        std::shared_ptr<CollectionMetadata> metadata =
+            shardingState->getCollectionMetadata(nss.ns());
+        if (metadata) {
+            shardingState->chunkLoadTracker()->report(
+                nss.ns(), *metadata, collectionSize, &chunks);
+        }
+
+        chunks.done();
+        return true;
+    }
+
+} getChunkLoadStatsCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,257 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_load_tracker.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+namespace {
+
+// How often the operation counters are halved
+const Seconds kDecayPeriod(60);
+
+}  // namespace
+
+MONGO_EXPORT_SERVER_PARAMETER(chunkLoadSamplingInterval, int, 0);
+
+ChunkLoadTracker::ChunkLoadTracker() : _clockSource(SystemClockSource::get()) {}
+
+ChunkLoadTracker::~ChunkLoadTracker() = default;
+
+void ChunkLoadTracker::setClockSource(ClockSource* clockSource) {
+    _clockSource = clockSource;
+}
+
+bool ChunkLoadTracker::shouldSample(unsigned int opId) {
+    const int interval = chunkLoadSamplingInterval.load();
+    if (interval <= 0) {
+        return false;
+    }
+
+    return opId % static_cast<unsigned>(interval) == 0;
+}
+
+void ChunkLoadTracker::noteRead(const std::string& ns,
+                                const CollectionMetadata& metadata,
+                                const BSONObj& shardKey) {
+    const long long weight = std::max(chunkLoadSamplingInterval.load(), 1);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ChunkLoad* load = _getChunkLoad_inlock(ns, metadata, shardKey);
+    if (load) {
+        load->reads += weight;
+    }
+}
+
+void ChunkLoadTracker::noteWrite(const std::string& ns,
+                                 const CollectionMetadata& metadata,
+                                 const BSONObj& shardKey,
+                                 long long bytesInserted) {
+    const long long weight = std::max(chunkLoadSamplingInterval.load(), 1);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ChunkLoad* load = _getChunkLoad_inlock(ns, metadata, shardKey);
+    if (load) {
+        load->writes += weight;
+        load->bytes += bytesInserted * weight;
+    }
+}
+
+void ChunkLoadTracker::report(const std::string& ns,
+                              const CollectionMetadata& metadata,
+                              long long collectionSize,
+                              BSONArrayBuilder* chunks) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    CollectionLoad& collLoad = _collections[ns];
+    _decay_inlock(&collLoad);
+
+    std::vector<std::pair<ChunkType, ChunkLoad>> owned;
+    long long trackedBytes = 0;
+
+    ChunkType chunk;
+    BSONObj lookupKey = metadata.getMinKey();
+    while (metadata.getNextChunk(lookupKey, &chunk)) {
+        ChunkLoad load;
+        auto it = collLoad.chunks.find(chunk.getMin());
+        if (it != collLoad.chunks.end()) {
+            load = it->second;
+        }
+
+        trackedBytes += load.bytes;
+        owned.emplace_back(chunk, load);
+        lookupKey = chunk.getMax();
+    }
+
+    const long long untrackedBytesPerChunk = owned.empty()
+        ? 0
+        : std::max(collectionSize - trackedBytes, 0LL) / static_cast<long long>(owned.size());
+
+    ChunkLoadMap current;
+    for (const auto& ownedChunk : owned) {
+        const ChunkLoad& load = ownedChunk.second;
+        chunks->append(BSON(ChunkType::min(ownedChunk.first.getMin())
+                            << ChunkType::max(ownedChunk.first.getMax()) << "reads" << load.reads
+                            << "writes" << load.writes << "bytes"
+                            << load.bytes + untrackedBytesPerChunk));
+
+        if (load.reads || load.writes || load.bytes) {
+            current[ownedChunk.first.getMin()] = load;
+        }
+    }
+
+    if (current.empty()) {
+        _collections.erase(ns);
+    } else {
+        collLoad.chunks.swap(current);
+    }
+}
+
+void ChunkLoadTracker::splitChunk(const std::string& ns,
+                                  const BSONObj& min,
+                                  const std::vector<BSONObj>& splitKeys) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto collIt = _collections.find(ns);
+    if (collIt == _collections.end()) {
+        return;
+    }
+
+    ChunkLoadMap& chunkLoads = collIt->second.chunks;
+    auto it = chunkLoads.find(min);
+    if (it == chunkLoads.end()) {
+        return;
+    }
+
+    const long long numChunks = splitKeys.size() + 1;
+    ChunkLoad share;
+    share.reads = it->second.reads / numChunks;
+    share.writes = it->second.writes / numChunks;
+    share.bytes = it->second.bytes / numChunks;
+
+    it->second = share;
+    for (const auto& splitKey : splitKeys) {
+        chunkLoads[splitKey.getOwned()] = share;
+    }
+}
+
+void ChunkLoadTracker::mergeChunks(const std::string& ns,
+                                   const BSONObj& minKey,
+                                   const BSONObj& maxKey) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto collIt = _collections.find(ns);
+    if (collIt == _collections.end()) {
+        return;
+    }
+
+    ChunkLoadMap& chunkLoads = collIt->second.chunks;
+    const auto begin = chunkLoads.lower_bound(minKey);
+    const auto end = chunkLoads.lower_bound(maxKey);
+    if (begin == end) {
+        return;
+    }
+
+    ChunkLoad merged;
+    for (auto it = begin; it != end; ++it) {
+        merged.reads += it->second.reads;
+        merged.writes += it->second.writes;
+        merged.bytes += it->second.bytes;
+    }
+
+    chunkLoads.erase(begin, end);
+    chunkLoads[minKey.getOwned()] = merged;
+}
+
+void ChunkLoadTracker::forgetRange(const std::string& ns,
+                                   const BSONObj& min,
+                                   const BSONObj& max) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto collIt = _collections.find(ns);
+    if (collIt == _collections.end()) {
+        return;
+    }
+
+    ChunkLoadMap& chunkLoads = collIt->second.chunks;
+    chunkLoads.erase(chunkLoads.lower_bound(min), chunkLoads.lower_bound(max));
+}
+
+void ChunkLoadTracker::clear(const std::string& ns) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _collections.erase(ns);
+}
+
+ChunkLoadTracker::ChunkLoad* ChunkLoadTracker::_getChunkLoad_inlock(
+    const std::string& ns, const CollectionMetadata& metadata, const BSONObj& shardKey) {
+    if (shardKey.isEmpty()) {
+        return nullptr;
+    }
+
+    ChunkType chunk;
+    if (!metadata.getNextChunk(shardKey, &chunk) || shardKey.woCompare(chunk.getMin()) < 0) {
+        // The key is not in any chunk owned by this shard
+        return nullptr;
+    }
+
+    CollectionLoad& collLoad = _collections[ns];
+    _decay_inlock(&collLoad);
+    return &collLoad.chunks[chunk.getMin().getOwned()];
+}
+
+void ChunkLoadTracker::_decay_inlock(CollectionLoad* collLoad) {
+    const Date_t now = _clockSource->now();
+    if (collLoad->lastDecay == Date_t()) {
+        collLoad->lastDecay = now;
+        return;
+    }
+
+    const long long periods = (now - collLoad->lastDecay) / kDecayPeriod;
+    if (periods <= 0) {
+        return;
+    }
+
+    // Counters which were halved this many times are gone anyway
+    const int shift = std::min(periods, 62LL);
+    for (auto& chunkLoad : collLoad->chunks) {
+        chunkLoad.second.reads >>= shift;
+        chunkLoad.second.writes >>= shift;
+    }
+
+    collLoad->lastDecay += periods * kDecayPeriod;
+}
+
+}  // namespace mongo
@@ -0,0 +1,175 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONArrayBuilder;
+class ClockSource;
+class CollectionMetadata;
+
+// Record one in this many operations against sharded collections; 0, the default, disables chunk
+// load tracking. Only needed on shards whose balancer uses the load or bytes weights.
+extern std::atomic<int> chunkLoadSamplingInterval;  // NOLINT
+
+/**
+ * Keeps sampled per-chunk read and write counts, plus an estimate of the bytes inserted into each
+ * chunk, for the sharded collections owned by this shard. The balancer retrieves these through
+ * the getChunkLoadStats command in order to balance on load and data size instead of chunk count.
+ *
+ * Only one operation in every 'chunkLoadSamplingInterval' is recorded and each recorded operation
+ * is weighted by the interval, so the counters are estimates. Statistics live only in memory and
+ * the operation counters are halved every minute, so that the balancer sees recent load rather
+ * than the load since startup. Splits, merges and migrations have to be passed on through
+ * splitChunk, mergeChunks and forgetRange, so that the statistics stay keyed by the min key of the
+ * chunk they describe.
+ *
+ * Thread safe.
+ */
+class ChunkLoadTracker {
+    MONGO_DISALLOW_COPYING(ChunkLoadTracker);
+
+public:
+    ChunkLoadTracker();
+    ~ChunkLoadTracker();
+
+    /**
+     * Replaces the clock used to decay the operation counters. For testing.
+     */
+    void setClockSource(ClockSource* clockSource);
+
+    /**
+     * Returns true if the operation with id 'opId' should be recorded through noteRead or
+     * noteWrite. Sampling is decided per operation rather than per document, so every document an
+     * operation touches is recorded if any is, and no shared state is modified.
+     */
+    static bool shouldSample(unsigned int opId);
+
+    /**
+     * Records a sampled read of the document with shard key 'shardKey' against the chunk of 'ns'
+     * which contains it according to 'metadata'.
+     */
+    void noteRead(const std::string& ns,
+                  const CollectionMetadata& metadata,
+                  const BSONObj& shardKey);
+
+    /**
+     * Records a sampled write of the document with shard key 'shardKey', which grew the chunk that
+     * contains it by 'bytesInserted' bytes.
+     */
+    void noteWrite(const std::string& ns,
+                   const CollectionMetadata& metadata,
+                   const BSONObj& shardKey,
+                   long long bytesInserted);
+
+    /**
+     * Appends one entry per chunk of 'metadata' to 'chunks', in the form
+     * { min: <key>, max: <key>, reads: <n>, writes: <n>, bytes: <n> }. Statistics for chunks which
+     * no longer belong to this shard are discarded.
+     *
+     * Data which was not inserted while being tracked, that is the part of 'collectionSize' not
+     * accounted for by the inserted bytes estimates, is spread evenly across the chunks.
+     */
+    void report(const std::string& ns,
+                const CollectionMetadata& metadata,
+                long long collectionSize,
+                BSONArrayBuilder* chunks);
+
+    /**
+     * Spreads the statistics of the chunk of 'ns' starting at 'min' evenly across the chunks it
+     * was split into at 'splitKeys', since nothing tells how they were spread within the chunk.
+     */
+    void splitChunk(const std::string& ns,
+                    const BSONObj& min,
+                    const std::vector<BSONObj>& splitKeys);
+
+    /**
+     * Adds up the statistics of the chunks of 'ns' in [minKey, maxKey), which were merged into a
+     * single chunk.
+     */
+    void mergeChunks(const std::string& ns, const BSONObj& minKey, const BSONObj& maxKey);
+
+    /**
+     * Discards the statistics of the chunks of 'ns' in [min, max), because the range was donated
+     * to another shard.
+     */
+    void forgetRange(const std::string& ns, const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Discards all statistics for 'ns', for example because the collection was dropped.
+     */
+    void clear(const std::string& ns);
+
+private:
+    struct ChunkLoad {
+        long long reads{0};
+        long long writes{0};
+        long long bytes{0};
+    };
+
+    // Chunk min key to the statistics for that chunk
+    typedef std::map<BSONObj, ChunkLoad, BSONObjCmp> ChunkLoadMap;
+
+    struct CollectionLoad {
+        ChunkLoadMap chunks;
+
+        // When the operation counters of the collection were last halved
+        Date_t lastDecay;
+    };
+
+    ChunkLoad* _getChunkLoad_inlock(const std::string& ns,
+                                    const CollectionMetadata& metadata,
+                                    const BSONObj& shardKey);
+
+    /**
+     * Halves the operation counters of 'collLoad' once for every decay period since they were
+     * last halved.
+     */
+    void _decay_inlock(CollectionLoad* collLoad);
+
+    ClockSource* _clockSource;  // not owned
+
+    // Protects _collections
+    stdx::mutex _mutex;
+
+    std::map<std::string, CollectionLoad> _collections;
+};
+
+}  // namespace mongo
@@ -0,0 +1,320 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/s/chunk_load_tracker.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/metadata_loader.h"
+#include "mongo/dbtests/mock/mock_conn_registry.h"
+#include "mongo/dbtests/mock/mock_remote_db_server.h"
+#include "mongo/s/catalog/legacy/catalog_manager_legacy.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/catalog/type_collection.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+const std::string CONFIG_HOST_PORT = "$dummy_config:27017";
+
+/**
+ * Metadata for shard0000, which owns [MinKey, 10) and [30, MaxKey) of x.y while [10, 30) is on
+ * shard0001.
+ */
+class ChunkLoadTrackerFixture : public mongo::unittest::Test {
+protected:
+    void setUp() {
+        _savedSamplingInterval = chunkLoadSamplingInterval.load();
+        chunkLoadSamplingInterval.store(1);
+
+        OperationContextNoop txn;
+        _dummyConfig.reset(new MockRemoteDBServer(CONFIG_HOST_PORT));
+        mongo::ConnectionString::setConnectionHook(MockConnRegistry::get()->getConnStrHook());
+        MockConnRegistry::get()->addServer(_dummyConfig.get());
+
+        OID epoch(OID::gen());
+
+        CollectionType collType;
+        collType.setNs(NamespaceString{"x.y"});
+        collType.setKeyPattern(BSON("a" << 1));
+        collType.setUnique(false);
+        collType.setUpdatedAt(Date_t::fromMillisSinceEpoch(1));
+        collType.setEpoch(epoch);
+        _dummyConfig->insert(CollectionType::ConfigNS, collType.toBSON());
+
+        _insertChunk(ChunkVersion(1, 1, epoch), BSON("a" << MINKEY), BSON("a" << 10), "shard0000");
+        _insertChunk(ChunkVersion(1, 2, epoch), BSON("a" << 10), BSON("a" << 30), "shard0001");
+        _insertChunk(ChunkVersion(1, 3, epoch), BSON("a" << 30), BSON("a" << MAXKEY), "shard0000");
+
+        ConnectionString configLoc = ConnectionString(HostAndPort(CONFIG_HOST_PORT));
+        ASSERT(configLoc.isValid());
+        CatalogManagerLegacy catalogManager;
+        std::string lockProcessId = "testhost:123455:1234567890:9876543210";
+        catalogManager.init(configLoc, lockProcessId);
+
+        MetadataLoader loader;
+        Status status = loader.makeCollectionMetadata(
+            &txn, &catalogManager, "x.y", "shard0000", NULL, &_metadata);
+        ASSERT_OK(status);
+        ASSERT_EQUALS(2u, _metadata.getNumChunks());
+    }
+
+    void tearDown() {
+        MockConnRegistry::get()->clear();
+        chunkLoadSamplingInterval.store(_savedSamplingInterval);
+    }
+
+    const CollectionMetadata& getCollMetadata() const {
+        return _metadata;
+    }
+
+    /**
+     * Returns the chunk entries reported by 'tracker' for x.y.
+     */
+    vector<BSONObj> report(ChunkLoadTracker* tracker, long long collectionSize = 0) {
+        return report(tracker, getCollMetadata(), collectionSize);
+    }
+
+    /**
+     * Returns the chunk entries reported by 'tracker' for x.y, whose chunks are now 'metadata'.
+     */
+    vector<BSONObj> report(ChunkLoadTracker* tracker,
+                           const CollectionMetadata& metadata,
+                           long long collectionSize) {
+        BSONArrayBuilder chunksBuilder;
+        tracker->report("x.y", metadata, collectionSize, &chunksBuilder);
+
+        vector<BSONObj> chunks;
+        BSONObjIterator it(chunksBuilder.arr());
+        while (it.more()) {
+            chunks.push_back(it.next().Obj().getOwned());
+        }
+        return chunks;
+    }
+
+private:
+    void _insertChunk(const ChunkVersion& version,
+                      const BSONObj& min,
+                      const BSONObj& max,
+                      const std::string& shard) {
+        _dummyConfig->insert(
+            ChunkType::ConfigNS,
+            BSON(ChunkType::name(OID::gen().toString())
+                 << ChunkType::ns("x.y") << ChunkType::min(min) << ChunkType::max(max)
+                 << ChunkType::DEPRECATED_lastmod(Date_t::fromMillisSinceEpoch(version.toLong()))
+                 << ChunkType::DEPRECATED_epoch(version.epoch()) << ChunkType::shard(shard)));
+    }
+
+    unique_ptr<MockRemoteDBServer> _dummyConfig;
+    CollectionMetadata _metadata;
+    int _savedSamplingInterval;
+};
+
+TEST_F(ChunkLoadTrackerFixture, ReportsEveryOwnedChunk) {
+    ChunkLoadTracker tracker;
+    vector<BSONObj> chunks = report(&tracker);
+    ASSERT_EQUALS(2u, chunks.size());
+
+    ASSERT_EQUALS(BSON("min" << BSON("a" << MINKEY) << "max" << BSON("a" << 10) << "reads" << 0LL
+                             << "writes" << 0LL << "bytes" << 0LL),
+                  chunks[0]);
+    ASSERT_EQUALS(BSON("a" << 30), chunks[1]["min"].Obj());
+    ASSERT_EQUALS(BSON("a" << MAXKEY), chunks[1]["max"].Obj());
+}
+
+TEST_F(ChunkLoadTrackerFixture, AttributesOperationsToChunks) {
+    ChunkLoadTracker tracker;
+    tracker.noteRead("x.y", getCollMetadata(), BSON("a" << 5));
+    tracker.noteRead("x.y", getCollMetadata(), BSON("a" << 40));
+    tracker.noteRead("x.y", getCollMetadata(), BSON("a" << 41));
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 1000), 100);
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 30), 0);
+
+    vector<BSONObj> chunks = report(&tracker);
+    ASSERT_EQUALS(2u, chunks.size());
+    ASSERT_EQUALS(1, chunks[0]["reads"].numberLong());
+    ASSERT_EQUALS(0, chunks[0]["writes"].numberLong());
+    ASSERT_EQUALS(0, chunks[0]["bytes"].numberLong());
+    ASSERT_EQUALS(2, chunks[1]["reads"].numberLong());
+    ASSERT_EQUALS(2, chunks[1]["writes"].numberLong());
+    ASSERT_EQUALS(100, chunks[1]["bytes"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, IgnoresKeysNotOwned) {
+    ChunkLoadTracker tracker;
+    tracker.noteRead("x.y", getCollMetadata(), BSON("a" << 10));
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 29), 50);
+    tracker.noteWrite("x.y", getCollMetadata(), BSONObj(), 50);
+
+    for (const auto& chunk : report(&tracker)) {
+        ASSERT_EQUALS(0, chunk["reads"].numberLong());
+        ASSERT_EQUALS(0, chunk["writes"].numberLong());
+        ASSERT_EQUALS(0, chunk["bytes"].numberLong());
+    }
+}
+
+TEST_F(ChunkLoadTrackerFixture, OperationCountsDecayOverTime) {
+    ClockSourceMock clock;
+    clock.reset(Date_t::now());
+
+    ChunkLoadTracker tracker;
+    tracker.setClockSource(&clock);
+    for (int i = 0; i < 8; i++) {
+        tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << i), 10);
+    }
+
+    // Reporting does not decay the counters
+    ASSERT_EQUALS(8, report(&tracker)[0]["writes"].numberLong());
+    ASSERT_EQUALS(8, report(&tracker)[0]["writes"].numberLong());
+
+    clock.advance(Seconds(60));
+    ASSERT_EQUALS(4, report(&tracker)[0]["writes"].numberLong());
+
+    clock.advance(Seconds(30));
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 0), 0);
+    ASSERT_EQUALS(5, report(&tracker)[0]["writes"].numberLong());
+
+    clock.advance(Seconds(60));
+    ASSERT_EQUALS(2, report(&tracker)[0]["writes"].numberLong());
+
+    // The size estimate does not decay
+    ASSERT_EQUALS(80, report(&tracker)[0]["bytes"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, SpreadsUntrackedBytesAcrossChunks) {
+    ChunkLoadTracker tracker;
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 50), 100);
+
+    vector<BSONObj> chunks = report(&tracker, 300);
+    ASSERT_EQUALS(2u, chunks.size());
+    ASSERT_EQUALS(100, chunks[0]["bytes"].numberLong());
+    ASSERT_EQUALS(200, chunks[1]["bytes"].numberLong());
+
+    // A stale collection size smaller than the tracked bytes is ignored
+    chunks = report(&tracker, 50);
+    ASSERT_EQUALS(0, chunks[0]["bytes"].numberLong());
+    ASSERT_EQUALS(100, chunks[1]["bytes"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, SamplingWeightsRecordedOperations) {
+    chunkLoadSamplingInterval.store(4);
+
+    ChunkLoadTracker tracker;
+    int sampled = 0;
+    for (unsigned int opId = 0; opId < 16; opId++) {
+        if (ChunkLoadTracker::shouldSample(opId)) {
+            sampled++;
+            tracker.noteRead("x.y", getCollMetadata(), BSON("a" << 0));
+        }
+    }
+
+    ASSERT_EQUALS(4, sampled);
+    ASSERT_EQUALS(16, report(&tracker)[0]["reads"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, ZeroIntervalDisablesSampling) {
+    chunkLoadSamplingInterval.store(0);
+
+    for (unsigned int opId = 0; opId < 16; opId++) {
+        ASSERT_FALSE(ChunkLoadTracker::shouldSample(opId));
+    }
+}
+
+TEST_F(ChunkLoadTrackerFixture, SplitSpreadsStatisticsAcrossChunks) {
+    ChunkLoadTracker tracker;
+    for (int i = 0; i < 4; i++) {
+        tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << i), 10);
+    }
+
+    ChunkVersion version = getCollMetadata().getCollVersion();
+    version.incMinor();
+
+    ChunkType chunk;
+    chunk.setMin(BSON("a" << MINKEY));
+    chunk.setMax(BSON("a" << 10));
+
+    vector<BSONObj> splitKeys{BSON("a" << 5)};
+
+    string errMsg;
+    unique_ptr<CollectionMetadata> split(
+        getCollMetadata().cloneSplit(chunk, splitKeys, version, &errMsg));
+    ASSERT(split);
+
+    tracker.splitChunk("x.y", chunk.getMin(), splitKeys);
+
+    vector<BSONObj> chunks = report(&tracker, *split, 0);
+    ASSERT_EQUALS(3u, chunks.size());
+    ASSERT_EQUALS(2, chunks[0]["writes"].numberLong());
+    ASSERT_EQUALS(20, chunks[0]["bytes"].numberLong());
+    ASSERT_EQUALS(BSON("a" << 5), chunks[1]["min"].Obj());
+    ASSERT_EQUALS(2, chunks[1]["writes"].numberLong());
+    ASSERT_EQUALS(20, chunks[1]["bytes"].numberLong());
+    ASSERT_EQUALS(0, chunks[2]["writes"].numberLong());
+
+    // Merging the chunks back adds their statistics up again
+    tracker.mergeChunks("x.y", BSON("a" << MINKEY), BSON("a" << 10));
+
+    chunks = report(&tracker);
+    ASSERT_EQUALS(4, chunks[0]["writes"].numberLong());
+    ASSERT_EQUALS(40, chunks[0]["bytes"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, ForgetRangeDiscardsDonatedChunks) {
+    ChunkLoadTracker tracker;
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 0), 10);
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 40), 10);
+    tracker.forgetRange("x.y", BSON("a" << MINKEY), BSON("a" << 10));
+
+    vector<BSONObj> chunks = report(&tracker);
+    ASSERT_EQUALS(0, chunks[0]["writes"].numberLong());
+    ASSERT_EQUALS(1, chunks[1]["writes"].numberLong());
+}
+
+TEST_F(ChunkLoadTrackerFixture, ClearDiscardsStatistics) {
+    ChunkLoadTracker tracker;
+    tracker.noteWrite("x.y", getCollMetadata(), BSON("a" << 0), 10);
+    tracker.clear("x.y");
+
+    ASSERT_EQUALS(0, report(&tracker)[0]["bytes"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,377 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_split_sketch.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+bool keyLess(const BSONObj& lhs, const BSONObj& rhs) {
+    return lhs.woCompare(rhs) < 0;
+}
+
+/**
+ * Returns the samples which fall into [min, max).
+ */
+std::vector<BSONObj> samplesInRange(const std::vector<BSONObj>& samples,
+                                    const BSONObj& min,
+                                    const BSONObj& max) {
+    std::vector<BSONObj> inRange;
+    for (const BSONObj& sample : samples) {
+        if (sample.woCompare(min) >= 0 && sample.woCompare(max) < 0) {
+            inRange.push_back(sample);
+        }
+    }
+    return inRange;
+}
+
+}  // namespace
+
+MONGO_EXPORT_SERVER_PARAMETER(chunkSplitSketchSamplingInterval, int, 10);
+
+const size_t ChunkSplitSketches::kMaxSamples;
+
+ChunkSplitSketches::Builder::Builder(int64_t seed) : _random(seed) {}
+
+void ChunkSplitSketches::Builder::addKey(const BSONObj& shardKey) {
+    _numKeys++;
+
+    // Reservoir sampling: every key seen so far is in the sample with the same probability
+    if (_samples.size() < kMaxSamples) {
+        _samples.push_back(shardKey.getOwned());
+        return;
+    }
+
+    const long long slot = _random.nextInt64(_numKeys);
+    if (slot < static_cast<long long>(kMaxSamples)) {
+        _samples[slot] = shardKey.getOwned();
+    }
+}
+
+ChunkSplitSketches::ChunkSplitSketches()
+    : ChunkSplitSketches(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {}
+
+ChunkSplitSketches::ChunkSplitSketches(int64_t seed) : _random(seed) {}
+
+ChunkSplitSketches::~ChunkSplitSketches() = default;
+
+bool ChunkSplitSketches::shouldSample(unsigned int opId) {
+    const int interval = chunkSplitSketchSamplingInterval.load();
+    if (interval <= 0) {
+        return false;
+    }
+
+    return opId % static_cast<unsigned>(interval) == 0;
+}
+
+long long ChunkSplitSketches::sampleWeight() {
+    return std::max(chunkSplitSketchSamplingInterval.load(), 1);
+}
+
+void ChunkSplitSketches::install(const std::string& ns,
+                                 const OID& epoch,
+                                 const BSONObj& min,
+                                 const BSONObj& max,
+                                 const Builder& builder) {
+    Sketch sketch;
+    sketch.max = max.getOwned();
+    sketch.numRecords = builder._numKeys;
+    sketch.numSeen = builder._numKeys;
+    sketch.samples = builder._samples;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    CollectionSketches* collection = _getCollection_inlock(ns, epoch);
+    if (!collection) {
+        collection = &_collections[ns];
+        collection->epoch = epoch;
+    }
+
+    _carve_inlock(collection, min, max);
+    collection->sketches[min.getOwned()] = std::move(sketch);
+}
+
+void ChunkSplitSketches::noteInsert(const std::string& ns,
+                                    const OID& epoch,
+                                    const BSONObj& shardKey,
+                                    long long weight) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    Sketch* sketch = _findSketch_inlock(ns, epoch, shardKey);
+    if (!sketch) {
+        return;
+    }
+
+    sketch->numRecords += weight;
+    sketch->numSeen += weight;
+
+    // A weighted insert stands for 'weight' records, so it replaces a sampled key with the
+    // probability that any of those records would have been sampled
+    if (sketch->samples.size() < kMaxSamples) {
+        sketch->samples.push_back(shardKey.getOwned());
+        return;
+    }
+
+    const double keepProbability = kMaxSamples * weight / sketch->numSeen;
+    if (keepProbability >= 1.0 || _random.nextCanonicalDouble() < keepProbability) {
+        sketch->samples[_random.nextInt32(kMaxSamples)] = shardKey.getOwned();
+    }
+}
+
+void ChunkSplitSketches::noteDelete(const std::string& ns,
+                                    const OID& epoch,
+                                    const BSONObj& shardKey,
+                                    long long weight) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    Sketch* sketch = _findSketch_inlock(ns, epoch, shardKey);
+    if (!sketch) {
+        return;
+    }
+
+    sketch->numRecords = std::max(sketch->numRecords - weight, 0.0);
+    sketch->numSeen = std::max(sketch->numSeen - weight, 0.0);
+
+    // Keys are not unique, so dropping any one sample equal to the deleted key will do
+    for (size_t i = 0; i < sketch->samples.size(); i++) {
+        if (sketch->samples[i].woCompare(shardKey) == 0) {
+            sketch->samples[i] = sketch->samples.back();
+            sketch->samples.pop_back();
+            break;
+        }
+    }
+}
+
+bool ChunkSplitSketches::estimate(const std::string& ns,
+                                  const OID& epoch,
+                                  const BSONObj& min,
+                                  const BSONObj& max,
+                                  Estimate* estimate) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    CollectionSketches* collection = _getCollection_inlock(ns, epoch);
+    if (!collection) {
+        return false;
+    }
+
+    SketchMap::const_iterator it = collection->sketches.upper_bound(min);
+    if (it == collection->sketches.begin()) {
+        return false;
+    }
+
+    --it;
+    const Sketch& sketch = it->second;
+    if (sketch.max.woCompare(max) < 0) {
+        return false;
+    }
+
+    estimate->sortedSamples = samplesInRange(sketch.samples, min, max);
+    std::sort(estimate->sortedSamples.begin(), estimate->sortedSamples.end(), keyLess);
+
+    if (sketch.samples.empty()) {
+        estimate->numRecords = sketch.numRecords;
+    } else {
+        estimate->numRecords =
+            sketch.numRecords * estimate->sortedSamples.size() / sketch.samples.size();
+    }
+
+    return true;
+}
+
+void ChunkSplitSketches::forgetRange(const std::string& ns,
+                                     const BSONObj& min,
+                                     const BSONObj& max) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto collIt = _collections.find(ns);
+    if (collIt == _collections.end()) {
+        return;
+    }
+
+    SketchMap& sketches = collIt->second.sketches;
+    SketchMap::iterator it = sketches.upper_bound(min);
+    if (it != sketches.begin()) {
+        --it;
+    }
+
+    while (it != sketches.end() && it->first.woCompare(max) < 0) {
+        if (it->second.max.woCompare(min) > 0) {
+            it = sketches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ChunkSplitSketches::clear(const std::string& ns) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _collections.erase(ns);
+}
+
+bool ChunkSplitSketches::pickSplitPoints(const Estimate& estimate,
+                                         const BSONObj& min,
+                                         long long keyCount,
+                                         long long maxSplitPoints,
+                                         bool median,
+                                         std::vector<BSONObj>* splitPoints) {
+    const std::vector<BSONObj>& samples = estimate.sortedSamples;
+
+    if (median) {
+        for (size_t i = samples.size() / 2; i < samples.size(); i++) {
+            if (samples[i].woCompare(min) > 0) {
+                splitPoints->push_back(samples[i]);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if (keyCount <= 0 || estimate.numRecords <= keyCount) {
+        return true;
+    }
+
+    // Number of samples which stand for 'keyCount' records. With fewer than two samples per
+    // chunk the split points would be little better than guesses.
+    const double samplesPerChunk = keyCount * samples.size() / estimate.numRecords;
+    if (samplesPerChunk < 2) {
+        return false;
+    }
+
+    for (double pos = samplesPerChunk; pos < samples.size(); pos += samplesPerChunk) {
+        const BSONObj& key = samples[static_cast<size_t>(pos)];
+        if (key.woCompare(min) <= 0) {
+            continue;
+        }
+
+        if (!splitPoints->empty() && key.woCompare(splitPoints->back()) == 0) {
+            continue;
+        }
+
+        splitPoints->push_back(key);
+
+        if (maxSplitPoints && static_cast<long long>(splitPoints->size()) >= maxSplitPoints) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+ChunkSplitSketches::CollectionSketches* ChunkSplitSketches::_getCollection_inlock(
+    const std::string& ns, const OID& epoch) {
+    auto it = _collections.find(ns);
+    if (it == _collections.end()) {
+        return NULL;
+    }
+
+    if (it->second.epoch != epoch) {
+        // The collection was dropped and sharded again since the sketches were built
+        _collections.erase(it);
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+ChunkSplitSketches::Sketch* ChunkSplitSketches::_findSketch_inlock(const std::string& ns,
+                                                                   const OID& epoch,
+                                                                   const BSONObj& shardKey) {
+    CollectionSketches* collection = _getCollection_inlock(ns, epoch);
+    if (!collection) {
+        return NULL;
+    }
+
+    SketchMap::iterator it = collection->sketches.upper_bound(shardKey);
+    if (it == collection->sketches.begin()) {
+        return NULL;
+    }
+
+    --it;
+    if (shardKey.woCompare(it->second.max) >= 0) {
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+void ChunkSplitSketches::_carve_inlock(CollectionSketches* collection,
+                                       const BSONObj& min,
+                                       const BSONObj& max) {
+    SketchMap& sketches = collection->sketches;
+
+    SketchMap::iterator it = sketches.upper_bound(min);
+    if (it != sketches.begin()) {
+        --it;
+    }
+
+    SketchMap remnants;
+    while (it != sketches.end() && it->first.woCompare(max) < 0) {
+        const Sketch& sketch = it->second;
+        if (sketch.max.woCompare(min) <= 0) {
+            ++it;
+            continue;
+        }
+
+        // Keep the parts of the sketch to the left and to the right of [min, max)
+        const BSONObj pieces[2][2] = {{it->first, min}, {max, sketch.max}};
+        for (const auto& piece : pieces) {
+            if (piece[0].woCompare(piece[1]) >= 0) {
+                continue;
+            }
+
+            Sketch remnant;
+            remnant.max = piece[1];
+            remnant.samples = samplesInRange(sketch.samples, piece[0], piece[1]);
+
+            const double fraction = sketch.samples.empty()
+                ? 0.0
+                : static_cast<double>(remnant.samples.size()) / sketch.samples.size();
+            remnant.numRecords = sketch.numRecords * fraction;
+            remnant.numSeen = sketch.numSeen * fraction;
+
+            remnants[piece[0]] = std::move(remnant);
+        }
+
+        it = sketches.erase(it);
+    }
+
+    for (auto& remnant : remnants) {
+        sketches[remnant.first] = std::move(remnant.second);
+    }
+}
+
+}  // namespace mongo
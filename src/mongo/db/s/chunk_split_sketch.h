@@ -0,0 +1,223 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+// Record one in this many inserts and deletes against sharded collections in the split point
+// sketches; 0 disables the sketches, so that splitVector always scans the shard key index.
+extern std::atomic<int> chunkSplitSketchSamplingInterval;  // NOLINT
+
+/**
+ * Approximate size and key distribution sketches for the chunks of sharded collections owned by
+ * this shard, which let splitVector pick split points without scanning the shard key index.
+ *
+ * A sketch of a key range holds an estimated record count and a uniform sample of at most
+ * kMaxSamples shard keys from that range. It is built by a full splitVector scan and is then kept
+ * up to date by sampled inserts and deletes, so later requests for the range, or for any part of
+ * it after the chunk was split, are answered from the sample. A sampled delete takes its key out
+ * of the sample if it is there, but otherwise leaves the sample as it is, so after heavy deletes
+ * the sample still reflects keys which are gone until the range is scanned again. Sketches are
+ * discarded when their range is donated to another shard or the collection epoch changes.
+ *
+ * Thread safe.
+ */
+class ChunkSplitSketches {
+    MONGO_DISALLOW_COPYING(ChunkSplitSketches);
+
+public:
+    // Maximum number of keys sampled per sketch
+    static const size_t kMaxSamples = 256;
+
+    /**
+     * What a sketch knows about a key range: the estimated number of records in it and the
+     * sampled keys which fall into it, in ascending order.
+     */
+    struct Estimate {
+        double numRecords{0};
+        std::vector<BSONObj> sortedSamples;
+    };
+
+    /**
+     * Accumulates a uniform sample of the keys seen by a full index scan over a range.
+     */
+    class Builder {
+    public:
+        explicit Builder(int64_t seed);
+
+        void addKey(const BSONObj& shardKey);
+
+    private:
+        friend class ChunkSplitSketches;
+
+        PseudoRandom _random;
+        long long _numKeys{0};
+        std::vector<BSONObj> _samples;
+    };
+
+    ChunkSplitSketches();
+    explicit ChunkSplitSketches(int64_t seed);
+    ~ChunkSplitSketches();
+
+    /**
+     * Returns true if the inserts and deletes done by the operation with id 'opId' should be
+     * recorded through noteInsert and noteDelete, with the weight returned by sampleWeight.
+     */
+    static bool shouldSample(unsigned int opId);
+
+    /**
+     * Returns the number of records each sampled insert or delete stands for.
+     */
+    static long long sampleWeight();
+
+    /**
+     * Replaces whatever is known about [min, max) of collection 'ns' with the keys collected by a
+     * full scan of that range. Older sketches which overlap the range keep their other parts.
+     */
+    void install(const std::string& ns,
+                 const OID& epoch,
+                 const BSONObj& min,
+                 const BSONObj& max,
+                 const Builder& builder);
+
+    /**
+     * Accounts for 'weight' newly inserted records with shard key 'shardKey', if a sketch covers
+     * that key.
+     */
+    void noteInsert(const std::string& ns,
+                    const OID& epoch,
+                    const BSONObj& shardKey,
+                    long long weight);
+
+    /**
+     * Accounts for 'weight' deleted records with shard key 'shardKey', if a sketch covers that
+     * key.
+     */
+    void noteDelete(const std::string& ns,
+                    const OID& epoch,
+                    const BSONObj& shardKey,
+                    long long weight);
+
+    /**
+     * Fills out 'estimate' for [min, max) if a single sketch covers the whole range. Returns false
+     * if the range is not covered, in which case it needs to be scanned.
+     */
+    bool estimate(const std::string& ns,
+                  const OID& epoch,
+                  const BSONObj& min,
+                  const BSONObj& max,
+                  Estimate* estimate);
+
+    /**
+     * Discards every sketch which overlaps [min, max) of 'ns', because the data in that range is
+     * about to change outside of the inserts we observe, for example when the chunk is donated.
+     */
+    void forgetRange(const std::string& ns, const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Discards all sketches for 'ns'.
+     */
+    void clear(const std::string& ns);
+
+    /**
+     * Picks split points for a range from its estimate, in the same way splitVector picks them
+     * from a scan: one every 'keyCount' records, never 'min' itself and never the same key twice,
+     * up to 'maxSplitPoints' if that is non-zero. If 'median' is true a single split point in the
+     * middle of the range is picked instead.
+     *
+     * Returns false if the sample is too coarse to place the split points, in which case the range
+     * needs to be scanned.
+     */
+    static bool pickSplitPoints(const Estimate& estimate,
+                                const BSONObj& min,
+                                long long keyCount,
+                                long long maxSplitPoints,
+                                bool median,
+                                std::vector<BSONObj>* splitPoints);
+
+private:
+    struct Sketch {
+        BSONObj max;
+        double numRecords{0};
+
+        // Weighted number of records the sample was drawn from
+        double numSeen{0};
+
+        std::vector<BSONObj> samples;
+    };
+
+    // Sketch min key to the sketch of the range starting there
+    typedef std::map<BSONObj, Sketch, BSONObjCmp> SketchMap;
+
+    struct CollectionSketches {
+        OID epoch;
+        SketchMap sketches;
+    };
+
+    /**
+     * Returns the sketches of 'ns' if they were built for collection epoch 'epoch', discarding
+     * them otherwise. Returns NULL if there are none.
+     */
+    CollectionSketches* _getCollection_inlock(const std::string& ns, const OID& epoch);
+
+    /**
+     * Returns the sketch of 'ns' which covers 'shardKey', or NULL if there is none.
+     */
+    Sketch* _findSketch_inlock(const std::string& ns, const OID& epoch, const BSONObj& shardKey);
+
+    /**
+     * Removes [min, max) from the sketches of 'collection'. Sketches which only partially overlap
+     * the range are trimmed, keeping a proportional part of their record count.
+     */
+    static void _carve_inlock(CollectionSketches* collection,
+                              const BSONObj& min,
+                              const BSONObj& max);
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    PseudoRandom _random;
+
+    std::map<std::string, CollectionSketches> _collections;
+};
+
+}  // namespace mongo
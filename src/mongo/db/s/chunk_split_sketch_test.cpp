@@ -0,0 +1,242 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/s/chunk_split_sketch.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::vector;
+
+const std::string kNs = "test.foo";
+
+/**
+ * Returns a builder which has seen the keys { a: first } ... { a: last - 1 }.
+ */
+ChunkSplitSketches::Builder scanKeys(int first, int last) {
+    ChunkSplitSketches::Builder builder(1);
+    for (int i = first; i < last; i++) {
+        builder.addKey(BSON("a" << i));
+    }
+    return builder;
+}
+
+TEST(ChunkSplitSketches, UnknownRangeIsNotEstimated) {
+    ChunkSplitSketches sketches(1);
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT_FALSE(
+        sketches.estimate(kNs, OID::gen(), BSON("a" << MINKEY), BSON("a" << MAXKEY), &estimate));
+}
+
+TEST(ChunkSplitSketches, SmallRangeIsExact) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 100));
+
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+    ASSERT_EQUALS(100, estimate.numRecords);
+    ASSERT_EQUALS(100u, estimate.sortedSamples.size());
+    ASSERT_EQUALS(BSON("a" << 0), estimate.sortedSamples.front());
+    ASSERT_EQUALS(BSON("a" << 99), estimate.sortedSamples.back());
+
+    // Any part of the range is covered as well
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 50), BSON("a" << 75), &estimate));
+    ASSERT_EQUALS(25, estimate.numRecords);
+
+    // But not a range extending past it
+    ASSERT_FALSE(sketches.estimate(kNs, epoch, BSON("a" << 50), BSON("a" << 150), &estimate));
+}
+
+TEST(ChunkSplitSketches, LargeRangeIsSampled) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << MINKEY), BSON("a" << MAXKEY), scanKeys(0, 100000));
+
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << MINKEY), BSON("a" << MAXKEY), &estimate));
+    ASSERT_EQUALS(100000, estimate.numRecords);
+    ASSERT_EQUALS(ChunkSplitSketches::kMaxSamples, estimate.sortedSamples.size());
+
+    // Half of the keys are below 50000, give or take the sampling error
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << MINKEY), BSON("a" << 50000), &estimate));
+    ASSERT_GREATER_THAN(estimate.numRecords, 35000);
+    ASSERT_LESS_THAN(estimate.numRecords, 65000);
+}
+
+TEST(ChunkSplitSketches, InsertsUpdateSketch) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 10));
+
+    sketches.noteInsert(kNs, epoch, BSON("a" << 50), 4);
+    sketches.noteInsert(kNs, epoch, BSON("a" << 150), 4);
+    sketches.noteInsert(kNs, OID::gen(), BSON("a" << 50), 4);
+
+    // The insert outside of the range is ignored, the one with another epoch discards the sketch
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT_FALSE(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 10));
+    sketches.noteInsert(kNs, epoch, BSON("a" << 50), 4);
+    sketches.noteInsert(kNs, epoch, BSON("a" << 150), 4);
+
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+    ASSERT_EQUALS(14, estimate.numRecords);
+    ASSERT_EQUALS(11u, estimate.sortedSamples.size());
+    ASSERT_EQUALS(BSON("a" << 50), estimate.sortedSamples.back());
+}
+
+TEST(ChunkSplitSketches, DeletesUpdateSketch) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 10));
+
+    sketches.noteDelete(kNs, epoch, BSON("a" << 9), 4);
+    sketches.noteDelete(kNs, epoch, BSON("a" << 150), 4);
+
+    // The deleted key leaves the sample, the delete outside of the range is ignored
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+    ASSERT_EQUALS(6, estimate.numRecords);
+    ASSERT_EQUALS(9u, estimate.sortedSamples.size());
+    ASSERT_EQUALS(BSON("a" << 8), estimate.sortedSamples.back());
+
+    // The estimate never drops below zero
+    sketches.noteDelete(kNs, epoch, BSON("a" << 0), 16);
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+    ASSERT_EQUALS(0, estimate.numRecords);
+}
+
+TEST(ChunkSplitSketches, InstallCarvesOverlappingSketch) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 100));
+    sketches.install(kNs, epoch, BSON("a" << 40), BSON("a" << 60), scanKeys(40, 50));
+
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 40), &estimate));
+    ASSERT_EQUALS(40, estimate.numRecords);
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 40), BSON("a" << 60), &estimate));
+    ASSERT_EQUALS(10, estimate.numRecords);
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 60), BSON("a" << 100), &estimate));
+    ASSERT_EQUALS(40, estimate.numRecords);
+
+    // The remnants do not cover ranges across the new sketch
+    ASSERT_FALSE(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+}
+
+TEST(ChunkSplitSketches, ForgetRangeDiscardsOverlappingSketches) {
+    ChunkSplitSketches sketches(1);
+    const OID epoch = OID::gen();
+    sketches.install(kNs, epoch, BSON("a" << 0), BSON("a" << 100), scanKeys(0, 100));
+    sketches.install(kNs, epoch, BSON("a" << 100), BSON("a" << 200), scanKeys(100, 200));
+
+    sketches.forgetRange(kNs, BSON("a" << 150), BSON("a" << 160));
+
+    ChunkSplitSketches::Estimate estimate;
+    ASSERT(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+    ASSERT_FALSE(sketches.estimate(kNs, epoch, BSON("a" << 100), BSON("a" << 150), &estimate));
+
+    sketches.clear(kNs);
+    ASSERT_FALSE(sketches.estimate(kNs, epoch, BSON("a" << 0), BSON("a" << 100), &estimate));
+}
+
+TEST(ChunkSplitSketches, PickSplitPointsEveryKeyCount) {
+    ChunkSplitSketches::Estimate estimate;
+    estimate.numRecords = 1000;
+    for (int i = 0; i < 100; i++) {
+        estimate.sortedSamples.push_back(BSON("a" << i * 10));
+    }
+
+    vector<BSONObj> splitPoints;
+    ASSERT(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 250, 0, false, &splitPoints));
+    ASSERT_EQUALS(3u, splitPoints.size());
+    ASSERT_EQUALS(BSON("a" << 250), splitPoints[0]);
+    ASSERT_EQUALS(BSON("a" << 500), splitPoints[1]);
+    ASSERT_EQUALS(BSON("a" << 750), splitPoints[2]);
+
+    splitPoints.clear();
+    ASSERT(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 250, 2, false, &splitPoints));
+    ASSERT_EQUALS(2u, splitPoints.size());
+
+    splitPoints.clear();
+    ASSERT(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 0, 0, true, &splitPoints));
+    ASSERT_EQUALS(1u, splitPoints.size());
+    ASSERT_EQUALS(BSON("a" << 500), splitPoints[0]);
+}
+
+TEST(ChunkSplitSketches, PickSplitPointsSmallRange) {
+    ChunkSplitSketches::Estimate estimate;
+    estimate.numRecords = 100;
+    estimate.sortedSamples.push_back(BSON("a" << 1));
+
+    vector<BSONObj> splitPoints;
+    ASSERT(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 250, 0, false, &splitPoints));
+    ASSERT(splitPoints.empty());
+}
+
+TEST(ChunkSplitSketches, PickSplitPointsSkipsRepeatedKeys) {
+    ChunkSplitSketches::Estimate estimate;
+    estimate.numRecords = 100;
+    for (int i = 0; i < 100; i++) {
+        estimate.sortedSamples.push_back(BSON("a" << (i < 80 ? 0 : i)));
+    }
+
+    vector<BSONObj> splitPoints;
+    ASSERT(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 20, 0, false, &splitPoints));
+    ASSERT_EQUALS(1u, splitPoints.size());
+    ASSERT_EQUALS(BSON("a" << 80), splitPoints[0]);
+}
+
+TEST(ChunkSplitSketches, PickSplitPointsNeedsEnoughSamples) {
+    ChunkSplitSketches::Estimate estimate;
+    estimate.numRecords = 1000000;
+    for (int i = 0; i < 256; i++) {
+        estimate.sortedSamples.push_back(BSON("a" << i));
+    }
+
+    // A chunk of 1000 records would be less than one sample
+    vector<BSONObj> splitPoints;
+    ASSERT_FALSE(ChunkSplitSketches::pickSplitPoints(
+        estimate, BSON("a" << 0), 1000, 0, false, &splitPoints));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,7 +40,6 @@
 namespace mongo {
 
 using std::unique_ptr;
-using std::make_pair;
 using std::string;
 using std::vector;
 using str::stream;
@@ -59,14 +58,14 @@ CollectionMetadata* CollectionMetadata::cloneMigrate(const ChunkType& chunk,
     }
 
     // Check that we have the exact chunk that will be subtracted.
-    if (!rangeMapContains(_chunksMap, chunk.getMin(), chunk.getMax())) {
+    if (!_chunksMap.contains(chunk.getMin(), chunk.getMax())) {
         *errMsg = stream() << "cannot remove chunk "
                            << rangeToString(chunk.getMin(), chunk.getMax())
                            << ", this shard does not contain the chunk";
 
-        if (rangeMapOverlaps(_chunksMap, chunk.getMin(), chunk.getMax())) {
+        if (_chunksMap.overlaps(chunk.getMin(), chunk.getMax())) {
             RangeVector overlap;
-            getRangeMapOverlap(_chunksMap, chunk.getMin(), chunk.getMax(), &overlap);
+            _chunksMap.getOverlap(chunk.getMin(), chunk.getMax(), &overlap);
 
             *errMsg += stream() << " and it overlaps " << overlapToString(overlap);
         }
@@ -105,10 +104,10 @@ CollectionMetadata* CollectionMetadata::cloneMigrate(const ChunkType& chunk,
     metadata->fillKeyPatternFields();
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
-    metadata->_chunksMap.erase(chunk.getMin());
+    metadata->_rangesMap = this->_rangesMap;
+    metadata->removeChunk(chunk.getMin(), chunk.getMax());
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -136,9 +135,9 @@ CollectionMetadata* CollectionMetadata::clonePlusChunk(const ChunkType& chunk,
     invariant(chunk.getMin().woCompare(chunk.getMax()) < 0);
 
     // Check that there isn't any chunk on the interval to be added.
-    if (rangeMapOverlaps(_chunksMap, chunk.getMin(), chunk.getMax())) {
+    if (_chunksMap.overlaps(chunk.getMin(), chunk.getMax())) {
         RangeVector overlap;
-        getRangeMapOverlap(_chunksMap, chunk.getMin(), chunk.getMax(), &overlap);
+        _chunksMap.getOverlap(chunk.getMin(), chunk.getMax(), &overlap);
 
         *errMsg = stream() << "cannot add chunk " << rangeToString(chunk.getMin(), chunk.getMax())
                            << " because the chunk overlaps " << overlapToString(overlap);
@@ -153,10 +152,10 @@ CollectionMetadata* CollectionMetadata::clonePlusChunk(const ChunkType& chunk,
     metadata->fillKeyPatternFields();
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
-    metadata->_chunksMap.insert(make_pair(chunk.getMin().getOwned(), chunk.getMax().getOwned()));
+    metadata->_rangesMap = this->_rangesMap;
+    metadata->addChunk(chunk.getMin(), chunk.getMax());
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -171,14 +170,14 @@ CollectionMetadata* CollectionMetadata::cloneMinusPending(const ChunkType& pendi
     }
 
     // Check that we have the exact chunk that will be subtracted.
-    if (!rangeMapContains(_pendingMap, pending.getMin(), pending.getMax())) {
+    if (!_pendingMap.contains(pending.getMin(), pending.getMax())) {
         *errMsg = stream() << "cannot remove pending chunk "
                            << rangeToString(pending.getMin(), pending.getMax())
                            << ", this shard does not contain the chunk";
 
-        if (rangeMapOverlaps(_pendingMap, pending.getMin(), pending.getMax())) {
+        if (_pendingMap.overlaps(pending.getMin(), pending.getMax())) {
             RangeVector overlap;
-            getRangeMapOverlap(_pendingMap, pending.getMin(), pending.getMax(), &overlap);
+            _pendingMap.getOverlap(pending.getMin(), pending.getMax(), &overlap);
 
             *errMsg += stream() << " and it overlaps " << overlapToString(overlap);
         }
@@ -210,9 +209,9 @@ CollectionMetadata* CollectionMetadata::clonePlusPending(const ChunkType& pendin
         errMsg = &dummy;
     }
 
-    if (rangeMapOverlaps(_chunksMap, pending.getMin(), pending.getMax())) {
+    if (_chunksMap.overlaps(pending.getMin(), pending.getMax())) {
         RangeVector overlap;
-        getRangeMapOverlap(_chunksMap, pending.getMin(), pending.getMax(), &overlap);
+        _chunksMap.getOverlap(pending.getMin(), pending.getMax(), &overlap);
 
         *errMsg = stream() << "cannot add pending chunk "
                            << rangeToString(pending.getMin(), pending.getMax())
@@ -238,9 +237,9 @@ CollectionMetadata* CollectionMetadata::clonePlusPending(const ChunkType& pendin
     // We remove any chunks we overlap, the remote request starting a chunk migration must have
     // been authoritative.
 
-    if (rangeMapOverlaps(_pendingMap, pending.getMin(), pending.getMax())) {
+    if (_pendingMap.overlaps(pending.getMin(), pending.getMax())) {
         RangeVector pendingOverlap;
-        getRangeMapOverlap(_pendingMap, pending.getMin(), pending.getMax(), &pendingOverlap);
+        _pendingMap.getOverlap(pending.getMin(), pending.getMax(), &pendingOverlap);
 
         warning() << "new pending chunk " << rangeToString(pending.getMin(), pending.getMax())
                   << " overlaps existing pending chunks " << overlapToString(pendingOverlap)
@@ -251,7 +250,7 @@ CollectionMetadata* CollectionMetadata::clonePlusPending(const ChunkType& pendin
         }
     }
 
-    metadata->_pendingMap.insert(make_pair(pending.getMin(), pending.getMax()));
+    metadata->_pendingMap.insert(pending.getMin(), pending.getMax());
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -285,13 +284,13 @@ CollectionMetadata* CollectionMetadata::cloneSplit(const ChunkType& chunk,
     }
 
     // Check that we have the exact chunk that will be subtracted.
-    if (!rangeMapContains(_chunksMap, chunk.getMin(), chunk.getMax())) {
+    if (!_chunksMap.contains(chunk.getMin(), chunk.getMax())) {
         *errMsg = stream() << "cannot split chunk " << rangeToString(chunk.getMin(), chunk.getMax())
                            << ", this shard does not contain the chunk";
 
-        if (rangeMapOverlaps(_chunksMap, chunk.getMin(), chunk.getMax())) {
+        if (_chunksMap.overlaps(chunk.getMin(), chunk.getMax())) {
             RangeVector overlap;
-            getRangeMapOverlap(_chunksMap, chunk.getMin(), chunk.getMax(), &overlap);
+            _chunksMap.getOverlap(chunk.getMin(), chunk.getMax(), &overlap);
 
             *errMsg += stream() << " and it overlaps " << overlapToString(overlap);
         }
@@ -318,6 +317,7 @@ CollectionMetadata* CollectionMetadata::cloneSplit(const ChunkType& chunk,
     metadata->fillKeyPatternFields();
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
+    metadata->_rangesMap = this->_rangesMap;  // splitting does not change the ranges covered
     metadata->_shardVersion = newShardVersion;  // will increment 2nd, 3rd,... chunks below
 
     BSONObj startKey = chunk.getMin();
@@ -338,15 +338,15 @@ CollectionMetadata* CollectionMetadata::cloneSplit(const ChunkType& chunk,
             ss << "]";
             uasserted(28821, ss.str());
         }
-        metadata->_chunksMap[startKey] = split.getOwned();
-        metadata->_chunksMap.insert(make_pair(split.getOwned(), chunk.getMax().getOwned()));
+        metadata->_chunksMap.erase(startKey);
+        metadata->_chunksMap.insert(startKey, split);
+        metadata->_chunksMap.insert(split, chunk.getMax());
         metadata->_shardVersion.incMinor();
         startKey = split;
     }
 
     metadata->_collVersion =
         metadata->_shardVersion > _collVersion ? metadata->_shardVersion : _collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -366,7 +366,7 @@ CollectionMetadata* CollectionMetadata::cloneMerge(const BSONObj& minKey,
     }
 
     RangeVector overlap;
-    getRangeMapOverlap(_chunksMap, minKey, maxKey, &overlap);
+    _chunksMap.getOverlap(minKey, maxKey, &overlap);
 
     if (overlap.empty() || overlap.size() == 1) {
         *errMsg = stream() << "cannot merge range " << rangeToString(minKey, maxKey)
@@ -421,7 +421,7 @@ CollectionMetadata* CollectionMetadata::cloneMerge(const BSONObj& minKey,
         metadata->_chunksMap.erase(it->first);
     }
 
-    metadata->_chunksMap.insert(make_pair(minKey, maxKey));
+    metadata->_chunksMap.insert(minKey, maxKey);
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -434,14 +434,11 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
         return true;
     }
 
-    if (_rangesMap.size() <= 0) {
+    PersistentRangeMap::const_iterator it = _rangesMap.floor(key);
+    if (it == _rangesMap.end()) {
         return false;
     }
 
-    RangeMap::const_iterator it = _rangesMap.upper_bound(key);
-    if (it != _rangesMap.begin())
-        it--;
-
     bool good = rangeContains(it->first, it->second, key);
 
 #if 0
@@ -451,7 +448,7 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
             log() << "bad: " << key << " " << it->first << " " << key.woCompare( it->first ) << " "
                   << key.woCompare( it->second );
 
-            for ( RangeMap::const_iterator i = _rangesMap.begin(); i != _rangesMap.end(); ++i ) {
+            for ( auto i = _rangesMap.begin(); i != _rangesMap.end(); ++i ) {
                 log() << "\t" << i->first << "\t" << i->second << "\t";
             }
         }
@@ -466,27 +463,18 @@ bool CollectionMetadata::keyIsPending(const BSONObj& key) const {
         return false;
     }
 
-    if (_pendingMap.size() <= 0) {
+    PersistentRangeMap::const_iterator it = _pendingMap.floor(key);
+    if (it == _pendingMap.end()) {
         return false;
     }
 
-    RangeMap::const_iterator it = _pendingMap.upper_bound(key);
-    if (it != _pendingMap.begin())
-        it--;
-
     bool isPending = rangeContains(it->first, it->second, key);
     return isPending;
 }
 
 bool CollectionMetadata::getNextChunk(const BSONObj& lookupKey, ChunkType* chunk) const {
-    RangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
-    RangeMap::const_iterator lowerChunkIt = upperChunkIt;
-
-    if (upperChunkIt != _chunksMap.begin()) {
-        --lowerChunkIt;
-    } else {
-        lowerChunkIt = _chunksMap.end();
-    }
+    PersistentRangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
+    PersistentRangeMap::const_iterator lowerChunkIt = _chunksMap.floor(lookupKey);
 
     if (lowerChunkIt != _chunksMap.end() && lowerChunkIt->second.woCompare(lookupKey) > 0) {
         chunk->setMin(lowerChunkIt->first);
@@ -513,7 +501,7 @@ void CollectionMetadata::toBSONChunks(BSONArrayBuilder& bb) const {
     if (_chunksMap.empty())
         return;
 
-    for (RangeMap::const_iterator it = _chunksMap.begin(); it != _chunksMap.end(); ++it) {
+    for (auto it = _chunksMap.begin(); it != _chunksMap.end(); ++it) {
         BSONArrayBuilder chunkBB(bb.subarrayStart());
         chunkBB.append(it->first);
         chunkBB.append(it->second);
@@ -525,7 +513,7 @@ void CollectionMetadata::toBSONPending(BSONArrayBuilder& bb) const {
     if (_pendingMap.empty())
         return;
 
-    for (RangeMap::const_iterator it = _pendingMap.begin(); it != _pendingMap.end(); ++it) {
+    for (auto it = _pendingMap.begin(); it != _pendingMap.end(); ++it) {
         BSONArrayBuilder pendingBB(bb.subarrayStart());
         pendingBB.append(it->first);
         pendingBB.append(it->second);
@@ -554,17 +542,8 @@ bool CollectionMetadata::getNextOrphanRange(const BSONObj& origLookupKey, KeyRan
     BSONObj lookupKey = origLookupKey;
     BSONObj maxKey = getMaxKey();  // so we don't keep rebuilding
     while (lookupKey.woCompare(maxKey) < 0) {
-        RangeMap::const_iterator lowerChunkIt = _chunksMap.end();
-        RangeMap::const_iterator upperChunkIt = _chunksMap.end();
-
-        if (!_chunksMap.empty()) {
-            upperChunkIt = _chunksMap.upper_bound(lookupKey);
-            lowerChunkIt = upperChunkIt;
-            if (upperChunkIt != _chunksMap.begin())
-                --lowerChunkIt;
-            else
-                lowerChunkIt = _chunksMap.end();
-        }
+        PersistentRangeMap::const_iterator lowerChunkIt = _chunksMap.floor(lookupKey);
+        PersistentRangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
 
         // If we overlap, continue after the overlap
         // TODO: Could optimize slightly by finding next non-contiguous chunk
@@ -573,17 +552,8 @@ bool CollectionMetadata::getNextOrphanRange(const BSONObj& origLookupKey, KeyRan
             continue;
         }
 
-        RangeMap::const_iterator lowerPendingIt = _pendingMap.end();
-        RangeMap::const_iterator upperPendingIt = _pendingMap.end();
-
-        if (!_pendingMap.empty()) {
-            upperPendingIt = _pendingMap.upper_bound(lookupKey);
-            lowerPendingIt = upperPendingIt;
-            if (upperPendingIt != _pendingMap.begin())
-                --lowerPendingIt;
-            else
-                lowerPendingIt = _pendingMap.end();
-        }
+        PersistentRangeMap::const_iterator lowerPendingIt = _pendingMap.floor(lookupKey);
+        PersistentRangeMap::const_iterator upperPendingIt = _pendingMap.upper_bound(lookupKey);
 
         // If we overlap, continue after the overlap
         // TODO: Could optimize slightly by finding next non-contiguous chunk
@@ -634,7 +604,7 @@ string CollectionMetadata::toString() const {
         return ss.str();
     }
 
-    RangeMap::const_iterator it = _rangesMap.begin();
+    PersistentRangeMap::const_iterator it = _rangesMap.begin();
     ss << it->first << " -> " << it->second;
     while (it != _rangesMap.end()) {
         ss << ", " << it->first << " -> " << it->second;
@@ -691,38 +661,57 @@ bool CollectionMetadata::isValidKey(const BSONObj& key) const {
     return key.nFields() == _keyPattern.nFields();
 }
 
-void CollectionMetadata::fillRanges() {
-    if (_chunksMap.empty())
-        return;
+void CollectionMetadata::addChunk(const BSONObj& min, const BSONObj& max) {
+    const bool inserted = _chunksMap.insert(min, max);
+    invariant(inserted);
 
-    // Load the chunk information, coallesceing their ranges.  The version for this shard
-    // would be the highest version for any of the chunks.
-    RangeMap::const_iterator it = _chunksMap.begin();
-    BSONObj min, max;
-    while (it != _chunksMap.end()) {
-        BSONObj currMin = it->first;
-        BSONObj currMax = it->second;
-        ++it;
-
-        // coalesce the chunk's bounds in ranges if they are adjacent chunks
-        if (min.isEmpty()) {
-            min = currMin;
-            max = currMax;
-            continue;
-        }
-        if (max == currMin) {
-            max = currMax;
-            continue;
-        }
+    // Coalesce with the ranges ending at min and starting at max, if there are any
+    BSONObj rangeMin = min;
+    BSONObj rangeMax = max;
+
+    PersistentRangeMap::const_iterator prev = _rangesMap.floor(min);
+    const bool mergePrev = prev != _rangesMap.end() && prev->second.woCompare(min) == 0;
+    if (mergePrev) {
+        rangeMin = prev->first;
+    }
+
+    PersistentRangeMap::const_iterator next = _rangesMap.find(max);
+    const bool mergeNext = next != _rangesMap.end();
+    if (mergeNext) {
+        rangeMax = next->second;
+    }
+
+    if (mergePrev) {
+        _rangesMap.erase(rangeMin);
+    }
+    if (mergeNext) {
+        _rangesMap.erase(max);
+    }
+    _rangesMap.insert(rangeMin, rangeMax);
+}
+
+void CollectionMetadata::removeChunk(const BSONObj& min, const BSONObj& max) {
+    const size_t erased = _chunksMap.erase(min);
+    invariant(erased == 1);
 
-        _rangesMap.insert(make_pair(min, max));
+    PersistentRangeMap::const_iterator range = _rangesMap.floor(min);
+    invariant(range != _rangesMap.end() && range->second.woCompare(max) >= 0);
 
-        min = currMin;
-        max = currMax;
+    const BSONObj rangeMin = range->first;
+    const BSONObj rangeMax = range->second;
+    _rangesMap.erase(rangeMin);
+
+    if (rangeMin.woCompare(min) < 0) {
+        _rangesMap.insert(rangeMin, min);
+    }
+    if (max.woCompare(rangeMax) < 0) {
+        _rangesMap.insert(max, rangeMax);
     }
-    dassert(!min.isEmpty());
+}
 
-    _rangesMap.insert(make_pair(min, max));
+void CollectionMetadata::clearChunks() {
+    _chunksMap.clear();
+    _rangesMap.clear();
 }
 
 void CollectionMetadata::fillKeyPatternFields() {
@@ -34,6 +34,7 @@
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/range_arithmetic.h"
+#include "mongo/db/s/persistent_range_map.h"
 #include "mongo/s/chunk_version.h"
 
 namespace mongo {
@@ -54,7 +55,9 @@ typedef std::shared_ptr<const CollectionMetadata> CollectionMetadataPtr;
  * here allow building a new incarnation of a collection's metadata based on an existing
  * one (e.g, we're splitting in a given collection.).
  *
- * This class is immutable once constructed.
+ * This class is immutable once constructed. Its range maps share structure with those of the
+ * metadata it was cloned from, so the clone*() methods cost time proportional to the number of
+ * chunks they change.
  */
 class CollectionMetadata {
     MONGO_DISALLOW_COPYING(CollectionMetadata);
@@ -284,20 +287,20 @@ private:
     OwnedPointerVector<FieldRef> _keyFields;
 
     //
-    // RangeMaps represent chunks by mapping the min key to the chunk's max key, allowing
+    // Range maps represent chunks by mapping the min key to the chunk's max key, allowing
     // efficient lookup and intersection.
     //
 
     // Map of ranges of chunks that are migrating but have not been confirmed added yet
-    RangeMap _pendingMap;
+    PersistentRangeMap _pendingMap;
 
     // Map of chunks tracked by this shard
-    RangeMap _chunksMap;
+    PersistentRangeMap _chunksMap;
 
     // A second map from a min key into a range or contiguous chunks. The map is redundant
     // w.r.t. _chunkMap but we expect high chunk contiguity, especially in small
     // installations.
-    RangeMap _rangesMap;
+    PersistentRangeMap _rangesMap;
 
     /**
      * Returns true if this metadata was loaded with all necessary information.
@@ -305,9 +308,21 @@ private:
     bool isValid() const;
 
     /**
-     * Try to find chunks that are adjacent and record these intervals in the _rangesMap
+     * Adds the chunk [min, max), which must not overlap any existing chunk, to _chunksMap and
+     * coalesces it into _rangesMap with any adjacent ranges.
      */
-    void fillRanges();
+    void addChunk(const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Removes the existing chunk [min, max) from _chunksMap and carves it out of its range in
+     * _rangesMap.
+     */
+    void removeChunk(const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Removes all chunks.
+     */
+    void clearChunks();
 
     /**
      * Creates the _keyField* local data
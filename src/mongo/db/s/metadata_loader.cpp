@@ -154,9 +154,9 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             versionMap[shard] = oldMetadata->_shardVersion;
             metadata->_collVersion = oldMetadata->_collVersion;
 
-            // TODO: This could be made more efficient if copying not required, but
-            // not as frequently reloaded as in mongos.
+            // The maps share structure with the old metadata, so this does not copy the chunks
             metadata->_chunksMap = oldMetadata->_chunksMap;
+            metadata->_rangesMap = oldMetadata->_rangesMap;
 
             LOG(2) << "loading new chunks for collection " << ns
                    << " using old metadata w/ version " << oldMetadata->getShardVersion() << " and "
@@ -169,10 +169,13 @@ Status MetadataLoader::initChunks(OperationContext* txn,
     }
 
 
-    // Exposes the new metadata's range map and version to the "differ," who
-    // would ultimately be responsible of filling them up.
+    // The "differ" only reads and modifies chunks starting within the bounds of the changed
+    // chunks it is given. Rather than exposing the new metadata's whole chunk map to it, it is
+    // attached to a scratch map which is filled with just those chunks once the changes are known,
+    // and the result is then applied back to the metadata.
+    RangeMap changedChunksMap;
     SCMConfigDiffTracker differ(shard);
-    differ.attach(ns, metadata->_chunksMap, metadata->_collVersion, versionMap);
+    differ.attach(ns, changedChunksMap, metadata->_collVersion, versionMap);
 
     try {
         std::vector<ChunkType> chunks;
@@ -183,11 +186,20 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             if (status == ErrorCodes::HostUnreachable) {
                 // Make our metadata invalid
                 metadata->_collVersion = ChunkVersion(0, 0, OID());
-                metadata->_chunksMap.clear();
+                metadata->clearChunks();
             }
             return status;
         }
 
+        for (const ChunkType& chunk : chunks) {
+            for (auto it = metadata->_chunksMap.lower_bound(chunk.getMin());
+                 it != metadata->_chunksMap.end() && it->first.woCompare(chunk.getMax()) < 0;
+                 ++it) {
+                changedChunksMap.insert(*it);
+            }
+        }
+        const RangeVector oldChangedChunks(changedChunksMap.begin(), changedChunksMap.end());
+
         //
         // The diff tracker should always find at least one chunk (the highest chunk we saw
         // last time).  If not, something has changed on the config server (potentially between
@@ -199,8 +211,14 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             LOG(2) << "loaded " << diffsApplied << " chunks into new metadata for " << ns
                    << " with version " << metadata->_collVersion;
 
+            for (const auto& oldChunk : oldChangedChunks) {
+                metadata->removeChunk(oldChunk.first, oldChunk.second);
+            }
+            for (const auto& newChunk : changedChunksMap) {
+                metadata->addChunk(newChunk.first, newChunk.second);
+            }
+
             metadata->_shardVersion = versionMap[shard];
-            metadata->fillRanges();
 
             invariant(metadata->isValid());
             return Status::OK();
@@ -217,7 +235,7 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             warning() << errMsg;
 
             metadata->_collVersion = ChunkVersion(0, 0, OID());
-            metadata->_chunksMap.clear();
+            metadata->clearChunks();
 
             return fullReload ? Status(ErrorCodes::NamespaceNotFound, errMsg)
                               : Status(ErrorCodes::RemoteChangeDetected, errMsg);
@@ -230,7 +248,7 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             warning() << errMsg;
 
             metadata->_collVersion = ChunkVersion(0, 0, OID());
-            metadata->_chunksMap.clear();
+            metadata->clearChunks();
 
             return Status(ErrorCodes::RemoteChangeDetected, errMsg);
         }
@@ -258,29 +276,27 @@ Status MetadataLoader::promotePendingChunks(const CollectionMetadata* afterMetad
     remoteMetadata->_pendingMap = afterMetadata->_pendingMap;
 
     // Resolve our pending chunks against the chunks we've loaded
-    for (RangeMap::iterator it = remoteMetadata->_pendingMap.begin();
-         it != remoteMetadata->_pendingMap.end();) {
-        if (!rangeMapOverlaps(remoteMetadata->_chunksMap, it->first, it->second)) {
-            ++it;
+    for (const auto& pending : afterMetadata->_pendingMap) {
+        if (!remoteMetadata->_chunksMap.overlaps(pending.first, pending.second)) {
             continue;
         }
 
         // Our pending range overlaps at least one chunk
 
-        if (rangeMapContains(remoteMetadata->_chunksMap, it->first, it->second)) {
+        if (remoteMetadata->_chunksMap.contains(pending.first, pending.second)) {
             // Chunk was promoted from pending, successful migration
-            LOG(2) << "verified chunk " << rangeToString(it->first, it->second)
+            LOG(2) << "verified chunk " << rangeToString(pending.first, pending.second)
                    << " was migrated earlier to this shard";
 
-            remoteMetadata->_pendingMap.erase(it++);
+            remoteMetadata->_pendingMap.erase(pending.first);
         } else {
             // Something strange happened, maybe manual editing of config?
             RangeVector overlap;
-            getRangeMapOverlap(remoteMetadata->_chunksMap, it->first, it->second, &overlap);
+            remoteMetadata->_chunksMap.getOverlap(pending.first, pending.second, &overlap);
 
             string errMsg = str::stream()
                 << "the remote metadata changed unexpectedly, pending range "
-                << rangeToString(it->first, it->second)
+                << rangeToString(pending.first, pending.second)
                 << " does not exactly overlap loaded chunks " << overlapToString(overlap);
 
             return Status(ErrorCodes::RemoteChangeDetected, errMsg);
@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/migration_destination_manager.h"
 
+#include <deque>
 #include <list>
 #include <vector>
 
@@ -43,6 +44,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
@@ -53,6 +55,7 @@
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/db/s/sharded_connection_info.h"
@@ -62,9 +65,12 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -187,6 +193,179 @@ BSONObj createTransferModsRequest(const MigrationSessionId& sessionId) {
     return builder.obj();
 }
 
+// Number of concurrent _migrateClone requests the recipient keeps outstanding to the donor.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneConcurrency, int, 4);
+
+// Maximum number of documents inserted in a single WriteUnitOfWork while cloning.
+const size_t kMaxClonedDocsPerInsert = 100;
+
+/**
+ * Runs several _migrateClone streams against the donor shard concurrently, each on its own
+ * connection, and queues up the responses so that fetching overlaps with inserting the previously
+ * fetched documents on the migration thread. At most one response per stream is queued.
+ */
+class CloneFetcher {
+    MONGO_DISALLOW_COPYING(CloneFetcher);
+
+public:
+    CloneFetcher(const string& fromShard, const BSONObj& migrateCloneRequest, int numStreams)
+        : _fromShard(fromShard),
+          _migrateCloneRequest(migrateCloneRequest),
+          _numStreams(std::max(1, numStreams)) {}
+
+    ~CloneFetcher() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stopped = true;
+            _cv.notify_all();
+        }
+        for (auto& stream : _streams) {
+            stream.join();
+        }
+    }
+
+    void start() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _activeStreams = _numStreams;
+        for (int i = 0; i < _numStreams; i++) {
+            _streams.emplace_back(stdx::bind(&CloneFetcher::_runStream, this, i));
+        }
+    }
+
+    /**
+     * Returns the next _migrateClone response, whose "objects" array is never empty, or an empty
+     * object once every stream has drained the donor. Returns an error if any stream failed.
+     */
+    StatusWith<BSONObj> next() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [this] { return !_responses.empty() || !_status.isOK() || !_activeStreams; });
+        if (!_status.isOK()) {
+            return _status;
+        }
+        if (_responses.empty()) {
+            return BSONObj();
+        }
+
+        BSONObj response = _responses.front();
+        _responses.pop_front();
+        _cv.notify_all();
+        return response;
+    }
+
+private:
+    void _runStream(int streamId) {
+        const string threadName = str::stream() << "migrateCloneFetcher-" << streamId;
+        Client::initThread(threadName.c_str());
+        try {
+            ScopedDbConnection conn(_fromShard);
+            while (true) {
+                BSONObj res;
+                if (!conn->runCommand("admin", _migrateCloneRequest, res)) {
+                    _setStatus(Status(ErrorCodes::OperationFailed,
+                                      str::stream() << "_migrateClone failed: " << res));
+                    conn.done();
+                    break;
+                }
+
+                if (res["objects"].Obj().isEmpty()) {
+                    conn.done();
+                    break;
+                }
+
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _cv.wait(lk,
+                         [this] {
+                             return _stopped || !_status.isOK() ||
+                                 _responses.size() < static_cast<size_t>(_numStreams);
+                         });
+                if (_stopped || !_status.isOK()) {
+                    lk.unlock();
+                    conn.done();
+                    break;
+                }
+                _responses.push_back(res);
+                _cv.notify_all();
+            }
+        } catch (const DBException& e) {
+            _setStatus(e.toStatus());
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _activeStreams--;
+        _cv.notify_all();
+    }
+
+    void _setStatus(const Status& status) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_status.isOK()) {
+            _status = status;
+        }
+        _cv.notify_all();
+    }
+
+    const string _fromShard;
+    const BSONObj _migrateCloneRequest;
+    const int _numStreams;
+
+    std::vector<stdx::thread> _streams;
+
+    // Protects the fields below and signals changes to any of them.
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+
+    std::deque<BSONObj> _responses;
+    int _activeStreams{0};
+    bool _stopped{false};
+    Status _status{Status::OK()};
+};
+
+/**
+ * Inserts documents cloned from the donor shard with a single Collection::insertDocuments call,
+ * falling back to upserting them one at a time if that fails (for example, because a document
+ * with the same _id is already present).
+ */
+void insertClonedDocuments(OperationContext* txn,
+                           const string& ns,
+                           const BSONObj& min,
+                           const BSONObj& max,
+                           const BSONObj& shardKeyPattern,
+                           std::vector<BSONObj>::const_iterator begin,
+                           std::vector<BSONObj>::const_iterator end) {
+    OldClientWriteContext cx(txn, ns);
+
+    for (auto it = begin; it != end; ++it) {
+        BSONObj localDoc;
+        if (willOverrideLocalId(txn, ns, min, max, shardKeyPattern, cx.db(), *it, &localDoc)) {
+            string errMsg = str::stream() << "cannot migrate chunk, local document " << localDoc
+                                          << " has same _id as cloned "
+                                          << "remote document " << *it;
+
+            warning() << errMsg;
+
+            // Exception will abort migration cleanly
+            uasserted(16976, errMsg);
+        }
+    }
+
+    bool inserted = false;
+    if (Collection* collection = cx.getCollection()) {
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+            WriteUnitOfWork wuow(txn);
+            inserted = collection->insertDocuments(txn, begin, end, true, true).isOK();
+            if (inserted) {
+                wuow.commit();
+            }
+        }
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "migrateClone", ns);
+    }
+
+    if (!inserted) {
+        for (auto it = begin; it != end; ++it) {
+            Helpers::upsert(txn, ns, *it, true);
+        }
+    }
+}
+
 MONGO_FP_DECLARE(failMigrationReceivedOutOfRangeOperation);
 
 }  // namespace
@@ -605,26 +784,32 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         // 3. Initial bulk clone
         setState(CLONE);
 
-        const BSONObj migrateCloneRequest = createMigrateCloneRequest(sessionId);
+        Timer cloneTimer;
+        CloneFetcher cloneFetcher(
+            fromShard, createMigrateCloneRequest(sessionId), migrateCloneConcurrency);
+        cloneFetcher.start();
 
         while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
+            // gets array of objects to copy, in disk order
+            StatusWith<BSONObj> res = cloneFetcher.next();
+            if (!res.isOK()) {
                 setState(FAIL);
-                errmsg = "_migrateClone failed: ";
-                errmsg += res.toString();
+                errmsg = res.getStatus().reason();
                 error() << errmsg << migrateLog;
                 conn.done();
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            if (res.getValue().isEmpty()) {
+                break;
+            }
+
+            std::vector<BSONObj> docs;
+            for (const auto& elem : res.getValue()["objects"].Obj()) {
+                docs.push_back(elem.Obj());
+            }
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
+            for (auto it = docs.cbegin(); it != docs.cend();) {
                 txn->checkForInterrupt();
 
                 if (getState() == ABORT) {
@@ -634,31 +819,16 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     return;
                 }
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(txn, ns);
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(
-                            txn, ns, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << localDoc << " has same _id as cloned "
-                                                      << "remote document " << docToClone;
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
-
-                    Helpers::upsert(txn, ns, docToClone, true);
-                }
-                thisTime++;
+                const auto batchEnd =
+                    it + std::min<size_t>(kMaxClonedDocsPerInsert, docs.cend() - it);
+                insertClonedDocuments(txn, ns, min, max, shardKeyPattern, it, batchEnd);
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    for (; it != batchEnd; ++it) {
+                        _numCloned++;
+                        _clonedBytes += it->objsize();
+                    }
                 }
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
@@ -675,9 +845,11 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     }
                 }
             }
+        }
 
-            if (thisTime == 0)
-                break;
+        {
+            stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+            timing.appendCloneStats(_numCloned, _clonedBytes, cloneTimer.millis());
         }
 
         timing.done(3);
@@ -1019,6 +1191,15 @@ MoveTimingHelper::~MoveTimingHelper() {
     }
 }
 
+void MoveTimingHelper::appendCloneStats(long long numCloned,
+                                        long long clonedBytes,
+                                        long long cloneMillis) {
+    _b.appendNumber("clonedDocs", numCloned);
+    _b.appendNumber("clonedBytes", clonedBytes);
+    // Throughput of the initial clone, in bytes per second.
+    _b.appendNumber("cloneBytesPerSec", clonedBytes * 1000 / std::max(cloneMillis, 1LL));
+}
+
 void MoveTimingHelper::done(int step) {
     invariant(step == ++_nextStep);
     invariant(step <= _totalNumSteps);
@@ -168,6 +168,11 @@ public:
 
     void done(int step);
 
+    /**
+     * Records the amount of data copied by the initial clone and its throughput.
+     */
+    void appendCloneStats(long long numCloned, long long clonedBytes, long long cloneMillis);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
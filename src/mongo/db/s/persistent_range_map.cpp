@@ -0,0 +1,266 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/persistent_range_map.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+struct PersistentRangeMap::Node {
+    Node(Range range, uint64_t priority, NodePtr left, NodePtr right)
+        : range(std::move(range)),
+          priority(priority),
+          size(1 + (left ? left->size : 0) + (right ? right->size : 0)),
+          left(std::move(left)),
+          right(std::move(right)) {}
+
+    const Range range;
+    const uint64_t priority;
+    const size_t size;
+    const NodePtr left;
+    const NodePtr right;
+};
+
+namespace {
+
+/**
+ * Treap priorities are derived from the key so that the shape of the tree, and thus the cost of
+ * operations, does not depend on the order in which ranges were inserted. The hash is mixed
+ * further since shard keys are frequently sequential.
+ */
+uint64_t priorityFor(const BSONObj& min) {
+    uint64_t x = BSONObj::Hasher()(min);
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
+
+const PersistentRangeMap::Range& PersistentRangeMap::const_iterator::operator*() const {
+    invariant(!_stack.empty());
+    return _stack.back()->range;
+}
+
+const PersistentRangeMap::Range* PersistentRangeMap::const_iterator::operator->() const {
+    return &**this;
+}
+
+PersistentRangeMap::const_iterator& PersistentRangeMap::const_iterator::operator++() {
+    invariant(!_stack.empty());
+    const Node* current = _stack.back();
+    _stack.pop_back();
+    _pushLeftSpine(current->right.get());
+    return *this;
+}
+
+bool PersistentRangeMap::const_iterator::operator==(const const_iterator& other) const {
+    const Node* mine = _stack.empty() ? nullptr : _stack.back();
+    const Node* theirs = other._stack.empty() ? nullptr : other._stack.back();
+    return mine == theirs;
+}
+
+void PersistentRangeMap::const_iterator::_pushLeftSpine(const Node* node) {
+    for (; node; node = node->left.get()) {
+        _stack.push_back(node);
+    }
+}
+
+size_t PersistentRangeMap::size() const {
+    return _root ? _root->size : 0;
+}
+
+PersistentRangeMap::const_iterator PersistentRangeMap::begin() const {
+    const_iterator it;
+    it._pushLeftSpine(_root.get());
+    return it;
+}
+
+PersistentRangeMap::const_iterator PersistentRangeMap::find(const BSONObj& min) const {
+    const_iterator it = lower_bound(min);
+    if (it != end() && it->first.woCompare(min) == 0) {
+        return it;
+    }
+    return end();
+}
+
+PersistentRangeMap::const_iterator PersistentRangeMap::lower_bound(const BSONObj& key) const {
+    // The traversal stack holds exactly the nodes at which the search descended to the left.
+    const_iterator it;
+    for (const Node* node = _root.get(); node;) {
+        if (node->range.first.woCompare(key) >= 0) {
+            it._stack.push_back(node);
+            node = node->left.get();
+        } else {
+            node = node->right.get();
+        }
+    }
+    return it;
+}
+
+PersistentRangeMap::const_iterator PersistentRangeMap::upper_bound(const BSONObj& key) const {
+    const_iterator it;
+    for (const Node* node = _root.get(); node;) {
+        if (node->range.first.woCompare(key) > 0) {
+            it._stack.push_back(node);
+            node = node->left.get();
+        } else {
+            node = node->right.get();
+        }
+    }
+    return it;
+}
+
+PersistentRangeMap::const_iterator PersistentRangeMap::floor(const BSONObj& key) const {
+    const Node* candidate = nullptr;
+    for (const Node* node = _root.get(); node;) {
+        if (node->range.first.woCompare(key) <= 0) {
+            candidate = node;
+            node = node->right.get();
+        } else {
+            node = node->left.get();
+        }
+    }
+    return candidate ? lower_bound(candidate->range.first) : end();
+}
+
+bool PersistentRangeMap::insert(const BSONObj& min, const BSONObj& max) {
+    if (find(min) != end()) {
+        return false;
+    }
+
+    NodePtr left;
+    NodePtr right;
+    _split(_root, min, false, &left, &right);
+
+    NodePtr node = std::make_shared<Node>(
+        Range(min.getOwned(), max.getOwned()), priorityFor(min), NodePtr(), NodePtr());
+    _root = _merge(_merge(left, node), right);
+    return true;
+}
+
+size_t PersistentRangeMap::erase(const BSONObj& min) {
+    if (find(min) == end()) {
+        return 0;
+    }
+
+    NodePtr left;
+    NodePtr rest;
+    _split(_root, min, false, &left, &rest);
+
+    NodePtr erased;
+    NodePtr right;
+    _split(rest, min, true, &erased, &right);
+    invariant(erased && erased->size == 1);
+
+    _root = _merge(left, right);
+    return 1;
+}
+
+void PersistentRangeMap::getOverlap(const BSONObj& inclusiveLower,
+                                    const BSONObj& exclusiveUpper,
+                                    RangeVector* overlap) const {
+    overlap->clear();
+    auto bounds = _overlapBounds(inclusiveLower, exclusiveUpper);
+    for (auto it = bounds.first; it != bounds.second; ++it) {
+        overlap->push_back(*it);
+    }
+}
+
+bool PersistentRangeMap::overlaps(const BSONObj& inclusiveLower,
+                                  const BSONObj& exclusiveUpper) const {
+    auto bounds = _overlapBounds(inclusiveLower, exclusiveUpper);
+    return bounds.first != bounds.second;
+}
+
+bool PersistentRangeMap::contains(const BSONObj& inclusiveLower,
+                                  const BSONObj& exclusiveUpper) const {
+    auto bounds = _overlapBounds(inclusiveLower, exclusiveUpper);
+    if (bounds.first == end())
+        return false;
+
+    return bounds.first->first.woCompare(inclusiveLower) == 0 &&
+        bounds.first->second.woCompare(exclusiveUpper) == 0;
+}
+
+PersistentRangeMap::NodePtr PersistentRangeMap::_makeNode(const Node& from,
+                                                          NodePtr left,
+                                                          NodePtr right) {
+    return std::make_shared<Node>(from.range, from.priority, std::move(left), std::move(right));
+}
+
+void PersistentRangeMap::_split(
+    const NodePtr& node, const BSONObj& key, bool keyGoesLeft, NodePtr* left, NodePtr* right) {
+    if (!node) {
+        left->reset();
+        right->reset();
+        return;
+    }
+
+    const int cmp = node->range.first.woCompare(key);
+    if (cmp < 0 || (cmp == 0 && keyGoesLeft)) {
+        NodePtr splitLeft;
+        _split(node->right, key, keyGoesLeft, &splitLeft, right);
+        *left = _makeNode(*node, node->left, std::move(splitLeft));
+    } else {
+        NodePtr splitRight;
+        _split(node->left, key, keyGoesLeft, left, &splitRight);
+        *right = _makeNode(*node, std::move(splitRight), node->right);
+    }
+}
+
+PersistentRangeMap::NodePtr PersistentRangeMap::_merge(const NodePtr& left,
+                                                       const NodePtr& right) {
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority) {
+        return _makeNode(*left, left->left, _merge(left->right, right));
+    }
+    return _makeNode(*right, _merge(left, right->left), right->right);
+}
+
+std::pair<PersistentRangeMap::const_iterator, PersistentRangeMap::const_iterator>
+PersistentRangeMap::_overlapBounds(const BSONObj& inclusiveLower,
+                                   const BSONObj& exclusiveUpper) const {
+    // The range starting at or before the lower bound overlaps only if it extends past it
+    const_iterator low = floor(inclusiveLower);
+    if (low == end() || low->second.woCompare(inclusiveLower) <= 0) {
+        low = lower_bound(inclusiveLower);
+    }
+
+    return std::make_pair(low, lower_bound(exclusiveUpper));
+}
+
+}  // namespace mongo
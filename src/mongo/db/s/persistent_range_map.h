@@ -0,0 +1,155 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/range_arithmetic.h"
+
+namespace mongo {
+
+/**
+ * An ordered map of non-overlapping [min, max) ranges keyed by min, with the same semantics as a
+ * RangeMap, whose copies share structure.
+ *
+ * The map is a persistent treap: nodes are immutable once built, copying a map copies a single
+ * pointer and insert/erase copy only the O(log n) nodes on the path to the modified key. Deriving
+ * a new CollectionMetadata from an existing one therefore costs time proportional to the number
+ * of changed chunks rather than to the total number of chunks.
+ *
+ * Distinct copies may be used concurrently from different threads. A single instance must not be
+ * modified concurrently with any other use of it.
+ */
+class PersistentRangeMap {
+    struct Node;
+
+public:
+    typedef std::pair<BSONObj, BSONObj> Range;
+
+    /**
+     * Forward iterator over the ranges in ascending order of min. Iterators remain valid as long
+     * as the map they were obtained from is neither modified nor destroyed.
+     */
+    class const_iterator {
+    public:
+        const Range& operator*() const;
+        const Range* operator->() const;
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class PersistentRangeMap;
+
+        void _pushLeftSpine(const Node* node);
+
+        // In-order traversal stack, with the current node on top. Empty at end.
+        std::vector<const Node*> _stack;
+    };
+
+    size_t size() const;
+
+    bool empty() const {
+        return !_root;
+    }
+
+    const_iterator begin() const;
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    const_iterator find(const BSONObj& min) const;
+
+    /**
+     * Same as std::map::lower_bound and std::map::upper_bound.
+     */
+    const_iterator lower_bound(const BSONObj& key) const;
+    const_iterator upper_bound(const BSONObj& key) const;
+
+    /**
+     * Returns the last range whose min is less than or equal to 'key', that is, the only range
+     * which may contain 'key', or end() if there is none.
+     */
+    const_iterator floor(const BSONObj& key) const;
+
+    /**
+     * Inserts the range [min, max). Returns false and leaves the map unchanged if a range with the
+     * same min already exists.
+     */
+    bool insert(const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Removes the range starting at 'min'. Returns the number of ranges removed.
+     */
+    size_t erase(const BSONObj& min);
+
+    void clear() {
+        _root.reset();
+    }
+
+    /**
+     * Same as getRangeMapOverlap, rangeMapOverlaps and rangeMapContains for a RangeMap.
+     */
+    void getOverlap(const BSONObj& inclusiveLower,
+                    const BSONObj& exclusiveUpper,
+                    RangeVector* overlap) const;
+    bool overlaps(const BSONObj& inclusiveLower, const BSONObj& exclusiveUpper) const;
+    bool contains(const BSONObj& inclusiveLower, const BSONObj& exclusiveUpper) const;
+
+private:
+    typedef std::shared_ptr<const Node> NodePtr;
+
+    static NodePtr _makeNode(const Node& from, NodePtr left, NodePtr right);
+
+    /**
+     * Splits 'node' into the ranges whose min is less than 'key' (or less than or equal, if
+     * 'keyGoesLeft' is set) and the remaining ranges.
+     */
+    static void _split(
+        const NodePtr& node, const BSONObj& key, bool keyGoesLeft, NodePtr* left, NodePtr* right);
+
+    // All ranges in 'left' must be lower than all ranges in 'right'.
+    static NodePtr _merge(const NodePtr& left, const NodePtr& right);
+
+    // Returns the first range overlapping [inclusiveLower, exclusiveUpper) if any, and the first
+    // range at or after exclusiveUpper.
+    std::pair<const_iterator, const_iterator> _overlapBounds(const BSONObj& inclusiveLower,
+                                                             const BSONObj& exclusiveUpper) const;
+
+    NodePtr _root;
+};
+
+}  // namespace mongo
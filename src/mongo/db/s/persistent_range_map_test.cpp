@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/persistent_range_map.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj key(int a) {
+    return BSON("a" << a);
+}
+
+void assertSameRanges(const RangeMap& expected, const PersistentRangeMap& actual) {
+    ASSERT_EQUALS(expected.size(), actual.size());
+    auto actualIt = actual.begin();
+    for (const auto& range : expected) {
+        ASSERT(actualIt != actual.end());
+        ASSERT_EQUALS(range.first, actualIt->first);
+        ASSERT_EQUALS(range.second, actualIt->second);
+        ++actualIt;
+    }
+    ASSERT(actualIt == actual.end());
+}
+
+TEST(PersistentRangeMap, Empty) {
+    PersistentRangeMap ranges;
+    ASSERT(ranges.empty());
+    ASSERT_EQUALS(0U, ranges.size());
+    ASSERT(ranges.begin() == ranges.end());
+    ASSERT(ranges.floor(key(0)) == ranges.end());
+    ASSERT(ranges.upper_bound(key(0)) == ranges.end());
+    ASSERT_FALSE(ranges.overlaps(key(0), key(1)));
+    ASSERT_EQUALS(0U, ranges.erase(key(0)));
+}
+
+TEST(PersistentRangeMap, Lookups) {
+    PersistentRangeMap ranges;
+    ASSERT(ranges.insert(key(0), key(10)));
+    ASSERT(ranges.insert(key(20), key(30)));
+    ASSERT(ranges.insert(key(10), key(15)));
+    ASSERT_FALSE(ranges.insert(key(10), key(20)));
+    ASSERT_EQUALS(3U, ranges.size());
+
+    ASSERT(ranges.floor(key(-1)) == ranges.end());
+    ASSERT_EQUALS(key(0), ranges.floor(key(0))->first);
+    ASSERT_EQUALS(key(10), ranges.floor(key(17))->first);
+    ASSERT_EQUALS(key(20), ranges.floor(key(100))->first);
+
+    ASSERT_EQUALS(key(10), ranges.lower_bound(key(10))->first);
+    ASSERT_EQUALS(key(20), ranges.upper_bound(key(10))->first);
+    ASSERT(ranges.upper_bound(key(20)) == ranges.end());
+    ASSERT_EQUALS(key(15), ranges.find(key(10))->second);
+    ASSERT(ranges.find(key(11)) == ranges.end());
+}
+
+TEST(PersistentRangeMap, Overlaps) {
+    PersistentRangeMap ranges;
+    ranges.insert(key(0), key(10));
+    ranges.insert(key(20), key(30));
+
+    ASSERT(ranges.overlaps(key(5), key(6)));
+    ASSERT(ranges.overlaps(key(-5), key(1)));
+    ASSERT_FALSE(ranges.overlaps(key(10), key(20)));
+    ASSERT_FALSE(ranges.overlaps(key(-5), key(0)));
+
+    ASSERT(ranges.contains(key(20), key(30)));
+    ASSERT_FALSE(ranges.contains(key(20), key(25)));
+    ASSERT_FALSE(ranges.contains(key(5), key(10)));
+
+    RangeVector overlap;
+    ranges.getOverlap(key(5), key(25), &overlap);
+    ASSERT_EQUALS(2U, overlap.size());
+    ASSERT_EQUALS(key(0), overlap[0].first);
+    ASSERT_EQUALS(key(20), overlap[1].first);
+}
+
+TEST(PersistentRangeMap, CopiesAreUnaffectedByModifications) {
+    PersistentRangeMap original;
+    for (int i = 0; i < 100; i++) {
+        original.insert(key(i * 10), key(i * 10 + 5));
+    }
+
+    PersistentRangeMap copy = original;
+    ASSERT_EQUALS(1U, copy.erase(key(500)));
+    ASSERT(copy.insert(key(1005), key(1006)));
+
+    ASSERT_EQUALS(100U, original.size());
+    ASSERT(original.find(key(500)) != original.end());
+    ASSERT(original.find(key(1005)) == original.end());
+    ASSERT_EQUALS(100U, copy.size());
+    ASSERT(copy.find(key(500)) == copy.end());
+    ASSERT(copy.find(key(1005)) != copy.end());
+}
+
+TEST(PersistentRangeMap, MatchesRangeMapUnderRandomOperations) {
+    PseudoRandom random(12345);
+    RangeMap expected;
+    PersistentRangeMap actual;
+    std::vector<std::pair<RangeMap, PersistentRangeMap>> snapshots;
+
+    for (int i = 0; i < 5000; i++) {
+        const int min = random.nextInt32(1000);
+        if (random.nextInt32(3)) {
+            const bool inserted = expected.insert(std::make_pair(key(min), key(min + 1))).second;
+            ASSERT_EQUALS(inserted, actual.insert(key(min), key(min + 1)));
+        } else {
+            ASSERT_EQUALS(expected.erase(key(min)), actual.erase(key(min)));
+        }
+
+        if (i % 500 == 0) {
+            snapshots.push_back(std::make_pair(expected, actual));
+        }
+    }
+
+    assertSameRanges(expected, actual);
+    for (const auto& snapshot : snapshots) {
+        assertSameRanges(snapshot.first, snapshot.second);
+    }
+
+    for (int lookup = -1; lookup <= 1001; lookup++) {
+        auto expectedIt = expected.upper_bound(key(lookup));
+        auto actualIt = actual.upper_bound(key(lookup));
+        if (expectedIt == expected.end()) {
+            ASSERT(actualIt == actual.end());
+        } else {
+            ASSERT_EQUALS(expectedIt->first, actualIt->first);
+        }
+        ASSERT_EQUALS(rangeMapOverlaps(expected, key(lookup), key(lookup + 3)),
+                      actual.overlaps(key(lookup), key(lookup + 3)));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
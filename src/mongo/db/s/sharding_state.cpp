@@ -265,6 +265,9 @@ void ShardingState::donateChunk(OperationContext* txn,
     // TODO: a bit dangerous to have two different zero-version states - no-metadata and
     // no-version
     _collMetadata[ns] = cloned;
+
+    _chunkLoadTracker.forgetRange(ns, min, max);
+    _chunkSplitSketches.forgetRange(ns, min, max);
 }
 
 void ShardingState::undoDonateChunk(OperationContext* txn,
@@ -391,6 +394,8 @@ void ShardingState::splitChunk(OperationContext* txn,
     uassert(16857, errMsg, NULL != cloned.get());
 
     _collMetadata[ns] = cloned;
+
+    _chunkLoadTracker.splitChunk(ns, min, splitKeys);
 }
 
 void ShardingState::mergeChunks(OperationContext* txn,
@@ -412,6 +417,8 @@ void ShardingState::mergeChunks(OperationContext* txn,
     uassert(17004, errMsg, NULL != cloned.get());
 
     _collMetadata[ns] = cloned;
+
+    _chunkLoadTracker.mergeChunks(ns, minKey, maxKey);
 }
 
 bool ShardingState::inCriticalMigrateSection() {
@@ -428,6 +435,8 @@ void ShardingState::resetMetadata(const string& ns) {
     warning() << "resetting metadata for " << ns << ", this should only be used in testing";
 
     _collMetadata.erase(ns);
+    _chunkLoadTracker.clear(ns);
+    _chunkSplitSketches.clear(ns);
 }
 
 Status ShardingState::refreshMetadataIfNeeded(OperationContext* txn,
@@ -34,6 +34,8 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/oid.h"
+#include "mongo/db/s/chunk_load_tracker.h"
+#include "mongo/db/s/chunk_split_sketch.h"
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/db/s/migration_source_manager.h"
 #include "mongo/stdx/memory.h"
@@ -91,6 +93,14 @@ public:
         return &_migrationDestManager;
     }
 
+    ChunkLoadTracker* chunkLoadTracker() {
+        return &_chunkLoadTracker;
+    }
+
+    ChunkSplitSketches* chunkSplitSketches() {
+        return &_chunkSplitSketches;
+    }
+
     /**
      * Initializes sharding state and begins authenticating outgoing connections and handling shard
      * versions. If this is not run before sharded operations occur auth will not work and versions
@@ -393,6 +403,12 @@ private:
     // Manages the state of the migration recipient shard
     MigrationDestinationManager _migrationDestManager;
 
+    // Per-chunk operation counts and size estimates reported to the balancer
+    ChunkLoadTracker _chunkLoadTracker;
+
+    // Key distribution sketches used by splitVector to avoid scanning chunks
+    ChunkSplitSketches _chunkSplitSketches;
+
     // Protects state below
     stdx::mutex _mutex;
 
@@ -291,25 +291,70 @@ void KeyString::resetToKey(const BSONObj& obj, Ordering ord, Discriminator discr
 void KeyString::_appendAllElementsForIndexing(const BSONObj& obj,
                                               Ordering ord,
                                               Discriminator discriminator) {
-    int elemCount = 0;
-    BSONObjIterator it(obj);
-    while (auto elem = it.next()) {
-        const int elemIdx = elemCount++;
-        const bool invert = (ord.get(elemIdx) == -1);
-
-        _appendBsonValue(elem, invert, NULL);
-
-        dassert(elem.fieldNameSize() < 3);  // fieldNameSize includes the NUL
+    // Index keys are walked directly rather than through a BSONObjIterator. Their field names
+    // are known to be at most one character long, and the sizes of the common scalar types are
+    // known up front, so neither needs to be computed separately from appending the value.
+    const char* pos = obj.objdata() + sizeof(int32_t);
+    int elemIdx = 0;
+    while (*pos != EOO) {
+        const bool invert = (ord.get(elemIdx++) == -1);
 
         // IndexEntryComparison::makeQueryObject() encodes a discriminator in the first byte of
         // the field name. This discriminator overrides the passed in one. Normal elements only
         // have the NUL byte terminator. Entries stored in an index are not allowed to have a
         // discriminator.
-        if (char ch = *elem.fieldName()) {
+        const char ch = pos[1];
+        const int fieldNameSize = ch ? 2 : 1;  // Includes the NUL.
+        // A longer field name would be misread as the start of the value.
+        invariant(pos[fieldNameSize] == '\0');
+
+        const BSONElement elem(pos, fieldNameSize, BSONElement::FieldNameSizeTag());
+        int valueSize;
+        switch (elem.type()) {
+            case NumberInt:
+                _appendNumberInt(elem._numberInt(), invert);
+                valueSize = sizeof(int32_t);
+                break;
+            case NumberLong:
+                _appendNumberLong(elem._numberLong(), invert);
+                valueSize = sizeof(int64_t);
+                break;
+            case NumberDouble:
+                _appendNumberDouble(elem._numberDouble(), invert);
+                valueSize = sizeof(double);
+                break;
+            case String:
+                _appendString(elem.valueStringData(), invert);
+                valueSize = sizeof(int32_t) + elem.valuestrsize();
+                break;
+            case jstOID:
+                _appendOID(elem.__oid(), invert);
+                valueSize = OID::kOIDSize;
+                break;
+            case Date:
+                _appendDate(elem.date(), invert);
+                valueSize = sizeof(int64_t);
+                break;
+            case Bool:
+                _appendBool(elem.boolean(), invert);
+                valueSize = 1;
+                break;
+            case jstNULL:
+                _append(bsonTypeToGenericKeyStringType(jstNULL), invert);
+                valueSize = 0;
+                break;
+            default:
+                _appendBsonValue(elem, invert, NULL);
+                valueSize = elem.valuesize();
+                break;
+        }
+        pos += 1 + fieldNameSize + valueSize;
+
+        if (ch) {
             // l for less / g for greater.
             invariant(ch == 'l' || ch == 'g');
             discriminator = ch == 'l' ? kExclusiveBefore : kExclusiveAfter;
-            invariant(!it.more());
+            invariant(*pos == EOO);
         }
     }
 
@@ -1152,6 +1197,62 @@ int KeyString::compare(const KeyString& other) const {
     return a < b ? -1 : 1;
 }
 
+int KeyString::compareWithSharedPrefix(const KeyString& other,
+                                       size_t sharedPrefixLen,
+                                       size_t* mismatchPos) const {
+    const size_t a = getSize();
+    const size_t b = other.getSize();
+    dassert(sharedPrefixLen <= std::min(a, b));
+    dassert(memcmp(getBuffer(), other.getBuffer(), sharedPrefixLen) == 0);
+
+    const size_t pos = sharedPrefixLen +
+        sharedPrefixLength(getBuffer() + sharedPrefixLen,
+                           a - sharedPrefixLen,
+                           other.getBuffer() + sharedPrefixLen,
+                           b - sharedPrefixLen);
+    if (mismatchPos) {
+        *mismatchPos = pos;
+    }
+
+    if (pos < a && pos < b) {
+        const uint8_t lhsByte = getBuffer()[pos];
+        const uint8_t rhsByte = other.getBuffer()[pos];
+        return lhsByte < rhsByte ? -1 : 1;
+    }
+
+    // One key is a prefix of the other.
+
+    if (a == b)
+        return 0;
+
+    return a < b ? -1 : 1;
+}
+
+size_t KeyString::sharedPrefixLength(const void* lhs,
+                                     size_t lhsSize,
+                                     const void* rhs,
+                                     size_t rhsSize) {
+    const char* const lhsBytes = static_cast<const char*>(lhs);
+    const char* const rhsBytes = static_cast<const char*>(rhs);
+    const size_t size = std::min(lhsSize, rhsSize);
+
+    // Compare a word at a time. Reading the words as big-endian puts the first differing byte
+    // in the most significant position, so it can be found by counting leading zeros.
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+        const uint64_t lhsWord = ConstDataView(lhsBytes + pos).read<BigEndian<uint64_t>>();
+        const uint64_t rhsWord = ConstDataView(rhsBytes + pos).read<BigEndian<uint64_t>>();
+        if (lhsWord != rhsWord) {
+            return pos + countLeadingZeros64(lhsWord ^ rhsWord) / 8;
+        }
+    }
+
+    while (pos < size && lhsBytes[pos] == rhsBytes[pos]) {
+        pos++;
+    }
+    return pos;
+}
+
 void KeyString::TypeBits::resetFromBuffer(BufReader* reader) {
     if (!reader->remaining()) {
         // This means AllZeros state was encoded as an empty buffer.
@@ -273,6 +273,25 @@ public:
 
     int compare(const KeyString& other) const;
 
+    /**
+     * Same as compare(), but the caller guarantees that the first 'sharedPrefixLen' bytes of
+     * both keys are equal, so they are not compared again. If 'mismatchPos' is not NULL, it is
+     * set to the offset of the first byte that differs, or to the size of the shorter key if it
+     * is a prefix of the other one. That offset may be passed back as 'sharedPrefixLen' when
+     * comparing a later key which shares at least as many bytes with this one.
+     */
+    int compareWithSharedPrefix(const KeyString& other,
+                                size_t sharedPrefixLen,
+                                size_t* mismatchPos) const;
+
+    /**
+     * Returns the number of leading bytes that the two buffers have in common.
+     */
+    static size_t sharedPrefixLength(const void* lhs,
+                                     size_t lhsSize,
+                                     const void* rhs,
+                                     size_t rhsSize);
+
     /**
      * @return a hex encoding of this key
      */
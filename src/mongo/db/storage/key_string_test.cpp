@@ -659,6 +659,40 @@ TEST(KeyStringTest, AllPerm2Compare) {
     testPermutation(elements, orderings, false);
 }
 
+TEST(KeyStringTest, CompareWithSharedPrefix) {
+    const std::vector<BSONObj>& elements = getInterestingElements();
+    const Ordering ordering = Ordering::make(BSON("a" << 1 << "b" << -1));
+
+    OwnedPointerVector<KeyString> keys;
+    for (size_t i = 0; i < elements.size(); i++) {
+        BSONObjBuilder b;
+        b.append("", "a string prefix shared by many keys");
+        b.appendAs(elements[i].firstElement(), "");
+        keys.push_back(new KeyString(b.obj(), ordering, RecordId(i + 1)));
+    }
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        for (size_t j = 0; j < keys.size(); j++) {
+            const KeyString& a = *keys[i];
+            const KeyString& b = *keys[j];
+
+            const size_t shared = KeyString::sharedPrefixLength(
+                a.getBuffer(), a.getSize(), b.getBuffer(), b.getSize());
+            ASSERT_LTE(shared, std::min(a.getSize(), b.getSize()));
+            ASSERT_EQ(memcmp(a.getBuffer(), b.getBuffer(), shared), 0);
+            if (shared < a.getSize() && shared < b.getSize()) {
+                ASSERT_NE(a.getBuffer()[shared], b.getBuffer()[shared]);
+            }
+
+            for (size_t prefix : {size_t(0), shared / 2, shared}) {
+                size_t mismatchPos;
+                ASSERT_EQ(a.compareWithSharedPrefix(b, prefix, &mismatchPos), a.compare(b));
+                ASSERT_EQ(mismatchPos, shared);
+            }
+        }
+    }
+}
+
 #define COMPARE_HELPER(LHS, RHS) (((LHS) < (RHS)) ? -1 : (((LHS) == (RHS)) ? 0 : 1))
 
 int compareLongToDouble(long long lhs, double rhs) {
@@ -51,6 +51,9 @@ namespace {
 //
 // NOTE: Must be locked *before* _identLock.
 const ResourceId resourceIdCatalogMetadata(RESOURCE_METADATA, 1ULL);
+
+// Field of a collection's entry which holds the compression dictionaries of its record store.
+const char kCompressionDictionariesFieldName[] = "compressionDictionaries";
 }
 
 using std::unique_ptr;
@@ -296,6 +299,53 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
     invariant(status.getValue() == loc);
 }
 
+std::vector<BSONObj> KVCatalog::getCompressionDictionaries(OperationContext* opCtx,
+                                                           StringData ns) const {
+    std::vector<BSONObj> dictionaries;
+    BSONObj obj = _findEntry(opCtx, ns);
+    const BSONElement dictionariesElement = obj[kCompressionDictionariesFieldName];
+    if (dictionariesElement.type() == Array) {
+        BSONForEach(dictionary, dictionariesElement.Obj()) {
+            dictionaries.push_back(dictionary.Obj().getOwned());
+        }
+    }
+    return dictionaries;
+}
+
+void KVCatalog::addCompressionDictionary(OperationContext* opCtx,
+                                         StringData ns,
+                                         const BSONObj& dictionary) {
+    std::unique_ptr<Lock::ResourceLock> rLk;
+    if (!_isRsThreadSafe && opCtx->lockState()) {
+        rLk.reset(new Lock::ResourceLock(opCtx->lockState(), resourceIdCatalogMetadata, MODE_X));
+    }
+
+    RecordId loc;
+    BSONObj obj = _findEntry(opCtx, ns, &loc);
+
+    {
+        BSONObjBuilder b;
+        BSONArrayBuilder dictionaries(b.subarrayStart(kCompressionDictionariesFieldName));
+        const BSONElement dictionariesElement = obj[kCompressionDictionariesFieldName];
+        if (dictionariesElement.type() == Array) {
+            BSONForEach(existing, dictionariesElement.Obj()) {
+                dictionaries.append(existing);
+            }
+        }
+        dictionaries.append(dictionary);
+        dictionaries.done();
+
+        b.appendElementsUnique(obj);
+        obj = b.obj();
+    }
+
+    LOG(3) << "recording new compression dictionary for " << ns;
+    StatusWith<RecordId> status =
+        _rs->updateRecord(opCtx, loc, obj.objdata(), obj.objsize(), false, NULL);
+    fassert(34429, status.getStatus());
+    invariant(status.getValue() == loc);
+}
+
 Status KVCatalog::renameCollection(OperationContext* opCtx,
                                    StringData fromNS,
                                    StringData toNS,
@@ -32,6 +32,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/catalog/collection_options.h"
@@ -70,6 +71,20 @@ public:
                      StringData ns,
                      BSONCollectionCatalogEntry::MetaData& md);
 
+    /**
+     * Returns the compression dictionaries stored for the record store of collection 'ns', in
+     * the order they were added.
+     */
+    std::vector<BSONObj> getCompressionDictionaries(OperationContext* opCtx, StringData ns) const;
+
+    /**
+     * Stores 'dictionary' with the entry of collection 'ns', as part of the current unit of work.
+     * The catalog keeps the dictionaries when the collection is renamed or its metadata changes.
+     */
+    void addCompressionDictionary(OperationContext* opCtx,
+                                  StringData ns,
+                                  const BSONObj& dictionary);
+
     Status renameCollection(OperationContext* opCtx,
                             StringData fromNS,
                             StringData toNS,
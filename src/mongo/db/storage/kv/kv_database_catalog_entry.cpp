@@ -31,6 +31,7 @@
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
@@ -41,6 +42,27 @@ namespace mongo {
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * Gives 'rs' the compression dictionaries stored in the catalog entry of 'ns', and the means to
+ * store more.
+ */
+void initCompressionDictionaries(OperationContext* opCtx,
+                                 KVCatalog* catalog,
+                                 StringData ns,
+                                 RecordStore* rs) {
+    const std::string nsString = ns.toString();
+    rs->setCompressionDictionaries(
+        opCtx,
+        catalog->getCompressionDictionaries(opCtx, ns),
+        [catalog, nsString](OperationContext* opCtx, const BSONObj& dictionary) {
+            catalog->addCompressionDictionary(opCtx, nsString, dictionary);
+        });
+}
+
+}  // namespace
+
 class KVDatabaseCatalogEntry::AddCollectionChange : public RecoveryUnit::Change {
 public:
     AddCollectionChange(OperationContext* opCtx,
@@ -216,6 +238,7 @@ Status KVDatabaseCatalogEntry::createCollection(OperationContext* txn,
 
     RecordStore* rs = _engine->getEngine()->getRecordStore(txn, ns, ident, options);
     invariant(rs);
+    initCompressionDictionaries(txn, _engine->getCatalog(), ns, rs);
 
     txn->recoveryUnit()->registerChange(new AddCollectionChange(txn, this, ns, ident, true));
     _collections[ns.toString()] =
@@ -240,6 +263,7 @@ void KVDatabaseCatalogEntry::initCollection(OperationContext* opCtx,
         BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
         rs = _engine->getEngine()->getRecordStore(opCtx, ns, ident, md.options);
         invariant(rs);
+        initCompressionDictionaries(opCtx, _engine->getCatalog(), ns, rs);
     }
 
     // No change registration since this is only for committed collections
@@ -295,6 +319,7 @@ Status KVDatabaseCatalogEntry::renameCollection(OperationContext* txn,
 
     BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(txn, toNS);
     RecordStore* rs = _engine->getEngine()->getRecordStore(txn, toNS, identTo, md.options);
+    initCompressionDictionaries(txn, _engine->getCatalog(), toNS, rs);
 
     const CollectionMap::iterator itFrom = _collections.find(fromNS.toString());
     invariant(itFrom != _collections.end());
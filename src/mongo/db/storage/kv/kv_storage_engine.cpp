@@ -32,12 +32,16 @@
 
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -82,16 +86,24 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
     }
 
     {
-        WriteUnitOfWork uow(&opCtx);
-
-        Status status =
-            _engine->createRecordStore(&opCtx, catalogInfo, catalogInfo, CollectionOptions());
-        // BadValue is usually caused by invalid configuration string.
-        // We still fassert() but without a stack trace.
-        if (status.code() == ErrorCodes::BadValue) {
-            fassertFailedNoTrace(28562);
+        // We wrap the WUOW in an optional as we can't create it if we are in RO mode.
+        boost::optional<WriteUnitOfWork> uow;
+        if (storageGlobalParams.readOnly) {
+            uassert(34430,
+                    "Server was started in read-only mode, but the catalog was not found.",
+                    _engine->hasIdent(&opCtx, catalogInfo));
+        } else {
+            uow.emplace(&opCtx);
+
+            Status status =
+                _engine->createRecordStore(&opCtx, catalogInfo, catalogInfo, CollectionOptions());
+            // BadValue is usually caused by invalid configuration string.
+            // We still fassert() but without a stack trace.
+            if (status.code() == ErrorCodes::BadValue) {
+                fassertFailedNoTrace(28562);
+            }
+            fassert(28520, status);
         }
-        fassert(28520, status);
 
         _catalogRecordStore.reset(
             _engine->getRecordStore(&opCtx, catalogInfo, catalogInfo, CollectionOptions()));
@@ -104,6 +116,7 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
         std::vector<std::string> collections;
         _catalog->getAllCollections(&collections);
 
+        Timer timer;
         for (size_t i = 0; i < collections.size(); i++) {
             std::string coll = collections[i];
             NamespaceString nss(coll);
@@ -117,15 +130,19 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
 
             db->initCollection(&opCtx, coll, options.forRepair);
         }
+        log() << "loaded " << collections.size() << " collections from the catalog in "
+              << timer.millis() << "ms";
 
-        uow.commit();
+        if (uow) {
+            uow->commit();
+        }
     }
 
     opCtx.recoveryUnit()->abandonSnapshot();
 
-    // now clean up orphaned idents
+    // now clean up orphaned idents, unless we may not write
 
-    {
+    if (!storageGlobalParams.readOnly) {
         // get all idents
         std::set<std::string> allIdents;
         {
@@ -31,6 +31,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <string>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -38,6 +40,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -309,6 +312,22 @@ public:
         invariant(false);
     }
 
+    /**
+     * Durably stores a compression dictionary with the catalog entry of this record store, as
+     * part of the unit of work of the OperationContext it is given.
+     */
+    typedef stdx::function<void(OperationContext*, const BSONObj&)>
+        CompressionDictionaryPersister;
+
+    /**
+     * Called by the catalog when the record store is opened, with the 'dictionaries' previously
+     * stored through 'persister'. Record stores which compress their records with trained
+     * dictionaries need every dictionary they have ever used to read their records back.
+     */
+    virtual void setCompressionDictionaries(OperationContext* txn,
+                                            const std::vector<BSONObj>& dictionaries,
+                                            CompressionDictionaryPersister persister) {}
+
     /**
      * @param extraInfo - optional more debug info
      * @param level - optional, level of debug info to put in (higher is more)
@@ -437,6 +456,17 @@ public:
     virtual std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* txn,
                                                             bool forward = true) const = 0;
 
+    /**
+     * Returns a cursor like getCursor(), except that each Record it returns only holds the
+     * top-level 'fields' (and _id) of the document, for stores which keep some fields apart
+     * from the rest of the document. Returns {} if the store would have to read whole documents
+     * to produce those fields, in which case callers should use getCursor() instead.
+     */
+    virtual std::unique_ptr<SeekableRecordCursor> getCursorForFields(
+        OperationContext* txn, const std::vector<std::string>& fields, bool forward = true) const {
+        return {};
+    }
+
     /**
      * Constructs a cursor over a potentially corrupted store, which can be used to salvage
      * damaged records. The iterator might return every record in the store if all of them
@@ -109,6 +109,40 @@ BSONObj stripFieldNames(const BSONObj& query) {
     return bb.obj();
 }
 
+bool loadBloomFilter(OperationContext* opCtx, const std::string& uri) {
+    StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
+    if (!appMetadata.isOK()) {
+        return false;
+    }
+
+    return appMetadata.getValue().getBoolField("bloomFilter");
+}
+
+/**
+ * Adds every key in the index 'uri' to 'filter' and returns the number of keys.
+ */
+uint64_t addKeysToBloomFilter(OperationContext* opCtx,
+                              const std::string& uri,
+                              uint64_t tableId,
+                              WiredTigerIndexBloomFilter* filter) {
+    WiredTigerCursor curwrap(uri, tableId, false, opCtx);
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    uint64_t numKeys = 0;
+    int ret;
+    while ((ret = WT_OP_CHECK(c->next(c))) == 0) {
+        WT_ITEM key;
+        invariantWTOK(c->get_key(c, &key));
+        filter->add(key.data, key.size);
+        numKeys++;
+    }
+    if (ret != WT_NOTFOUND) {
+        invariantWTOK(ret);
+    }
+    return numKeys;
+}
+
 Status checkKeySize(const BSONObj& key) {
     if (key.objsize() >= TempKeyMaxSize) {
         string msg = mongoutils::str::stream()
@@ -140,6 +174,12 @@ StatusWith<std::string> WiredTigerIndex::parseIndexOptions(const BSONObj& option
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "bloomFilter") {
+            // The filter is kept by WiredTigerIndex itself, see generateCreateString().
+            StatusWith<bool> enabled = parseBloomFilterField(elem);
+            if (!enabled.isOK()) {
+                return enabled.getStatus();
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -150,11 +190,20 @@ StatusWith<std::string> WiredTigerIndex::parseIndexOptions(const BSONObj& option
     return StatusWith<std::string>(ss.str());
 }
 
+// static
+StatusWith<bool> WiredTigerIndex::parseBloomFilterField(const BSONElement& elem) {
+    if (!elem.isBoolean()) {
+        return {ErrorCodes::TypeMismatch, "'bloomFilter' must be a boolean"};
+    }
+    return elem.boolean();
+}
+
 // static
 StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string& engineName,
                                                               const std::string& sysIndexConfig,
                                                               const std::string& collIndexConfig,
-                                                              const IndexDescriptor& desc) {
+                                                              const IndexDescriptor& desc,
+                                                              bool collIndexBloomFilter) {
     str::stream ss;
 
     // Separate out a prefix and suffix in the default string. User configuration will override
@@ -172,6 +221,9 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
     ss << sysIndexConfig << ",";
     ss << collIndexConfig << ",";
 
+    // The collection's default only applies to the unique indexes it is useful for.
+    bool bloomFilter = collIndexBloomFilter && desc.unique();
+
     // Validate configuration object.
     // Raise an error about unrecognized fields that may be introduced in newer versions of
     // this storage engine.
@@ -187,6 +239,18 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
         if (!parseStatus.getValue().empty()) {
             ss << "," << parseStatus.getValue();
         }
+
+        const BSONElement bloomFilterElem =
+            storageEngine.getObjectField(engineName)["bloomFilter"];
+        if (!bloomFilterElem.eoo()) {
+            bloomFilter = parseBloomFilterField(bloomFilterElem).getValue();
+            if (bloomFilter && !desc.unique()) {
+                // Only exact lookups of whole keys can be answered by the filter, and those are
+                // only made on unique indexes.
+                return {ErrorCodes::InvalidOptions,
+                        "'bloomFilter' is only supported for unique indexes"};
+            }
+        }
     }
 
     // WARNING: No user-specified config can appear below this line. These options are required
@@ -197,8 +261,11 @@ StatusWith<std::string> WiredTigerIndex::generateCreateString(const std::string&
 
     // Index metadata
     ss << ",app_metadata=("
-       << "formatVersion=" << kCurrentIndexVersion << ','
-       << "infoObj=" << desc.infoObj().jsonString() << "),";
+       << "formatVersion=" << kCurrentIndexVersion << ',';
+    if (bloomFilter) {
+        ss << "bloomFilter=true,";
+    }
+    ss << "infoObj=" << desc.infoObj().jsonString() << "),";
 
     LOG(3) << "index create string: " << ss.ss.str();
     return StatusWith<std::string>(ss);
@@ -229,6 +296,31 @@ WiredTigerIndex::WiredTigerIndex(OperationContext* ctx,
     }
 }
 
+void WiredTigerIndex::_initBloomFilter(OperationContext* txn, const IndexDescriptor* desc) {
+    if (!loadBloomFilter(txn, _uri)) {
+        return;
+    }
+
+    // Counting the keys of the index would take another scan, but a unique index holds about
+    // one key per document, so size the filter from the collection's record count instead.
+    const Collection* collection = desc->getCollection();
+    const uint64_t expectedKeys = collection ? collection->numRecords(txn) * 2 : 0;
+
+    // The filter is rebuilt from the index rather than saved with checkpoints: after an unclean
+    // shutdown, keys replayed from the journal would be missing from a checkpointed filter,
+    // which must never report a key that is in the index as absent.
+    _bloomFilter = stdx::make_unique<WiredTigerIndexBloomFilter>(expectedKeys);
+    const uint64_t numKeys = addKeysToBloomFilter(txn, _uri, _tableId, _bloomFilter.get());
+    if (_bloomFilter->numLayers() > 1) {
+        // Only a multikey index should outgrow the estimate. Each layer adds to the false
+        // positive rate, so start over with a single layer sized for the whole index.
+        _bloomFilter = stdx::make_unique<WiredTigerIndexBloomFilter>(numKeys * 2);
+        addKeysToBloomFilter(txn, _uri, _tableId, _bloomFilter.get());
+    }
+    LOG(1) << "built a Bloom filter of " << numKeys << " keys (" << _bloomFilter->sizeInBytes()
+           << " bytes) for index " << _indexName << " on " << _collectionNamespace;
+}
+
 Status WiredTigerIndex::insert(OperationContext* txn,
                                const BSONObj& key,
                                const RecordId& id,
@@ -345,6 +437,11 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* txn,
         output->append("type", type);
     }
 
+    if (_bloomFilter) {
+        BSONObjBuilder bloomFilter(output->subobjStart("bloomFilter"));
+        _bloomFilter->appendStats(&bloomFilter);
+    }
+
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn);
     WT_SESSION* s = session->getSession();
     Status status =
@@ -399,10 +496,16 @@ bool WiredTigerIndex::isDup(WT_CURSOR* c, const BSONObj& key, const RecordId& id
     invariant(unique());
     // First check whether the key exists.
     KeyString data(key, _ordering);
+    if (_bloomFilter && !_bloomFilter->mayContain(data.getBuffer(), data.getSize())) {
+        return false;
+    }
     WiredTigerItem item(data.getBuffer(), data.getSize());
     c->set_key(c, item.Get());
     int ret = WT_OP_CHECK(c->search(c));
     if (ret == WT_NOTFOUND) {
+        if (_bloomFilter) {
+            _bloomFilter->noteFalsePositive();
+        }
         return false;
     }
     invariantWTOK(ret);
@@ -583,6 +686,10 @@ private:
             }
         }
 
+        if (_idx->_bloomFilter) {
+            _idx->_bloomFilter->add(_keyString.getBuffer(), _keyString.getSize());
+        }
+
         WiredTigerItem keyItem(_keyString.getBuffer(), _keyString.getSize());
         WiredTigerItem valueItem(value.getBuffer(), value.getSize());
 
@@ -637,6 +744,7 @@ public:
             _forward == inclusive ? KeyString::kExclusiveAfter : KeyString::kExclusiveBefore;
         _endPosition = stdx::make_unique<KeyString>();
         _endPosition->resetToKey(stripFieldNames(key), _idx.ordering(), discriminator);
+        _endPositionSharedPrefix = 0;
     }
 
     boost::optional<IndexKeyEntry> seek(const BSONObj& key,
@@ -745,8 +853,28 @@ protected:
         if (!_endPosition)
             return false;
 
-        const int cmp = _key.compare(*_endPosition);
+        return isPastEndPosition(_key.compare(*_endPosition));
+    }
+
+    /**
+     * Like atOrPastEndPointAfterSeeking() but used right after _key has been replaced.
+     * 'sharedWithPrevious' is the number of leading bytes the new _key has in common with the
+     * one it replaced. Keys near each other in the index tend to share long prefixes with each
+     * other and with the end position, so only the bytes after the part _key is already known
+     * to share with _endPosition are compared.
+     */
+    bool atOrPastEndPointAfterMove(size_t sharedWithPrevious) {
+        if (!_endPosition)
+            return false;
+
+        size_t mismatchPos;
+        const int cmp = _key.compareWithSharedPrefix(
+            *_endPosition, std::min(_endPositionSharedPrefix, sharedWithPrevious), &mismatchPos);
+        _endPositionSharedPrefix = mismatchPos;
+        return isPastEndPosition(cmp);
+    }
 
+    bool isPastEndPosition(int cmp) const {
         // We set up _endPosition to be in between the last in-range value and the first
         // out-of-range value. In particular, it is constructed to never equal any legal index
         // key.
@@ -824,12 +952,23 @@ protected:
         invariantWTOK(c->get_key(c, &item));
 
         const auto isForwardNextCall = _forward && inNext && !_key.isEmpty();
+
+        // The new key is compared with both the old key and the end position, so the length of
+        // the prefix it shares with the old key is only computed once.
+        size_t sharedWithPrevious = 0;
+        if (!_key.isEmpty() && (isForwardNextCall || _endPosition)) {
+            sharedWithPrevious = KeyString::sharedPrefixLength(
+                _key.getBuffer(), _key.getSize(), item.data, item.size);
+        }
+
         if (isForwardNextCall) {
             // Due to a bug in wired tiger (SERVER-21867) sometimes calling next
             // returns something prev.
-            const int cmp =
-                std::memcmp(_key.getBuffer(), item.data, std::min(_key.getSize(), item.size));
-            bool nextNotIncreasing = cmp > 0 || (cmp == 0 && _key.getSize() > item.size);
+            const uint8_t* const newKey = static_cast<const uint8_t*>(item.data);
+            bool nextNotIncreasing = sharedWithPrevious < std::min(_key.getSize(), item.size)
+                ? static_cast<uint8_t>(_key.getBuffer()[sharedWithPrevious]) >
+                    newKey[sharedWithPrevious]
+                : _key.getSize() > item.size;
 
             if (MONGO_FAIL_POINT(WTEmulateOutOfOrderNextIndexKey)) {
                 log() << "WTIndex::updatePosition simulating next key not increasing.";
@@ -851,7 +990,7 @@ protected:
         // Store (a copy of) the new item data as the current key for this cursor.
         _key.resetFromBuffer(item.data, item.size);
 
-        if (atOrPastEndPointAfterSeeking()) {
+        if (atOrPastEndPointAfterMove(sharedWithPrevious)) {
             _eof = true;
             return;
         }
@@ -882,6 +1021,9 @@ protected:
     KeyString _query;
 
     std::unique_ptr<KeyString> _endPosition;
+
+    // The number of leading bytes _key is known to have in common with _endPosition.
+    size_t _endPositionSharedPrefix = 0;
 };
 
 class WiredTigerIndexStandardCursor final : public WiredTigerIndexCursorBase {
@@ -926,6 +1068,15 @@ public:
 
     boost::optional<IndexKeyEntry> seekExact(const BSONObj& key, RequestedInfo parts) override {
         _query.resetToKey(stripFieldNames(key), _idx.ordering());
+
+        const WiredTigerIndexBloomFilter* filter = _idx.bloomFilter();
+        if (filter && !filter->mayContain(_query.getBuffer(), _query.getSize())) {
+            // The key was never inserted, so there is no need to search for it.
+            _cursorAtEof = true;
+            updatePosition();
+            return {};
+        }
+
         const WiredTigerItem keyItem(_query.getBuffer(), _query.getSize());
 
         WT_CURSOR* c = _cursor->get();
@@ -936,6 +1087,9 @@ public:
         if (ret != WT_NOTFOUND)
             invariantWTOK(ret);
         _cursorAtEof = ret == WT_NOTFOUND;
+        if (_cursorAtEof && filter) {
+            filter->noteFalsePositive();
+        }
         updatePosition();
         dassert(_eof || _key.compare(_query) == 0);
         return curr(parts);
@@ -947,7 +1101,9 @@ public:
 WiredTigerIndexUnique::WiredTigerIndexUnique(OperationContext* ctx,
                                              const std::string& uri,
                                              const IndexDescriptor* desc)
-    : WiredTigerIndex(ctx, uri, desc) {}
+    : WiredTigerIndex(ctx, uri, desc) {
+    _initBloomFilter(ctx, desc);
+}
 
 std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(OperationContext* txn,
                                                                               bool forward) const {
@@ -966,6 +1122,12 @@ Status WiredTigerIndexUnique::_insert(WT_CURSOR* c,
     const KeyString data(key, _ordering);
     WiredTigerItem keyItem(data.getBuffer(), data.getSize());
 
+    // The insert below is the duplicate key check, so the filter only needs to learn the key.
+    // It must do so before the key can be seen by any reader.
+    if (_bloomFilter) {
+        _bloomFilter->add(data.getBuffer(), data.getSize());
+    }
+
     KeyString value(id);
     if (!data.getTypeBits().isAllZeros())
         value.appendTypeBits(data.getTypeBits());
@@ -33,6 +33,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_bloom_filter.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
 namespace mongo {
@@ -57,6 +58,9 @@ public:
      *     'sysIndexConfig'
      *     'collIndexConfig'
      *     storageEngine.wiredTiger.configString in index descriptor's info object.
+     * A unique index keeps a Bloom filter of its keys if its info object sets
+     * storageEngine.wiredTiger.bloomFilter, or if 'collIndexBloomFilter' is true because the
+     * collection's indexOptionDefaults do.
      * Performs simple validation on the supplied parameters.
      * Returns error status if validation fails.
      * Note that even if this function returns an OK status, WT_SESSION:create() may still
@@ -65,7 +69,13 @@ public:
     static StatusWith<std::string> generateCreateString(const std::string& engineName,
                                                         const std::string& sysIndexConfig,
                                                         const std::string& collIndexConfig,
-                                                        const IndexDescriptor& desc);
+                                                        const IndexDescriptor& desc,
+                                                        bool collIndexBloomFilter = false);
+
+    /**
+     * Parses the 'bloomFilter' index option, which must be a boolean.
+     */
+    static StatusWith<bool> parseBloomFilterField(const BSONElement& elem);
 
     /**
      * Creates a WiredTiger table suitable for implementing a MongoDB index.
@@ -121,9 +131,22 @@ public:
 
     virtual bool unique() const = 0;
 
+    /**
+     * Returns the filter of the keys in this index, or nullptr if it doesn't keep one.
+     */
+    const WiredTigerIndexBloomFilter* bloomFilter() const {
+        return _bloomFilter.get();
+    }
+
     Status dupKeyError(const BSONObj& key);
 
 protected:
+    /**
+     * Creates _bloomFilter from the keys already in the index if its metadata asks for one.
+     * The index must not be written to concurrently.
+     */
+    void _initBloomFilter(OperationContext* txn, const IndexDescriptor* desc);
+
     virtual Status _insert(WT_CURSOR* c,
                            const BSONObj& key,
                            const RecordId& id,
@@ -143,6 +166,9 @@ protected:
     uint64_t _tableId;
     std::string _collectionNamespace;
     std::string _indexName;
+
+    // Every key is added before it is inserted, and never removed.
+    std::unique_ptr<WiredTigerIndexBloomFilter> _bloomFilter;
 };
 
 
@@ -0,0 +1,230 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_bloom_filter.h"
+
+#include <algorithm>
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+const uint64_t WiredTigerIndexBloomFilter::kMinCapacity;
+const uint64_t WiredTigerIndexBloomFilter::kBitsPerKey;
+const int WiredTigerIndexBloomFilter::kNumHashes;
+const int WiredTigerIndexBloomFilter::kMaxLayers;
+const int WiredTigerIndexBloomFilter::kNumCounterPartitions;
+
+namespace {
+
+struct KeyHash {
+    KeyHash(const void* data, size_t size) {
+        uint64_t out[2];
+        MurmurHash3_x64_128(data, static_cast<int>(size), 0, out);
+        h1 = out[0];
+        // The step must not be 0, or every probe would test the same bit.
+        h2 = out[1] | 1;
+    }
+
+    uint64_t h1;
+    uint64_t h2;
+};
+
+// Threads are assigned counter partitions round robin the first time they look a key up.
+AtomicUInt32 nextCounterPartition;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL int threadCounterPartition = -1;
+
+}  // namespace
+
+/**
+ * A fixed size Bloom filter which sets kNumHashes bits per key, chosen by double hashing.
+ */
+class WiredTigerIndexBloomFilter::Layer {
+    MONGO_DISALLOW_COPYING(Layer);
+
+public:
+    explicit Layer(uint64_t capacity)
+        : _capacity(capacity),
+          _numWords((capacity * kBitsPerKey + 63) / 64),
+          _words(new std::atomic<uint64_t>[_numWords]) {  // NOLINT
+        for (uint64_t i = 0; i < _numWords; i++) {
+            _words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Returns true if the layer holds more keys than it was sized for once 'hash' is added.
+     */
+    bool add(const KeyHash& hash) {
+        const uint64_t numBits = _numWords * 64;
+        for (int i = 0; i < kNumHashes; i++) {
+            const uint64_t bit = (hash.h1 + i * hash.h2) % numBits;
+            _words[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_release);
+        }
+        return _numKeys.addAndFetch(1) > _capacity;
+    }
+
+    bool mayContain(const KeyHash& hash) const {
+        const uint64_t numBits = _numWords * 64;
+        for (int i = 0; i < kNumHashes; i++) {
+            const uint64_t bit = (hash.h1 + i * hash.h2) % numBits;
+            if (!(_words[bit / 64].load(std::memory_order_acquire) & (uint64_t(1) << (bit % 64))))
+                return false;
+        }
+        return true;
+    }
+
+    uint64_t capacity() const {
+        return _capacity;
+    }
+
+    uint64_t numKeys() const {
+        return _numKeys.load();
+    }
+
+    size_t sizeInBytes() const {
+        return _numWords * sizeof(uint64_t);
+    }
+
+private:
+    const uint64_t _capacity;
+    const uint64_t _numWords;
+    const std::unique_ptr<std::atomic<uint64_t>[]> _words;  // NOLINT
+    AtomicUInt64 _numKeys;
+};
+
+WiredTigerIndexBloomFilter::WiredTigerIndexBloomFilter(uint64_t expectedKeys) {
+    for (auto& layer : _layers) {
+        layer.store(nullptr);
+    }
+    _addLayer(std::max(expectedKeys, kMinCapacity));
+}
+
+WiredTigerIndexBloomFilter::~WiredTigerIndexBloomFilter() {
+    for (auto& layer : _layers) {
+        delete layer.load();
+    }
+}
+
+void WiredTigerIndexBloomFilter::_addLayer(uint64_t capacity) {
+    const int numLayers = _numLayers.load();
+    invariant(numLayers < kMaxLayers);
+    _layers[numLayers].store(new Layer(capacity));
+    _numLayers.store(numLayers + 1);
+}
+
+void WiredTigerIndexBloomFilter::add(const void* data, size_t size) {
+    const KeyHash hash(data, size);
+    const int numLayers = _numLayers.load();
+    Layer* const newest = _layers[numLayers - 1].load();
+    if (!newest->add(hash) || numLayers == kMaxLayers) {
+        return;
+    }
+
+    // The newest layer is full. Only the first thread to notice adds the next one, and keys
+    // added to the full layer in the meantime are still found there.
+    stdx::lock_guard<stdx::mutex> lk(_growMutex);
+    if (_numLayers.load() == numLayers) {
+        _addLayer(newest->capacity() * 2);
+    }
+}
+
+WiredTigerIndexBloomFilter::LookupCounters& WiredTigerIndexBloomFilter::_lookupCounters() const {
+    if (threadCounterPartition < 0) {
+        threadCounterPartition = nextCounterPartition.fetchAndAdd(1) % kNumCounterPartitions;
+    }
+    return _counters[threadCounterPartition];
+}
+
+bool WiredTigerIndexBloomFilter::mayContain(const void* data, size_t size) const {
+    LookupCounters& counters = _lookupCounters();
+    counters.lookups.fetchAndAdd(1);
+    const KeyHash hash(data, size);
+    const int numLayers = _numLayers.load();
+    // Recently added keys are most likely in the newest layer.
+    for (int i = numLayers - 1; i >= 0; i--) {
+        if (_layers[i].load()->mayContain(hash))
+            return true;
+    }
+    counters.negatives.fetchAndAdd(1);
+    return false;
+}
+
+void WiredTigerIndexBloomFilter::noteFalsePositive() const {
+    _falsePositives.fetchAndAdd(1);
+}
+
+uint64_t WiredTigerIndexBloomFilter::numKeys() const {
+    uint64_t keys = 0;
+    const int numLayers = _numLayers.load();
+    for (int i = 0; i < numLayers; i++) {
+        keys += _layers[i].load()->numKeys();
+    }
+    return keys;
+}
+
+int WiredTigerIndexBloomFilter::numLayers() const {
+    return _numLayers.load();
+}
+
+size_t WiredTigerIndexBloomFilter::sizeInBytes() const {
+    size_t bytes = 0;
+    const int numLayers = _numLayers.load();
+    for (int i = 0; i < numLayers; i++) {
+        bytes += _layers[i].load()->sizeInBytes();
+    }
+    return bytes;
+}
+
+void WiredTigerIndexBloomFilter::appendStats(BSONObjBuilder* builder) const {
+    builder->append("keys", static_cast<long long>(numKeys()));
+    builder->append("layers", numLayers());
+    builder->append("bytes", static_cast<long long>(sizeInBytes()));
+
+    uint64_t lookups = 0;
+    uint64_t negatives = 0;
+    for (const auto& counters : _counters) {
+        lookups += counters.lookups.load();
+        negatives += counters.negatives.load();
+    }
+    const uint64_t falsePositives = _falsePositives.load();
+    builder->append("lookups", static_cast<long long>(lookups));
+    builder->append("negatives", static_cast<long long>(negatives));
+    builder->append("falsePositives", static_cast<long long>(falsePositives));
+    // The share of lookups for missing keys which still had to search the index.
+    const uint64_t misses = negatives + falsePositives;
+    builder->append("falsePositiveRate",
+                    misses ? static_cast<double>(falsePositives) / misses : 0.0);
+}
+
+}  // namespace mongo
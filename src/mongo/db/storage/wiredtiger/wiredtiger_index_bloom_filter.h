@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * An in-memory Bloom filter over the keys of a unique index, which answers most lookups of keys
+ * that are not in the index without descending the WiredTiger btree.
+ *
+ * Keys are never removed, so the filter describes a superset of the keys visible to any snapshot
+ * and can only report false positives. It grows by adding layers of twice the capacity of the
+ * previous one once the newest layer is full; a key is only absent if every layer says so.
+ *
+ * This class is thread safe.
+ */
+class WiredTigerIndexBloomFilter {
+    MONGO_DISALLOW_COPYING(WiredTigerIndexBloomFilter);
+
+public:
+    // Capacity of the first layer when the index holds fewer keys than this.
+    static const uint64_t kMinCapacity = 64 * 1024;
+
+    // Each layer is sized for about a 1% false positive rate when full.
+    static const uint64_t kBitsPerKey = 10;
+    static const int kNumHashes = 7;
+
+    static const int kMaxLayers = 24;
+
+    /**
+     * Sizes the first layer for 'expectedKeys' keys.
+     */
+    explicit WiredTigerIndexBloomFilter(uint64_t expectedKeys);
+    ~WiredTigerIndexBloomFilter();
+
+    /**
+     * Adds the key stored as 'size' bytes at 'data'. Must be called before the key becomes
+     * visible to any reader.
+     */
+    void add(const void* data, size_t size);
+
+    /**
+     * Returns false if the key stored as 'size' bytes at 'data' was never added, and true if it
+     * may have been.
+     */
+    bool mayContain(const void* data, size_t size) const;
+
+    /**
+     * Records that a key mayContain() returned true for turned out not to be in the index.
+     */
+    void noteFalsePositive() const;
+
+    uint64_t numKeys() const;
+    int numLayers() const;
+    size_t sizeInBytes() const;
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    class Layer;
+
+    void _addLayer(uint64_t capacity);
+
+    // Layers are only added, under _growMutex, and live as long as the filter. A layer is
+    // published in _layers before _numLayers is incremented.
+    std::array<std::atomic<Layer*>, kMaxLayers> _layers;  // NOLINT
+    AtomicInt32 _numLayers;
+    stdx::mutex _growMutex;
+
+    // Every lookup is counted, so the counters are split into cache line sized partitions,
+    // chosen per thread, to keep concurrent lookups from contending on them.
+    struct LookupCounters {
+        AtomicUInt64 lookups;
+        AtomicUInt64 negatives;
+        char padding[64 - 2 * sizeof(AtomicUInt64)];
+    };
+
+    static const int kNumCounterPartitions = 16;
+
+    LookupCounters& _lookupCounters() const;
+
+    mutable std::array<LookupCounters, kNumCounterPartitions> _counters;
+    mutable AtomicUInt64 _falsePositives;
+};
+
+}  // namespace mongo
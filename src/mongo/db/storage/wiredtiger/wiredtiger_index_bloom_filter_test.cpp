@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_bloom_filter.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string makeKey(int i) {
+    return "key" + std::to_string(i);
+}
+
+void addKeys(WiredTigerIndexBloomFilter* filter, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const std::string key = makeKey(i);
+        filter->add(key.data(), key.size());
+    }
+}
+
+// Returns the number of keys in ['begin', 'end') the filter claims it may contain.
+int countMayContain(const WiredTigerIndexBloomFilter& filter, int begin, int end) {
+    int count = 0;
+    for (int i = begin; i < end; i++) {
+        const std::string key = makeKey(i);
+        if (filter.mayContain(key.data(), key.size())) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(WiredTigerIndexBloomFilterTest, EmptyFilterContainsNothing) {
+    WiredTigerIndexBloomFilter filter(0);
+    ASSERT_EQUALS(0, countMayContain(filter, 0, 1000));
+    ASSERT_EQUALS(0U, filter.numKeys());
+    ASSERT_EQUALS(1, filter.numLayers());
+}
+
+TEST(WiredTigerIndexBloomFilterTest, NoFalseNegatives) {
+    WiredTigerIndexBloomFilter filter(10000);
+    addKeys(&filter, 0, 10000);
+    ASSERT_EQUALS(10000, countMayContain(filter, 0, 10000));
+    ASSERT_EQUALS(10000U, filter.numKeys());
+}
+
+TEST(WiredTigerIndexBloomFilterTest, FewFalsePositives) {
+    WiredTigerIndexBloomFilter filter(WiredTigerIndexBloomFilter::kMinCapacity);
+    addKeys(&filter, 0, WiredTigerIndexBloomFilter::kMinCapacity);
+    ASSERT_EQUALS(1, filter.numLayers());
+
+    // A full layer is sized for a false positive rate of about 1%.
+    const int falsePositives = countMayContain(filter, -100000, 0);
+    ASSERT_LESS_THAN(falsePositives, 2000);
+}
+
+TEST(WiredTigerIndexBloomFilterTest, GrowsWhenFull) {
+    const int numKeys = WiredTigerIndexBloomFilter::kMinCapacity * 4;
+    WiredTigerIndexBloomFilter filter(0);
+    addKeys(&filter, 0, numKeys);
+    ASSERT_GREATER_THAN(filter.numLayers(), 1);
+    ASSERT_EQUALS(static_cast<uint64_t>(numKeys), filter.numKeys());
+
+    // Keys added to every layer are still found.
+    ASSERT_EQUALS(numKeys, countMayContain(filter, 0, numKeys));
+    ASSERT_LESS_THAN(countMayContain(filter, -100000, 0), 5000);
+}
+
+TEST(WiredTigerIndexBloomFilterTest, AppendStats) {
+    WiredTigerIndexBloomFilter filter(0);
+    addKeys(&filter, 0, 10);
+    const int found = countMayContain(filter, 0, 20);
+    ASSERT_GREATER_THAN_OR_EQUALS(found, 10);
+    filter.noteFalsePositive();
+
+    BSONObjBuilder builder;
+    filter.appendStats(&builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_EQUALS(10, stats["keys"].numberLong());
+    ASSERT_EQUALS(1, stats["layers"].numberInt());
+    ASSERT_EQUALS(static_cast<long long>(filter.sizeInBytes()), stats["bytes"].numberLong());
+    ASSERT_EQUALS(20, stats["lookups"].numberLong());
+    ASSERT_EQUALS(20 - found, stats["negatives"].numberLong());
+    ASSERT_EQUALS(1, stats["falsePositives"].numberLong());
+    ASSERT_GREATER_THAN(stats["falsePositiveRate"].numberDouble(), 0.0);
+}
+
+}  // namespace
+}  // namespace mongo
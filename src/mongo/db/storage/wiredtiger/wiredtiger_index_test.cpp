@@ -141,4 +141,35 @@ TEST(WiredTigerIndexTest, GenerateCreateStringValidConfigStringOption) {
     ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerIndexTest, GenerateCreateStringBloomFilter) {
+    ASSERT_OK(WiredTigerIndex::parseIndexOptions(fromjson("{bloomFilter: true}")).getStatus());
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(fromjson("{bloomFilter: 1}")),
+              ErrorCodes::TypeMismatch);
+
+    BSONObj uniqueSpec = fromjson(
+        "{key: {a: 1}, name: 'a_1', ns: 'test.wt', unique: true, "
+        "storageEngine: {wiredTiger: {bloomFilter: true}}}");
+    IndexDescriptor uniqueDesc(NULL, "", uniqueSpec);
+    StatusWith<std::string> result =
+        WiredTigerIndex::generateCreateString(kWiredTigerEngineName, "", "", uniqueDesc);
+    ASSERT_OK(result.getStatus());
+    ASSERT_NOT_EQUALS(std::string::npos, result.getValue().find("bloomFilter=true"));
+
+    // Only unique indexes keep a filter.
+    BSONObj standardSpec = fromjson(
+        "{key: {a: 1}, name: 'a_1', ns: 'test.wt', "
+        "storageEngine: {wiredTiger: {bloomFilter: true}}}");
+    IndexDescriptor standardDesc(NULL, "", standardSpec);
+    ASSERT_EQ(
+        WiredTigerIndex::generateCreateString(kWiredTigerEngineName, "", "", standardDesc),
+        ErrorCodes::InvalidOptions);
+
+    // The collection's default is ignored by indexes which can't use it.
+    IndexDescriptor defaultDesc(NULL, "", fromjson("{key: {a: 1}, name: 'a_1', ns: 'test.wt'}"));
+    result = WiredTigerIndex::generateCreateString(
+        kWiredTigerEngineName, "", "", defaultDesc, true);
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS(std::string::npos, result.getValue().find("bloomFilter=true"));
+}
+
 }  // namespace mongo
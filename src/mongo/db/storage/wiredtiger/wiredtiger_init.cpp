@@ -57,7 +57,14 @@ public:
     virtual ~WiredTigerFactory() {}
     virtual StorageEngine* create(const StorageGlobalParams& params,
                                   const StorageEngineLockFile* lockFile) const {
-        if (lockFile && lockFile->createdByUncleanShutdown()) {
+        if (params.readOnly) {
+            // The bundled WiredTiger opens every file for writing and updates its own metadata,
+            // so only user collections and indexes are left untouched in read-only mode. There
+            // is no lock file when the dbpath isn't writable.
+            uassert(34433,
+                    "WiredTiger can only be started in read-only mode on a writable dbpath",
+                    lockFile);
+        } else if (lockFile && lockFile->createdByUncleanShutdown()) {
             warning() << "Recovering data from the last clean checkpoint.";
         }
 
@@ -69,7 +76,9 @@ public:
             ProcessInfo pi;
             double memSizeMB = pi.getMemSizeMB();
             if (memSizeMB > 0) {
-                double cacheMB = (memSizeMB - 1024) * 0.6;
+                // A read-only instance never dirties pages and reads uncompressed pages straight
+                // from the memory-mapped files, so more of the memory is left to the page cache.
+                double cacheMB = (memSizeMB - 1024) * (params.readOnly ? 0.25 : 0.6);
                 cacheSizeGB = static_cast<size_t>(cacheMB / 1024);
                 if (cacheSizeGB < 1)
                     cacheSizeGB = 1;
@@ -82,7 +91,8 @@ public:
                                                         cacheSizeGB,
                                                         params.dur,
                                                         ephemeral,
-                                                        params.repair);
+                                                        params.repair,
+                                                        params.readOnly);
         kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
         // Intentionally leaked.
@@ -131,6 +141,10 @@ public:
         builder.appendBool("directoryForIndexes", wiredTigerGlobalOptions.directoryForIndexes);
         return builder.obj();
     }
+
+    bool supportsReadOnly() const override {
+        return true;
+    }
 };
 }  // namespace
 
@@ -121,6 +121,63 @@ private:
 
 namespace {
 
+// How long WiredTiger keeps the handle of a table open after it was last used, and how many
+// handles must be open before it closes idle ones, see "file_manager" in wiredtiger_open.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerFileHandleCloseIdleTime, int, 100000);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerFileHandleCloseMinimum, int, 250);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerFileHandleCloseScanInterval, int, 10);
+
+// Cached sessions idle for longer than this many seconds are closed, along with their cursors,
+// which would otherwise keep the handles of idle tables open. 0 keeps them forever.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerSessionCloseIdleTimeSecs, int, 300);
+
+}  // namespace
+
+class WiredTigerKVEngine::WiredTigerSessionSweeper : public BackgroundJob {
+public:
+    explicit WiredTigerSessionSweeper(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTIdleSessionSweeper";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        int secondsSinceSweep = 0;
+        while (!_shuttingDown.load()) {
+            // Wake up every second so that shutdown isn't held up by the sweep interval.
+            sleepsecs(1);
+            if (++secondsSinceSweep < kSweepIntervalSecs) {
+                continue;
+            }
+            secondsSinceSweep = 0;
+
+            const int idleTimeSecs = wiredTigerSessionCloseIdleTimeSecs.load();
+            if (idleTimeSecs > 0) {
+                _sessionCache->closeExpiredIdleSessions(Seconds(idleTimeSecs));
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        wait();
+    }
+
+private:
+    static const int kSweepIntervalSecs = 10;
+
+    WiredTigerSessionCache* _sessionCache;
+    std::atomic<bool> _shuttingDown{false};  // NOLINT
+};
+
+namespace {
+
 class TicketServerParameter : public ServerParameter {
     MONGO_DISALLOW_COPYING(TicketServerParameter);
 
@@ -174,13 +231,15 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        size_t cacheSizeGB,
                                        bool durable,
                                        bool ephemeral,
-                                       bool repair)
+                                       bool repair,
+                                       bool readOnly)
     : _eventHandler(WiredTigerUtil::defaultEventHandlers()),
       _canonicalName(canonicalName),
       _path(path),
       _sizeStorerSyncTracker(100000, 60 * 1000),
-      _durable(durable),
-      _ephemeral(ephemeral) {
+      _durable(durable && !readOnly),
+      _ephemeral(ephemeral),
+      _readOnly(readOnly) {
     boost::filesystem::path journalPath = path;
     journalPath /= "journal";
     if (_durable) {
@@ -208,13 +267,21 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     // from using the journal.
     ss << "log=(enabled=true,archive=true,path=journal,compressor=";
     ss << wiredTigerGlobalOptions.journalCompressor << "),";
-    ss << "file_manager=(close_idle_time=100000),";  //~28 hours, will put better fix in 3.1.x
+    ss << "file_manager=(close_idle_time=" << wiredTigerFileHandleCloseIdleTime
+       << ",close_handle_minimum=" << wiredTigerFileHandleCloseMinimum
+       << ",close_scan_interval=" << wiredTigerFileHandleCloseScanInterval << "),";
     ss << "checkpoint=(wait=" << wiredTigerGlobalOptions.checkpointDelaySecs;
     ss << ",log_size=2GB),";
     ss << "statistics_log=(wait=" << wiredTigerGlobalOptions.statisticsLogDelaySecs << "),";
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())->getOpenConfig("system");
     ss << extraOpenOptions;
-    if (!_durable) {
+    if (_readOnly) {
+        // Nothing is ever written, so there is no journal to append to and nothing to
+        // checkpoint. The last shutdown was clean, so the journal holds nothing beyond the last
+        // checkpoint to replay. These settings override the earlier ones since they come later
+        // in the config string.
+        ss << ",log=(enabled=false),checkpoint=(wait=0),";
+    } else if (!_durable) {
         // If we started without the journal, but previously used the journal then open with the
         // WT log enabled to perform any unclean shutdown recovery and then close and reopen in
         // the normal path without the journal.
@@ -253,6 +320,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _journalFlusher->go();
     }
 
+    _sessionSweeper = stdx::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
+    _sessionSweeper->go();
+
     _sizeStorerUri = "table:sizeStorer";
     {
         WiredTigerSession session(_conn);
@@ -302,6 +372,8 @@ void WiredTigerKVEngine::cleanShutdown() {
         // these must be the last things we do before _conn->close();
         if (_journalFlusher)
             _journalFlusher->shutdown();
+        if (_sessionSweeper)
+            _sessionSweeper->shutdown();
         _sizeStorer.reset();
         _sessionCache->shuttingDown();
 
@@ -405,7 +477,7 @@ void WiredTigerKVEngine::endBackup(OperationContext* txn) {
 }
 
 void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
-    if (!_sizeStorer)
+    if (!_sizeStorer || _readOnly)
         return;
 
     try {
@@ -444,7 +516,11 @@ Status WiredTigerKVEngine::createRecordStore(OperationContext* opCtx,
     string uri = _uri(ident);
     WT_SESSION* s = session.getSession();
     LOG(2) << "WiredTigerKVEngine::createRecordStore uri: " << uri << " config: " << config;
-    return wtRCToStatus(s->create(s, uri.c_str(), config.c_str()));
+    Status status = wtRCToStatus(s->create(s, uri.c_str(), config.c_str()));
+    if (!status.isOK()) {
+        return status;
+    }
+    return WiredTigerRecordStore::createColumnGroups(s, _canonicalName, uri, options, config);
 }
 
 RecordStore* WiredTigerKVEngine::getRecordStore(OperationContext* opCtx,
@@ -486,6 +562,7 @@ Status WiredTigerKVEngine::createSortedDataInterface(OperationContext* opCtx,
     _checkIdentPath(ident);
 
     std::string collIndexOptions;
+    bool collIndexBloomFilter = false;
     const Collection* collection = desc->getCollection();
 
     // Treat 'collIndexOptions' as an empty string when the collection member of 'desc' is NULL in
@@ -498,11 +575,13 @@ Status WiredTigerKVEngine::createSortedDataInterface(OperationContext* opCtx,
             BSONObj storageEngineOptions = collOptions.indexOptionDefaults["storageEngine"].Obj();
             collIndexOptions = storageEngineOptions.getFieldDotted(_canonicalName + ".configString")
                                    .valuestrsafe();
+            collIndexBloomFilter =
+                storageEngineOptions.getFieldDotted(_canonicalName + ".bloomFilter").trueValue();
         }
     }
 
     StatusWith<std::string> result = WiredTigerIndex::generateCreateString(
-        _canonicalName, _indexOptions, collIndexOptions, *desc);
+        _canonicalName, _indexOptions, collIndexOptions, *desc, collIndexBloomFilter);
     if (!result.isOK()) {
         return result.getStatus();
     }
@@ -56,7 +56,8 @@ public:
                        size_t cacheSizeGB,
                        bool durable,
                        bool ephemeral,
-                       bool repair);
+                       bool repair,
+                       bool readOnly = false);
     virtual ~WiredTigerKVEngine();
 
     void setRecordStoreExtraOptions(const std::string& options);
@@ -74,6 +75,15 @@ public:
         return _ephemeral;
     }
 
+    /**
+     * In read-only mode, the data files are read as of their last checkpoint: the journal is
+     * neither replayed nor written, no checkpoints are taken and cursors read the checkpoint
+     * through memory-mapped files.
+     */
+    bool isReadOnly() const {
+        return _readOnly;
+    }
+
     virtual RecoveryUnit* newRecoveryUnit();
 
     virtual Status createRecordStore(OperationContext* opCtx,
@@ -145,10 +155,23 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Starts, if needed, the background job which truncates excess stones from capped
+     * collections other than the oplog. A single job serves every such collection, see
+     * notifyCappedTruncationNeeded(). Returns false if no job can be run, e.g. during repair.
+     */
+    static bool initRsCappedTruncationThread();
+
+    /**
+     * Asks the capped truncation job to reclaim the excess stones of the capped collection 'ns'.
+     */
+    static void notifyCappedTruncationNeeded(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
 private:
     class WiredTigerJournalFlusher;
+    class WiredTigerSessionSweeper;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -170,7 +193,9 @@ private:
 
     bool _durable;
     bool _ephemeral;
+    bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
+    std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -0,0 +1,271 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_compressor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <zlib.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Longer strings are unlikely to repeat verbatim from one document to the next.
+const int kMaxStringFragmentSize = 64;
+
+/**
+ * Setting up a zlib stream allocates its whole window, which costs more than compressing a small
+ * record, so each thread keeps a stream for each direction and resets it for every record.
+ */
+struct ZlibStreams {
+    ZlibStreams() {
+        memset(&deflater, 0, sizeof(deflater));
+        memset(&inflater, 0, sizeof(inflater));
+        // Raw streams, since the record header already says how to decode the record.
+        invariant(deflateInit2(&deflater,
+                               Z_DEFAULT_COMPRESSION,
+                               Z_DEFLATED,
+                               -MAX_WBITS,
+                               8,
+                               Z_DEFAULT_STRATEGY) == Z_OK);
+        invariant(inflateInit2(&inflater, -MAX_WBITS) == Z_OK);
+    }
+
+    ~ZlibStreams() {
+        deflateEnd(&deflater);
+        inflateEnd(&inflater);
+    }
+
+    z_stream deflater;
+    z_stream inflater;
+};
+
+/**
+ * Counts the element headers (type byte and field name) and short string elements of 'obj' and
+ * of the objects nested in it.
+ */
+void countFragments(const BSONObj& obj, std::unordered_map<std::string, int>* counts) {
+    BSONForEach(elem, obj) {
+        const char* start = elem.rawdata();
+        ++(*counts)[std::string(start, 1 + elem.fieldNameSize())];
+
+        switch (elem.type()) {
+            case Object:
+            case Array:
+                countFragments(elem.Obj(), counts);
+                break;
+            case String:
+                if (elem.valuestrsize() <= kMaxStringFragmentSize) {
+                    ++(*counts)[std::string(start, elem.size())];
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void writeHeader(char* out, int32_t dictionaryId, int32_t size) {
+    DataView(out).write(tagLittleEndian<int32_t>(dictionaryId));
+    DataView(out).write(tagLittleEndian<int32_t>(size), sizeof(int32_t));
+}
+
+}  // namespace
+
+TSP_DEFINE(ZlibStreams, threadZlibStreams);
+
+// static
+std::string WiredTigerRecordCompressor::trainDictionary(const std::vector<BSONObj>& samples,
+                                                        size_t maxSize) {
+    std::unordered_map<std::string, int> counts;
+    for (const auto& sample : samples) {
+        countFragments(sample, &counts);
+    }
+
+    // A fragment saves roughly its size every time it repeats.
+    std::vector<std::pair<size_t, std::string>> scored;
+    for (const auto& fragment : counts) {
+        if (fragment.second > 1) {
+            scored.emplace_back((fragment.second - 1) * fragment.first.size(), fragment.first);
+        }
+    }
+    typedef std::pair<size_t, std::string> ScoredFragment;
+    std::sort(scored.begin(),
+              scored.end(),
+              [](const ScoredFragment& lhs, const ScoredFragment& rhs) {
+                  return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+              });
+
+    std::vector<const std::string*> chosen;
+    size_t size = 0;
+    for (const auto& fragment : scored) {
+        if (size + fragment.second.size() > maxSize) {
+            continue;
+        }
+        chosen.push_back(&fragment.second);
+        size += fragment.second.size();
+    }
+
+    std::string dictionary;
+    dictionary.reserve(size);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        dictionary += **it;
+    }
+    return dictionary;
+}
+
+// static
+int WiredTigerRecordCompressor::uncompressedSize(const char* data, int len) {
+    massert(34425, "stored record is shorter than its header", len >= kHeaderSize);
+    return ConstDataView(data).read<LittleEndian<int32_t>>(sizeof(int32_t));
+}
+
+void WiredTigerRecordCompressor::addDictionary(int id, std::string dictionary) {
+    invariant(id > 0);
+    auto entry = std::make_shared<const std::string>(std::move(dictionary));
+    _update([&](Dictionaries* dictionaries) { dictionaries->byId[id] = std::move(entry); });
+}
+
+void WiredTigerRecordCompressor::removeDictionary(int id) {
+    _update([&](Dictionaries* dictionaries) {
+        invariant(id != dictionaries->current);
+        dictionaries->byId.erase(id);
+    });
+}
+
+void WiredTigerRecordCompressor::setCurrentDictionary(int id) {
+    _update([&](Dictionaries* dictionaries) {
+        invariant(dictionaries->byId.count(id));
+        dictionaries->current = id;
+    });
+}
+
+int WiredTigerRecordCompressor::currentDictionary() const {
+    return _getDictionaries()->current;
+}
+
+int WiredTigerRecordCompressor::maxDictionary() const {
+    const auto dictionaries = _getDictionaries();
+    return dictionaries->byId.empty() ? 0 : dictionaries->byId.rbegin()->first;
+}
+
+std::shared_ptr<const WiredTigerRecordCompressor::Dictionaries>
+WiredTigerRecordCompressor::_getDictionaries() const {
+    return std::atomic_load(&_dictionaries);
+}
+
+template <typename Change>
+void WiredTigerRecordCompressor::_update(Change change) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto updated = std::make_shared<Dictionaries>(*_getDictionaries());
+    change(updated.get());
+    std::atomic_store(&_dictionaries, std::shared_ptr<const Dictionaries>(std::move(updated)));
+}
+
+std::string WiredTigerRecordCompressor::compress(const char* data, int len) const {
+    const auto dictionaries = _getDictionaries();
+    const int id = dictionaries->current;
+    std::shared_ptr<const std::string> dictionary;
+    if (id) {
+        dictionary = dictionaries->byId.find(id)->second;
+    }
+
+    std::string out;
+    if (dictionary) {
+        z_stream* zs = &threadZlibStreams.getMake()->deflater;
+        invariant(deflateReset(zs) == Z_OK);
+        invariant(deflateSetDictionary(zs,
+                                       reinterpret_cast<const Bytef*>(dictionary->data()),
+                                       dictionary->size()) == Z_OK);
+
+        const uLong bound = deflateBound(zs, len);
+        out.resize(kHeaderSize + bound);
+        zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zs->avail_in = len;
+        zs->next_out = reinterpret_cast<Bytef*>(&out[kHeaderSize]);
+        zs->avail_out = bound;
+        invariant(deflate(zs, Z_FINISH) == Z_STREAM_END);
+
+        if (zs->total_out < static_cast<uLong>(len)) {
+            out.resize(kHeaderSize + zs->total_out);
+            writeHeader(&out[0], id, len);
+            return out;
+        }
+    }
+
+    out.resize(kHeaderSize + len);
+    writeHeader(&out[0], 0, len);
+    memcpy(&out[kHeaderSize], data, len);
+    return out;
+}
+
+RecordData WiredTigerRecordCompressor::decompress(const char* data, int len) const {
+    const int size = uncompressedSize(data, len);
+    const int32_t id = ConstDataView(data).read<LittleEndian<int32_t>>();
+    if (id == 0) {
+        massert(34426, "invalid size for uncompressed record", size == len - kHeaderSize);
+        return RecordData(data + kHeaderSize, size);
+    }
+
+    const auto dictionaries = _getDictionaries();
+    const auto it = dictionaries->byId.find(id);
+    std::shared_ptr<const std::string> dictionary =
+        it == dictionaries->byId.end() ? nullptr : it->second;
+    massert(34427,
+            str::stream() << "record was compressed with unknown dictionary " << id,
+            dictionary);
+
+    z_stream* zs = &threadZlibStreams.getMake()->inflater;
+    invariant(inflateReset(zs) == Z_OK);
+    invariant(inflateSetDictionary(zs,
+                                   reinterpret_cast<const Bytef*>(dictionary->data()),
+                                   dictionary->size()) == Z_OK);
+
+    SharedBuffer buffer = SharedBuffer::allocate(size);
+    zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + kHeaderSize));
+    zs->avail_in = len - kHeaderSize;
+    zs->next_out = reinterpret_cast<Bytef*>(buffer.get());
+    zs->avail_out = size;
+    const int ret = inflate(zs, Z_FINISH);
+    massert(34428,
+            str::stream() << "failed to decompress record with dictionary " << id << ": " << ret,
+            ret == Z_STREAM_END && zs->total_out == static_cast<uLong>(size));
+
+    return RecordData(std::move(buffer), size);
+}
+
+}  // namespace mongo
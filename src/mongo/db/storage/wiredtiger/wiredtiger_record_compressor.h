@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/storage/record_data.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Compresses the records of a collection with zlib against preset dictionaries trained from
+ * sample documents. Block compression only sees one page at a time, but the field names and
+ * common values which repeat in every small document of a collection are in the dictionary, so
+ * even a single record compresses well.
+ *
+ * Every stored value starts with a header naming the dictionary it was compressed with, so
+ * records written with older dictionaries stay readable after the collection is retrained.
+ * Dictionary 0 means the record is stored uncompressed.
+ *
+ * This class is thread safe.
+ */
+class WiredTigerRecordCompressor {
+    MONGO_DISALLOW_COPYING(WiredTigerRecordCompressor);
+
+public:
+    // Size of the header in front of every stored value.
+    static const int kHeaderSize = 2 * sizeof(int32_t);
+
+    // zlib can only refer back 32KB, and the dictionary shares that window with the record.
+    static const size_t kMaxDictionarySize = 16 * 1024;
+
+    WiredTigerRecordCompressor() = default;
+
+    /**
+     * Builds a dictionary of at most 'maxSize' bytes out of the BSON fragments, such as element
+     * headers and short strings, which recur across 'samples'. The most valuable fragments are
+     * placed last, where zlib refers to them most cheaply. Returns an empty string if nothing
+     * recurs.
+     */
+    static std::string trainDictionary(const std::vector<BSONObj>& samples,
+                                       size_t maxSize = kMaxDictionarySize);
+
+    /**
+     * Returns the size of the record held by the stored value 'data', without decompressing it.
+     */
+    static int uncompressedSize(const char* data, int len);
+
+    /**
+     * Makes the dictionary 'id' available for decompression. 'id' must be positive.
+     */
+    void addDictionary(int id, std::string dictionary);
+
+    /**
+     * Forgets the dictionary 'id', which must not be used by any stored record.
+     */
+    void removeDictionary(int id);
+
+    /**
+     * Compresses new records with the dictionary 'id' from now on.
+     */
+    void setCurrentDictionary(int id);
+
+    /**
+     * Returns the id of the dictionary new records are compressed with, or 0 if there is none.
+     */
+    int currentDictionary() const;
+
+    /**
+     * Returns the largest dictionary id known, or 0 if there is none.
+     */
+    int maxDictionary() const;
+
+    /**
+     * Returns the stored form of a record, compressed with the current dictionary unless that
+     * wouldn't make it smaller.
+     */
+    std::string compress(const char* data, int len) const;
+
+    /**
+     * Returns the record held by the stored value 'data'. Uncompressed records are returned
+     * without copying, so they are only valid as long as 'data' is.
+     */
+    RecordData decompress(const char* data, int len) const;
+
+private:
+    /**
+     * An immutable snapshot of the known dictionaries. Changes publish a new copy, so that
+     * compressing and decompressing records never takes a lock.
+     */
+    struct Dictionaries {
+        std::map<int, std::shared_ptr<const std::string>> byId;
+        int current = 0;
+    };
+
+    std::shared_ptr<const Dictionaries> _getDictionaries() const;
+
+    /**
+     * Publishes a copy of the current snapshot after applying 'change' to it.
+     */
+    template <typename Change>
+    void _update(Change change);
+
+    // Serializes changes to the dictionaries. Readers don't take it.
+    stdx::mutex _mutex;
+
+    // Only accessed with std::atomic_load and std::atomic_store
+    std::shared_ptr<const Dictionaries> _dictionaries = std::make_shared<Dictionaries>();
+};
+
+}  // namespace mongo
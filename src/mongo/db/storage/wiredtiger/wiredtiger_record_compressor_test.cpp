@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_compressor.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeDocuments(int count) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < count; i++) {
+        docs.push_back(BSON("_id" << i << "customerName"
+                                  << "customer" << (i % 3 ? "status" : "state") << "active"
+                                  << "address" << BSON("streetName" << "Main Street"
+                                                                    << "postalCode" << i)));
+    }
+    return docs;
+}
+
+TEST(WiredTigerRecordCompressorTest, TrainDictionaryFromRepeatedFragments) {
+    const std::string dictionary =
+        WiredTigerRecordCompressor::trainDictionary(makeDocuments(20));
+    ASSERT_NOT_EQUALS(std::string::npos, dictionary.find("customerName"));
+    ASSERT_NOT_EQUALS(std::string::npos, dictionary.find("Main Street"));
+    ASSERT_NOT_EQUALS(std::string::npos, dictionary.find("postalCode"));
+}
+
+TEST(WiredTigerRecordCompressorTest, TrainDictionaryRespectsMaxSize) {
+    const std::string dictionary =
+        WiredTigerRecordCompressor::trainDictionary(makeDocuments(20), 32);
+    ASSERT_LESS_THAN_OR_EQUALS(dictionary.size(), 32U);
+    ASSERT_FALSE(dictionary.empty());
+}
+
+TEST(WiredTigerRecordCompressorTest, TrainDictionaryWithoutRepetition) {
+    std::vector<BSONObj> docs = {BSON("a" << 1), BSON("b" << 2)};
+    ASSERT_EQUALS(std::string(), WiredTigerRecordCompressor::trainDictionary(docs));
+}
+
+TEST(WiredTigerRecordCompressorTest, StoredUncompressedWithoutDictionary) {
+    WiredTigerRecordCompressor compressor;
+    const BSONObj doc = makeDocuments(1)[0];
+
+    const std::string stored = compressor.compress(doc.objdata(), doc.objsize());
+    ASSERT_EQUALS(WiredTigerRecordCompressor::kHeaderSize + doc.objsize(),
+                  static_cast<int>(stored.size()));
+    ASSERT_EQUALS(doc.objsize(),
+                  WiredTigerRecordCompressor::uncompressedSize(stored.data(), stored.size()));
+
+    RecordData data = compressor.decompress(stored.data(), stored.size());
+    ASSERT_FALSE(data.isOwned());
+    ASSERT_EQUALS(doc, data.toBson());
+}
+
+TEST(WiredTigerRecordCompressorTest, RoundTripWithDictionary) {
+    const std::vector<BSONObj> docs = makeDocuments(50);
+    WiredTigerRecordCompressor compressor;
+    compressor.addDictionary(1, WiredTigerRecordCompressor::trainDictionary(docs));
+    compressor.setCurrentDictionary(1);
+    ASSERT_EQUALS(1, compressor.currentDictionary());
+
+    for (const auto& doc : docs) {
+        const std::string stored = compressor.compress(doc.objdata(), doc.objsize());
+        ASSERT_LESS_THAN(static_cast<int>(stored.size()), doc.objsize());
+        ASSERT_EQUALS(doc.objsize(),
+                      WiredTigerRecordCompressor::uncompressedSize(stored.data(), stored.size()));
+        ASSERT_EQUALS(doc, compressor.decompress(stored.data(), stored.size()).toBson());
+    }
+}
+
+TEST(WiredTigerRecordCompressorTest, OlderDictionariesStayReadable) {
+    const BSONObj doc = makeDocuments(1)[0];
+    WiredTigerRecordCompressor compressor;
+    compressor.addDictionary(1, WiredTigerRecordCompressor::trainDictionary(makeDocuments(10)));
+    compressor.setCurrentDictionary(1);
+    const std::string first = compressor.compress(doc.objdata(), doc.objsize());
+
+    compressor.addDictionary(2, WiredTigerRecordCompressor::trainDictionary({doc, doc}));
+    compressor.setCurrentDictionary(2);
+    ASSERT_EQUALS(2, compressor.maxDictionary());
+    const std::string second = compressor.compress(doc.objdata(), doc.objsize());
+    ASSERT_NOT_EQUALS(first, second);
+
+    ASSERT_EQUALS(doc, compressor.decompress(first.data(), first.size()).toBson());
+    ASSERT_EQUALS(doc, compressor.decompress(second.data(), second.size()).toBson());
+}
+
+TEST(WiredTigerRecordCompressorTest, UnknownDictionary) {
+    const BSONObj doc = makeDocuments(1)[0];
+    std::string stored;
+    {
+        WiredTigerRecordCompressor compressor;
+        compressor.addDictionary(1, WiredTigerRecordCompressor::trainDictionary(makeDocuments(10)));
+        compressor.setCurrentDictionary(1);
+        stored = compressor.compress(doc.objdata(), doc.objsize());
+    }
+
+    WiredTigerRecordCompressor compressor;
+    ASSERT_THROWS_CODE(
+        compressor.decompress(stored.data(), stored.size()), MsgAssertionException, 34427);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <wiredtiger.h>
 
 #include "mongo/base/checked_cast.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -59,6 +61,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/stringutils.h"
 #include "mongo/util/time_support.h"
 
 //#define RS_ITERATOR_TRACE(x) log() << "WTRS::Iterator " << x
@@ -73,11 +76,37 @@ namespace {
 
 static const int kMinimumRecordStoreVersion = 1;
 static const int kCurrentRecordStoreVersion = 1;  // New record stores use this by default.
-static const int kMaximumRecordStoreVersion = 1;
+static const int kMaximumRecordStoreVersion = 2;
+// Tables which keep some fields in a column group of their own can't be read by versions which
+// only understand a single value column.
+static const int kColumnGroupsRecordStoreVersion = 2;
 static_assert(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion,
               "kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion");
 static_assert(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion,
               "kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion");
+static_assert(kColumnGroupsRecordStoreVersion <= kMaximumRecordStoreVersion,
+              "kColumnGroupsRecordStoreVersion <= kMaximumRecordStoreVersion");
+// Neither can tables whose values start with a compression header.
+static const int kDictionaryCompressionRecordStoreVersion = 2;
+static_assert(kDictionaryCompressionRecordStoreVersion <= kMaximumRecordStoreVersion,
+              "kDictionaryCompressionRecordStoreVersion <= kMaximumRecordStoreVersion");
+
+// Names of the value columns, which are also the names of the column groups, of tables created
+// with 'columnGroups'.
+const char kDocColumn[] = "doc";
+const char kProjectedColumn[] = "projected";
+
+// Every kCompressionSampleInterval-th record inserted into a collection with
+// 'dictionaryCompression' is kept as a training sample, unless it is larger than
+// kMaxCompressionSampleSize. Small records are the ones which gain the most from a dictionary.
+const int64_t kCompressionSampleInterval = 8;
+const int kMaxCompressionSampleSize = 16 * 1024;
+const size_t kMaxCompressionSamples = 256;
+// Number of samples the first dictionary is trained from.
+const size_t kMinCompressionSamples = 64;
+// Every dictionary is kept in the collection's catalog entry for as long as the collection
+// exists, since records compressed with it may still be around, so retraining stops here.
+const int kMaxCompressionDictionaries = 64;
 
 bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
@@ -88,8 +117,37 @@ bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     return (appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
 
+std::vector<std::string> loadProjectedFields(OperationContext* opCtx, const std::string& uri) {
+    std::vector<std::string> fields;
+    StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
+    if (!appMetadata.isOK()) {
+        return fields;
+    }
+
+    const std::string projectedFields = appMetadata.getValue().getStringField("projectedFields");
+    if (!projectedFields.empty()) {
+        splitStringDelim(projectedFields, &fields, ',');
+    }
+    return fields;
+}
+
+bool loadDictionaryCompression(OperationContext* opCtx, const std::string& uri) {
+    StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
+    if (!appMetadata.isOK()) {
+        return false;
+    }
+
+    return appMetadata.getValue().getBoolField("dictionaryCompression");
+}
+
 }  // namespace
 
+// Number of inserts into a collection with 'dictionaryCompression' after which its dictionary
+// is retrained from recent documents. 0 keeps the first dictionary forever.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerDictionaryRetrainInterval, int, 1000 * 1000);
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerCappedTruncationThread, bool, false);
+
 MONGO_FP_DECLARE(WTWriteConflictException);
 MONGO_FP_DECLARE(WTEmulateOutOfOrderNextRecordId);
 
@@ -425,18 +483,35 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
 
 void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     if (hasExcessStones()) {
-        _oplogReclaimCv.notify_one();
+        if (_rs->_isOplog) {
+            _oplogReclaimCv.notify_one();
+        } else {
+            WiredTigerKVEngine::notifyCappedTruncationNeeded(_rs->ns());
+        }
     }
 }
 
 class WiredTigerRecordStore::Cursor final : public SeekableRecordCursor {
 public:
-    Cursor(OperationContext* txn, const WiredTigerRecordStore& rs, bool forward = true)
+    // What the cursor returns for each record.
+    enum class Mode {
+        kDocument,         // The whole document.
+        kProjectedFields,  // The "projected" column group.
+        kStored,           // The value as stored in the table, which may be compressed.
+    };
+
+    Cursor(OperationContext* txn,
+           const WiredTigerRecordStore& rs,
+           bool forward = true,
+           Mode mode = Mode::kDocument)
         : _rs(rs),
           _txn(txn),
           _forward(forward),
+          _mode(mode),
+          _uri(mode == Mode::kProjectedFields ? rs._projectedUri : rs._readUri),
+          _tableId(mode == Mode::kProjectedFields ? rs._projectedTableId : rs._readTableId),
           _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()) {
-        _cursor.emplace(rs.getURI(), rs.tableId(), true, txn);
+        _cursor.emplace(_uri, _tableId, true, txn);
     }
 
     boost::optional<Record> next() final {
@@ -511,7 +586,7 @@ public:
         invariantWTOK(c->get_value(c, &value));
 
         _lastReturnedId = id;
-        return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+        return {{id, _toRecordData(value)}};
     }
 
     boost::optional<Record> seekExact(const RecordId& id) final {
@@ -531,7 +606,7 @@ public:
 
         _lastReturnedId = id;
         _eof = false;
-        return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+        return {{id, _toRecordData(value)}};
     }
 
     void save() final {
@@ -551,7 +626,7 @@ public:
 
     bool restore() final {
         if (!_cursor)
-            _cursor.emplace(_rs.getURI(), _rs.tableId(), true, _txn);
+            _cursor.emplace(_uri, _tableId, true, _txn);
 
         // This will ensure an active session exists, so any restored cursors will bind to it
         invariant(WiredTigerRecoveryUnit::get(_txn)->getSession(_txn) == _cursor->getSession());
@@ -626,9 +701,19 @@ private:
         return id < _readUntilForOplog;
     }
 
+    RecordData _toRecordData(const WT_ITEM& value) const {
+        if (_mode == Mode::kStored) {
+            return {static_cast<const char*>(value.data), static_cast<int>(value.size)};
+        }
+        return _rs._toRecordData(value);
+    }
+
     const WiredTigerRecordStore& _rs;
     OperationContext* _txn;
     const bool _forward;
+    const Mode _mode;
+    const std::string& _uri;
+    const uint64_t _tableId;
     bool _skipNextAdvance = false;
     boost::optional<WiredTigerCursor> _cursor;
     bool _eof = false;
@@ -645,6 +730,19 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "columnGroups") {
+            // Column groups change the table schema rather than its configuration string, see
+            // generateCreateString() and createColumnGroups().
+            StatusWith<std::vector<std::string>> fields = parseColumnGroupsField(elem);
+            if (!fields.isOK()) {
+                return fields.getStatus();
+            }
+        } else if (elem.fieldNameStringData() == "dictionaryCompression") {
+            // Records are compressed by the record store itself, see WiredTigerRecordCompressor.
+            StatusWith<bool> enabled = parseDictionaryCompressionField(elem);
+            if (!enabled.isOK()) {
+                return enabled.getStatus();
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -655,6 +753,55 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
     return StatusWith<std::string>(ss.str());
 }
 
+StatusWith<std::vector<std::string>> WiredTigerRecordStore::parseColumnGroupsField(
+    const BSONElement& elem) {
+    if (elem.type() != Array) {
+        return {ErrorCodes::TypeMismatch, "'columnGroups' must be an array of field names"};
+    }
+
+    std::vector<std::string> fields;
+    BSONForEach(field, elem.Obj()) {
+        if (field.type() != String) {
+            return {ErrorCodes::TypeMismatch,
+                    str::stream() << "'columnGroups' must only contain field names, found "
+                                  << field.toString(false)};
+        }
+        const std::string fieldName = field.str();
+        // The names are stored in the table's app_metadata as a comma separated string, and only
+        // whole top-level fields are projected.
+        if (fieldName.empty() || fieldName[0] == '$' ||
+            fieldName.find_first_of(".,\"\\") != std::string::npos ||
+            fieldName.find('\0') != std::string::npos) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'columnGroups' field name '" << fieldName
+                                  << "' must be a top-level field name which doesn't start with "
+                                     "'$' or contain '.', ',', '\"' or '\\'"};
+        }
+        if (fieldName == "_id") {
+            return {ErrorCodes::BadValue,
+                    "'columnGroups' must not name '_id', which is always projected"};
+        }
+        if (std::find(fields.begin(), fields.end(), fieldName) != fields.end()) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'columnGroups' names field '" << fieldName << "' twice"};
+        }
+        fields.push_back(fieldName);
+    }
+
+    if (fields.empty()) {
+        return {ErrorCodes::BadValue, "'columnGroups' must name at least one field"};
+    }
+    return fields;
+}
+
+// static
+StatusWith<bool> WiredTigerRecordStore::parseDictionaryCompressionField(const BSONElement& elem) {
+    if (!elem.isBoolean()) {
+        return {ErrorCodes::TypeMismatch, "'dictionaryCompression' must be a boolean"};
+    }
+    return elem.boolean();
+}
+
 class WiredTigerRecordStore::RandomCursor final : public RecordCursor {
 public:
     RandomCursor(OperationContext* txn, const WiredTigerRecordStore& rs, StringData config)
@@ -680,7 +827,7 @@ public:
         WT_ITEM value;
         invariantWTOK(_cursor->get_value(_cursor, &value));
 
-        return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+        return {{id, _rs->_toRecordData(value)}};
     }
 
     void save() final {
@@ -700,7 +847,7 @@ public:
 
         if (!_cursor) {
             invariantWTOK(session->open_cursor(
-                session, _rs->_uri.c_str(), nullptr, _config.c_str(), &_cursor));
+                session, _rs->_readUri.c_str(), nullptr, _config.c_str(), &_cursor));
             invariant(_cursor);
         }
         return true;
@@ -759,6 +906,36 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
 
     ss << customOptions.getValue();
 
+    std::vector<std::string> projectedFields;
+    const BSONElement columnGroups =
+        options.storageEngine.getObjectField(engineName)["columnGroups"];
+    if (!columnGroups.eoo()) {
+        if (options.capped || NamespaceString::oplog(ns)) {
+            return {ErrorCodes::InvalidOptions,
+                    "'columnGroups' is not supported for capped collections"};
+        }
+        // Already validated by parseOptionsField().
+        projectedFields = parseColumnGroupsField(columnGroups).getValue();
+    }
+
+    bool dictionaryCompression = false;
+    const BSONElement dictionaryCompressionElem =
+        options.storageEngine.getObjectField(engineName)["dictionaryCompression"];
+    if (!dictionaryCompressionElem.eoo()) {
+        dictionaryCompression =
+            parseDictionaryCompressionField(dictionaryCompressionElem).getValue();
+    }
+    if (dictionaryCompression) {
+        if (options.capped || NamespaceString::oplog(ns)) {
+            return {ErrorCodes::InvalidOptions,
+                    "'dictionaryCompression' is not supported for capped collections"};
+        }
+        if (!projectedFields.empty()) {
+            return {ErrorCodes::InvalidOptions,
+                    "'dictionaryCompression' can't be combined with 'columnGroups'"};
+        }
+    }
+
     if (NamespaceString::oplog(ns)) {
         // force file for oplog
         ss << "type=file,";
@@ -769,18 +946,69 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
     // WARNING: No user-specified config can appear below this line. These options are required
     // for correct behavior of the server.
 
-    ss << "key_format=q,value_format=u";
+    if (projectedFields.empty()) {
+        ss << "key_format=q,value_format=u";
+    } else {
+        // The whole document is kept in one column group and a BSON object holding _id and the
+        // projected fields in another, so scans of those fields only read the smaller one.
+        ss << "key_format=q,value_format=uu";
+        ss << ",columns=(id," << kDocColumn << ',' << kProjectedColumn << ')';
+        ss << ",colgroups=(" << kDocColumn << ',' << kProjectedColumn << ')';
+    }
 
     // Record store metadata
-    ss << ",app_metadata=(formatVersion=" << kCurrentRecordStoreVersion;
+    ss << ",app_metadata=(formatVersion=";
+    if (!projectedFields.empty()) {
+        ss << kColumnGroupsRecordStoreVersion;
+    } else if (dictionaryCompression) {
+        ss << kDictionaryCompressionRecordStoreVersion;
+    } else {
+        ss << kCurrentRecordStoreVersion;
+    }
     if (NamespaceString::oplog(ns)) {
         ss << ",oplogKeyExtractionVersion=1";
     }
+    if (!projectedFields.empty()) {
+        std::string joined;
+        joinStringDelim(projectedFields, &joined, ',');
+        ss << ",projectedFields=\"" << joined << '"';
+    }
+    if (dictionaryCompression) {
+        ss << ",dictionaryCompression=true";
+    }
     ss << ")";
 
     return StatusWith<std::string>(ss);
 }
 
+// static
+Status WiredTigerRecordStore::createColumnGroups(WT_SESSION* session,
+                                                 const std::string& engineName,
+                                                 const std::string& uri,
+                                                 const CollectionOptions& options,
+                                                 const std::string& config) {
+    if (options.storageEngine.getObjectField(engineName)["columnGroups"].eoo()) {
+        return Status::OK();
+    }
+
+    // The column groups are created with the same file configuration as the table. The
+    // 'columns' setting appended last overrides the one listing all of the table's columns.
+    const size_t colon = uri.find(':');
+    invariant(colon != std::string::npos);
+    for (const char* column : {kDocColumn, kProjectedColumn}) {
+        const std::string colgroupUri =
+            str::stream() << "colgroup" << uri.substr(colon) << ':' << column;
+        const std::string colgroupConfig = str::stream() << config << ",columns=(" << column
+                                                         << ')';
+        Status status =
+            wtRCToStatus(session->create(session, colgroupUri.c_str(), colgroupConfig.c_str()));
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
 WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
                                              StringData ns,
                                              StringData uri,
@@ -794,6 +1022,18 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
     : RecordStore(ns),
       _uri(uri.toString()),
       _tableId(WiredTigerSession::genTableId()),
+      _projectedFields(loadProjectedFields(ctx, _uri)),
+      _readUri(_projectedFields.empty() ? _uri
+                                        : std::string(str::stream() << _uri << '(' << kDocColumn
+                                                                    << ')')),
+      _readTableId(_projectedFields.empty() ? _tableId : WiredTigerSession::genTableId()),
+      _projectedUri(_projectedFields.empty()
+                        ? std::string()
+                        : std::string(str::stream() << _uri << '(' << kProjectedColumn << ')')),
+      _projectedTableId(_projectedFields.empty() ? 0 : WiredTigerSession::genTableId()),
+      _compressor(loadDictionaryCompression(ctx, _uri)
+                      ? stdx::make_unique<WiredTigerRecordCompressor>()
+                      : nullptr),
       _engineName(engineName),
       _isCapped(isCapped),
       _isEphemeral(isEphemeral),
@@ -806,8 +1046,9 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
       _cappedCallback(cappedCallback),
       _cappedDeleteCheckCount(0),
       _useOplogHack(shouldUseOplogHack(ctx, _uri)),
+      _sizeInfo(sizeStorer ? sizeStorer->load(uri)
+                           : std::make_shared<WiredTigerSizeStorer::SizeInfo>()),
       _sizeStorer(sizeStorer),
-      _sizeStorerCounter(0),
       _shuttingDown(false) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
         ctx, uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion);
@@ -823,42 +1064,23 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
         invariant(_cappedMaxDocs == -1);
     }
 
-    // Find the largest RecordId currently in use and estimate the number of records.
-    Cursor cursor(ctx, *this, /*forward=*/false);
-    if (auto record = cursor.next()) {
-        int64_t max = _makeKey(record->id);
-        _oplog_highestSeen = record->id;
-        _nextIdNum.store(1 + max);
-
-        if (_sizeStorer) {
-            long long numRecords;
-            long long dataSize;
-            _sizeStorer->loadFromCache(uri, &numRecords, &dataSize);
-            _numRecords.store(numRecords);
-            _dataSize.store(dataSize);
-            _sizeStorer->onCreate(this, numRecords, dataSize);
-        } else {
-            LOG(1) << "Doing scan of collection " << ns << " to get size and count info";
-
-            _numRecords.store(0);
-            _dataSize.store(0);
-
-            do {
-                _numRecords.fetchAndAdd(1);
-                _dataSize.fetchAndAdd(record->data.size());
-            } while ((record = cursor.next()));
-        }
+    // Opening the table is the expensive part of opening a record store, so when the size and
+    // count are known, uncapped collections wait for their first insert, delete or truncate to
+    // find the largest RecordId in use. Capped collections and the oplog track more state and
+    // are loaded now.
+    if (_sizeStorer && !_isCapped) {
+        _nextIdNum.store(0);
     } else {
-        _dataSize.store(0);
-        _numRecords.store(0);
-        // Need to start at 1 so we are always higher than RecordId::min()
-        _nextIdNum.store(1);
-        if (sizeStorer)
-            _sizeStorer->onCreate(this, 0, 0);
+        _loadNextId(ctx);
     }
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns)) {
         _oplogStones = std::make_shared<OplogStones>(ctx, this);
+    } else if (_isCapped && _cappedMaxDocs == -1 && wiredTigerCappedTruncationThread &&
+               WiredTigerKVEngine::initRsCappedTruncationThread()) {
+        // A maximum number of documents has to be enforced exactly, so only collections capped
+        // by size alone are truncated in the background.
+        _oplogStones = std::make_shared<OplogStones>(ctx, this);
     }
 }
 
@@ -869,9 +1091,6 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
     }
 
     LOG(1) << "~WiredTigerRecordStore for: " << ns();
-    if (_sizeStorer) {
-        _sizeStorer->onDestroy(this);
-    }
 
     if (_oplogStones) {
         _oplogStones->kill();
@@ -888,11 +1107,11 @@ bool WiredTigerRecordStore::inShutdown() const {
 }
 
 long long WiredTigerRecordStore::dataSize(OperationContext* txn) const {
-    return _dataSize.load();
+    return _sizeInfo->dataSize.load();
 }
 
 long long WiredTigerRecordStore::numRecords(OperationContext* txn) const {
-    return _numRecords.load();
+    return _sizeInfo->numRecords.load();
 }
 
 bool WiredTigerRecordStore::isCapped() const {
@@ -932,12 +1151,52 @@ int64_t WiredTigerRecordStore::storageSize(OperationContext* txn,
     return size;
 }
 
+// Retrieve the document from a cursor positioned in the whole table rather than a projection.
+int WiredTigerRecordStore::_getDocument(WT_CURSOR* c, WT_ITEM* value) const {
+    if (_projectedFields.empty()) {
+        return c->get_value(c, value);
+    }
+    WT_ITEM projected;
+    return c->get_value(c, value, &projected);
+}
+
+BSONObj WiredTigerRecordStore::_projectFields(const char* data) const {
+    BSONObjBuilder bob;
+    BSONForEach(elem, BSONObj(data)) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == "_id" ||
+            std::find(_projectedFields.begin(), _projectedFields.end(), fieldName) !=
+                _projectedFields.end()) {
+            bob.append(elem);
+        }
+    }
+    return bob.obj();
+}
+
+// Turn a stored value into the record it holds, which may point into 'value'.
+RecordData WiredTigerRecordStore::_toRecordData(const WT_ITEM& value) const {
+    const char* data = static_cast<const char*>(value.data);
+    if (_compressor) {
+        return _compressor->decompress(data, value.size);
+    }
+    return RecordData(data, value.size);
+}
+
+// The size of the record held by a stored value.
+int64_t WiredTigerRecordStore::_recordSize(const char* data, int len) const {
+    return _compressor ? WiredTigerRecordCompressor::uncompressedSize(data, len) : len;
+}
+
 // Retrieve the value from a positioned cursor.
 RecordData WiredTigerRecordStore::_getData(const WiredTigerCursor& cursor) const {
     WT_ITEM value;
     int ret = cursor->get_value(cursor.get(), &value);
     invariantWTOK(ret);
 
+    if (_compressor) {
+        return _toRecordData(value).getOwned();
+    }
+
     SharedBuffer data = SharedBuffer::allocate(value.size);
     memcpy(data.get(), value.data, value.size);
     return RecordData(data, value.size);
@@ -945,7 +1204,7 @@ RecordData WiredTigerRecordStore::_getData(const WiredTigerCursor& cursor) const
 
 RecordData WiredTigerRecordStore::dataFor(OperationContext* txn, const RecordId& id) const {
     // ownership passes to the shared_array created below
-    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    WiredTigerCursor curwrap(_readUri, _readTableId, true, txn);
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     c->set_key(c, _makeKey(id));
@@ -958,7 +1217,7 @@ RecordData WiredTigerRecordStore::dataFor(OperationContext* txn, const RecordId&
 bool WiredTigerRecordStore::findRecord(OperationContext* txn,
                                        const RecordId& id,
                                        RecordData* out) const {
-    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    WiredTigerCursor curwrap(_readUri, _readTableId, true, txn);
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     c->set_key(c, _makeKey(id));
@@ -976,6 +1235,8 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* txn, const RecordId&
     // WT_SESSION::truncate().
     invariant(!isCapped());
 
+    _loadNextIdIfNeeded(txn);
+
     WiredTigerCursor cursor(_uri, _tableId, true, txn);
     cursor.assertInActiveTxn();
     WT_CURSOR* c = cursor.get();
@@ -984,10 +1245,10 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* txn, const RecordId&
     invariantWTOK(ret);
 
     WT_ITEM old_value;
-    ret = c->get_value(c, &old_value);
+    ret = _getDocument(c, &old_value);
     invariantWTOK(ret);
 
-    int64_t old_length = old_value.size;
+    int64_t old_length = _recordSize(static_cast<const char*>(old_value.data), old_value.size);
 
     ret = WT_OP_CHECK(c->remove(c));
     invariantWTOK(ret);
@@ -1000,10 +1261,10 @@ bool WiredTigerRecordStore::cappedAndNeedDelete() const {
     if (!_isCapped)
         return false;
 
-    if (_dataSize.load() >= _cappedMaxSize)
+    if (_sizeInfo->dataSize.load() >= _cappedMaxSize)
         return true;
 
-    if ((_cappedMaxDocs != -1) && (_numRecords.load() > _cappedMaxDocs))
+    if ((_cappedMaxDocs != -1) && (_sizeInfo->numRecords.load() > _cappedMaxDocs))
         return true;
 
     return false;
@@ -1029,7 +1290,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
         if (!lock.try_lock()) {
             // Someone else is deleting old records. Apply back-pressure if too far behind,
             // otherwise continue.
-            if ((_dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack)
+            if ((_sizeInfo->dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack)
                 return 0;
 
             // Don't wait forever: we're in a transaction, we could block eviction.
@@ -1044,7 +1305,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
 
             // If we already waited, let someone else do cleanup unless we are significantly
             // over the limit.
-            if ((_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
+            if ((_sizeInfo->dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
                 return 0;
         }
     }
@@ -1064,8 +1325,8 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* txn
 
     WT_SESSION* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
 
-    int64_t dataSize = _dataSize.load();
-    int64_t numRecords = _numRecords.load();
+    int64_t dataSize = _sizeInfo->dataSize.load();
+    int64_t numRecords = _sizeInfo->numRecords.load();
 
     int64_t sizeOverCap = (dataSize > _cappedMaxSize) ? dataSize - _cappedMaxSize : 0;
     int64_t sizeSaved = 0;
@@ -1110,7 +1371,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* txn
                 break;
 
             WT_ITEM old_value;
-            invariantWTOK(truncateEnd->get_value(truncateEnd, &old_value));
+            invariantWTOK(_getDocument(truncateEnd, &old_value));
 
             ++docsRemoved;
             sizeSaved += old_value.size;
@@ -1214,7 +1475,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isNormal());
 
-        LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
+        LOG(1) << "Truncating " << ns() << " between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
                << " records totaling to " << stone->bytes << " bytes";
 
@@ -1232,9 +1493,18 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
             WT_CURSOR* end = endwrap.get();
             end->set_key(end, _makeKey(stone->lastRecord));
 
+            int64_t records = stone->records;
+            int64_t bytes = stone->bytes;
+            if (!_isOplog) {
+                // Unlike the oplog, other capped collections have indexes which must be told
+                // about every record going away, so the exact sizes are known as well.
+                _aboutToTruncateCapped(
+                    txn, _oplogStones->firstRecord, stone->lastRecord, &records, &bytes);
+            }
+
             invariantWTOK(session->truncate(session, nullptr, start, end, nullptr));
-            _changeNumRecords(txn, -stone->records);
-            _increaseDataSize(txn, -stone->bytes);
+            _changeNumRecords(txn, -records);
+            _increaseDataSize(txn, -bytes);
 
             wuow.commit();
 
@@ -1244,12 +1514,55 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
         } catch (const WriteConflictException& wce) {
-            LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
+            LOG(1) << "Caught WriteConflictException while truncating " << ns() << ", retrying";
+        }
+    }
+
+    LOG(1) << "Finished truncating " << ns() << ", it now contains approximately "
+           << _sizeInfo->numRecords.load() << " records totaling to "
+           << _sizeInfo->dataSize.load() << " bytes";
+}
+
+void WiredTigerRecordStore::_aboutToTruncateCapped(OperationContext* txn,
+                                                   const RecordId& firstRecord,
+                                                   const RecordId& lastRecord,
+                                                   int64_t* records,
+                                                   int64_t* bytes) {
+    *records = 0;
+    *bytes = 0;
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    WT_CURSOR* c = curwrap.get();
+    c->set_key(c, _makeKey(firstRecord));
+    int cmp;
+    int ret = WT_OP_CHECK(c->search_near(c, &cmp));
+    if (ret == 0 && cmp < 0) {
+        ret = WT_OP_CHECK(c->next(c));
+    }
+
+    while (ret == 0) {
+        int64_t key;
+        invariantWTOK(c->get_key(c, &key));
+        const RecordId id = _fromKey(key);
+        if (id > lastRecord) {
+            return;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(_getDocument(c, &value));
+        ++*records;
+        *bytes += value.size;
+
+        if (_cappedCallback) {
+            uassertStatusOK(_cappedCallback->aboutToDeleteCapped(
+                txn, id, RecordData(static_cast<const char*>(value.data), value.size)));
         }
+        ret = WT_OP_CHECK(c->next(c));
     }
 
-    LOG(1) << "Finished truncating the oplog, it now contains approximately " << _numRecords.load()
-           << " records totaling to " << _dataSize.load() << " bytes";
+    if (ret != WT_NOTFOUND) {
+        invariantWTOK(ret);
+    }
 }
 
 Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
@@ -1265,6 +1578,10 @@ Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
     if (_isCapped && totalLength > _cappedMaxSize)
         return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
 
+    if (!_useOplogHack) {
+        _loadNextIdIfNeeded(txn);
+    }
+
     WiredTigerCursor curwrap(_uri, _tableId, true, txn);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
@@ -1298,8 +1615,20 @@ Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
 
     for (auto& record : *records) {
         c->set_key(c, _makeKey(record.id));
-        WiredTigerItem value(record.data.data(), record.data.size());
-        c->set_value(c, value.Get());
+        const std::string compressed = _compressor
+            ? _compressor->compress(record.data.data(), record.data.size())
+            : std::string();
+        WiredTigerItem value = _compressor
+            ? WiredTigerItem(compressed)
+            : WiredTigerItem(record.data.data(), record.data.size());
+        BSONObj projected;
+        if (_projectedFields.empty()) {
+            c->set_value(c, value.Get());
+        } else {
+            projected = _projectFields(record.data.data());
+            WiredTigerItem projectedValue(projected.objdata(), projected.objsize());
+            c->set_value(c, value.Get(), projectedValue.Get());
+        }
         int ret = WT_OP_CHECK(c->insert(c));
         if (ret)
             return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
@@ -1308,6 +1637,12 @@ Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
     _changeNumRecords(txn, records->size());
     _increaseDataSize(txn, totalLength);
 
+    if (_compressor) {
+        for (const auto& record : *records) {
+            _sampleForCompression(txn, record);
+        }
+    }
+
     if (_oplogStones) {
         _oplogStones->updateCurrentStoneAfterInsertOnCommit(
             txn, totalLength, highestId, records->size());
@@ -1376,18 +1711,26 @@ StatusWith<RecordId> WiredTigerRecordStore::updateRecord(OperationContext* txn,
     invariantWTOK(ret);
 
     WT_ITEM old_value;
-    ret = c->get_value(c, &old_value);
+    ret = _getDocument(c, &old_value);
     invariantWTOK(ret);
 
-    int64_t old_length = old_value.size;
+    int64_t old_length = _recordSize(static_cast<const char*>(old_value.data), old_value.size);
 
-    if (_oplogStones && len != old_length) {
+    if (_oplogStones && _isOplog && len != old_length) {
         return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
     }
 
     c->set_key(c, _makeKey(id));
-    WiredTigerItem value(data, len);
-    c->set_value(c, value.Get());
+    const std::string compressed = _compressor ? _compressor->compress(data, len) : std::string();
+    WiredTigerItem value = _compressor ? WiredTigerItem(compressed) : WiredTigerItem(data, len);
+    BSONObj projected;
+    if (_projectedFields.empty()) {
+        c->set_value(c, value.Get());
+    } else {
+        projected = _projectFields(data);
+        WiredTigerItem projectedValue(projected.objdata(), projected.objsize());
+        c->set_value(c, value.Get(), projectedValue.Get());
+    }
     ret = WT_OP_CHECK(c->insert(c));
     invariantWTOK(ret);
 
@@ -1434,6 +1777,23 @@ std::unique_ptr<SeekableRecordCursor> WiredTigerRecordStore::getCursor(Operation
     return stdx::make_unique<Cursor>(txn, *this, forward);
 }
 
+std::unique_ptr<SeekableRecordCursor> WiredTigerRecordStore::getCursorForFields(
+    OperationContext* txn, const std::vector<std::string>& fields, bool forward) const {
+    if (_projectedFields.empty()) {
+        return {};
+    }
+
+    for (const auto& field : fields) {
+        if (field != "_id" &&
+            std::find(_projectedFields.begin(), _projectedFields.end(), field) ==
+                _projectedFields.end()) {
+            return {};
+        }
+    }
+
+    return stdx::make_unique<Cursor>(txn, *this, forward, Cursor::Mode::kProjectedFields);
+}
+
 std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(OperationContext* txn) const {
     const char* extraConfig = "";
     return getRandomCursorWithOptions(txn, extraConfig);
@@ -1452,6 +1812,8 @@ std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors
 }
 
 Status WiredTigerRecordStore::truncate(OperationContext* txn) {
+    _loadNextIdIfNeeded(txn);
+
     WiredTigerCursor startWrap(_uri, _tableId, true, txn);
     WT_CURSOR* start = startWrap.get();
     int ret = WT_OP_CHECK(start->next(start));
@@ -1533,16 +1895,17 @@ Status WiredTigerRecordStore::validate(OperationContext* txn,
     }
 
     if (_sizeStorer && results->valid) {
-        if (nrecords != _numRecords.load() || dataSizeTotal != _dataSize.load()) {
-            warning() << _uri << ": Existing record and data size counters (" << _numRecords.load()
-                      << " records " << _dataSize.load() << " bytes) "
+        const long long numRecords = _sizeInfo->numRecords.load();
+        const long long dataSize = _sizeInfo->dataSize.load();
+        if (nrecords != numRecords || dataSizeTotal != dataSize) {
+            warning() << _uri << ": Existing record and data size counters (" << numRecords
+                      << " records " << dataSize << " bytes) "
                       << "are inconsistent with validation results (" << nrecords << " records "
                       << dataSizeTotal << " bytes). "
                       << "Updating counters with new values.";
         }
-        _numRecords.store(nrecords);
-        _dataSize.store(dataSizeTotal);
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
+        _sizeInfo->numRecords.store(nrecords);
+        _sizeInfo->dataSize.store(dataSizeTotal);
     }
 
     output->appendNumber("nrecords", nrecords);
@@ -1558,6 +1921,7 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
         result->appendIntOrLL("maxSize", static_cast<long long>(_cappedMaxSize / scale));
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
+        result->appendBool("truncatedInBackground", _oplogStones && !_isOplog);
     }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn);
     WT_SESSION* s = session->getSession();
@@ -1571,9 +1935,16 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
             metadata.append("reason", status.reason());
         }
     }
+    if (_compressor) {
+        BSONObjBuilder compression(bob.subobjStart("dictionaryCompression"));
+        compression.append("currentDictionary", _compressor->currentDictionary());
+        compression.append("dictionaries", _compressor->maxDictionary());
+    }
 
     std::string type, sourceURI;
-    WiredTigerUtil::fetchTypeAndSourceURI(txn, _uri, &type, &sourceURI);
+    // Report the creation string of the column group holding whole documents.
+    WiredTigerUtil::fetchTypeAndSourceURI(
+        txn, _uri, &type, &sourceURI, _projectedFields.empty() ? StringData() : kDocColumn);
     StatusWith<std::string> metadataResult = WiredTigerUtil::getMetadata(txn, sourceURI);
     StringData creationStringName("creationString");
     if (!metadataResult.isOK()) {
@@ -1645,6 +2016,104 @@ void WiredTigerRecordStore::_addUncommitedRecordId_inlock(OperationContext* txn,
     _oplog_highestSeen = id;
 }
 
+class WiredTigerRecordStore::CompressionDictionaryChange : public RecoveryUnit::Change {
+public:
+    CompressionDictionaryChange(WiredTigerRecordStore* rs, int id) : _rs(rs), _id(id) {}
+
+    virtual void commit() {
+        // The dictionary is durable, so records compressed with it can be read back.
+        _rs->_compressor->setCurrentDictionary(_id);
+        stdx::lock_guard<stdx::mutex> lk(_rs->_compressionMutex);
+        _rs->_insertsSinceTraining = 0;
+        _rs->_trainingDictionary = false;
+    }
+
+    virtual void rollback() {
+        _rs->_compressor->removeDictionary(_id);
+        stdx::lock_guard<stdx::mutex> lk(_rs->_compressionMutex);
+        _rs->_trainingDictionary = false;
+    }
+
+private:
+    WiredTigerRecordStore* _rs;
+    const int _id;
+};
+
+void WiredTigerRecordStore::setCompressionDictionaries(OperationContext* txn,
+                                                       const std::vector<BSONObj>& dictionaries,
+                                                       CompressionDictionaryPersister persister) {
+    if (!_compressor) {
+        return;
+    }
+
+    for (const auto& dictionary : dictionaries) {
+        int len;
+        const char* data = dictionary["data"].binData(len);
+        _compressor->addDictionary(dictionary["id"].numberInt(), std::string(data, len));
+    }
+    if (const int id = _compressor->maxDictionary()) {
+        _compressor->setCurrentDictionary(id);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_compressionMutex);
+    _persistCompressionDictionary = std::move(persister);
+}
+
+void WiredTigerRecordStore::_sampleForCompression(OperationContext* txn, const Record& record) {
+    std::vector<BSONObj> samples;
+    CompressionDictionaryPersister persister;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_compressionMutex);
+        if (++_insertsSinceTraining % kCompressionSampleInterval == 0 &&
+            record.data.size() <= kMaxCompressionSampleSize) {
+            BSONObj sample = record.data.toBson().getOwned();
+            if (_compressionSamples.size() < kMaxCompressionSamples) {
+                _compressionSamples.push_back(std::move(sample));
+            } else {
+                _compressionSamples[_nextCompressionSample] = std::move(sample);
+                _nextCompressionSample = (_nextCompressionSample + 1) % kMaxCompressionSamples;
+            }
+        }
+
+        if (_trainingDictionary || !_persistCompressionDictionary) {
+            return;
+        }
+        const int retrainInterval = wiredTigerDictionaryRetrainInterval.load();
+        const bool due = _compressor->currentDictionary() == 0
+            ? _compressionSamples.size() >= kMinCompressionSamples
+            : retrainInterval > 0 && _insertsSinceTraining >= retrainInterval &&
+                _compressor->maxDictionary() < kMaxCompressionDictionaries;
+        if (!due) {
+            return;
+        }
+        _trainingDictionary = true;
+        samples = _compressionSamples;
+        persister = _persistCompressionDictionary;
+    }
+
+    const std::string dictionary = WiredTigerRecordCompressor::trainDictionary(samples);
+    if (dictionary.empty()) {
+        // Nothing recurs across these documents, so wait for new samples before trying again.
+        stdx::lock_guard<stdx::mutex> lk(_compressionMutex);
+        _compressionSamples.clear();
+        _nextCompressionSample = 0;
+        _insertsSinceTraining = 0;
+        _trainingDictionary = false;
+        return;
+    }
+
+    // The new dictionary is stored as part of this insert, and only used for new records once
+    // the insert commits.
+    const int id = _compressor->maxDictionary() + 1;
+    _compressor->addDictionary(id, dictionary);
+    txn->recoveryUnit()->registerChange(new CompressionDictionaryChange(this, id));
+    LOG(1) << "Trained compression dictionary " << id << " of " << dictionary.size()
+           << " bytes for " << ns() << " from " << samples.size() << " documents";
+    persister(txn,
+              BSON("id" << id << "data"
+                        << BSONBinData(dictionary.data(), dictionary.size(), BinDataGeneral)));
+}
+
 boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
     OperationContext* txn, const RecordId& startingPosition) const {
     if (!_useOplogHack)
@@ -1676,16 +2145,56 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
 void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* txn,
                                                    long long numRecords,
                                                    long long dataSize) {
-    _numRecords.store(numRecords);
-    _dataSize.store(dataSize);
+    _sizeInfo->numRecords.store(numRecords);
+    _sizeInfo->dataSize.store(dataSize);
+}
+
+void WiredTigerRecordStore::_loadNextId(OperationContext* txn) {
+    // Find the largest RecordId currently in use and estimate the number of records. The
+    // compression dictionaries may not have been loaded yet, so the records are read as stored.
+    Cursor cursor(txn, *this, /*forward=*/false, Cursor::Mode::kStored);
+    if (auto record = cursor.next()) {
+        int64_t max = _makeKey(record->id);
+        _oplog_highestSeen = record->id;
+        _nextIdNum.store(1 + max);
+
+        if (!_sizeStorer) {
+            LOG(1) << "Doing scan of collection " << ns() << " to get size and count info";
+
+            _sizeInfo->numRecords.store(0);
+            _sizeInfo->dataSize.store(0);
+
+            do {
+                _sizeInfo->numRecords.fetchAndAdd(1);
+                _sizeInfo->dataSize.fetchAndAdd(
+                    _recordSize(record->data.data(), record->data.size()));
+            } while ((record = cursor.next()));
+        }
+    } else {
+        _sizeInfo->dataSize.store(0);
+        _sizeInfo->numRecords.store(0);
+        // Need to start at 1 so we are always higher than RecordId::min()
+        _nextIdNum.store(1);
+    }
+}
+
+void WiredTigerRecordStore::_loadNextIdIfNeeded(OperationContext* txn) {
+    if (_nextIdNum.load()) {
+        return;
+    }
 
-    if (_sizeStorer) {
-        _sizeStorer->storeToCache(_uri, numRecords, dataSize);
+    // Every write which removes records calls this first, so the largest RecordId is found
+    // before it can be deleted. Storage engines with document level locking don't invalidate
+    // cursors on deletes, so RecordIds must never be reused while the server is running.
+    stdx::lock_guard<stdx::mutex> lk(_nextIdMutex);
+    if (!_nextIdNum.load()) {
+        _loadNextId(txn);
     }
 }
 
 RecordId WiredTigerRecordStore::_nextId() {
     invariant(!_useOplogHack);
+    invariant(_nextIdNum.load());
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
@@ -1700,7 +2209,7 @@ public:
     NumRecordsChange(WiredTigerRecordStore* rs, int64_t diff) : _rs(rs), _diff(diff) {}
     virtual void commit() {}
     virtual void rollback() {
-        _rs->_numRecords.fetchAndAdd(-_diff);
+        _rs->_sizeInfo->numRecords.fetchAndAdd(-_diff);
     }
 
 private:
@@ -1710,8 +2219,8 @@ private:
 
 void WiredTigerRecordStore::_changeNumRecords(OperationContext* txn, int64_t diff) {
     txn->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
-    if (_numRecords.fetchAndAdd(diff) < 0)
-        _numRecords.store(std::max(diff, int64_t(0)));
+    if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
+        _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
 }
 
 class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
@@ -1731,12 +2240,8 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* txn, int64_t amo
     if (txn)
         txn->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
 
-    if (_dataSize.fetchAndAdd(amount) < 0)
-        _dataSize.store(std::max(amount, int64_t(0)));
-
-    if (_sizeStorer && _sizeStorerCounter++ % 1000 == 0) {
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
-    }
+    if (_sizeInfo->dataSize.fetchAndAdd(amount) < 0)
+        _sizeInfo->dataSize.store(std::max(amount, int64_t(0)));
 }
 
 int64_t WiredTigerRecordStore::_makeKey(const RecordId& id) {
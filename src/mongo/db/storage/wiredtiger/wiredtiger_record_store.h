@@ -34,10 +34,14 @@
 #include <boost/thread/mutex.hpp>
 #include <set>
 #include <string>
+#include <vector>
+#include <wiredtiger.h>
 
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_compressor.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/synchronization.h"
@@ -54,9 +58,12 @@ namespace mongo {
 class RecoveryUnit;
 class WiredTigerCursor;
 class WiredTigerRecoveryUnit;
-class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
+
+// If true, capped collections without a maximum number of documents are truncated in the
+// background a stone at a time, like the oplog, instead of by the inserting threads.
+extern bool wiredTigerCappedTruncationThread;
 typedef std::list<RecordId> SortedRecordIds;
 
 class WiredTigerRecordStore : public RecordStore {
@@ -68,6 +75,19 @@ public:
      */
     static StatusWith<std::string> parseOptionsField(const BSONObj options);
 
+    /**
+     * Parses the 'columnGroups' field of the 'wiredTiger' collection options: the top-level
+     * fields which are copied into a column group of their own on every write, so that scans
+     * which only need those fields don't have to read whole documents.
+     */
+    static StatusWith<std::vector<std::string>> parseColumnGroupsField(const BSONElement& elem);
+
+    /**
+     * Parses the 'dictionaryCompression' field of the 'wiredTiger' collection options, which
+     * compresses each record against dictionaries trained from the collection's own documents.
+     */
+    static StatusWith<bool> parseDictionaryCompressionField(const BSONElement& elem);
+
     /**
      * Creates a configuration string suitable for 'config' parameter in WT_SESSION::create().
      * Configuration string is constructed from:
@@ -84,6 +104,16 @@ public:
                                                         const CollectionOptions& options,
                                                         StringData extraStrings);
 
+    /**
+     * Creates the column groups of the table 'uri', which must have just been created with
+     * 'config' from generateCreateString(). Does nothing unless 'options' name 'columnGroups'.
+     */
+    static Status createColumnGroups(WT_SESSION* session,
+                                     const std::string& engineName,
+                                     const std::string& uri,
+                                     const CollectionOptions& options,
+                                     const std::string& config);
+
     WiredTigerRecordStore(OperationContext* txn,
                           StringData ns,
                           StringData uri,
@@ -148,6 +178,9 @@ public:
 
     std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* txn,
                                                     bool forward) const final;
+    std::unique_ptr<SeekableRecordCursor> getCursorForFields(OperationContext* txn,
+                                                             const std::vector<std::string>& fields,
+                                                             bool forward) const final;
     std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* txn) const final;
 
     std::unique_ptr<RecordCursor> getRandomCursorWithOptions(OperationContext* txn,
@@ -203,6 +236,9 @@ public:
     void setCappedCallback(CappedCallback* cb) {
         _cappedCallback = cb;
     }
+    void setCompressionDictionaries(OperationContext* txn,
+                                    const std::vector<BSONObj>& dictionaries,
+                                    CompressionDictionaryPersister persister) final;
     int64_t cappedMaxDocs() const;
     int64_t cappedMaxSize() const;
 
@@ -215,6 +251,9 @@ public:
 
     void setSizeStorer(WiredTigerSizeStorer* ss) {
         _sizeStorer = ss;
+        if (_sizeStorer) {
+            _sizeStorer->store(_uri, _sizeInfo);
+        }
     }
 
     bool isCappedHidden(const RecordId& id) const;
@@ -237,7 +276,7 @@ public:
 
     class OplogStones;
 
-    // Exposed only for testing.
+    // Null unless the record store is truncated by stones, see OplogStones.
     OplogStones* oplogStones() {
         return _oplogStones.get();
     };
@@ -247,6 +286,7 @@ private:
     class RandomCursor;
 
     class CappedInsertChange;
+    class CompressionDictionaryChange;
     class NumRecordsChange;
     class DataSizeChange;
 
@@ -258,17 +298,57 @@ private:
     void _dealtWithCappedId(SortedRecordIds::iterator it);
     void _addUncommitedRecordId_inlock(OperationContext* txn, const RecordId& id);
 
+    /**
+     * Sets _nextIdNum past the largest RecordId in the table, and the size and count if they
+     * aren't kept by the size storer.
+     */
+    void _loadNextId(OperationContext* txn);
+    void _loadNextIdIfNeeded(OperationContext* txn);
     RecordId _nextId();
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* txn, int64_t diff);
     void _increaseDataSize(OperationContext* txn, int64_t amount);
     RecordData _getData(const WiredTigerCursor& cursor) const;
+    int _getDocument(WT_CURSOR* c, WT_ITEM* value) const;
+    RecordData _toRecordData(const WT_ITEM& value) const;
+    int64_t _recordSize(const char* data, int len) const;
+    void _sampleForCompression(OperationContext* txn, const Record& record);
+    BSONObj _projectFields(const char* data) const;
     void _oplogSetStartHack(WiredTigerRecoveryUnit* wru) const;
+    // Notifies the capped callback of the records in [firstRecord, lastRecord], which are about
+    // to be truncated, and counts them.
+    void _aboutToTruncateCapped(OperationContext* txn,
+                                const RecordId& firstRecord,
+                                const RecordId& lastRecord,
+                                int64_t* records,
+                                int64_t* bytes);
 
     const std::string _uri;
     const uint64_t _tableId;  // not persisted
 
+    // Top-level fields which are copied into the "projected" column group on every write. Empty
+    // if the table keeps each document in a single column.
+    const std::vector<std::string> _projectedFields;
+    // Whole documents are read through a projection onto the "doc" column, so that those reads
+    // don't touch the "projected" column group. Both are the same as _uri and _tableId for
+    // tables without column groups.
+    const std::string _readUri;
+    const uint64_t _readTableId;       // not persisted
+    const std::string _projectedUri;   // Empty for tables without column groups.
+    const uint64_t _projectedTableId;  // not persisted
+
+    // Non-null if records are stored compressed against trained dictionaries.
+    const std::unique_ptr<WiredTigerRecordCompressor> _compressor;
+    // Everything below is protected by _compressionMutex, and only used if _compressor is set.
+    stdx::mutex _compressionMutex;
+    CompressionDictionaryPersister _persistCompressionDictionary;
+    // Documents sampled from recent inserts, to train the next dictionary from.
+    std::vector<BSONObj> _compressionSamples;
+    size_t _nextCompressionSample = 0;
+    int64_t _insertsSinceTraining = 0;
+    bool _trainingDictionary = false;
+
     // Canonical engine name to use for retrieving options
     const std::string _engineName;
     // The capped settings should not be updated once operations have started
@@ -296,12 +376,15 @@ private:
     RecordId _oplog_highestSeen;
     mutable stdx::mutex _uncommittedRecordIdsMutex;
 
+    // Zero until the table has been read to find the largest RecordId in use, which is
+    // serialized by _nextIdMutex.
     AtomicInt64 _nextIdNum;
-    AtomicInt64 _dataSize;
-    AtomicInt64 _numRecords;
+    stdx::mutex _nextIdMutex;
 
+    // The number of records and data size, shared with _sizeStorer if there is one, which
+    // writes them out whenever they change.
+    std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
-    int _sizeStorerCounter;
 
     bool _shuttingDown;
 
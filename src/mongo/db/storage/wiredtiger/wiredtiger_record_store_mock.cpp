@@ -45,6 +45,14 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return NamespaceString::oplog(ns);
 }
 
+// static
+bool WiredTigerKVEngine::initRsCappedTruncationThread() {
+    return true;
+}
+
+// static
+void WiredTigerKVEngine::notifyCappedTruncationNeeded(StringData ns) {}
+
 MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
     setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
     return Status::OK();
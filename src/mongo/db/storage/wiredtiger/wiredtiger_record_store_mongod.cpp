@@ -45,6 +45,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -128,6 +129,86 @@ private:
     std::string _name;
 };
 
+/**
+ * Truncates the excess stones of capped collections other than the oplog. Unlike the oplog, of
+ * which there is one per node, there can be any number of capped collections, so they share a
+ * single thread which is told which collections to look at.
+ */
+class WiredTigerCappedTruncationThread : public BackgroundJob {
+public:
+    WiredTigerCappedTruncationThread() : BackgroundJob(false /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WTCappedTruncator";
+    }
+
+    void notify(const NamespaceString& ns) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _pending.insert(ns);
+        }
+        _cv.notify_one();
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        while (!inShutdown()) {
+            NamespaceString ns;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                if (_pending.empty()) {
+                    // Wake up periodically to notice shutdown.
+                    _cv.wait_for(lk, Seconds(1));
+                    continue;
+                }
+                ns = *_pending.begin();
+                _pending.erase(_pending.begin());
+            }
+            _truncate(ns);
+        }
+    }
+
+private:
+    void _truncate(const NamespaceString& ns) {
+        OperationContextImpl txn;
+
+        try {
+            ScopedTransaction transaction(&txn, MODE_IX);
+
+            AutoGetDb autoDb(&txn, ns.db(), MODE_IX);
+            Database* db = autoDb.getDb();
+            if (!db) {
+                return;  // Dropped since it asked to be truncated.
+            }
+
+            Lock::CollectionLock collectionLock(txn.lockState(), ns.ns(), MODE_IX);
+            Collection* collection = db->getCollection(ns);
+            if (!collection) {
+                return;
+            }
+
+            OldClientContext ctx(&txn, ns.ns(), false);
+            WiredTigerRecordStore* rs =
+                checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+            if (!rs->oplogStones()) {
+                return;  // Recreated without stones, e.g. by convertToCapped.
+            }
+            rs->reclaimOplog(&txn);
+        } catch (const DBException& e) {
+            // The collection will ask again once more stones are added.
+            warning() << "failed to truncate capped collection " << ns << ": " << e.toString();
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::set<NamespaceString> _pending;
+};
+
+stdx::mutex _cappedTruncationThreadMutex;
+WiredTigerCappedTruncationThread* _cappedTruncationThread = nullptr;
+
 }  // namespace
 
 // static
@@ -142,6 +223,12 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
         return false;
     }
 
+    if (storageGlobalParams.readOnly) {
+        LOG(1) << "not starting WiredTigerRecordStoreThread for " << ns
+               << " because we are in read-only mode";
+        return false;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
     NamespaceString nss(ns);
     if (_backgroundThreadNamespaces.count(nss)) {
@@ -155,4 +242,26 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return true;
 }
 
+// static
+bool WiredTigerKVEngine::initRsCappedTruncationThread() {
+    if (storageGlobalParams.repair || storageGlobalParams.readOnly) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_cappedTruncationThreadMutex);
+    if (!_cappedTruncationThread) {
+        log() << "Starting WiredTigerCappedTruncationThread";
+        _cappedTruncationThread = new WiredTigerCappedTruncationThread();
+        _cappedTruncationThread->go();
+    }
+    return true;
+}
+
+// static
+void WiredTigerKVEngine::notifyCappedTruncationNeeded(StringData ns) {
+    stdx::lock_guard<stdx::mutex> lock(_cappedTruncationThreadMutex);
+    invariant(_cappedTruncationThread);
+    _cappedTruncationThread->notify(NamespaceString(ns));
+}
+
 }  // namespace mongo
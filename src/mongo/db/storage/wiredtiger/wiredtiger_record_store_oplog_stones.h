@@ -42,7 +42,8 @@ class OperationContext;
 class RecordId;
 
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
-// grows beyond its desired maximum size.
+// grows beyond its desired maximum size. Other capped collections use them too when
+// 'wiredTigerCappedTruncationThread' is enabled.
 class WiredTigerRecordStore::OplogStones {
 public:
     struct Stone {
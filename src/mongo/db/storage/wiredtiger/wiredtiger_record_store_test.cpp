@@ -39,6 +39,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -111,6 +113,33 @@ public:
             &txn, ns, uri, kWiredTigerEngineName, false, false);
     }
 
+    std::unique_ptr<RecordStore> newColumnGroupsRecordStore(const std::string& ns,
+                                                            const BSONArray& fields) {
+        WiredTigerRecoveryUnit* ru = new WiredTigerRecoveryUnit(_sessionCache);
+        OperationContextNoop txn(ru);
+        string uri = "table:" + ns;
+
+        CollectionOptions options;
+        options.storageEngine =
+            BSON(kWiredTigerEngineName << BSON("columnGroups" << fields));
+        StatusWith<std::string> result =
+            WiredTigerRecordStore::generateCreateString(kWiredTigerEngineName, ns, options, "");
+        ASSERT_TRUE(result.isOK());
+        std::string config = result.getValue();
+
+        {
+            WriteUnitOfWork uow(&txn);
+            WT_SESSION* s = ru->getSession(&txn)->getSession();
+            invariantWTOK(s->create(s, uri.c_str(), config.c_str()));
+            ASSERT_OK(WiredTigerRecordStore::createColumnGroups(
+                s, kWiredTigerEngineName, uri, options, config));
+            uow.commit();
+        }
+
+        return stdx::make_unique<WiredTigerRecordStore>(
+            &txn, ns, uri, kWiredTigerEngineName, false, false);
+    }
+
     std::unique_ptr<RecordStore> newCappedRecordStore(int64_t cappedSizeBytes,
                                                       int64_t cappedMaxDocs) final {
         return newCappedRecordStore("a.b", cappedSizeBytes, cappedMaxDocs);
@@ -205,6 +234,39 @@ TEST(WiredTigerRecordStoreTest, GenerateCreateStringValidConfigStringOption) {
               std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringValidColumnGroups) {
+    BSONObj spec = fromjson("{columnGroups: ['a', 'b']}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec), std::string(""));
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringInvalidColumnGroups) {
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: 'a'}")),
+              ErrorCodes::TypeMismatch);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: [1]}")),
+              ErrorCodes::TypeMismatch);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: []}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: ['a.b']}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: ['a,b']}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: ['$a']}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: ['_id']}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{columnGroups: ['a', 'a']}")),
+              ErrorCodes::BadValue);
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringColumnGroupsCapped) {
+    CollectionOptions options;
+    options.capped = true;
+    options.storageEngine = BSON(kWiredTigerEngineName << BSON("columnGroups" << BSON_ARRAY("a")));
+    ASSERT_EQ(WiredTigerRecordStore::generateCreateString(kWiredTigerEngineName, "a.b", options, "")
+                  .getStatus(),
+              ErrorCodes::InvalidOptions);
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation1) {
     unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -382,6 +444,147 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// A record store which gets its size and count from the size storer doesn't read the table until
+// its first insert, which must still get a RecordId larger than those already in use.
+TEST(WiredTigerRecordStoreTest, SizeStorerDefersFindingLargestRecordId) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    RecordId lastId;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 10; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            lastId = res.getValue();
+        }
+        uow.commit();
+    }
+
+    WiredTigerSizeStorer ss(harnessHelper->conn(), "table:sizeStorer");
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        rs.reset(new WiredTigerRecordStore(
+            opCtx.get(), "a.b", uri, kWiredTigerEngineName, false, false, -1, -1, NULL, &ss));
+        rs->updateStatsAfterRepair(opCtx.get(), 10, 20);
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(10, rs->numRecords(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "b", 2, false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastId);
+        uow.commit();
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(11, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS(string("a"), rs->dataFor(opCtx.get(), lastId).data());
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
+TEST(WiredTigerRecordStoreTest, DeferredLargestRecordIdSurvivesDeletingIt) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    RecordId lastId;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 10; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            lastId = res.getValue();
+        }
+        uow.commit();
+    }
+
+    WiredTigerSizeStorer ss(harnessHelper->conn(), "table:sizeStorer");
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        rs.reset(new WiredTigerRecordStore(
+            opCtx.get(), "a.b", uri, kWiredTigerEngineName, false, false, -1, -1, NULL, &ss));
+        rs->updateStatsAfterRepair(opCtx.get(), 10, 20);
+    }
+
+    // Deleting the record with the largest RecordId before anything is inserted must not let
+    // that RecordId be handed out again.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), lastId);
+        uow.commit();
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "b", 2, false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastId);
+        uow.commit();
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(10, rs->numRecords(opCtx.get()));
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
+TEST(WiredTigerRecordStoreTest, SizeStorerSyncsOnlyChangedSizes) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    const string storageUri = "table:sizeStorer";
+    WiredTigerSizeStorer ss(harnessHelper->conn(), storageUri);
+
+    ss.storeToCache("table:a", 1, 10);
+    ss.storeToCache("table:b", 2, 20);
+    ss.syncCache(true);
+
+    // Overwrite the stored sizes of 'b' behind the size storer's back.
+    {
+        WiredTigerSession session(harnessHelper->conn());
+        WT_SESSION* s = session.getSession();
+        WT_CURSOR* c;
+        invariantWTOK(s->open_cursor(s, storageUri.c_str(), NULL, "overwrite=true", &c));
+        BSONObj data = BSON("numRecords" << 7LL << "dataSize" << 70LL);
+        const string key = "table:b";
+        WiredTigerItem keyItem(key.c_str(), key.size());
+        WiredTigerItem valueItem(data.objdata(), data.objsize());
+        c->set_key(c, keyItem.Get());
+        c->set_value(c, valueItem.Get());
+        invariantWTOK(c->insert(c));
+        invariantWTOK(c->close(c));
+    }
+
+    // Only 'a' changed, so 'b' isn't written again.
+    std::shared_ptr<WiredTigerSizeStorer::SizeInfo> sizeInfo = ss.load("table:a");
+    sizeInfo->numRecords.fetchAndAdd(1);
+    sizeInfo->dataSize.fetchAndAdd(10);
+    ss.syncCache(true);
+
+    WiredTigerSizeStorer ss2(harnessHelper->conn(), storageUri);
+    ss2.fillCache();
+    long long numRecords;
+    long long dataSize;
+    ss2.loadFromCache("table:a", &numRecords, &dataSize);
+    ASSERT_EQUALS(2, numRecords);
+    ASSERT_EQUALS(20, dataSize);
+    ss2.loadFromCache("table:b", &numRecords, &dataSize);
+    ASSERT_EQUALS(7, numRecords);
+    ASSERT_EQUALS(70, dataSize);
+}
+
 namespace {
 
 class GoodValidateAdaptor : public ValidateAdaptor {
@@ -928,6 +1131,92 @@ TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     ASSERT_EQUALS(creationStringElement.type(), String);
 }
 
+TEST(WiredTigerRecordStoreTest, CursorForFieldsWithoutColumnGroups) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b"));
+
+    unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+    ASSERT(!rs->getCursorForFields(opCtx.get(), {"a"}));
+}
+
+TEST(WiredTigerRecordStoreTest, ColumnGroups) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newColumnGroupsRecordStore("a.b", BSON_ARRAY("a" << "b")));
+
+    const BSONObj doc1 = BSON("_id" << 1 << "a" << 1 << "c" << BSON("x" << 1) << "b" << 1);
+    const BSONObj doc2 = BSON("_id" << 2 << "c" << 2);
+    const BSONObj doc3 = BSON("_id" << 3 << "b" << BSON_ARRAY(1 << 2) << "a" << 3);
+    const BSONObj doc1Updated = BSON("_id" << 1 << "a" << 10 << "c" << 10);
+
+    RecordId id1, id2, id3;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        id1 = uassertStatusOK(rs->insertRecord(opCtx.get(), doc1.objdata(), doc1.objsize(), false));
+        id2 = uassertStatusOK(rs->insertRecord(opCtx.get(), doc2.objdata(), doc2.objsize(), false));
+        id3 = uassertStatusOK(rs->insertRecord(opCtx.get(), doc3.objdata(), doc3.objsize(), false));
+        ASSERT_OK(rs->updateRecord(opCtx.get(),
+                                   id1,
+                                   doc1Updated.objdata(),
+                                   doc1Updated.objsize(),
+                                   false,
+                                   NULL)
+                      .getStatus());
+        rs->deleteRecord(opCtx.get(), id2);
+        uow.commit();
+    }
+
+    unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+    ASSERT_EQUALS(2, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(doc1Updated.objsize() + doc3.objsize(), rs->dataSize(opCtx.get()));
+    ASSERT_EQUALS(doc3, rs->dataFor(opCtx.get(), id3).toBson());
+
+    // Ordinary cursors return whole documents.
+    {
+        auto cursor = rs->getCursor(opCtx.get());
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(id1, record->id);
+        ASSERT_EQUALS(doc1Updated, record->data.toBson());
+        record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(doc3, record->data.toBson());
+        ASSERT(!cursor->next());
+    }
+
+    // Cursors over projected fields return _id and those fields, in document order.
+    {
+        auto cursor = rs->getCursorForFields(opCtx.get(), {"_id", "b", "a"}, true);
+        ASSERT(cursor);
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(id1, record->id);
+        ASSERT_EQUALS(BSON("_id" << 1 << "a" << 10), record->data.toBson());
+
+        cursor->save();
+        ASSERT(cursor->restore());
+
+        record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQUALS(BSON("_id" << 3 << "b" << BSON_ARRAY(1 << 2) << "a" << 3),
+                      record->data.toBson());
+        ASSERT(!cursor->next());
+
+        record = cursor->seekExact(id1);
+        ASSERT(record);
+        ASSERT_EQUALS(BSON("_id" << 1 << "a" << 10), record->data.toBson());
+    }
+
+    // Fields outside the column group need whole documents.
+    ASSERT(!rs->getCursorForFields(opCtx.get(), {"a", "c"}, true));
+
+    BSONObjBuilder builder;
+    rs->appendCustomStats(opCtx.get(), &builder, 1.0);
+    BSONObj metadata = builder.obj()[kWiredTigerEngineName]["metadata"].Obj();
+    ASSERT_EQUALS("a,b", metadata["projectedFields"].str());
+}
+
 TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, 50));
@@ -1443,4 +1732,91 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+class CountingCappedCallback : public CappedCallback {
+public:
+    Status aboutToDeleteCapped(OperationContext* txn, const RecordId& loc, RecordData data) final {
+        deleted.push_back(loc);
+        return Status::OK();
+    }
+
+    void notifyCappedWaitersIfNeeded() final {}
+
+    std::vector<RecordId> deleted;
+};
+
+// Capped collections other than the oplog are truncated by stones when
+// 'wiredTigerCappedTruncationThread' is enabled, and their indexes are told about every record
+// that goes away.
+TEST(WiredTigerRecordStoreTest, CappedStones_ReclaimStones) {
+    const bool oldCappedTruncationThread = wiredTigerCappedTruncationThread;
+    wiredTigerCappedTruncationThread = true;
+    ON_BLOCK_EXIT([oldCappedTruncationThread] {
+        wiredTigerCappedTruncationThread = oldCappedTruncationThread;
+    });
+
+    WiredTigerHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", cappedMaxSize, -1));
+    CountingCappedCallback callback;
+    rs->setCappedCallback(&callback);
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* stones = wtrs->oplogStones();
+    ASSERT(stones);
+
+    stones->setMinBytesPerStone(100);
+    stones->setNumStonesToKeep(2U);
+
+    std::vector<RecordId> ids;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+        for (int i = 0; i < 4; i++) {
+            BSONObj obj = makeBSONObjWithSize(Timestamp(1, i + 1), 100);
+            WriteUnitOfWork wuow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false);
+            ASSERT_OK(res.getStatus());
+            wuow.commit();
+            ids.push_back(res.getValue());
+        }
+
+        // Nothing is deleted by the inserts themselves.
+        ASSERT_EQ(4, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(400, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(4U, stones->numStones());
+        ASSERT(callback.deleted.empty());
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, stones->numStones());
+        ASSERT_EQ(2U, callback.deleted.size());
+        ASSERT_EQ(ids[0], callback.deleted[0]);
+        ASSERT_EQ(ids[1], callback.deleted[1]);
+
+        RecordData data;
+        ASSERT_FALSE(rs->findRecord(opCtx.get(), ids[1], &data));
+        ASSERT_TRUE(rs->findRecord(opCtx.get(), ids[2], &data));
+    }
+}
+
+// Capped collections with a maximum number of documents still delete as they insert.
+TEST(WiredTigerRecordStoreTest, CappedStones_NotUsedWithMaxDocs) {
+    const bool oldCappedTruncationThread = wiredTigerCappedTruncationThread;
+    wiredTigerCappedTruncationThread = true;
+    ON_BLOCK_EXIT([oldCappedTruncationThread] {
+        wiredTigerCappedTruncationThread = oldCappedTruncationThread;
+    });
+
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", 10 * 1024, 5));
+    ASSERT_FALSE(static_cast<WiredTigerRecordStore*>(rs.get())->oplogStones());
+}
+
 }  // namespace mongo
@@ -33,19 +33,78 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/system_clock_source.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerSessionCachePartitions, int, 0);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerSessionCacheMaxPerPartition, int, 256);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalCommitWindowMicros, int, 0);
+
+namespace {
+
+const size_t kMaxSessionCachePartitions = 128;
+
+// The commit window is capped so that a bad setting can't stall every j:true write.
+const int kMaxJournalCommitWindowMicros = 100 * 1000;
+
+// Lower bounds of the buckets of the group commit histograms.
+const uint64_t kBatchSizeBuckets[] = {1, 2, 4, 8, 16, 32, 64, 128};
+const uint64_t kDurableLatencyBucketsMicros[] = {
+    0, 100, 250, 500, 1000, 2500, 5000, 10 * 1000, 25 * 1000, 50 * 1000, 100 * 1000};
+
+template <size_t N>
+size_t histogramBucket(const uint64_t(&buckets)[N], uint64_t value) {
+    size_t i = N - 1;
+    while (i > 0 && value < buckets[i]) {
+        i--;
+    }
+    return i;
+}
+
+template <size_t N>
+void appendHistogram(BSONObjBuilder* builder,
+                     StringData name,
+                     const uint64_t(&buckets)[N],
+                     const uint64_t* counts) {
+    BSONObjBuilder histogram(builder->subobjStart(name));
+    for (size_t i = 0; i < N; i++) {
+        histogram.appendNumber(std::to_string(buckets[i]), static_cast<long long>(counts[i]));
+    }
+}
+
+// Threads are assigned session cache partitions round-robin the first time they use one. Zero
+// means that the thread has not been assigned one yet.
+AtomicUInt32 nextPartitionSlot;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL uint32_t threadPartitionSlot;
+
+}  // namespace
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, int epoch)
-    : _epoch(epoch), _session(NULL), _cursorGen(0), _cursorsCached(0), _cursorsOut(0) {
+    : _epoch(epoch),
+      _cache(NULL),
+      _session(NULL),
+      _cursorGen(0),
+      _cursorsCached(0),
+      _cursorsOut(0),
+      _cursorCacheHits(0),
+      _cursorCacheMisses(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
 }
 
@@ -55,7 +114,9 @@ WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, WiredTigerSessionCache
       _session(NULL),
       _cursorGen(0),
       _cursorsCached(0),
-      _cursorsOut(0) {
+      _cursorsOut(0),
+      _cursorCacheHits(0),
+      _cursorCacheMisses(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
 }
 
@@ -73,13 +134,23 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
             _cursors.erase(i);
             _cursorsOut++;
             _cursorsCached--;
+            _cursorCacheHits++;
             return c;
         }
     }
 
+    _cursorCacheMisses++;
+
+    // In read-only mode, cursors on tables read the last checkpoint. WiredTiger maps the files
+    // of checkpoint cursors into memory, so uncompressed pages are read straight from the OS
+    // page cache instead of being copied into the WiredTiger cache.
+    const char* config = forRecordStore ? "" : "overwrite=false";
+    if (id != kMetadataTableId && _cache && _cache->isReadOnly()) {
+        config = "checkpoint=WiredTigerCheckpoint";
+    }
+
     WT_CURSOR* c = NULL;
-    int ret = _session->open_cursor(
-        _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
+    int ret = _session->open_cursor(_session, uri.c_str(), NULL, config, &c);
     if (ret != ENOENT)
         invariantWTOK(ret);
     if (c)
@@ -133,10 +204,44 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _clockSource(SystemClockSource::get()),
+      _snapshotManager(_conn),
+      _shuttingDown(0) {
+    _initPartitions();
+}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _clockSource(SystemClockSource::get()),
+      _snapshotManager(_conn),
+      _shuttingDown(0) {
+    _initPartitions();
+}
+
+void WiredTigerSessionCache::_initPartitions() {
+    size_t numPartitions = wiredTigerSessionCachePartitions > 0
+        ? static_cast<size_t>(wiredTigerSessionCachePartitions)
+        : ProcessInfo().getNumCores();
+    numPartitions = std::max<size_t>(1, std::min(numPartitions, kMaxSessionCachePartitions));
+
+    for (size_t i = 0; i < numPartitions; i++) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+
+    _maxSessionsPerPartition =
+        static_cast<size_t>(std::max(0, wiredTigerSessionCacheMaxPerPartition));
+}
+
+WiredTigerSessionCache::Partition& WiredTigerSessionCache::_threadPartition() {
+    if (threadPartitionSlot == 0) {
+        threadPartitionSlot = (nextPartitionSlot.fetchAndAdd(1) & 0x7fffffff) + 1;
+    }
+
+    return *_partitions[(threadPartitionSlot - 1) % _partitions.size()];
+}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -171,9 +276,14 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
             "Cannot wait for durability because a shutdown is in progress",
             !(shuttingDown & kShuttingDownMask));
 
+    if (isReadOnly()) {
+        // Nothing is ever written, so everything is already durable.
+        return;
+    }
+
     // When forcing a checkpoint with journaling enabled, don't synchronize with other
     // waiters, as a log flush is much cheaper than a full checkpoint.
-    if (forceCheckpoint && _engine->isDurable()) {
+    if (forceCheckpoint && _engine && _engine->isDurable()) {
         UniqueWiredTigerSession session = getSession();
         WT_SESSION* s = session->getSession();
         {
@@ -186,18 +296,65 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
+    Timer timer;
+    stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+
+    // Any flush which starts from now on makes our commits durable.
+    const uint64_t target = _flushesStarted + 1;
+    _flushWaiters[target % 2]++;
+
+    while (_flushesCompleted < target) {
+        if (_flushInProgress) {
+            // Either it is our flush, or we will be woken to start ours once it completes.
+            _flushCompleted[target % 2].wait(lk);
+            continue;
+        }
+
+        // Flush on behalf of every caller waiting for the target flush, after giving more
+        // commits the chance to join it.
+        _flushInProgress = true;
+        const int commitWindowMicros =
+            std::min(wiredTigerJournalCommitWindowMicros.load(), kMaxJournalCommitWindowMicros);
+        if (commitWindowMicros > 0) {
+            lk.unlock();
+            sleepmicros(commitWindowMicros);
+            lk.lock();
+        }
+        const uint64_t flush = ++_flushesStarted;
+        invariant(flush == target);
+        lk.unlock();
+
+        // If the flush throws, nothing became durable. Take it back and wake the other callers
+        // waiting for it, so that one of them retries it instead of all waiting forever.
+        ScopeGuard flushFailed = MakeGuard([&] {
+            lk.lock();
+            _flushesStarted--;
+            _flushInProgress = false;
+            _flushWaiters[flush % 2]--;
+            _flushCompleted[flush % 2].notify_all();
+        });
+
+        _flushForDurability();
+
+        flushFailed.Dismiss();
+        lk.lock();
+        _flushesCompleted = flush;
+        _flushInProgress = false;
+        _batchSizeHistogram[histogramBucket(kBatchSizeBuckets, _flushWaiters[flush % 2])]++;
+        _flushWaiters[flush % 2] = 0;
+        _flushCompleted[flush % 2].notify_all();
+
+        // Callers which arrived during this flush need the next one, so wake one of them to
+        // start it.
+        if (_flushWaiters[(flush + 1) % 2]) {
+            _flushCompleted[(flush + 1) % 2].notify_one();
+        }
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    _durableLatencyHistogram[histogramBucket(kDurableLatencyBucketsMicros, timer.micros())]++;
+}
+
+void WiredTigerSessionCache::_flushForDurability() {
     auto session = getSession();
     WT_SESSION* s = session->getSession();
 
@@ -207,7 +364,7 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
     JournalListener::Token token = _journalListener->getToken();
 
     // Use the journal when available, or a checkpoint otherwise.
-    if (_engine->isDurable()) {
+    if (_engine && _engine->isDurable()) {
         invariantWTOK(s->log_flush(s, "sync=on"));
         LOG(4) << "flushed journal";
     } else {
@@ -218,17 +375,52 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions are only
+    // returned to a partition if their epoch matches while holding its lock, so none of them
+    // can be added back once the partition has been emptied below.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    for (auto&& partition : _partitions) {
+        SessionCache swap;
+
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition->lock);
+            partition->sessions.swap(swap);
+        }
+
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
+}
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+void WiredTigerSessionCache::setClockSource(ClockSource* clockSource) {
+    _clockSource = clockSource;
+}
+
+void WiredTigerSessionCache::closeExpiredIdleSessions(Milliseconds idleTime) {
+    const Date_t cutoff = _clockSource->now() - idleTime;
+
+    for (auto&& partition : _partitions) {
+        SessionCache expired;
+
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition->lock);
+
+            // Sessions are taken from and returned to the back, so the ones which have been
+            // idle longest are at the front.
+            auto firstKept = partition->sessions.begin();
+            while (firstKept != partition->sessions.end() && (*firstKept)->_lastReleased < cutoff) {
+                ++firstKept;
+            }
+            expired.assign(partition->sessions.begin(), firstKept);
+            partition->sessions.erase(partition->sessions.begin(), firstKept);
+            partition->idleSessionsClosed += expired.size();
+        }
+
+        for (SessionCache::iterator i = expired.begin(); i != expired.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -236,18 +428,34 @@ bool WiredTigerSessionCache::isEphemeral() {
     return _engine && _engine->isEphemeral();
 }
 
+bool WiredTigerSessionCache::isReadOnly() const {
+    return _engine && _engine->isReadOnly();
+}
+
 UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // We should never be able to get here after _shuttingDown is set, because no new
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    Partition& threadPartition = _threadPartition();
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+        stdx::lock_guard<stdx::mutex> lock(threadPartition.lock);
+        if (!threadPartition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = threadPartition.sessions.back();
+            threadPartition.sessions.pop_back();
+            return UniqueWiredTigerSession(cachedSession);
+        }
+    }
+
+    // Take an idle session from another partition rather than opening a new one, without
+    // waiting on partitions which are in use
+    for (auto&& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lock(partition->lock, stdx::try_to_lock);
+        if (lock && !partition->sessions.empty()) {
+            WiredTigerSession* cachedSession = partition->sessions.back();
+            partition->sessions.pop_back();
             return UniqueWiredTigerSession(cachedSession);
         }
     }
@@ -281,16 +489,24 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     }
 
     bool returnedToCache = false;
-    uint64_t currentEpoch = _epoch.load();
+    invariant(session->_getEpoch() <= _epoch.load());
 
-    if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+    Partition& partition = _threadPartition();
+    {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+
+        partition.cursorCacheHits += session->_cursorCacheHits;
+        partition.cursorCacheMisses += session->_cursorCacheMisses;
+        session->_cursorCacheHits = 0;
+        session->_cursorCacheMisses = 0;
+
+        if (session->_getEpoch() == _epoch.load() &&
+            partition.sessions.size() < _maxSessionsPerPartition) {
             returnedToCache = true;
-            _sessions.push_back(session);
+            session->_lastReleased = _clockSource->now();
+            partition.sessions.push_back(session);
         }
-    } else
-        invariant(session->_getEpoch() < currentEpoch);
+    }
 
     if (!returnedToCache)
         delete session;
@@ -300,6 +516,36 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) {
+    long long cachedSessions = 0;
+    long long cursorCacheHits = 0;
+    long long cursorCacheMisses = 0;
+    long long idleSessionsClosed = 0;
+
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->lock);
+        cachedSessions += partition->sessions.size();
+        cursorCacheHits += partition->cursorCacheHits;
+        cursorCacheMisses += partition->cursorCacheMisses;
+        idleSessionsClosed += partition->idleSessionsClosed;
+    }
+
+    BSONObjBuilder bob(builder->subobjStart("sessionCache"));
+    bob.appendNumber("partitions", static_cast<long long>(_partitions.size()));
+    bob.appendNumber("cachedSessions", cachedSessions);
+    bob.appendNumber("idleSessionsClosed", idleSessionsClosed);
+    bob.appendNumber("cursorCacheHits", cursorCacheHits);
+    bob.appendNumber("cursorCacheMisses", cursorCacheMisses);
+    bob.done();
+
+    BSONObjBuilder groupCommit(builder->subobjStart("groupCommit"));
+    stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+    groupCommit.appendNumber("flushes", static_cast<long long>(_flushesCompleted));
+    appendHistogram(&groupCommit, "batchSize", kBatchSizeBuckets, _batchSizeHistogram);
+    appendHistogram(
+        &groupCommit, "latencyMicros", kDurableLatencyBucketsMicros, _durableLatencyHistogram);
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -40,14 +43,28 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+class ClockSource;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
+// Number of partitions of the session cache; 0 means one per core
+extern int wiredTigerSessionCachePartitions;
+
+// Maximum number of idle sessions kept in each partition of the session cache
+extern int wiredTigerSessionCacheMaxPerPartition;
+
+// How long the thread which flushes the journal for waitUntilDurable waits for more commits to
+// join the flush, in microseconds
+extern std::atomic<int> wiredTigerJournalCommitWindowMicros;  // NOLINT
+
 class WiredTigerCachedCursor {
 public:
     WiredTigerCachedCursor(uint64_t id, uint64_t gen, WT_CURSOR* cursor)
@@ -126,11 +143,22 @@ private:
     CursorCache _cursors;            // owned
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
+
+    // Cursor cache hits and misses in getCursor since the session was last returned to the
+    // session cache, which accumulates them
+    uint64_t _cursorCacheHits, _cursorCacheMisses;
+
+    // When the session was last returned to the session cache
+    Date_t _lastReleased;
 };
 
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into partitions, each with its own mutex, and every thread gets and
+ *  releases sessions through the partition it is assigned to, so that short operations running
+ *  on many cores do not all serialize on one lock.
  */
 class WiredTigerSessionCache {
 public:
@@ -159,6 +187,19 @@ public:
      */
     void closeAll();
 
+    /**
+     * Closes the cached sessions which have been idle for longer than 'idleTime', along with
+     * their cached cursors. Open cursors keep WiredTiger from closing the handles of tables that
+     * are no longer used, so this lets idle tables be closed.
+     */
+    void closeExpiredIdleSessions(Milliseconds idleTime);
+
+    /**
+     * Replaces the clock which measures how long sessions have been idle. Only for testing, and
+     * must be called before any session is released.
+     */
+    void setClockSource(ClockSource* clockSource);
+
     /**
      * Transitions the cache to shutting down mode. Any already released sessions are freed and
      * any sessions released subsequently are leaked. Must be called while holding the global
@@ -167,10 +208,19 @@ public:
     void shuttingDown();
 
     bool isEphemeral();
+
+    /**
+     * True if the engine was started in read-only mode, see WiredTigerKVEngine::isReadOnly().
+     */
+    bool isReadOnly() const;
+
     /**
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers are grouped: the first one to arrive flushes on behalf of all those
+     * that arrive before its flush starts, optionally after waiting for the commit window.
      */
     void waitUntilDurable(bool forceCheckpoint);
 
@@ -187,9 +237,41 @@ public:
 
     void setJournalListener(JournalListener* jl);
 
+    /**
+     * Appends the number of cached sessions and of idle sessions closed, the cursor cache hits
+     * and misses of all the sessions which have been returned to this cache, and histograms of
+     * the number of waitUntilDurable callers per flush and of how long they waited.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
 private:
+    typedef std::vector<WiredTigerSession*> SessionCache;
+
+    struct Partition {
+        stdx::mutex lock;
+        SessionCache sessions;  // Must hold lock for access
+
+        // Accumulated from the sessions released through this partition. Must hold lock.
+        uint64_t cursorCacheHits = 0;
+        uint64_t cursorCacheMisses = 0;
+
+        // Number of sessions closed by closeExpiredIdleSessions. Must hold lock.
+        uint64_t idleSessionsClosed = 0;
+
+        // Keeps whatever is allocated after this partition off the cache lines written above
+        char padding[64];
+    };
+
+    void _initPartitions();
+
+    /**
+     * Returns the partition which the calling thread gets and releases sessions through.
+     */
+    Partition& _threadPartition();
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
+    ClockSource* _clockSource;    // not owned
     WiredTigerSnapshotManager _snapshotManager;
 
     // Used as follows:
@@ -198,16 +280,39 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    // Partitions are allocated separately and each ends in a cache line of padding, so that no
+    // two partitions' mutexes and counters share a cache line, whatever order they land in.
+    std::vector<std::unique_ptr<Partition>> _partitions;
+    size_t _maxSessionsPerPartition;
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicUInt32 _lastSyncTime;
-    stdx::mutex _lastSyncMutex;
+    static const size_t kNumBatchSizeBuckets = 8;
+    static const size_t kNumDurableLatencyBuckets = 11;
+
+    /**
+     * Flushes the journal, or takes a checkpoint if there isn't one, and notifies the journal
+     * listener.
+     */
+    void _flushForDurability();
+
+    // Group commit state for waitUntilDurable, protected by _groupCommitMutex. Flushes are
+    // numbered in the order they start, and a caller is satisfied by the first flush which
+    // starts after it arrives. Only the flush in progress and the one after it can have
+    // waiters, so those for flush n wait on _flushCompleted[n % 2] and are counted in
+    // _flushWaiters[n % 2].
+    stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _flushCompleted[2];
+    uint64_t _flushesStarted = 0;
+    uint64_t _flushesCompleted = 0;
+    bool _flushInProgress = false;
+    uint64_t _flushWaiters[2] = {0, 0};
+
+    // Histograms of the number of callers satisfied by each flush and of the time each caller
+    // waited, both protected by _groupCommitMutex.
+    uint64_t _batchSizeHistogram[kNumBatchSizeBuckets] = {};
+    uint64_t _durableLatencyHistogram[kNumDurableLatencyBuckets] = {};
 
     // Notified when we commit to the journal.
     JournalListener* _journalListener = &NoOpJournalListener::instance;
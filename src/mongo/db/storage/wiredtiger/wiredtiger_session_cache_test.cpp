@@ -0,0 +1,227 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerSessionCacheTest : public unittest::Test {
+public:
+    WiredTigerSessionCacheTest() : _dbpath("wt_session_cache_test"), _conn(NULL) {
+        int ret = wiredtiger_open(_dbpath.path().c_str(), NULL, "create,", &_conn);
+        ASSERT_OK(wtRCToStatus(ret));
+        ASSERT(_conn);
+    }
+
+    ~WiredTigerSessionCacheTest() {
+        _conn->close(_conn, NULL);
+    }
+
+protected:
+    WT_CONNECTION* conn() const {
+        return _conn;
+    }
+
+    static BSONObj getStats(WiredTigerSessionCache* cache) {
+        BSONObjBuilder builder;
+        cache->appendStats(&builder);
+        return builder.obj().getObjectField("sessionCache").getOwned();
+    }
+
+    static BSONObj getGroupCommitStats(WiredTigerSessionCache* cache) {
+        BSONObjBuilder builder;
+        cache->appendStats(&builder);
+        return builder.obj().getObjectField("groupCommit").getOwned();
+    }
+
+    static long long sumHistogram(const BSONObj& histogram) {
+        long long total = 0;
+        BSONForEach(bucket, histogram) {
+            total += bucket.numberLong();
+        }
+        return total;
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn;
+};
+
+TEST_F(WiredTigerSessionCacheTest, ReleasedSessionIsReused) {
+    WiredTigerSessionCache cache(conn());
+
+    WiredTigerSession* first;
+    {
+        UniqueWiredTigerSession session = cache.getSession();
+        first = session.get();
+    }
+    ASSERT_EQUALS(1, getStats(&cache)["cachedSessions"].numberLong());
+
+    UniqueWiredTigerSession session = cache.getSession();
+    ASSERT_EQUALS(first, session.get());
+    ASSERT_EQUALS(0, getStats(&cache)["cachedSessions"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseAllDiscardsOutstandingSessions) {
+    WiredTigerSessionCache cache(conn());
+
+    UniqueWiredTigerSession cached = cache.getSession();
+    UniqueWiredTigerSession outstanding = cache.getSession();
+    cached.reset();
+    ASSERT_EQUALS(1, getStats(&cache)["cachedSessions"].numberLong());
+
+    cache.closeAll();
+    ASSERT_EQUALS(0, getStats(&cache)["cachedSessions"].numberLong());
+
+    // A session from before closeAll is closed instead of being returned to the cache.
+    outstanding.reset();
+    ASSERT_EQUALS(0, getStats(&cache)["cachedSessions"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, PartitionSizeIsBounded) {
+    const int oldMaxPerPartition = wiredTigerSessionCacheMaxPerPartition;
+    const int oldPartitions = wiredTigerSessionCachePartitions;
+    wiredTigerSessionCacheMaxPerPartition = 2;
+    wiredTigerSessionCachePartitions = 1;
+    WiredTigerSessionCache cache(conn());
+    wiredTigerSessionCacheMaxPerPartition = oldMaxPerPartition;
+    wiredTigerSessionCachePartitions = oldPartitions;
+
+    {
+        UniqueWiredTigerSession s1 = cache.getSession();
+        UniqueWiredTigerSession s2 = cache.getSession();
+        UniqueWiredTigerSession s3 = cache.getSession();
+    }
+
+    BSONObj stats = getStats(&cache);
+    ASSERT_EQUALS(1, stats["partitions"].numberLong());
+    ASSERT_EQUALS(2, stats["cachedSessions"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CursorCacheStatsAreReportedOnRelease) {
+    WiredTigerSessionCache cache(conn());
+    const std::string uri = "table:cursor_stats";
+    const uint64_t tableId = WiredTigerSession::genTableId();
+
+    {
+        UniqueWiredTigerSession session = cache.getSession();
+        WT_SESSION* s = session->getSession();
+        ASSERT_OK(wtRCToStatus(s->create(s, uri.c_str(), NULL)));
+
+        WT_CURSOR* cursor = session->getCursor(uri, tableId, false);
+        ASSERT(cursor);
+        session->releaseCursor(tableId, cursor);
+
+        cursor = session->getCursor(uri, tableId, false);
+        ASSERT(cursor);
+        session->releaseCursor(tableId, cursor);
+
+        // Not reported until the session is returned to the cache.
+        ASSERT_EQUALS(0, getStats(&cache)["cursorCacheMisses"].numberLong());
+    }
+
+    BSONObj stats = getStats(&cache);
+    ASSERT_EQUALS(1, stats["cursorCacheHits"].numberLong());
+    ASSERT_EQUALS(1, stats["cursorCacheMisses"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseExpiredIdleSessionsKeepsRecentlyUsedSessions) {
+    ClockSourceMock clock;
+    clock.reset(Date_t::now());
+
+    const int oldPartitions = wiredTigerSessionCachePartitions;
+    wiredTigerSessionCachePartitions = 1;
+    WiredTigerSessionCache cache(conn());
+    wiredTigerSessionCachePartitions = oldPartitions;
+    cache.setClockSource(&clock);
+
+    {
+        UniqueWiredTigerSession s1 = cache.getSession();
+        UniqueWiredTigerSession s2 = cache.getSession();
+    }
+    ASSERT_EQUALS(2, getStats(&cache)["cachedSessions"].numberLong());
+
+    cache.closeExpiredIdleSessions(Hours(1));
+    ASSERT_EQUALS(2, getStats(&cache)["cachedSessions"].numberLong());
+
+    clock.advance(Milliseconds(100));
+    { UniqueWiredTigerSession s3 = cache.getSession(); }
+
+    // Only the session which wasn't just used has been idle for long enough.
+    cache.closeExpiredIdleSessions(Milliseconds(50));
+    BSONObj stats = getStats(&cache);
+    ASSERT_EQUALS(1, stats["cachedSessions"].numberLong());
+    ASSERT_EQUALS(1, stats["idleSessionsClosed"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, ConcurrentWaitUntilDurableCallsShareFlushes) {
+    const int oldCommitWindow = wiredTigerJournalCommitWindowMicros.load();
+    wiredTigerJournalCommitWindowMicros.store(20 * 1000);
+    ON_BLOCK_EXIT(
+        [oldCommitWindow] { wiredTigerJournalCommitWindowMicros.store(oldCommitWindow); });
+
+    // Without an engine, durability comes from checkpoints.
+    WiredTigerSessionCache cache(conn());
+    const int kThreads = 8;
+    const int kCallsPerThread = 5;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&cache] {
+            for (int j = 0; j < kCallsPerThread; j++) {
+                cache.waitUntilDurable(false);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BSONObj stats = getGroupCommitStats(&cache);
+    const long long flushes = stats["flushes"].numberLong();
+    ASSERT_GREATER_THAN(flushes, 0);
+    ASSERT_LESS_THAN(flushes, kThreads * kCallsPerThread);
+    ASSERT_EQUALS(flushes, sumHistogram(stats.getObjectField("batchSize")));
+    ASSERT_EQUALS(kThreads * kCallsPerThread, sumHistogram(stats.getObjectField("latencyMicros")));
+}
+
+}  // namespace
+}  // namespace mongo
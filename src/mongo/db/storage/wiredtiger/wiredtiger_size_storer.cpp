@@ -31,13 +31,14 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
 
+#include <algorithm>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
-#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -51,6 +52,9 @@ using std::string;
 
 namespace {
 int MAGIC = 123123;
+
+// Maximum number of sizes written by each transaction of syncCache().
+const size_t kSyncBatchSize = 1000;
 }
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn, const std::string& storageUri)
@@ -84,36 +88,27 @@ void WiredTigerSizeStorer::_checkMagic() const {
     invariant(_magic == MAGIC);
 }
 
-void WiredTigerSizeStorer::onCreate(WiredTigerRecordStore* rs,
-                                    long long numRecords,
-                                    long long dataSize) {
+std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(StringData uri) {
     _checkMagic();
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
-    entry.rs = rs;
-    entry.numRecords = numRecords;
-    entry.dataSize = dataSize;
-    entry.dirty = true;
+    std::shared_ptr<SizeInfo>& sizeInfo = _entries[uri.toString()];
+    if (!sizeInfo) {
+        sizeInfo = std::make_shared<SizeInfo>();
+    }
+    return sizeInfo;
 }
 
-void WiredTigerSizeStorer::onDestroy(WiredTigerRecordStore* rs) {
+void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeInfo) {
     _checkMagic();
+    invariant(sizeInfo);
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
-    entry.numRecords = rs->numRecords(NULL);
-    entry.dataSize = rs->dataSize(NULL);
-    entry.dirty = true;
-    entry.rs = NULL;
+    _entries[uri.toString()] = std::move(sizeInfo);
 }
 
-
 void WiredTigerSizeStorer::storeToCache(StringData uri, long long numRecords, long long dataSize) {
-    _checkMagic();
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[uri.toString()];
-    entry.numRecords = numRecords;
-    entry.dataSize = dataSize;
-    entry.dirty = true;
+    std::shared_ptr<SizeInfo> sizeInfo = load(uri);
+    sizeInfo->numRecords.store(numRecords);
+    sizeInfo->dataSize.store(dataSize);
 }
 
 void WiredTigerSizeStorer::loadFromCache(StringData uri,
@@ -127,8 +122,8 @@ void WiredTigerSizeStorer::loadFromCache(StringData uri,
         *dataSize = 0;
         return;
     }
-    *numRecords = it->second.numRecords;
-    *dataSize = it->second.dataSize;
+    *numRecords = it->second->numRecords.load();
+    *dataSize = it->second->dataSize.load();
 }
 
 void WiredTigerSizeStorer::fillCache() {
@@ -156,11 +151,11 @@ void WiredTigerSizeStorer::fillCache() {
 
             LOG(2) << "WiredTigerSizeStorer::loadFrom " << uriKey << " -> " << data;
 
-            Entry& e = m[uriKey];
-            e.numRecords = data["numRecords"].safeNumberLong();
-            e.dataSize = data["dataSize"].safeNumberLong();
-            e.dirty = false;
-            e.rs = NULL;
+            auto sizeInfo = std::make_shared<SizeInfo>(data["numRecords"].safeNumberLong(),
+                                                       data["dataSize"].safeNumberLong());
+            sizeInfo->_storedNumRecords = sizeInfo->numRecords.load();
+            sizeInfo->_storedDataSize = sizeInfo->dataSize.load();
+            m[uriKey] = std::move(sizeInfo);
         }
     }
 
@@ -172,66 +167,72 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     _checkMagic();
 
-    Map myMap;
+    struct DirtyEntry {
+        std::string uri;
+        std::shared_ptr<SizeInfo> sizeInfo;
+        long long numRecords;
+        long long dataSize;
+    };
+
+    // Only the sizes which changed since they were last written are copied out, so that the
+    // entries mutex isn't held for long even with many collections.
+    std::vector<DirtyEntry> dirty;
     {
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            std::string uriKey = it->first;
-            Entry& entry = it->second;
-            if (entry.rs) {
-                if (entry.dataSize != entry.rs->dataSize(NULL)) {
-                    entry.dataSize = entry.rs->dataSize(NULL);
-                    entry.dirty = true;
-                }
-                if (entry.numRecords != entry.rs->numRecords(NULL)) {
-                    entry.numRecords = entry.rs->numRecords(NULL);
-                    entry.dirty = true;
-                }
+        for (Map::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            const std::shared_ptr<SizeInfo>& sizeInfo = it->second;
+            const long long numRecords = sizeInfo->numRecords.load();
+            const long long dataSize = sizeInfo->dataSize.load();
+            if (numRecords != sizeInfo->_storedNumRecords ||
+                dataSize != sizeInfo->_storedDataSize) {
+                dirty.push_back({it->first, sizeInfo, numRecords, dataSize});
             }
-
-            if (!entry.dirty)
-                continue;
-            myMap[uriKey] = entry;
         }
     }
 
-    if (myMap.empty())
+    if (dirty.empty())
         return;  // Nothing to do.
 
+    // Write in batches so that a sync after changes to many collections doesn't become one
+    // huge transaction. Only the last one needs to be synced, as that makes the journal durable
+    // up to its commit.
     WT_SESSION* session = _session.getSession();
-    invariantWTOK(session->begin_transaction(session, syncToDisk ? "sync=true" : ""));
-    ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
-
-    for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
-        string uriKey = it->first;
-        Entry& entry = it->second;
-
-        BSONObj data;
-        {
-            BSONObjBuilder b;
-            b.append("numRecords", entry.numRecords);
-            b.append("dataSize", entry.dataSize);
-            data = b.obj();
-        }
+    for (size_t batchStart = 0; batchStart < dirty.size(); batchStart += kSyncBatchSize) {
+        const size_t batchEnd = std::min(dirty.size(), batchStart + kSyncBatchSize);
+        const bool lastBatch = batchEnd == dirty.size();
+        invariantWTOK(
+            session->begin_transaction(session, syncToDisk && lastBatch ? "sync=true" : ""));
+        ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
+
+        for (size_t i = batchStart; i < batchEnd; i++) {
+            const DirtyEntry& entry = dirty[i];
+
+            BSONObj data;
+            {
+                BSONObjBuilder b;
+                b.append("numRecords", entry.numRecords);
+                b.append("dataSize", entry.dataSize);
+                data = b.obj();
+            }
 
-        LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << data;
+            LOG(2) << "WiredTigerSizeStorer::storeInto " << entry.uri << " -> " << data;
 
-        WiredTigerItem key(uriKey.c_str(), uriKey.size());
-        WiredTigerItem value(data.objdata(), data.objsize());
-        _cursor->set_key(_cursor, key.Get());
-        _cursor->set_value(_cursor, value.Get());
-        invariantWTOK(_cursor->insert(_cursor));
-    }
+            WiredTigerItem key(entry.uri.c_str(), entry.uri.size());
+            WiredTigerItem value(data.objdata(), data.objsize());
+            _cursor->set_key(_cursor, key.Get());
+            _cursor->set_value(_cursor, value.Get());
+            invariantWTOK(_cursor->insert(_cursor));
+        }
 
-    invariantWTOK(_cursor->reset(_cursor));
+        invariantWTOK(_cursor->reset(_cursor));
 
-    rollbacker.Dismiss();
-    invariantWTOK(session->commit_transaction(session, NULL));
+        rollbacker.Dismiss();
+        invariantWTOK(session->commit_transaction(session, NULL));
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+        // Sizes which changed again since they were copied out are written by the next sync.
+        for (size_t i = batchStart; i < batchEnd; i++) {
+            dirty[i].sizeInfo->_storedNumRecords = dirty[i].numRecords;
+            dirty[i].sizeInfo->_storedDataSize = dirty[i].dataSize;
         }
     }
 }
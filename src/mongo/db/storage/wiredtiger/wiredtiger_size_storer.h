@@ -31,26 +31,61 @@
 
 #pragma once
 
-#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <wiredtiger.h>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
-class WiredTigerRecordStore;
 class WiredTigerSession;
 
+/**
+ * Keeps the number of records and data size of every WiredTiger record store, and periodically
+ * writes the ones which changed to a table so they don't need to be counted on startup.
+ *
+ * A record store updates the counters of its SizeInfo directly, so the size storer is not
+ * involved in writes to collections.
+ */
 class WiredTigerSizeStorer {
 public:
+    class SizeInfo {
+        MONGO_DISALLOW_COPYING(SizeInfo);
+
+    public:
+        SizeInfo() = default;
+        SizeInfo(long long nr, long long ds) : numRecords(nr), dataSize(ds) {}
+
+        AtomicInt64 numRecords;
+        AtomicInt64 dataSize;
+
+    private:
+        friend class WiredTigerSizeStorer;
+
+        // The values last written to or read from the table, or -1 if there are none. Protected
+        // by the size storer's _cursorMutex.
+        long long _storedNumRecords = -1;
+        long long _storedDataSize = -1;
+    };
+
     WiredTigerSizeStorer(WT_CONNECTION* conn, const std::string& storageUri);
     ~WiredTigerSizeStorer();
 
-    void onCreate(WiredTigerRecordStore* rs, long long nr, long long ds);
-    void onDestroy(WiredTigerRecordStore* rs);
+    /**
+     * Returns the sizes for 'uri', which start at zero if they are not known.
+     */
+    std::shared_ptr<SizeInfo> load(StringData uri);
+
+    /**
+     * Makes 'sizeInfo' the sizes for 'uri', replacing any that were known.
+     */
+    void store(StringData uri, std::shared_ptr<SizeInfo> sizeInfo);
 
     void storeToCache(StringData uri, long long numRecords, long long dataSize);
 
@@ -62,21 +97,13 @@ public:
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes the sizes which changed since they were last written to the underlying table.
      */
     void syncCache(bool syncToDisk);
 
 private:
     void _checkMagic() const;
 
-    struct Entry {
-        Entry() : numRecords(0), dataSize(0), dirty(false), rs(NULL) {}
-        long long numRecords;
-        long long dataSize;
-        bool dirty;
-        WiredTigerRecordStore* rs;  // not owned
-    };
-
     int _magic;
 
     // Guards _cursor. Acquire *before* _entriesMutex.
@@ -84,7 +111,7 @@ private:
     const WiredTigerSession _session;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
-    typedef std::map<std::string, Entry> Map;
+    typedef std::unordered_map<std::string, std::shared_ptr<SizeInfo>> Map;
     Map _entries;
     mutable stdx::mutex _entriesMutex;
 };
@@ -77,11 +77,16 @@ Status wtRCToStatus_slow(int retCode, const char* prefix) {
 void WiredTigerUtil::fetchTypeAndSourceURI(OperationContext* opCtx,
                                            const std::string& tableUri,
                                            std::string* type,
-                                           std::string* source) {
+                                           std::string* source,
+                                           StringData colgroupName) {
     std::string colgroupUri = "colgroup";
     const size_t colon = tableUri.find(':');
     invariant(colon != string::npos);
     colgroupUri += tableUri.substr(colon);
+    if (!colgroupName.empty()) {
+        colgroupUri += ':';
+        colgroupUri += colgroupName.toString();
+    }
     StatusWith<std::string> colgroupResult = getMetadata(opCtx, colgroupUri);
     invariant(colgroupResult.isOK());
     WiredTigerConfigParser parser(colgroupResult.getValue());
@@ -98,12 +98,14 @@ private:
 public:
     /**
      * Fetch the type and source fields out of the colgroup metadata.  'tableUri' must be a
-     * valid table: uri.
+     * valid table: uri. 'colgroupName' names the column group of a table which has several,
+     * and must be empty for tables which only have the default one.
      */
     static void fetchTypeAndSourceURI(OperationContext* opCtx,
                                       const std::string& tableUri,
                                       std::string* type,
-                                      std::string* source);
+                                      std::string* source,
+                                      StringData colgroupName = StringData());
 
     /**
      * Reads contents of table using URI and exports all keys to BSON as string elements.
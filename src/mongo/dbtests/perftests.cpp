@@ -54,6 +54,7 @@
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
@@ -444,6 +445,80 @@ public:
     }
 };
 
+/** Keys for the index benchmarks below: compound, with a long string prefix shared by all. */
+BSONObj sharedPrefixIndexKey(unsigned i) {
+    const string a = str::stream() << "com.example.tenants.production.account." << (i % 64);
+    return BSON("a" << a << "b" << static_cast<int>(i) << "c" << (i * 0.5));
+}
+
+const unsigned kSharedPrefixDocs = 10000;
+
+class KeyStringEncode : public B {
+public:
+    KeyStringEncode() : _ordering(Ordering::make(BSON("a" << 1 << "b" << -1 << "c" << 1))) {}
+    string name() {
+        return "KeyString-encode";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        for (unsigned i = 0; i < 64; i++) {
+            BSONObjBuilder b;
+            BSONForEach(elem, sharedPrefixIndexKey(i)) {
+                b.appendAs(elem, "");
+            }
+            _keys.push_back(b.obj());
+        }
+    }
+    void timed() {
+        _keyString.resetToKey(_keys[_n++ % _keys.size()], _ordering, RecordId(_n));
+    }
+
+private:
+    const Ordering _ordering;
+    vector<BSONObj> _keys;
+    KeyString _keyString;
+    unsigned _n = 0;
+};
+
+class IndexSeekSharedPrefix : public B {
+public:
+    string name() {
+        return "index-seek-shared-prefix";
+    }
+    virtual int howLongMillis() {
+        return 2000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        client()->ensureIndex(ns(), BSON("a" << 1 << "b" << 1 << "c" << 1));
+        for (unsigned i = 0; i < kSharedPrefixDocs; i++) {
+            insert(ns(), sharedPrefixIndexKey(i));
+        }
+    }
+    void timed() {
+        const BSONObj key = sharedPrefixIndexKey(_n++ % kSharedPrefixDocs);
+        client()->findOne(ns(), Query(key).hint(BSON("a" << 1 << "b" << 1 << "c" << 1)));
+    }
+
+    // Range scans over a single 'a' value compare every key against the end of the range.
+    string name2() {
+        return "index-range-scan-shared-prefix";
+    }
+    void timed2(DBClientBase* c) {
+        const BSONObj key = sharedPrefixIndexKey(_n++ % kSharedPrefixDocs);
+        c->count(ns(), BSON("a" << key["a"] << "b" << BSON("$gte" << 0)));
+    }
+
+private:
+    unsigned _n = 0;
+};
 
 class All : public Suite {
 public:
@@ -457,6 +532,8 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<KeyStringEncode>();
+        add<IndexSeekSharedPrefix>();
     }
 } myall;
 }
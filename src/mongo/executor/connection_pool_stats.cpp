@@ -45,6 +45,8 @@ ConnectionStatsPerHost& ConnectionStatsPerHost::operator+=(const ConnectionStats
     inUse += other.inUse;
     available += other.available;
     created += other.created;
+    waited += other.waited;
+    waitTimeouts += other.waitTimeouts;
 
     return *this;
 }
@@ -59,12 +61,16 @@ void ConnectionPoolStats::updateStatsForHost(HostAndPort host, ConnectionStatsPe
     totalInUse += newStats.inUse;
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
+    totalWaited += newStats.waited;
+    totalWaitTimeouts += newStats.waitTimeouts;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalInUse", totalInUse);
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
+    result.appendNumber("totalWaited", totalWaited);
+    result.appendNumber("totalWaitTimeouts", totalWaitTimeouts);
 
     BSONObjBuilder hostBuilder(result.subobjStart("hosts"));
     for (auto&& host : statsByHost) {
@@ -74,6 +80,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
         hostInfo.appendNumber("inUse", hostStats.inUse);
         hostInfo.appendNumber("available", hostStats.available);
         hostInfo.appendNumber("created", hostStats.created);
+        hostInfo.appendNumber("waited", hostStats.waited);
+        hostInfo.appendNumber("waitTimeouts", hostStats.waitTimeouts);
     }
 }
 
@@ -49,6 +49,11 @@ struct ConnectionStatsPerHost {
     size_t inUse = 0u;
     size_t available = 0u;
     size_t created = 0u;
+
+    // Only maintained by pools which limit the number of connections in use per host: the
+    // number of requests which had to wait for a connection, and how many of them timed out.
+    size_t waited = 0u;
+    size_t waitTimeouts = 0u;
 };
 
 /**
@@ -64,6 +69,8 @@ struct ConnectionPoolStats {
     size_t totalInUse = 0u;
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
+    size_t totalWaited = 0u;
+    size_t totalWaitTimeouts = 0u;
 
     std::unordered_map<HostAndPort, ConnectionStatsPerHost> statsByHost;
 };
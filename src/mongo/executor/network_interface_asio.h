@@ -56,6 +56,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 
@@ -145,6 +146,9 @@ private:
         rpc::ProtocolSet clientProtocols() const;
         void setServerProtocols(rpc::ProtocolSet protocols);
 
+        MessageCompressorId compressor() const;
+        void setCompressor(MessageCompressorId compressor);
+
 // Explicit move construction and assignment to support MSVC
 #if defined(_MSC_VER) && _MSC_VER < 1900
         AsyncConnection(AsyncConnection&&);
@@ -162,6 +166,9 @@ private:
         // Dynamically initialized from [min max]WireVersionOutgoing.
         // Its expected that isMaster response is checked only on the caller.
         rpc::ProtocolSet _clientProtocols{rpc::supports::kNone};
+
+        // Negotiated from the isMaster reply; kNoop unless both sides enable compression.
+        MessageCompressorId _compressor{MessageCompressorId::kNoop};
     };
 
     /**
@@ -198,6 +205,7 @@ private:
         NetworkInterfaceASIO::AsyncConnection& conn();
 
         Message& toSend();
+        Message& toSendCompressed();
         Message& toRecv();
         MSGHEADER::Value& header();
 
@@ -211,6 +219,7 @@ private:
         const CommandType _type;
 
         Message _toSend;
+        Message _toSendCompressed;
         Message _toRecv;
 
         // TODO: Investigate efficiency of storing header separately.
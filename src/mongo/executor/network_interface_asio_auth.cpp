@@ -43,6 +43,7 @@
 #include "mongo/rpc/legacy_request_builder.h"
 #include "mongo/rpc/reply_interface.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_manager.h"
 
@@ -106,6 +107,7 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
         }
 
         op->setOperationProtocol(negotiatedProtocol.getValue());
+        op->connection().setCompressor(negotiateMessageCompressor(commandReply.data));
 
         if (_hook) {
             // Run the validation hook.
@@ -50,6 +50,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 namespace executor {
@@ -72,12 +73,12 @@ template <typename FunctionLike>
 using IsNetworkHandler =
     std::is_convertible<FunctionLike, stdx::function<void(std::error_code, std::size_t)>>;
 
+// The caller is responsible for setting the id of 'm', which may be a compressed copy of the
+// message the response will be matched against.
 template <typename Handler>
 void asyncSendMessage(AsyncStreamInterface& stream, Message* m, Handler&& handler) {
     static_assert(IsNetworkHandler<Handler>::value,
                   "Handler passed to asyncSendMessage does not conform to NetworkHandler concept");
-    m->header().setResponseTo(0);
-    m->header().setId(nextMessageId());
     // TODO: Some day we may need to support vector messages.
     fassert(28708, m->buf() != 0);
     stream.write(asio::buffer(m->buf(), m->size()), std::forward<Handler>(handler));
@@ -186,6 +187,10 @@ Message& NetworkInterfaceASIO::AsyncCommand::toSend() {
     return _toSend;
 }
 
+Message& NetworkInterfaceASIO::AsyncCommand::toSendCompressed() {
+    return _toSendCompressed;
+}
+
 Message& NetworkInterfaceASIO::AsyncCommand::toRecv() {
     return _toRecv;
 }
@@ -351,6 +356,24 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
 
     // Step 4
     auto recvMessageCallback = [this, cmd, handler, op](std::error_code ec, size_t bytes) {
+        if (!ec && cmd->toRecv().operation() == dbCompressed) {
+            Message decompressed;
+            MessageCompressorId compressor;
+            auto status = decompressMessage(cmd->toRecv(), &decompressed, &compressor);
+            if (status.isOK() && compressor != cmd->conn().compressor()) {
+                status = Status(ErrorCodes::ProtocolError,
+                                str::stream() << "response compressed with "
+                                              << messageCompressorName(compressor)
+                                              << ", which was not negotiated for this connection");
+            }
+            if (!status.isOK()) {
+                warning() << "failed to decompress response from "
+                          << op->request().target.toString() << ": " << status;
+                ec = make_error_code(ErrorCodes::ProtocolError);
+            } else {
+                cmd->toRecv() = std::move(decompressed);
+            }
+        }
         // We don't call _validateAndRun here as we assume the caller will.
         handler(ec, bytes);
     };
@@ -395,7 +418,16 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
         };
 
     // Step 1
-    asyncSendMessage(cmd->conn().stream(), &cmd->toSend(), std::move(sendMessageCallback));
+    // The response is matched against the id of the uncompressed message, so it is assigned
+    // before compressing.
+    cmd->toSend().header().setResponseTo(0);
+    cmd->toSend().header().setId(nextMessageId());
+    Message* toSend = &cmd->toSend();
+    if (cmd->conn().compressor() != MessageCompressorId::kNoop &&
+        compressMessage(cmd->conn().compressor(), cmd->toSend(), &cmd->toSendCompressed())) {
+        toSend = &cmd->toSendCompressed();
+    }
+    asyncSendMessage(cmd->conn().stream(), toSend, std::move(sendMessageCallback));
 }
 
 void NetworkInterfaceASIO::_runConnectionHook(AsyncOp* op) {
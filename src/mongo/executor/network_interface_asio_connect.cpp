@@ -60,13 +60,15 @@ NetworkInterfaceASIO::AsyncConnection::AsyncConnection(std::unique_ptr<AsyncStre
 NetworkInterfaceASIO::AsyncConnection::AsyncConnection(AsyncConnection&& other)
     : _stream(std::move(other._stream)),
       _serverProtocols(other._serverProtocols),
-      _clientProtocols(other._clientProtocols) {}
+      _clientProtocols(other._clientProtocols),
+      _compressor(other._compressor) {}
 
 NetworkInterfaceASIO::AsyncConnection& NetworkInterfaceASIO::AsyncConnection::operator=(
     AsyncConnection&& other) {
     _stream = std::move(other._stream);
     _serverProtocols = other._serverProtocols;
     _clientProtocols = other._clientProtocols;
+    _compressor = other._compressor;
     return *this;
 }
 #endif
@@ -91,6 +93,14 @@ void NetworkInterfaceASIO::AsyncConnection::setServerProtocols(rpc::ProtocolSet
     _serverProtocols = protocols;
 }
 
+MessageCompressorId NetworkInterfaceASIO::AsyncConnection::compressor() const {
+    return _compressor;
+}
+
+void NetworkInterfaceASIO::AsyncConnection::setCompressor(MessageCompressorId compressor) {
+    _compressor = compressor;
+}
+
 void NetworkInterfaceASIO::_connect(AsyncOp* op) {
     LOG(1) << "Connecting to " << op->request().target.toString();
 
@@ -40,6 +40,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/balancer_policy.h"
@@ -120,6 +121,12 @@ private:
 MONGO_FP_DECLARE(skipBalanceRound);
 MONGO_FP_DECLARE(balancerRoundIntervalSetting);
 
+// Relative importance of chunk count, data size and load when comparing shards. With the default
+// of chunk count only, the shards are not asked for their chunk load statistics.
+MONGO_EXPORT_SERVER_PARAMETER(balancerChunksWeight, double, 1.0);
+MONGO_EXPORT_SERVER_PARAMETER(balancerBytesWeight, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadWeight, double, 0.0);
+
 namespace {
 const Seconds kBalanceRoundDefaultInterval(10);
 const Seconds kShortBalanceRoundInterval(1);
@@ -380,6 +387,11 @@ void Balancer::_doBalanceRound(OperationContext* txn,
 
     OCCASIONALLY warnOnMultiVersion(shardInfo);
 
+    BalancerWeights weights;
+    weights.chunks = balancerChunksWeight.load();
+    weights.bytes = balancerBytesWeight.load();
+    weights.load = balancerLoadWeight.load();
+
     // For each collection, check if the balancing policy recommends moving anything around.
     for (const auto& coll : collections) {
         uassertStatusOK(distLock->checkForPendingCatalogChange());
@@ -497,8 +509,22 @@ void Balancer::_doBalanceRound(OperationContext* txn,
             continue;
         }
 
+        BalancerWeights collectionWeights = weights;
+        ChunkLoadInfoMap chunkLoad;
+        if (!collectionWeights.isChunkCountOnly()) {
+            Status status = DistributionStatus::populateChunkLoadMap(
+                txn, nss.ns(), shardToChunksMap, &chunkLoad);
+            if (status.isOK()) {
+                distStatus.setChunkLoad(&chunkLoad);
+            } else {
+                warning() << "could not retrieve chunk load for " << nss.ns()
+                          << ", balancing by chunk count" << causedBy(status);
+                collectionWeights = BalancerWeights();
+            }
+        }
+
         shared_ptr<MigrateInfo> migrateInfo(
-            _policy->balance(nss.ns(), distStatus, _balancedLastTime));
+            _policy->balance(nss.ns(), distStatus, _balancedLastTime, collectionWeights));
         if (migrateInfo) {
             candidateChunks->push_back(migrateInfo);
         }
@@ -34,9 +34,11 @@
 #include "mongo/s/balancer_policy.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -83,6 +85,96 @@ std::string retrieveShardMongoDVersion(OperationContext* txn,
     return versionElement.str();
 }
 
+/**
+ * Weighs the chunks of one tag according to a BalancerWeights, in units of average chunks: a chunk
+ * of average size and load always weighs 1.
+ */
+class ChunkWeigher {
+public:
+    ChunkWeigher(const DistributionStatus& distribution,
+                 const string& tag,
+                 const BalancerWeights& weights)
+        : _distribution(distribution),
+          _tag(tag),
+          _chunksWeight(std::max(weights.chunks, 0.0)),
+          _bytesWeight(std::max(weights.bytes, 0.0)),
+          _loadWeight(std::max(weights.load, 0.0)) {
+        long long numChunks = 0;
+        long long totalBytes = 0;
+        long long totalOps = 0;
+
+        for (const ShardId& shardId : _distribution.shardIds()) {
+            if (_distribution.numberOfChunksInShard(shardId) == 0)
+                continue;
+
+            for (const ChunkType& chunk : _distribution.getChunks(shardId)) {
+                if (_distribution.getTagForChunk(chunk) != _tag)
+                    continue;
+
+                numChunks++;
+
+                const ChunkLoadInfo* load = _distribution.getChunkLoad(chunk);
+                if (load) {
+                    totalBytes += load->bytes;
+                    totalOps += load->ops;
+                }
+            }
+        }
+
+        if (numChunks > 0) {
+            _avgBytes = static_cast<double>(totalBytes) / numChunks;
+            _avgOps = static_cast<double>(totalOps) / numChunks;
+        }
+
+        if (_chunksWeight + _bytesWeight + _loadWeight <= 0) {
+            _chunksWeight = 1.0;
+        }
+    }
+
+    double weigh(const ChunkType& chunk) const {
+        const ChunkLoadInfo* load = _distribution.getChunkLoad(chunk);
+
+        // When nothing is known about sizes or load, every chunk counts as an average one
+        double relativeBytes = 1.0;
+        if (_avgBytes > 0) {
+            relativeBytes = load ? load->bytes / _avgBytes : 0.0;
+        }
+
+        double relativeOps = 1.0;
+        if (_avgOps > 0) {
+            relativeOps = load ? load->ops / _avgOps : 0.0;
+        }
+
+        return (_chunksWeight + _bytesWeight * relativeBytes + _loadWeight * relativeOps) /
+            (_chunksWeight + _bytesWeight + _loadWeight);
+    }
+
+    double weighShard(const ShardId& shardId) const {
+        if (_distribution.numberOfChunksInShard(shardId) == 0)
+            return 0;
+
+        double total = 0;
+        for (const ChunkType& chunk : _distribution.getChunks(shardId)) {
+            if (_distribution.getTagForChunk(chunk) == _tag) {
+                total += weigh(chunk);
+            }
+        }
+
+        return total;
+    }
+
+private:
+    const DistributionStatus& _distribution;
+    const string _tag;
+
+    double _chunksWeight;
+    double _bytesWeight;
+    double _loadWeight;
+
+    double _avgBytes{0};
+    double _avgOps{0};
+};
+
 }  // namespace
 
 string TagRange::toString() const {
@@ -191,6 +283,17 @@ string DistributionStatus::getMostOverloadedShard(const string& tag) const {
     return worst;
 }
 
+const ChunkLoadInfo* DistributionStatus::getChunkLoad(const ChunkType& chunk) const {
+    if (!_chunkLoad)
+        return NULL;
+
+    ChunkLoadInfoMap::const_iterator i = _chunkLoad->find(chunk.getMin());
+    if (i == _chunkLoad->end())
+        return NULL;
+
+    return &i->second;
+}
+
 const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) const {
     ShardToChunksMap::const_iterator i = _shardChunks.find(shardId);
     invariant(i != _shardChunks.end());
@@ -332,9 +435,48 @@ void DistributionStatus::populateShardToChunksMap(const ShardInfoMap& allShards,
     }
 }
 
+Status DistributionStatus::populateChunkLoadMap(OperationContext* txn,
+                                                const string& ns,
+                                                const ShardToChunksMap& shardToChunksMap,
+                                                ChunkLoadInfoMap* chunkLoad) {
+    for (ShardToChunksMap::const_iterator i = shardToChunksMap.begin();
+         i != shardToChunksMap.end();
+         ++i) {
+        if (i->second.empty())
+            continue;
+
+        auto response = grid.shardRegistry()->runCommandOnShard(
+            txn,
+            i->first,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            "admin",
+            BSON("getChunkLoadStats" << ns));
+        if (!response.isOK()) {
+            return response.getStatus();
+        }
+
+        Status commandStatus = getStatusFromCommandResult(response.getValue());
+        if (!commandStatus.isOK()) {
+            return commandStatus;
+        }
+
+        BSONObjIterator it(response.getValue().getObjectField("chunks"));
+        while (it.more()) {
+            BSONObj chunkStats = it.next().Obj();
+
+            ChunkLoadInfo& load = (*chunkLoad)[chunkStats[ChunkType::min()].Obj().getOwned()];
+            load.ops = chunkStats["reads"].safeNumberLong() + chunkStats["writes"].safeNumberLong();
+            load.bytes = chunkStats["bytes"].safeNumberLong();
+        }
+    }
+
+    return Status::OK();
+}
+
 MigrateInfo* BalancerPolicy::balance(const string& ns,
                                      const DistributionStatus& distribution,
-                                     int balancedLastTime) {
+                                     int balancedLastTime,
+                                     const BalancerWeights& weights) {
     // 1) check for shards that policy require to us to move off of:
     //    draining only
     // 2) check tag policy violations
@@ -442,6 +584,15 @@ MigrateInfo* BalancerPolicy::balance(const string& ns,
     for (unsigned i = 0; i < tags.size(); i++) {
         string tag = tags[i];
 
+        if (!weights.isChunkCountOnly()) {
+            MigrateInfo* migrate =
+                _balanceTagByWeight(ns, distribution, tag, threshold, weights);
+            if (migrate)
+                return migrate;
+
+            continue;
+        }
+
         const ShardId from = distribution.getMostOverloadedShard(tag);
         if (from.size() == 0)
             continue;
@@ -499,6 +650,95 @@ MigrateInfo* BalancerPolicy::balance(const string& ns,
     return NULL;
 }
 
+MigrateInfo* BalancerPolicy::_balanceTagByWeight(const string& ns,
+                                                 const DistributionStatus& distribution,
+                                                 const string& tag,
+                                                 int threshold,
+                                                 const BalancerWeights& weights) {
+    ChunkWeigher weigher(distribution, tag, weights);
+
+    ShardId from;
+    double maxWeight = 0;
+    for (const ShardId& shardId : distribution.shardIds()) {
+        const double weight = weigher.weighShard(shardId);
+        if (weight > maxWeight) {
+            from = shardId;
+            maxWeight = weight;
+        }
+    }
+
+    if (from.size() == 0)
+        return NULL;
+
+    ShardId to;
+    double minWeight = numeric_limits<double>::max();
+    for (const ShardId& shardId : distribution.shardIds()) {
+        const ShardInfo& info = distribution.shardInfo(shardId);
+        if (info.isSizeMaxed() || info.isDraining() || !info.hasTag(tag))
+            continue;
+
+        const double weight = weigher.weighShard(shardId);
+        if (weight < minWeight) {
+            to = shardId;
+            minWeight = weight;
+        }
+    }
+
+    if (to.size() == 0) {
+        log() << "no available shards to take chunks for tag [" << tag << "]";
+        return NULL;
+    }
+
+    const double imbalance = maxWeight - minWeight;
+
+    LOG(1) << "collection : " << ns;
+    LOG(1) << "donor      : " << from << " weight " << maxWeight;
+    LOG(1) << "receiver   : " << to << " weight " << minWeight;
+    LOG(1) << "threshold  : " << threshold;
+
+    if (imbalance < threshold)
+        return NULL;
+
+    // Pick the chunk which brings the donor and the receiver closest to each other. A chunk
+    // weighing as much as the imbalance would only swap the two shards' roles.
+    const ChunkType* best = NULL;
+    double bestDistance = numeric_limits<double>::max();
+    unsigned numJumboChunks = 0;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from);
+    for (unsigned j = 0; j < chunks.size(); j++) {
+        const ChunkType& chunk = chunks[j];
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        const double weight = weigher.weigh(chunk);
+        if (weight >= imbalance)
+            continue;
+
+        const double distance = std::fabs(imbalance - 2 * weight);
+        if (distance < bestDistance) {
+            best = &chunk;
+            bestDistance = distance;
+        }
+    }
+
+    if (!best) {
+        warning() << "shard: " << from << " ns: " << ns << " is overloaded for tag [" << tag
+                  << "], but has no chunk which can be moved to reduce the imbalance"
+                  << " numJumboChunks: " << numJumboChunks;
+        return NULL;
+    }
+
+    log() << " ns: " << ns << " going to move " << *best << " from: " << from << " to: " << to
+          << " tag [" << tag << "] weight " << weigher.weigh(*best);
+    return new MigrateInfo(ns, to, from, best->toBSON());
+}
+
 
 ShardInfo::ShardInfo(long long maxSizeMB,
                      long long currSizeMB,
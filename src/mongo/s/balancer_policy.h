@@ -134,6 +134,37 @@ struct MigrateInfo {
 typedef std::map<ShardId, ShardInfo> ShardInfoMap;
 typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
+/**
+ * Sampled operation count and estimated data size of a chunk, as reported by the shard which owns
+ * it through the getChunkLoadStats command.
+ */
+struct ChunkLoadInfo {
+    long long ops{0};
+    long long bytes{0};
+};
+
+// Chunk min key to the load of that chunk
+typedef std::map<BSONObj, ChunkLoadInfo, BSONObjCmp> ChunkLoadInfoMap;
+
+/**
+ * Relative importance of chunk count, data size and load when the balancer compares shards. Each
+ * chunk is weighed as the weighted average of 1 (its count), its size relative to the average
+ * chunk size and its load relative to the average chunk load, so a balanced shard always holds
+ * "number of chunks" worth of weight and the migration thresholds keep their meaning.
+ *
+ * The default, chunk count only, is the traditional balancer behaviour.
+ */
+struct BalancerWeights {
+    double chunks{1.0};
+    double bytes{0.0};
+    double load{0.0};
+
+    /** @return true if only the number of chunks matters, so no chunk load info is needed */
+    bool isChunkCountOnly() const {
+        return bytes <= 0 && load <= 0;
+    }
+};
+
 
 class DistributionStatus {
     MONGO_DISALLOW_COPYING(DistributionStatus);
@@ -193,6 +224,17 @@ public:
     /** @return the ShardInfo for the shard */
     const ShardInfo& shardInfo(const ShardId& shardId) const;
 
+    /**
+     * Makes the per-chunk load in 'chunkLoad' available to the policy. The map is not owned and
+     * must outlive this object.
+     */
+    void setChunkLoad(const ChunkLoadInfoMap* chunkLoad) {
+        _chunkLoad = chunkLoad;
+    }
+
+    /** @return the load reported for the chunk, or NULL if none is known */
+    const ChunkLoadInfo* getChunkLoad(const ChunkType& chunk) const;
+
     /** writes all state to log() */
     void dump() const;
 
@@ -209,9 +251,20 @@ public:
                                          const ChunkManager& chunkMgr,
                                          ShardToChunksMap* shardToChunksMap);
 
+    /**
+     * Retrieves the per-chunk load of collection 'ns' from every shard which owns chunks of it.
+     * Fails if any of those shards cannot report, since partial statistics would make the shards
+     * which did report look overloaded.
+     */
+    static Status populateChunkLoadMap(OperationContext* txn,
+                                       const std::string& ns,
+                                       const ShardToChunksMap& shardToChunksMap,
+                                       ChunkLoadInfoMap* chunkLoad);
+
 private:
     const ShardInfoMap& _shardInfo;
     const ShardToChunksMap& _shardChunks;
+    const ChunkLoadInfoMap* _chunkLoad{nullptr};
     std::map<BSONObj, TagRange> _tagRanges;
     std::set<std::string> _allTags;
     std::set<ShardId> _shardIds;
@@ -228,12 +281,26 @@ public:
      * @param ns is the collections namepace.
      * @param DistributionStatus holds all the info about the current state of the cluster/namespace
      * @param balancedLastTime is the number of chunks effectively moved in the last round.
+     * @param weights how to weigh chunks when comparing shards. Anything other than chunk count
+     *        only uses the chunk load set on the distribution.
      * @returns NULL or MigrateInfo of the best move to make towards balacing the collection.
      *          caller owns the MigrateInfo instance
      */
     static MigrateInfo* balance(const std::string& ns,
                                 const DistributionStatus& distribution,
-                                int balancedLastTime);
+                                int balancedLastTime,
+                                const BalancerWeights& weights = BalancerWeights());
+
+private:
+    /**
+     * Balances the chunks of 'tag' by weight rather than by count. Returns NULL if the shards are
+     * within 'threshold' chunks worth of weight of each other, or no chunk can be moved.
+     */
+    static MigrateInfo* _balanceTagByWeight(const std::string& ns,
+                                            const DistributionStatus& distribution,
+                                            const std::string& tag,
+                                            int threshold,
+                                            const BalancerWeights& weights);
 };
 
 }  // namespace mongo
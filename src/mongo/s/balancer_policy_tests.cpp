@@ -620,4 +620,228 @@ TEST(BalancerPolicyTests, Simulation) {
     }
 }
 
+/**
+ * Records load for the chunks of 'shardToChunks', in the order in which they were added, as if
+ * it had been reported by the shards.
+ */
+void addChunkLoad(const ShardToChunksMap& shardToChunks,
+                  const vector<long long>& ops,
+                  const vector<long long>& bytes,
+                  ChunkLoadInfoMap* chunkLoad) {
+    size_t i = 0;
+    for (const auto& shardChunks : shardToChunks) {
+        for (const ChunkType& chunk : shardChunks.second) {
+            ChunkLoadInfo& load = (*chunkLoad)[chunk.getMin()];
+            load.ops = i < ops.size() ? ops[i] : 0;
+            load.bytes = i < bytes.size() ? bytes[i] : 0;
+            i++;
+        }
+    }
+}
+
+TEST(BalancerPolicyTests, DefaultWeightsAreChunkCountOnly) {
+    BalancerWeights weights;
+    ASSERT(weights.isChunkCountOnly());
+
+    weights.load = 1;
+    ASSERT(!weights.isChunkCountOnly());
+}
+
+TEST(BalancerPolicyTests, BalanceByBytes) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 2, false);
+    addShard(chunks, 6, true);
+
+    // shard0 has fewer chunks, but they hold almost all of the data
+    ChunkLoadInfoMap chunkLoad;
+    addChunkLoad(chunks, {}, {1000, 1000, 10, 10, 10, 10, 10, 10}, &chunkLoad);
+
+    ShardInfoMap shards;
+    shards["shard0"] = ShardInfo(0, 2, false);
+    shards["shard1"] = ShardInfo(0, 6, false);
+
+    DistributionStatus d(shards, chunks);
+    d.setChunkLoad(&chunkLoad);
+
+    std::unique_ptr<MigrateInfo> byCount(BalancerPolicy::balance("ns", d, 1));
+    ASSERT(byCount);
+    ASSERT_EQUALS("shard1", byCount->from);
+
+    BalancerWeights weights;
+    weights.chunks = 0;
+    weights.bytes = 1;
+
+    std::unique_ptr<MigrateInfo> byBytes(BalancerPolicy::balance("ns", d, 1, weights));
+    ASSERT(byBytes);
+    ASSERT_EQUALS("shard0", byBytes->from);
+    ASSERT_EQUALS("shard1", byBytes->to);
+}
+
+TEST(BalancerPolicyTests, BalanceByLoadSkipsChunkHotterThanImbalance) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 4, false);
+    addShard(chunks, 4, true);
+
+    // The first chunk of shard0 is hotter than the difference between the shards, so moving it
+    // would just make shard1 the overloaded one
+    ChunkLoadInfoMap chunkLoad;
+    addChunkLoad(chunks, {700, 100, 100, 100, 100, 100, 100, 100}, {}, &chunkLoad);
+
+    ShardInfoMap shards;
+    shards["shard0"] = ShardInfo(0, 4, false);
+    shards["shard1"] = ShardInfo(0, 4, false);
+
+    DistributionStatus d(shards, chunks);
+    d.setChunkLoad(&chunkLoad);
+
+    BalancerWeights weights;
+    weights.chunks = 0;
+    weights.load = 1;
+
+    std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 1, weights));
+    ASSERT(m);
+    ASSERT_EQUALS("shard0", m->from);
+    ASSERT_EQUALS("shard1", m->to);
+    ASSERT_EQUALS(chunks["shard0"][1].getMin(), m->chunk.min);
+}
+
+TEST(BalancerPolicyTests, BalanceByLoadDoesNotMoveChunkHeavierThanImbalance) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 1, false);
+    addShard(chunks, 2, true);
+
+    ChunkLoadInfoMap chunkLoad;
+    addChunkLoad(chunks, {300, 0, 0}, {}, &chunkLoad);
+
+    ShardInfoMap shards;
+    shards["shard0"] = ShardInfo(0, 1, false);
+    shards["shard1"] = ShardInfo(0, 2, false);
+
+    DistributionStatus d(shards, chunks);
+    d.setChunkLoad(&chunkLoad);
+
+    BalancerWeights weights;
+    weights.chunks = 0;
+    weights.load = 1;
+
+    std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 1, weights));
+    ASSERT(!m);
+}
+
+TEST(BalancerPolicyTests, BalanceByLoadWithoutStatsFallsBackToCount) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 5, false);
+    addShard(chunks, 0, true);
+
+    ShardInfoMap shards;
+    shards["shard0"] = ShardInfo(0, 5, false);
+    shards["shard1"] = ShardInfo(0, 0, false);
+
+    DistributionStatus d(shards, chunks);
+
+    BalancerWeights weights;
+    weights.bytes = 1;
+    weights.load = 1;
+
+    std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 1, weights));
+    ASSERT(m);
+    ASSERT_EQUALS("shard0", m->from);
+    ASSERT_EQUALS("shard1", m->to);
+}
+
+/**
+ * Replays recorded per-chunk statistics through the policy: chunks are assigned skewed load and
+ * size, and we virtually migrate until the policy stops recommending moves. The statistics stay
+ * attached to the chunks as they move, as they would once the receiving shard starts reporting.
+ *
+ * For each set of weights, the run must converge, and afterwards the most and least weighted
+ * shards must be within the policy threshold, or within the weight of a single chunk if no chunk
+ * is light enough to be moved without overshooting.
+ */
+TEST(BalancerPolicyTests, LoadSimulation) {
+    int64_t seed = 4242;
+    PseudoRandom rng(seed);
+
+    const int numShards = 5;
+
+    for (int test = 0; test < 5; test++) {
+        ShardToChunksMap chunks;
+        ShardInfoMap shards;
+        for (int i = 0; i < numShards; i++) {
+            const int numShardChunks = 1 + rng.nextInt32(60);
+            addShard(chunks, numShardChunks, i == numShards - 1);
+            shards[str::stream() << "shard" << i] = ShardInfo(0, numShardChunks, false);
+        }
+
+        // A few hot chunks carry most of the operations, sizes vary by an order of magnitude
+        vector<long long> ops;
+        vector<long long> bytes;
+        for (const auto& shardChunks : chunks) {
+            for (size_t i = 0; i < shardChunks.second.size(); i++) {
+                ops.push_back(rng.nextInt32(20) == 0 ? 1000 + rng.nextInt32(5000)
+                                                     : rng.nextInt32(100));
+                bytes.push_back(1024 * (1 + rng.nextInt32(10)));
+            }
+        }
+
+        ChunkLoadInfoMap chunkLoad;
+        addChunkLoad(chunks, ops, bytes, &chunkLoad);
+
+        BalancerWeights weights;
+        weights.chunks = rng.nextInt32(2);
+        weights.bytes = rng.nextInt32(2);
+        weights.load = 1;
+
+        bool converged = false;
+        for (int i = 0; i < 10000; i++) {
+            DistributionStatus d(shards, chunks);
+            d.setChunkLoad(&chunkLoad);
+
+            std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 1, weights));
+            if (!m) {
+                converged = true;
+                break;
+            }
+
+            moveChunk(chunks, m.get());
+        }
+
+        ASSERT(converged);
+
+        // Weigh the final distribution the way the policy does
+        const double totalWeight = weights.chunks + weights.bytes + weights.load;
+        double avgOps = 0;
+        double avgBytes = 0;
+        for (const auto& load : chunkLoad) {
+            avgOps += load.second.ops;
+            avgBytes += load.second.bytes;
+        }
+        avgOps /= chunkLoad.size();
+        avgBytes /= chunkLoad.size();
+
+        double maxChunkWeight = 0;
+        double maxShardWeight = 0;
+        double minShardWeight = std::numeric_limits<double>::max();
+        for (const auto& shardChunks : chunks) {
+            double shardWeight = 0;
+            for (const ChunkType& chunk : shardChunks.second) {
+                const ChunkLoadInfo& load = chunkLoad[chunk.getMin()];
+                const double chunkWeight = (weights.chunks + weights.bytes * load.bytes / avgBytes +
+                                            weights.load * load.ops / avgOps) /
+                    totalWeight;
+                maxChunkWeight = std::max(maxChunkWeight, chunkWeight);
+                shardWeight += chunkWeight;
+            }
+
+            log() << shardChunks.first << " : " << shardChunks.second.size()
+                  << " chunks, weight " << shardWeight;
+            maxShardWeight = std::max(maxShardWeight, shardWeight);
+            minShardWeight = std::min(minShardWeight, shardWeight);
+        }
+
+        ASSERT_LESS_THAN_OR_EQUALS(maxShardWeight - minShardWeight,
+                                   std::max(2.0, maxChunkWeight) + 1e-9);
+    }
+}
+
 }  // namespace
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -47,14 +48,53 @@ CatalogCache::CatalogCache() {}
 
 StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn,
                                                            const string& dbName) {
-    stdx::lock_guard<stdx::mutex> guard(_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     ShardedDatabasesMap::iterator it = _databases.find(dbName);
     if (it != _databases.end()) {
         return it->second;
     }
 
+    // Wait for a load of the same database which is already in progress
+    DatabaseLoadsMap::iterator loadIt = _loads.find(dbName);
+    if (loadIt != _loads.end()) {
+        const auto load = loadIt->second;
+        load->finished.wait(lk, [&load] { return load->done; });
+        return load->result;
+    }
+
     // Need to load from the store
+    const auto load = std::make_shared<DatabaseLoad>();
+    _loads[dbName] = load;
+    lk.unlock();
+
+    auto finishLoad = [&](const StatusWith<shared_ptr<DBConfig>>& result) {
+        stdx::lock_guard<stdx::mutex> guard(_mutex);
+
+        invariant(_loads.erase(dbName) == 1);
+        if (result.isOK() && !load->invalidated) {
+            invariant(_databases.insert(std::make_pair(dbName, result.getValue())).second);
+        }
+
+        load->result = result;
+        load->done = true;
+        load->finished.notify_all();
+    };
+
+    StatusWith<shared_ptr<DBConfig>> result{ErrorCodes::InternalError, "not loaded"};
+    try {
+        result = _loadDatabase(txn, dbName);
+    } catch (...) {
+        finishLoad(exceptionToStatus());
+        throw;
+    }
+
+    finishLoad(result);
+    return result;
+}
+
+StatusWith<shared_ptr<DBConfig>> CatalogCache::_loadDatabase(OperationContext* txn,
+                                                             const string& dbName) {
     auto status = grid.catalogManager(txn)->getDatabase(txn, dbName);
     if (!status.isOK()) {
         return status.getStatus();
@@ -65,8 +105,6 @@ StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn
         std::make_shared<DBConfig>(dbName, dbOpTimePair.value, dbOpTimePair.opTime);
     db->load(txn);
 
-    invariant(_databases.insert(std::make_pair(dbName, db)).second);
-
     return db;
 }
 
@@ -77,12 +115,21 @@ void CatalogCache::invalidate(const string& dbName) {
     if (it != _databases.end()) {
         _databases.erase(it);
     }
+
+    DatabaseLoadsMap::iterator loadIt = _loads.find(dbName);
+    if (loadIt != _loads.end()) {
+        loadIt->second->invalidated = true;
+    }
 }
 
 void CatalogCache::invalidateAll() {
     stdx::lock_guard<stdx::mutex> guard(_mutex);
 
     _databases.clear();
+
+    for (auto& load : _loads) {
+        load.second->invalidated = true;
+    }
 }
 
 }  // namespace mongo
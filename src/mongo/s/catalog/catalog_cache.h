@@ -33,6 +33,8 @@
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -40,8 +42,6 @@ namespace mongo {
 class CatalogManager;
 class DBConfig;
 class OperationContext;
-template <typename T>
-class StatusWith;
 
 
 /**
@@ -61,6 +61,10 @@ public:
      * local variable. The reason for this is so that if the cache gets invalidated, the caller
      * does not miss getting the most up-to-date value.
      *
+     * The database is loaded from the config server without holding the cache's mutex, so that
+     * lookups of other databases are not blocked by it. Concurrent lookups of a database which
+     * is being loaded wait for that load instead of issuing their own.
+     *
      * @param dbname The name of the database (must not contain dots, etc).
      * @return The database if it exists, NULL otherwise.
      */
@@ -79,11 +83,36 @@ public:
     void invalidateAll();
 
 private:
+    /**
+     * A load of a database's metadata from the config server which is in progress.
+     */
+    struct DatabaseLoad {
+        bool done = false;
+
+        // Set if the database is invalidated while it is being loaded, in which case the result
+        // is returned to the threads waiting for it, but not cached
+        bool invalidated = false;
+
+        StatusWith<std::shared_ptr<DBConfig>> result{ErrorCodes::InternalError, "not loaded"};
+        stdx::condition_variable finished;
+    };
+
     typedef std::map<std::string, std::shared_ptr<DBConfig>> ShardedDatabasesMap;
+    typedef std::map<std::string, std::shared_ptr<DatabaseLoad>> DatabaseLoadsMap;
+
+    /**
+     * Loads the specified database from the config server. Must be called without holding
+     * _mutex.
+     */
+    static StatusWith<std::shared_ptr<DBConfig>> _loadDatabase(OperationContext* txn,
+                                                               const std::string& dbName);
 
     // Databases catalog map and mutex to protect it
     stdx::mutex _mutex;
     ShardedDatabasesMap _databases;
+
+    // Databases which are being loaded, protected by _mutex
+    DatabaseLoadsMap _loads;
 };
 
 }  // namespace mongo
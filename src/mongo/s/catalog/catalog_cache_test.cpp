@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/s/catalog/catalog_cache.h"
+#include "mongo/s/catalog/type_collection.h"
+#include "mongo/s/catalog/type_database.h"
+#include "mongo/s/config.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/sharding_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+using executor::RemoteCommandRequest;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+const HostAndPort kConfigHost("TestHost1");
+const string kDbName("TestDB");
+
+class CatalogCacheTest : public ShardingTestFixture {
+public:
+    void setUp() override {
+        ShardingTestFixture::setUp();
+        configTargeter()->setFindHostReturnValue(kConfigHost);
+
+        _db.setName(kDbName);
+        _db.setPrimary("shard0000");
+        _db.setSharded(true);
+    }
+
+protected:
+    /**
+     * Expects a single lookup of the test database's entry in config.databases.
+     */
+    void expectGetDatabase() {
+        onFindCommand([this](const RemoteCommandRequest& request) {
+            ASSERT_EQUALS(kConfigHost, request.target);
+
+            const NamespaceString nss(request.dbname, request.cmdObj.firstElement().String());
+            ASSERT_EQ(DatabaseType::ConfigNS, nss.ns());
+
+            return vector<BSONObj>{_db.toBSON()};
+        });
+    }
+
+    /**
+     * Expects a single lookup of the test database's collections in config.collections and
+     * reports that it has none.
+     */
+    void expectGetCollections() {
+        onFindCommand([](const RemoteCommandRequest& request) {
+            ASSERT_EQUALS(kConfigHost, request.target);
+
+            const NamespaceString nss(request.dbname, request.cmdObj.firstElement().String());
+            ASSERT_EQ(CollectionType::ConfigNS, nss.ns());
+
+            return vector<BSONObj>{};
+        });
+    }
+
+    DatabaseType _db;
+};
+
+TEST_F(CatalogCacheTest, ConcurrentGetDatabaseLoadsOnce) {
+    auto lookup = [this] {
+        auto status = grid.catalogCache()->getDatabase(operationContext(), kDbName);
+        ASSERT_OK(status.getStatus());
+        return status.getValue();
+    };
+
+    auto future1 = launchAsync(lookup);
+    auto future2 = launchAsync(lookup);
+
+    // Whichever lookup starts loading the database, the other one must wait for it instead of
+    // going to the config server itself, so only a single load is served here.
+    expectGetDatabase();  // CatalogCache::_loadDatabase
+    expectGetDatabase();  // DBConfig::load
+    expectGetCollections();
+
+    shared_ptr<DBConfig> db1 = future1.timed_get(kFutureTimeout);
+    shared_ptr<DBConfig> db2 = future2.timed_get(kFutureTimeout);
+    ASSERT(db1);
+    ASSERT_EQ(db1.get(), db2.get());
+    ASSERT(db1->isShardingEnabled());
+}
+
+TEST_F(CatalogCacheTest, ConcurrentDBConfigReloadsLoadOnce) {
+    auto loadFuture = launchAsync([this] {
+        auto status = grid.catalogCache()->getDatabase(operationContext(), kDbName);
+        ASSERT_OK(status.getStatus());
+        return status.getValue();
+    });
+
+    expectGetDatabase();
+    expectGetDatabase();
+    expectGetCollections();
+
+    shared_ptr<DBConfig> db = loadFuture.timed_get(kFutureTimeout);
+
+    AtomicInt32 numStarted;
+    auto reload = [this, db, &numStarted] {
+        numStarted.fetchAndAdd(1);
+        return db->reload(operationContext());
+    };
+
+    auto future1 = launchAsync(reload);
+    auto future2 = launchAsync(reload);
+
+    // The first reload cannot complete until its requests are served below, so once both
+    // threads have started they are reloading the same iteration and must share one reload.
+    while (numStarted.load() < 2) {
+        sleepmillis(1);
+    }
+
+    expectGetDatabase();
+    expectGetCollections();
+
+    ASSERT(future1.timed_get(kFutureTimeout));
+    ASSERT(future2.timed_get(kFutureTimeout));
+}
+
+}  // namespace
+}  // namespace mongo
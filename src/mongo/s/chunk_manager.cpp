@@ -163,14 +163,16 @@ ChunkManager::ChunkManager(const string& ns, const ShardKeyPattern& pattern, boo
       _keyPattern(pattern.getKeyPattern()),
       _unique(unique),
       _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {}
+      _chunkTable(RoutingTable::Builder().done()),
+      _rangeTable(_chunkTable) {}
 
 ChunkManager::ChunkManager(const CollectionType& coll)
     : _ns(coll.getNs().ns()),
       _keyPattern(coll.getKeyPattern()),
       _unique(coll.getUnique()),
       _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {
+      _chunkTable(RoutingTable::Builder().done()),
+      _rangeTable(_chunkTable) {
     // coll does not have correct version. Use same initial version as _load and createFirstChunks.
     _version = ChunkVersion(0, 0, coll.getEpoch());
 }
@@ -182,10 +184,12 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
         ChunkMap chunkMap;
         set<ShardId> shardIds;
         ShardVersionMap shardVersions;
+        OldChunkIndexes oldChunkIndexes;
 
         Timer t;
 
-        bool success = _load(txn, chunkMap, shardIds, &shardVersions, oldManager);
+        bool success =
+            _load(txn, chunkMap, shardIds, &shardVersions, oldManager, &oldChunkIndexes);
         if (success) {
             log() << "ChunkManager: time to load chunks for " << _ns << ": " << t.millis() << "ms"
                   << " sequenceNumber: " << _sequenceNumber << " version: " << _version.toString()
@@ -197,7 +201,7 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _chunkMap.swap(chunkMap);
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
-                _chunkRanges.reloadAll(_chunkMap);
+                _buildRoutingTables(oldManager, oldChunkIndexes);
 
                 return;
             }
@@ -222,7 +226,8 @@ bool ChunkManager::_load(OperationContext* txn,
                          ChunkMap& chunkMap,
                          set<ShardId>& shardIds,
                          ShardVersionMap* shardVersions,
-                         const ChunkManager* oldManager) {
+                         const ChunkManager* oldManager,
+                         OldChunkIndexes* oldChunkIndexes) {
     // Reset the max version, but not the epoch, when we aren't loading from the oldManager
     _version = ChunkVersion(0, 0, _version.epoch());
 
@@ -241,6 +246,7 @@ bool ChunkManager::_load(OperationContext* txn,
         // Could be v.expensive
         // TODO: If chunks were immutable and didn't reference the manager, we could do more
         // interesting things here
+        size_t oldIndex = 0;
         for (const auto& oldChunkMapEntry : oldChunkMap) {
             shared_ptr<Chunk> oldC = oldChunkMapEntry.second;
             shared_ptr<Chunk> newC(new Chunk(
@@ -249,6 +255,7 @@ bool ChunkManager::_load(OperationContext* txn,
             newC->setBytesWritten(oldC->getBytesWritten());
 
             chunkMap.insert(make_pair(oldC->getMax(), newC));
+            oldChunkIndexes->emplace(newC, oldIndex++);
         }
 
         LOG(2) << "loading chunk manager for collection " << _ns
@@ -328,6 +335,54 @@ bool ChunkManager::_load(OperationContext* txn,
     }
 }
 
+void ChunkManager::_buildRoutingTables(const ChunkManager* oldManager,
+                                       const OldChunkIndexes& oldChunkIndexes) {
+    _chunks.clear();
+    _chunks.reserve(_chunkMap.size());
+
+    // Chunks copied from the old manager reuse its encoding of their upper bound, so only the
+    // chunks changed by the diff are encoded here.
+    RoutingTable::Builder chunkTableBuilder(_chunkMap.size());
+    bool unchanged = oldManager && oldManager->_chunkTable->size() == _chunkMap.size();
+    for (const auto& chunkMapEntry : _chunkMap) {
+        const ChunkPtr& chunk = chunkMapEntry.second;
+        const auto oldIndex = oldChunkIndexes.find(chunk);
+        if (oldIndex != oldChunkIndexes.end()) {
+            chunkTableBuilder.append(oldManager->_chunkTable->encodedMax(oldIndex->second),
+                                     chunk->getShardId());
+            unchanged = unchanged && oldIndex->second == _chunks.size();
+        } else {
+            chunkTableBuilder.append(chunk->getMax(), chunk->getShardId());
+            unchanged = false;
+        }
+        _chunks.push_back(chunk);
+    }
+
+    if (unchanged) {
+        _chunkTable = oldManager->_chunkTable;
+        _rangeTable = oldManager->_rangeTable;
+        return;
+    }
+
+    _chunkTable = chunkTableBuilder.done();
+
+    RoutingTable::Builder rangeTableBuilder;
+    for (size_t i = 0; i < _chunkTable->size(); ++i) {
+        const bool lastOfRange =
+            i + 1 == _chunkTable->size() || _chunkTable->shardId(i + 1) != _chunkTable->shardId(i);
+        if (lastOfRange) {
+            rangeTableBuilder.append(_chunkTable->encodedMax(i), _chunkTable->shardId(i));
+        }
+    }
+    _rangeTable = rangeTableBuilder.done();
+
+    DEV {
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            invariant(_chunkTable->upperBound(_chunks[i]->getMin()) == i);
+        }
+    }
+}
+
 shared_ptr<ChunkManager> ChunkManager::reload(OperationContext* txn, bool force) const {
     const NamespaceString nss(_ns);
     auto config = uassertStatusOK(grid.catalogCache()->getDatabase(txn, nss.db().toString()));
@@ -449,10 +504,10 @@ ChunkPtr ChunkManager::findIntersectingChunk(OperationContext* txn, const BSONOb
         BSONObj chunkMin;
         ChunkPtr chunk;
         {
-            ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-            if (it != _chunkMap.end()) {
-                chunkMin = it->first;
-                chunk = it->second;
+            const size_t index = _chunkTable->upperBound(shardKey);
+            if (index < _chunks.size()) {
+                chunk = _chunks[index];
+                chunkMin = chunk->getMin();
             }
         }
 
@@ -525,26 +580,26 @@ void ChunkManager::getShardIdsForQuery(OperationContext* txn,
     // returned.  For now, we satisfy that assumption by adding a shard with no matches rather
     // than return an empty set of shards.
     if (shardIds->empty()) {
-        massert(16068, "no chunk ranges available", !_chunkRanges.ranges().empty());
-        shardIds->insert(_chunkRanges.ranges().begin()->second->getShardId());
+        massert(16068, "no chunk ranges available", !_rangeTable->empty());
+        shardIds->insert(_rangeTable->shardId(0));
     }
 }
 
 void ChunkManager::getShardIdsForRange(set<ShardId>& shardIds,
                                        const BSONObj& min,
                                        const BSONObj& max) const {
-    ChunkRangeMap::const_iterator it = _chunkRanges.upper_bound(min);
-    ChunkRangeMap::const_iterator end = _chunkRanges.upper_bound(max);
+    size_t it = _rangeTable->upperBound(min);
+    size_t end = _rangeTable->upperBound(max);
 
     massert(13507,
             str::stream() << "no chunks found between bounds " << min << " and " << max,
-            it != _chunkRanges.ranges().end());
+            it != _rangeTable->size());
 
-    if (end != _chunkRanges.ranges().end())
+    if (end != _rangeTable->size())
         ++end;
 
     for (; it != end; ++it) {
-        shardIds.insert(it->second->getShardId());
+        shardIds.insert(_rangeTable->shardId(it));
 
         // once we know we need to visit all shards no need to keep looping
         if (shardIds.size() == _shardIds.size())
@@ -697,116 +752,6 @@ string ChunkManager::toString() const {
 }
 
 
-ChunkRange::ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end)
-    : _manager(begin->second->getManager()),
-      _shardId(begin->second->getShardId()),
-      _min(begin->second->getMin()),
-      _max(boost::prior(end)->second->getMax()) {
-    invariant(begin != end);
-
-    DEV while (begin != end) {
-        dassert(begin->second->getManager() == _manager);
-        dassert(begin->second->getShardId() == _shardId);
-        ++begin;
-    }
-}
-
-ChunkRange::ChunkRange(const ChunkRange& min, const ChunkRange& max)
-    : _manager(min.getManager()),
-      _shardId(min.getShardId()),
-      _min(min.getMin()),
-      _max(max.getMax()) {
-    invariant(min.getShardId() == max.getShardId());
-    invariant(min.getManager() == max.getManager());
-    invariant(min.getMax() == max.getMin());
-}
-
-string ChunkRange::toString() const {
-    StringBuilder sb;
-    sb << "ChunkRange(min=" << _min << ", max=" << _max << ", shard=" << _shardId << ")";
-
-    return sb.str();
-}
-
-
-void ChunkRangeManager::assertValid() const {
-    if (_ranges.empty())
-        return;
-
-    try {
-        // No Nulls
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->second);
-        }
-
-        // Check endpoints
-        verify(allOfType(MinKey, _ranges.begin()->second->getMin()));
-        verify(allOfType(MaxKey, boost::prior(_ranges.end())->second->getMax()));
-
-        // Make sure there are no gaps or overlaps
-        for (ChunkRangeMap::const_iterator it = boost::next(_ranges.begin()), end = _ranges.end();
-             it != end;
-             ++it) {
-            ChunkRangeMap::const_iterator last = boost::prior(it);
-            verify(it->second->getMin() == last->second->getMax());
-        }
-
-        // Check Map keys
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->first == it->second->getMax());
-        }
-
-        // Make sure we match the original chunks
-        const ChunkMap chunks = _ranges.begin()->second->getManager()->_chunkMap;
-        for (ChunkMap::const_iterator i = chunks.begin(); i != chunks.end(); ++i) {
-            const ChunkPtr chunk = i->second;
-
-            ChunkRangeMap::const_iterator min = _ranges.upper_bound(chunk->getMin());
-            ChunkRangeMap::const_iterator max = _ranges.lower_bound(chunk->getMax());
-
-            verify(min != _ranges.end());
-            verify(max != _ranges.end());
-            verify(min == max);
-            verify(min->second->getShardId() == chunk->getShardId());
-            verify(min->second->containsKey(chunk->getMin()));
-            verify(min->second->containsKey(chunk->getMax()) ||
-                   (min->second->getMax() == chunk->getMax()));
-        }
-
-    } catch (...) {
-        error() << "\t invalid ChunkRangeMap! printing ranges:";
-
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            log() << it->first << ": " << it->second->toString();
-        }
-
-        throw;
-    }
-}
-
-void ChunkRangeManager::reloadAll(const ChunkMap& chunks) {
-    _ranges.clear();
-    _insertRange(chunks.begin(), chunks.end());
-
-    DEV assertValid();
-}
-
-void ChunkRangeManager::_insertRange(ChunkMap::const_iterator begin,
-                                     const ChunkMap::const_iterator end) {
-    while (begin != end) {
-        ChunkMap::const_iterator first = begin;
-        ShardId shardId = first->second->getShardId();
-        while (begin != end && (begin->second->getShardId() == shardId))
-            ++begin;
-
-        shared_ptr<ChunkRange> cr(new ChunkRange(first, begin));
-        _ranges[cr->getMax()] = cr;
-    }
-}
-
 int ChunkManager::getCurrentDesiredChunkSize() const {
     // split faster in early chunks helps spread out an initial load better
     const int minChunkSize = 1 << 20;  // 1 MBytes
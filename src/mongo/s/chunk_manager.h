@@ -30,10 +30,12 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/routing_table.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -47,79 +49,9 @@ class OperationContext;
 
 typedef std::shared_ptr<ChunkManager> ChunkManagerPtr;
 
-// The key for the map is max for each Chunk or ChunkRange
+// The key for the map is max for each Chunk
 typedef std::map<BSONObj, std::shared_ptr<Chunk>, BSONObjCmp> ChunkMap;
 
-class ChunkRange {
-public:
-    ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
-
-    // Merge min and max (must be adjacent ranges)
-    ChunkRange(const ChunkRange& min, const ChunkRange& max);
-
-    const ChunkManager* getManager() const {
-        return _manager;
-    }
-    ShardId getShardId() const {
-        return _shardId;
-    }
-
-    const BSONObj& getMin() const {
-        return _min;
-    }
-    const BSONObj& getMax() const {
-        return _max;
-    }
-
-    // clones of Chunk methods
-    // Returns true if this ChunkRange contains the given shard key, and false otherwise
-    //
-    // Note: this function takes an extracted *key*, not an original document
-    // (the point may be computed by, say, hashing a given field or projecting
-    //  to a subset of fields).
-    bool containsKey(const BSONObj& shardKey) const;
-
-    std::string toString() const;
-
-private:
-    const ChunkManager* _manager;
-    const ShardId _shardId;
-    const BSONObj _min;
-    const BSONObj _max;
-};
-
-typedef std::map<BSONObj, std::shared_ptr<ChunkRange>, BSONObjCmp> ChunkRangeMap;
-
-
-class ChunkRangeManager {
-public:
-    const ChunkRangeMap& ranges() const {
-        return _ranges;
-    }
-
-    void clear() {
-        _ranges.clear();
-    }
-
-    void reloadAll(const ChunkMap& chunks);
-
-    // Slow operation -- wrap with DEV
-    void assertValid() const;
-
-    ChunkRangeMap::const_iterator upper_bound(const BSONObj& o) const {
-        return _ranges.upper_bound(o);
-    }
-    ChunkRangeMap::const_iterator lower_bound(const BSONObj& o) const {
-        return _ranges.lower_bound(o);
-    }
-
-private:
-    // assumes nothing in this range exists in _ranges
-    void _insertRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
-
-    ChunkRangeMap _ranges;
-};
-
 
 /* config.sharding
      { ns: 'alleyinsider.fs.chunks' ,
@@ -255,12 +187,25 @@ public:
     repl::OpTime getConfigOpTime() const;
 
 private:
+    // Position, in the old manager's chunk table, of each chunk copied from it by _load. Holds
+    // references so that chunks replaced by the diff cannot be confused with new allocations.
+    typedef std::unordered_map<ChunkPtr, size_t> OldChunkIndexes;
+
     // returns true if load was consistent
     bool _load(OperationContext* txn,
                ChunkMap& chunks,
                std::set<ShardId>& shardIds,
                ShardVersionMap* shardVersions,
-               const ChunkManager* oldManager);
+               const ChunkManager* oldManager,
+               OldChunkIndexes* oldChunkIndexes);
+
+    /**
+     * Rebuilds the routing tables from _chunkMap. Encoded bounds of chunks listed in
+     * 'oldChunkIndexes' are copied from 'oldManager' rather than encoded again, and if no chunk
+     * changed, the old manager's tables are shared outright.
+     */
+    void _buildRoutingTables(const ChunkManager* oldManager,
+                             const OldChunkIndexes& oldChunkIndexes);
 
 
     // All members should be const for thread-safety
@@ -274,7 +219,15 @@ private:
     const unsigned long long _sequenceNumber;
 
     ChunkMap _chunkMap;
-    ChunkRangeManager _chunkRanges;
+
+    // One entry per chunk in _chunkMap order, with _chunks holding the chunk for each entry. Used
+    // to find the chunk containing a shard key.
+    std::shared_ptr<const RoutingTable> _chunkTable;
+    std::vector<ChunkPtr> _chunks;
+
+    // One entry per run of consecutive chunks on the same shard. Used to find the shards covering
+    // a range of shard keys.
+    std::shared_ptr<const RoutingTable> _rangeTable;
 
     std::set<ShardId> _shardIds;
 
@@ -317,7 +270,6 @@ private:
     //
 
     friend class Chunk;
-    friend class ChunkRangeManager;  // only needed for CRM::assertValid()
     static AtomicUInt32 NextSequenceNumber;
 
     friend class TestableChunkManager;
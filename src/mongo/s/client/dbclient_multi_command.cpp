@@ -30,6 +30,9 @@
 
 #include "mongo/s/client/dbclient_multi_command.h"
 
+#include <set>
+#include <vector>
+
 #include "mongo/db/audit.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/wire_version.h"
@@ -39,6 +42,7 @@
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/socket_poll.h"
 
 namespace mongo {
 
@@ -145,7 +149,11 @@ void DBClientMultiCommand::sendAll() {
          it != _pendingCommands.end();
          ++it) {
         PendingCommand* command = *it;
+        if (command->sent)
+            continue;
+
         dassert(!command->conn);
+        command->sent = true;
 
         try {
             dassert(command->endpoint.type() == ConnectionString::MASTER ||
@@ -176,8 +184,9 @@ int DBClientMultiCommand::numPending() const {
 }
 
 Status DBClientMultiCommand::recvAny(ConnectionString* endpoint, BSONSerializable* response) {
-    unique_ptr<PendingCommand> command(_pendingCommands.front());
-    _pendingCommands.pop_front();
+    PendingQueue::iterator nextIt = _nextResponse();
+    unique_ptr<PendingCommand> command(*nextIt);
+    _pendingCommands.erase(nextIt);
 
     *endpoint = command->endpoint;
     if (!command->status.isOK())
@@ -209,10 +218,75 @@ Status DBClientMultiCommand::recvAny(ConnectionString* endpoint, BSONSerializabl
     return Status::OK();
 }
 
+DBClientMultiCommand::PendingQueue::iterator DBClientMultiCommand::_nextResponse() {
+    dassert(!_pendingCommands.empty());
+    if (_pendingCommands.size() == 1 || !isPollSupported())
+        return _pendingCommands.begin();
+
+    // Only the oldest command for each endpoint may be received, so that responses from the
+    // same endpoint are returned in order.
+    std::set<string> seenEndpoints;
+    std::vector<int> fds;
+    std::vector<PendingQueue::iterator> candidates;
+    for (PendingQueue::iterator it = _pendingCommands.begin(); it != _pendingCommands.end();
+         ++it) {
+        PendingCommand* command = *it;
+        dassert(command->sent);
+
+        if (!seenEndpoints.insert(command->endpoint.toString()).second)
+            continue;
+
+        // A command which failed to send already has its result
+        if (!command->status.isOK())
+            return it;
+
+        DBClientConnection* const actualConn = dynamic_cast<DBClientConnection*>(
+            !_isConfig ? command->conn->get() : command->conn->getRawConn());
+        if (!actualConn)
+            return _pendingCommands.begin();
+
+        fds.push_back(actualConn->port().psock->rawFD());
+        candidates.push_back(it);
+    }
+
+    // Don't wait longer than a receive from the oldest command would before timing out
+    const double soTimeout = (!_isConfig ? _pendingCommands.front()->conn->get()
+                                         : _pendingCommands.front()->conn->getRawConn())
+                                 ->getSoTimeout();
+    const int timeoutMillis = soTimeout > 0 ? static_cast<int>(soTimeout * 1000) : -1;
+
+    // The oldest command is always the first candidate, so it is also the fallback
+    return candidates[pollForResponse(fds, timeoutMillis)];
+}
+
+size_t DBClientMultiCommand::pollForResponse(const std::vector<int>& fds, int timeoutMillis) {
+    std::vector<pollfd> pollInfo;
+    for (int fd : fds) {
+        pollfd pollEntry;
+        pollEntry.fd = fd;
+        pollEntry.events = POLLIN;
+        pollEntry.revents = 0;
+        pollInfo.push_back(pollEntry);
+    }
+
+    if (socketPoll(pollInfo.data(), pollInfo.size(), timeoutMillis) > 0) {
+        for (size_t i = 0; i < pollInfo.size(); ++i) {
+            if (pollInfo[i].revents)
+                return i;
+        }
+    }
+
+    return 0;
+}
+
 DBClientMultiCommand::PendingCommand::PendingCommand(const ConnectionString& endpoint,
                                                      StringData dbName,
                                                      const BSONObj& cmdObj)
-    : endpoint(endpoint), dbName(dbName.toString()), cmdObj(cmdObj), status(Status::OK()) {}
+    : endpoint(endpoint),
+      dbName(dbName.toString()),
+      cmdObj(cmdObj),
+      sent(false),
+      status(Status::OK()) {}
 
 DBClientMultiCommand::PendingCommand::~PendingCommand() = default;
 
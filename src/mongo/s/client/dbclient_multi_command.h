@@ -29,6 +29,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/s/client/multi_command_dispatch.h"
@@ -63,6 +64,13 @@ public:
 
     Status recvAny(ConnectionString* endpoint, BSONSerializable* response) override;
 
+    /**
+     * Waits up to timeoutMillis (-1 waits indefinitely) for one of the given sockets to become
+     * readable and returns the index of the first one which did, or 0 if none became readable
+     * in time.  Requires poll support.
+     */
+    static size_t pollForResponse(const std::vector<int>& fds, int timeoutMillis);
+
 private:
     // All info associated with an pre- or in-flight command
     struct PendingCommand {
@@ -77,12 +85,21 @@ private:
         // Where to send it
         std::unique_ptr<ShardConnection> conn;
 
+        // Whether sendAll has already attempted to send it
+        bool sent;
+
         // If anything goes wrong
         Status status;
     };
 
     typedef std::deque<PendingCommand*> PendingQueue;
 
+    /**
+     * Returns the sent command whose response should be received next, which is one whose
+     * response has arrived if any, and otherwise the oldest command.
+     */
+    PendingQueue::iterator _nextResponse();
+
     const bool _isConfig;
 
     PendingQueue _pendingCommands;
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+#include "mongo/s/client/dbclient_multi_command.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/socket_poll.h"
+
+namespace mongo {
+namespace {
+
+#ifndef _WIN32
+
+/**
+ * A connected pair of local sockets, closed on destruction.
+ */
+class LocalSocketPair {
+public:
+    LocalSocketPair() {
+        ASSERT_EQUALS(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, _fds));
+    }
+
+    ~LocalSocketPair() {
+        ::close(_fds[0]);
+        ::close(_fds[1]);
+    }
+
+    // The end which polls for a response
+    int local() const {
+        return _fds[0];
+    }
+
+    // Makes a response readable on the local end
+    void respond() {
+        const char data = 'x';
+        ASSERT_EQUALS(1, ::write(_fds[1], &data, 1));
+    }
+
+private:
+    int _fds[2];
+};
+
+TEST(DBClientMultiCommandTest, PollReturnsReadableSocket) {
+    ASSERT(isPollSupported());
+
+    LocalSocketPair first;
+    LocalSocketPair second;
+    LocalSocketPair third;
+    third.respond();
+
+    std::vector<int> fds{first.local(), second.local(), third.local()};
+    ASSERT_EQUALS(2U, DBClientMultiCommand::pollForResponse(fds, 0));
+}
+
+TEST(DBClientMultiCommandTest, PollPrefersOldestReadableSocket) {
+    ASSERT(isPollSupported());
+
+    LocalSocketPair first;
+    LocalSocketPair second;
+    LocalSocketPair third;
+    second.respond();
+    third.respond();
+
+    std::vector<int> fds{first.local(), second.local(), third.local()};
+    ASSERT_EQUALS(1U, DBClientMultiCommand::pollForResponse(fds, 0));
+}
+
+TEST(DBClientMultiCommandTest, PollFallsBackToOldestOnTimeout) {
+    ASSERT(isPollSupported());
+
+    LocalSocketPair first;
+    LocalSocketPair second;
+
+    std::vector<int> fds{first.local(), second.local()};
+    ASSERT_EQUALS(0U, DBClientMultiCommand::pollForResponse(fds, 10));
+}
+
+TEST(DBClientMultiCommandTest, PollReturnsClosedSocket) {
+    ASSERT(isPollSupported());
+
+    LocalSocketPair first;
+    int fds[2];
+    ASSERT_EQUALS(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ::close(fds[1]);
+
+    // A closed peer must be received so that the error is reported rather than waited on
+    std::vector<int> pollFds{first.local(), fds[0]};
+    ASSERT_EQUALS(1U, DBClientMultiCommand::pollForResponse(pollFds, 0));
+    ::close(fds[0]);
+}
+
+#endif  // ndef _WIN32
+
+}  // namespace
+}  // namespace mongo
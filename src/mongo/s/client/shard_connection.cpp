@@ -185,6 +185,7 @@ public:
                         versionManager.resetShardVersionCB(ss->avail);
                     }
 
+                    shardConnectionPool.decrementEgress(addr, ss->avail);
                     delete ss->avail;
                 } else {
                     release(addr, ss->avail);
@@ -247,6 +248,7 @@ public:
             }
 
             if (!isConnGood) {
+                shardConnectionPool.decrementEgress(addr, s->avail);
                 delete s->avail;
                 s->avail = NULL;
             }
@@ -357,6 +359,7 @@ public:
     void clearPool() {
         for (HostMap::iterator iter = _hosts.begin(); iter != _hosts.end(); ++iter) {
             if (iter->second->avail != NULL) {
+                shardConnectionPool.decrementEgress(iter->first, iter->second->avail);
                 delete iter->second->avail;
             }
             delete iter->second;
@@ -482,6 +485,7 @@ void ShardConnection::kill() {
             // Let the pool know about the bad connection and also delegate disposal to it.
             ClientConnections::threadInstance()->done(_cs.toString(), _conn);
         } else {
+            shardConnectionPool.decrementEgress(_cs.toString(), _conn);
             delete _conn;
         }
 
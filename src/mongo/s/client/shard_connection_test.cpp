@@ -81,6 +81,7 @@ public:
         delete _dummyServer;
 
         mongo::shardConnectionPool.setMaxPoolSize(_maxPoolSizePerHost);
+        mongo::shardConnectionPool.setMaxInUse(PoolForHost::kPoolSizeUnlimited);
     }
 
     void killServer() {
@@ -308,5 +309,45 @@ TEST_F(ShardConnFixture, DontReturnConnGoneBadToPool) {
     conn1Again.done();
 }
 
+TEST_F(ShardConnFixture, ClearPoolReleasesInUseLimit) {
+    mongo::shardConnectionPool.setMaxInUse(1);
+    mongo::shardConnectionPool.setMaxInUseWaitTimeout(Milliseconds(100));
+
+    // The thread local pool keeps conn1, which still counts against the in-use limit
+    ShardConnection conn1(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    conn1.done();
+
+    ShardConnection::clearPool();
+
+    ShardConnection conn2(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    conn2.done();
+}
+
+TEST_F(ShardConnFixture, DroppingAdditionalConnReleasesInUseLimit) {
+    mongo::shardConnectionPool.setMaxInUse(2);
+    mongo::shardConnectionPool.setMaxInUseWaitTimeout(Milliseconds(100));
+
+    ShardConnection conn1(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    ShardConnection conn2(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    conn1.done();
+
+    killServer();
+
+    try {
+        conn2.get()->query("test.user", mongo::Query());
+    } catch (const mongo::SocketException&) {
+    }
+
+    // Returning the bad conn2 also drops conn1 from the thread local pool
+    conn2.done();
+
+    restartServer();
+
+    ShardConnection conn3(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    ShardConnection conn4(ConnectionString(HostAndPort(TARGET_HOST)), "test.user");
+    conn3.done();
+    conn4.done();
+}
+
 }  // namespace
 }  // namespace mongo
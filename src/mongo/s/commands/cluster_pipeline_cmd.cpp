@@ -42,6 +42,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/platform/random.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/catalog_cache.h"
@@ -149,7 +150,12 @@ public:
 
         // Split the pipeline into pieces for mongod(s) and this mongos. If needSplit is true,
         // 'pipeline' will become the merger side.
-        intrusive_ptr<Pipeline> shardPipeline(needSplit ? pipeline->splitForSharded() : pipeline);
+        // If a $group is on the shard key, each shard can complete the groups it produces.
+        const BSONObj shardKeyPattern = internalQueryCompleteShardKeyGroupsOnShards.load()
+            ? chunkMgr->getShardKeyPattern().toBSON()
+            : BSONObj();
+        intrusive_ptr<Pipeline> shardPipeline(needSplit ? pipeline->splitForSharded(shardKeyPattern)
+                                                        : pipeline);
 
         // Create the command for the shards. The 'fromRouter' field means produce output to
         // be merged.
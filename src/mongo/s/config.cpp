@@ -272,21 +272,19 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
                                                         const string& ns,
                                                         bool shouldReload,
                                                         bool forceReload) {
-    BSONObj key;
-    ChunkVersion oldVersion;
-    ChunkManagerPtr oldManager;
-
     const auto currentReloadIteration = _reloadCount.load();
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_lock);
+    stdx::unique_lock<stdx::mutex> lk(_lock);
 
-        bool earlyReload = !_collections[ns].isSharded() && (shouldReload || forceReload);
-        if (earlyReload) {
-            // This is to catch cases where there this is a new sharded collection
-            _loadIfNeeded(txn, currentReloadIteration);
-        }
+    bool earlyReload = !_collections[ns].isSharded() && (shouldReload || forceReload);
+    if (earlyReload) {
+        // This is to catch cases where there this is a new sharded collection
+        lk.unlock();
+        _loadIfNeeded(txn, currentReloadIteration);
+        lk.lock();
+    }
 
+    {
         CollectionInfo& ci = _collections[ns];
         uassert(10181, str::stream() << "not sharded:" << ns, ci.isSharded());
 
@@ -295,6 +293,71 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
         if (!(shouldReload || forceReload) || earlyReload) {
             return ci.getCM();
         }
+    }
+
+    // Join a reload of this collection which is already in progress, unless this is a forced
+    // reload and that one is not. Until the reload finishes, threads which do not ask for a
+    // reload keep routing with the chunk manager which is currently cached.
+    for (auto it = _chunkManagerRefreshes.find(ns); it != _chunkManagerRefreshes.end();
+         it = _chunkManagerRefreshes.find(ns)) {
+        const auto refresh = it->second;
+        refresh->finished.wait(lk, [&refresh] { return refresh->done; });
+
+        if (forceReload && !refresh->forced) {
+            continue;
+        }
+
+        uassertStatusOK(refresh->status);
+
+        const CollectionInfo& ci = _collections[ns];
+        uassert(34424,
+                str::stream() << "not sharded after waiting for chunk manager reload : " << ns,
+                ci.isSharded());
+        return ci.getCM();
+    }
+
+    const auto refresh = std::make_shared<ChunkManagerRefresh>(forceReload);
+    _chunkManagerRefreshes[ns] = refresh;
+    lk.unlock();
+
+    ChunkManagerPtr manager;
+    try {
+        manager = _refreshChunkManager(txn, ns, forceReload);
+    } catch (...) {
+        _finishChunkManagerRefresh(ns, refresh, exceptionToStatus());
+        throw;
+    }
+
+    _finishChunkManagerRefresh(ns, refresh, Status::OK());
+    return manager;
+}
+
+void DBConfig::_finishChunkManagerRefresh(const string& ns,
+                                          const std::shared_ptr<ChunkManagerRefresh>& refresh,
+                                          Status status) {
+    stdx::lock_guard<stdx::mutex> lk(_lock);
+
+    auto it = _chunkManagerRefreshes.find(ns);
+    invariant(it != _chunkManagerRefreshes.end() && it->second == refresh);
+    _chunkManagerRefreshes.erase(it);
+
+    refresh->status = std::move(status);
+    refresh->done = true;
+    refresh->finished.notify_all();
+}
+
+std::shared_ptr<ChunkManager> DBConfig::_refreshChunkManager(OperationContext* txn,
+                                                             const string& ns,
+                                                             bool forceReload) {
+    BSONObj key;
+    ChunkVersion oldVersion;
+    ChunkManagerPtr oldManager;
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_lock);
+
+        CollectionInfo& ci = _collections[ns];
+        uassert(34432, str::stream() << "not sharded:" << ns, ci.isSharded());
 
         key = ci.key().copy();
 
@@ -341,36 +404,32 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
 
     unique_ptr<ChunkManager> tempChunkManager;
 
-    {
-        stdx::lock_guard<stdx::mutex> lll(_hitConfigServerLock);
-
-        if (!newestChunk.empty() && !forceReload) {
-            // If we have a target we're going for see if we've hit already
-            stdx::lock_guard<stdx::mutex> lk(_lock);
+    if (!newestChunk.empty() && !forceReload) {
+        // If we have a target we're going for see if we've hit already
+        stdx::lock_guard<stdx::mutex> lk(_lock);
 
-            CollectionInfo& ci = _collections[ns];
+        CollectionInfo& ci = _collections[ns];
 
-            if (ci.isSharded() && ci.getCM()) {
-                ChunkVersion currentVersion = newestChunk[0].getVersion();
+        if (ci.isSharded() && ci.getCM()) {
+            ChunkVersion currentVersion = newestChunk[0].getVersion();
 
-                // Only reload if the version we found is newer than our own in the same epoch
-                if (currentVersion <= ci.getCM()->getVersion() &&
-                    ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
-                    return ci.getCM();
-                }
+            // Only reload if the version we found is newer than our own in the same epoch
+            if (currentVersion <= ci.getCM()->getVersion() &&
+                ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
+                return ci.getCM();
             }
         }
+    }
 
-        tempChunkManager.reset(new ChunkManager(
-            oldManager->getns(), oldManager->getShardKeyPattern(), oldManager->isUnique()));
-        tempChunkManager->loadExistingRanges(txn, oldManager.get());
+    tempChunkManager.reset(new ChunkManager(
+        oldManager->getns(), oldManager->getShardKeyPattern(), oldManager->isUnique()));
+    tempChunkManager->loadExistingRanges(txn, oldManager.get());
 
-        if (tempChunkManager->numChunks() == 0) {
-            // Maybe we're not sharded any more, so do a full reload
-            reload(txn);
+    if (tempChunkManager->numChunks() == 0) {
+        // Maybe we're not sharded any more, so do a full reload
+        reload(txn);
 
-            return getChunkManager(txn, ns, false);
-        }
+        return getChunkManager(txn, ns, false);
     }
 
     stdx::lock_guard<stdx::mutex> lk(_lock);
@@ -434,15 +493,56 @@ void DBConfig::setPrimary(OperationContext* txn, const ShardId& newPrimaryId) {
 
 bool DBConfig::load(OperationContext* txn) {
     const auto currentReloadIteration = _reloadCount.load();
-    stdx::lock_guard<stdx::mutex> lk(_lock);
     return _loadIfNeeded(txn, currentReloadIteration);
 }
 
 bool DBConfig::_loadIfNeeded(OperationContext* txn, Counter reloadIteration) {
-    if (reloadIteration != _reloadCount.load()) {
-        return true;
+    std::shared_ptr<FullReload> reload;
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(_lock);
+
+        if (reloadIteration != _reloadCount.load()) {
+            return true;
+        }
+
+        // Join the reload which is already in progress
+        if (_fullReload) {
+            reload = _fullReload;
+            reload->finished.wait(lk, [&reload] { return reload->done; });
+            uassertStatusOK(reload->status);
+            return reload->found;
+        }
+
+        reload = std::make_shared<FullReload>();
+        _fullReload = reload;
+    }
+
+    auto finishReload = [&](Status status, bool found) {
+        stdx::lock_guard<stdx::mutex> lk(_lock);
+
+        invariant(_fullReload == reload);
+        _fullReload.reset();
+
+        reload->status = std::move(status);
+        reload->found = found;
+        reload->done = true;
+        reload->finished.notify_all();
+    };
+
+    bool found = false;
+    try {
+        found = _load(txn);
+    } catch (...) {
+        finishReload(exceptionToStatus(), false);
+        throw;
     }
 
+    finishReload(Status::OK(), found);
+    return found;
+}
+
+bool DBConfig::_load(OperationContext* txn) {
     auto status = grid.catalogManager(txn)->getDatabase(txn, _name);
     if (status == ErrorCodes::NamespaceNotFound) {
         return false;
@@ -454,37 +554,66 @@ bool DBConfig::_loadIfNeeded(OperationContext* txn, Counter reloadIteration) {
     const auto& dbOpTimePair = status.getValue();
     const auto& dbt = dbOpTimePair.value;
     invariant(_name == dbt.getName());
-    _primaryId = dbt.getPrimary();
-    _shardingEnabled = dbt.getSharded();
 
-    invariant(dbOpTimePair.opTime >= _configOpTime);
-    _configOpTime = dbOpTimePair.opTime;
-
-    // Load all collections
+    // Load all collections, along with their chunks. This is done without holding _lock so
+    // that routing with the metadata which is already cached is not blocked meanwhile.
     vector<CollectionType> collections;
     repl::OpTime configOpTimeWhenLoadingColl;
     uassertStatusOK(grid.catalogManager(txn)
                         ->getCollections(txn, &_name, &collections, &configOpTimeWhenLoadingColl));
 
+    invariant(configOpTimeWhenLoadingColl >= dbOpTimePair.opTime);
+
+    std::vector<std::pair<string, CollectionInfo>> loadedCollections;
+    for (const auto& coll : collections) {
+        if (!coll.getDropped()) {
+            loadedCollections.emplace_back(
+                coll.getNs().ns(), CollectionInfo(txn, coll, configOpTimeWhenLoadingColl));
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_lock);
+
+    _primaryId = dbt.getPrimary();
+    _shardingEnabled = dbt.getSharded();
+
+    invariant(dbOpTimePair.opTime >= _configOpTime);
+    _configOpTime = dbOpTimePair.opTime;
+
     int numCollsErased = 0;
     int numCollsSharded = 0;
 
-    invariant(configOpTimeWhenLoadingColl >= _configOpTime);
-
+    auto loadedIt = loadedCollections.begin();
     for (const auto& coll : collections) {
-        auto collIter = _collections.find(coll.getNs().ns());
+        const string ns = coll.getNs().ns();
+
+        auto collIter = _collections.find(ns);
         if (collIter != _collections.end()) {
             invariant(configOpTimeWhenLoadingColl >= collIter->second.getConfigOpTime());
         }
 
         if (coll.getDropped()) {
-            _collections.erase(coll.getNs().ns());
+            _collections.erase(ns);
             numCollsErased++;
-        } else {
-            _collections[coll.getNs().ns()] =
-                CollectionInfo(txn, coll, configOpTimeWhenLoadingColl);
-            numCollsSharded++;
+            continue;
+        }
+
+        invariant(loadedIt != loadedCollections.end() && loadedIt->first == ns);
+        CollectionInfo& loaded = (loadedIt++)->second;
+        numCollsSharded++;
+
+        // A chunk manager reload for this collection may have installed newer chunks while
+        // this thread was loading, in which case those are kept.
+        if (collIter != _collections.end() && collIter->second.isSharded() &&
+            loaded.isSharded()) {
+            const ChunkVersion cachedVersion = collIter->second.getCM()->getVersion();
+            const ChunkVersion loadedVersion = loaded.getCM()->getVersion();
+            if (cachedVersion.hasEqualEpoch(loadedVersion) && loadedVersion < cachedVersion) {
+                continue;
+            }
         }
+
+        _collections[ns] = std::move(loaded);
     }
 
     LOG(2) << "found " << numCollsSharded << " collections left and " << numCollsErased
@@ -517,13 +646,8 @@ void DBConfig::_save(OperationContext* txn, bool db, bool coll) {
 }
 
 bool DBConfig::reload(OperationContext* txn) {
-    bool successful = false;
     const auto currentReloadIteration = _reloadCount.load();
-
-    {
-        stdx::lock_guard<stdx::mutex> lk(_lock);
-        successful = _loadIfNeeded(txn, currentReloadIteration);
-    }
+    const bool successful = _loadIfNeeded(txn, currentReloadIteration);
 
     // If we aren't successful loading the database entry, we don't want to keep the stale
     // object around which has invalid data.
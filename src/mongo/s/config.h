@@ -28,12 +28,15 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <set>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -181,6 +184,48 @@ protected:
     typedef std::map<std::string, CollectionInfo> CollectionInfoMap;
     typedef AtomicUInt64::WordType Counter;
 
+    /**
+     * A reload of one collection's chunk manager which is in progress. Threads which need the
+     * same collection reloaded wait for it to finish instead of loading the chunks themselves.
+     */
+    struct ChunkManagerRefresh {
+        explicit ChunkManagerRefresh(bool isForced) : forced(isForced) {}
+
+        const bool forced;
+        bool done = false;
+        Status status = Status::OK();
+        stdx::condition_variable finished;
+    };
+
+    typedef std::map<std::string, std::shared_ptr<ChunkManagerRefresh>> ChunkManagerRefreshMap;
+
+    /**
+     * A full reload of the database which is in progress. Threads which need a reload of the same
+     * iteration wait for its result instead of loading the database themselves.
+     */
+    struct FullReload {
+        bool done = false;
+        Status status = Status::OK();
+        bool found = false;
+        stdx::condition_variable finished;
+    };
+
+    /**
+     * Loads the newer chunks for 'ns' from the config server, installs the resulting chunk
+     * manager if it is newer than the cached one and returns the cached chunk manager. Must be
+     * called without holding _lock, by the thread which registered the refresh for 'ns'.
+     */
+    std::shared_ptr<ChunkManager> _refreshChunkManager(OperationContext* txn,
+                                                       const std::string& ns,
+                                                       bool forceReload);
+
+    /**
+     * Unregisters a refresh of 'ns' and wakes up the threads waiting for it.
+     */
+    void _finishChunkManagerRefresh(const std::string& ns,
+                                    const std::shared_ptr<ChunkManagerRefresh>& refresh,
+                                    Status status);
+
     bool _dropShardedCollections(OperationContext* txn,
                                  int& num,
                                  std::set<ShardId>& shardIds,
@@ -190,10 +235,19 @@ protected:
      * Returns true if it is successful at loading the DBConfig, false if the database is not found,
      * and throws on all other errors.
      * Also returns true without reloading if reloadIteration is not equal to the _reloadCount.
-     * This is to avoid multiple threads attempting to reload do duplicate work.
+     * This is to avoid multiple threads attempting to reload do duplicate work. If another thread
+     * is already reloading, waits for it and returns its result.
+     * Must be called without holding _lock.
      */
     bool _loadIfNeeded(OperationContext* txn, Counter reloadIteration);
 
+    /**
+     * Loads the database and its collections from the config server and installs them. Called
+     * only by the thread which registered the full reload, without holding _lock, which is only
+     * taken to install the loaded metadata.
+     */
+    bool _load(OperationContext* txn);
+
     void _save(OperationContext* txn, bool db = true, bool coll = true);
 
     // All member variables are labeled with one of the following codes indicating the
@@ -203,8 +257,8 @@ protected:
     // (I) Immutable, can access freely.
     // (S) Self synchronizing, no explicit locking needed.
     //
-    // Mutex lock order:
-    // _hitConfigServerLock -> _lock
+    // Nothing is loaded from the config server while holding _lock, so that routing for one
+    // collection never waits for metadata of another collection to be loaded.
     //
 
     // Name of the database which this entry caches
@@ -223,9 +277,13 @@ protected:
     // OpTime of config server when the database definition was loaded.
     repl::OpTime _configOpTime;  // (L)
 
-    // Ensures that only one thread at a time loads collection configuration data from
-    // the config server
-    stdx::mutex _hitConfigServerLock;
+    // Chunk manager reloads in progress, by namespace. Ensures that only one thread at a time
+    // loads the chunks of a given collection from the config server.
+    ChunkManagerRefreshMap _chunkManagerRefreshes;  // (L)
+
+    // The full reload in progress, if any. Ensures that only one thread at a time reloads the
+    // database from the config server.
+    std::shared_ptr<FullReload> _fullReload;  // (L)
 
     // Increments every time this performs a full reload. Since a full reload can take a very
     // long time for very large clusters, this can be used to minimize duplicate work when multiple
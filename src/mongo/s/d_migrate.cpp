@@ -46,11 +46,15 @@
 #include "mongo/db/field_parser.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/range_deleter_service.h"
+#include "mongo/db/s/chunk_load_tracker.h"
 #include "mongo/db/s/chunk_move_write_concern_options.h"
+#include "mongo/db/s/chunk_split_sketch.h"
+#include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/migration_impl.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/migration_secondary_throttle_options.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -432,6 +436,61 @@ public:
 
 } recvChunkAbortCommand;
 
+/**
+ * Attributes a write of 'doc' to the chunk which contains it, for the balancer and, for inserts,
+ * the split point sketches, if the operation is sampled by either. Writes done by migrations and
+ * to orphaned ranges are not counted.
+ */
+void noteChunkWrite(OperationContext* txn,
+                    ShardingState* shardingState,
+                    const char* ns,
+                    const BSONObj& doc,
+                    long long bytesInserted,
+                    bool isInsert,
+                    bool notInActiveChunk) {
+    if (notInActiveChunk)
+        return;
+
+    const bool sampleLoad = ChunkLoadTracker::shouldSample(txn->getOpID());
+    const bool sampleSketch = isInsert && ChunkSplitSketches::shouldSample(txn->getOpID());
+    if (!sampleLoad && !sampleSketch)
+        return;
+
+    std::shared_ptr<CollectionMetadata> metadata = shardingState->getCollectionMetadata(ns);
+    if (!metadata)
+        return;
+
+    ShardKeyPattern shardKeyPattern(metadata->getKeyPattern());
+    const BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+    if (sampleLoad) {
+        shardingState->chunkLoadTracker()->noteWrite(ns, *metadata, shardKey, bytesInserted);
+    }
+
+    if (sampleSketch && !shardKey.isEmpty()) {
+        shardingState->chunkSplitSketches()->noteInsert(ns,
+                                                        metadata->getCollVersion().epoch(),
+                                                        shardKey,
+                                                        ChunkSplitSketches::sampleWeight());
+    }
+}
+
+/**
+ * Takes a sampled delete of the document with shard key 'shardKey' out of the split point
+ * sketches. Deletes by migrations only touch ranges which this shard does not own, and so which
+ * have no sketch.
+ */
+void noteChunkDelete(ShardingState* shardingState, const char* ns, const BSONObj& shardKey) {
+    if (shardKey.isEmpty())
+        return;
+
+    std::shared_ptr<CollectionMetadata> metadata = shardingState->getCollectionMetadata(ns);
+    if (!metadata)
+        return;
+
+    shardingState->chunkSplitSketches()->noteDelete(
+        ns, metadata->getCollVersion().epoch(), shardKey, ChunkSplitSketches::sampleWeight());
+}
+
 }  // namespace
 
 void logInsertOpForSharding(OperationContext* txn,
@@ -439,8 +498,10 @@ void logInsertOpForSharding(OperationContext* txn,
                             const BSONObj& obj,
                             bool notInActiveChunk) {
     ShardingState* shardingState = ShardingState::get(txn);
-    if (shardingState->enabled())
+    if (shardingState->enabled()) {
         shardingState->migrationSourceManager()->logInsertOp(txn, ns, obj, notInActiveChunk);
+        noteChunkWrite(txn, shardingState, ns, obj, obj.objsize(), true, notInActiveChunk);
+    }
 }
 
 void logUpdateOpForSharding(OperationContext* txn,
@@ -448,17 +509,40 @@ void logUpdateOpForSharding(OperationContext* txn,
                             const BSONObj& updatedDoc,
                             bool notInActiveChunk) {
     ShardingState* shardingState = ShardingState::get(txn);
-    if (shardingState->enabled())
+    if (shardingState->enabled()) {
         shardingState->migrationSourceManager()->logUpdateOp(txn, ns, updatedDoc, notInActiveChunk);
+        noteChunkWrite(txn, shardingState, ns, updatedDoc, 0, false, notInActiveChunk);
+    }
 }
 
 void logDeleteOpForSharding(OperationContext* txn,
                             const char* ns,
                             const BSONObj& obj,
+                            const BSONObj& sampledShardKey,
                             bool notInActiveChunk) {
     ShardingState* shardingState = ShardingState::get(txn);
-    if (shardingState->enabled())
+    if (shardingState->enabled()) {
         shardingState->migrationSourceManager()->logDeleteOp(txn, ns, obj, notInActiveChunk);
+        noteChunkDelete(shardingState, ns, sampledShardKey);
+    }
+}
+
+BSONObj getSampledShardKeyForDelete(OperationContext* txn,
+                                    const NamespaceString& ns,
+                                    const BSONObj& doc) {
+    if (!ChunkSplitSketches::shouldSample(txn->getOpID()))
+        return BSONObj();
+
+    ShardingState* shardingState = ShardingState::get(txn);
+    if (!shardingState->enabled())
+        return BSONObj();
+
+    std::shared_ptr<CollectionMetadata> metadata = shardingState->getCollectionMetadata(ns.ns());
+    if (!metadata)
+        return BSONObj();
+
+    ShardKeyPattern shardKeyPattern(metadata->getKeyPattern());
+    return shardKeyPattern.extractShardKeyFromDoc(doc).getOwned();
 }
 
 bool isInMigratingChunk(OperationContext* txn, const NamespaceString& ns, const BSONObj& doc) {
@@ -49,9 +49,11 @@
 #include "mongo/db/instance.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/s/chunk_split_sketch.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/operation_shard_version.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk.h"
@@ -218,6 +220,9 @@ BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+// Answer splitVector from the shard's chunk sketches when possible instead of scanning the index
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorUseSketches, bool, true);
+
 class SplitVector : public Command {
 public:
     SplitVector() : Command("splitVector", false) {}
@@ -283,6 +288,10 @@ public:
             return false;
         }
 
+        // The range as requested, in shard key format, which is how the sketches are keyed
+        const BSONObj requestedMin = min.getOwned();
+        const BSONObj requestedMax = max.getOwned();
+
         long long maxSplitPoints = 0;
         BSONElement maxSplitPointsElem = jsobj["maxSplitPoints"];
         if (maxSplitPointsElem.isNumber()) {
@@ -392,9 +401,56 @@ public:
             }
 
             //
-            // 2. Traverse the index and add the keyCount-th key to the result vector. If that key
-            //    appeared in the vector before, we omit it. The invariant here is that all the
-            //    instances of a given key value live in the same chunk.
+            // 2.a If the shard has a sketch of the range, pick the split points from it. Otherwise
+            //     the scan below builds one, provided the range belongs to a single chunk.
+            //
+
+            ShardingState* const shardingState = ShardingState::get(txn);
+            std::shared_ptr<CollectionMetadata> metadata;
+            if (splitVectorUseSketches.load() && chunkSplitSketchSamplingInterval.load() > 0 &&
+                !requestedMin.isEmpty() && shardingState->enabled()) {
+                metadata = shardingState->getCollectionMetadata(nss.ns());
+                if (metadata && metadata->getKeyPattern().woCompare(keyPattern) != 0) {
+                    metadata.reset();
+                }
+            }
+
+            std::unique_ptr<ChunkSplitSketches::Builder> sketchBuilder;
+            if (metadata) {
+                const OID epoch = metadata->getCollVersion().epoch();
+
+                ChunkSplitSketches::Estimate estimate;
+                vector<BSONObj> sketchSplitKeys;
+                if (shardingState->chunkSplitSketches()->estimate(
+                        nss.ns(), epoch, requestedMin, requestedMax, &estimate) &&
+                    ChunkSplitSketches::pickSplitPoints(estimate,
+                                                        requestedMin,
+                                                        keyCount,
+                                                        maxSplitPoints,
+                                                        forceMedianSplit,
+                                                        &sketchSplitKeys)) {
+                    LOG(1) << "picked " << sketchSplitKeys.size() << " split points for chunk "
+                           << nss.toString() << " " << requestedMin << " -->> " << requestedMax
+                           << " from an estimate of " << estimate.numRecords << " objects";
+
+                    result.append("fromSketch", true);
+                    result.append("splitKeys", sketchSplitKeys);
+                    return true;
+                }
+
+                ChunkType chunk;
+                if (metadata->getNextChunk(requestedMin, &chunk) &&
+                    chunk.getMin().woCompare(requestedMin) <= 0 &&
+                    chunk.getMax().woCompare(requestedMax) >= 0) {
+                    const int64_t seed = Date_t::now().toMillisSinceEpoch();
+                    sketchBuilder.reset(new ChunkSplitSketches::Builder(seed));
+                }
+            }
+
+            //
+            // 2.b Traverse the index and add the keyCount-th key to the result vector. If that key
+            //     appeared in the vector before, we omit it. The invariant here is that all the
+            //     instances of a given key value live in the same chunk.
             //
 
             Timer timer;
@@ -429,6 +485,11 @@ public:
                 while (PlanExecutor::ADVANCED == state) {
                     currCount++;
 
+                    if (sketchBuilder) {
+                        sketchBuilder->addKey(
+                            prettyKey(idx->keyPattern(), currKey).extractFields(keyPattern));
+                    }
+
                     if (currCount > keyCount && !forceMedianSplit) {
                         currKey = prettyKey(idx->keyPattern(), currKey.getOwned())
                                       .extractFields(keyPattern);
@@ -455,6 +516,16 @@ public:
                     state = exec->getNext(&currKey, NULL);
                 }
 
+                // Only a scan of the whole range describes it
+                if (sketchBuilder && PlanExecutor::IS_EOF == state) {
+                    shardingState->chunkSplitSketches()->install(nss.ns(),
+                                                                 metadata->getCollVersion().epoch(),
+                                                                 requestedMin,
+                                                                 requestedMax,
+                                                                 *sketchBuilder);
+                }
+                sketchBuilder.reset();
+
                 if (!forceMedianSplit)
                     break;
 
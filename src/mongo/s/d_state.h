@@ -95,6 +95,7 @@ void logUpdateOpForSharding(OperationContext* txn,
  *
  * 'ns' name of the collection in which the operation will occur.
  * 'obj' contains the _id value of the doc being deleted.
+ * 'sampledShardKey' the shard key returned by getSampledShardKeyForDelete, if any.
  * 'notInActiveChunk' a true value indicates that either:
  *      1) the delete is coming from a donor shard in a current chunk migration,
  *         and so does not need to be entered in this shard's outgoing transfer log.
@@ -104,8 +105,18 @@ void logUpdateOpForSharding(OperationContext* txn,
 void logDeleteOpForSharding(OperationContext* txn,
                             const char* ns,
                             const BSONObj& obj,
+                            const BSONObj& sampledShardKey,
                             bool notInActiveChunk);
 
+/**
+ * Returns the shard key of 'doc' if its deletion from 'ns' was picked to be recorded in the chunk
+ * split sketches, and an empty object otherwise. Deletes are logged with the _id only, so the key
+ * has to be extracted before the document is gone.
+ */
+BSONObj getSampledShardKeyForDelete(OperationContext* txn,
+                                    const NamespaceString& ns,
+                                    const BSONObj& doc);
+
 /**
  * Checks if 'doc' in 'ns' belongs to a currently migrating chunk.
  *
@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -51,6 +52,29 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+/**
+ * KeyString only accepts the empty field names of index keys, but the sort keys of text score
+ * sorts carry a "$metaTextScore" field. Returns 'sortKey' with all field names removed.
+ */
+BSONObj stripFieldNames(const BSONObj& sortKey) {
+    bool hasFieldNames = false;
+    for (BSONElement elem : sortKey) {
+        if (elem.fieldName()[0]) {
+            hasFieldNames = true;
+            break;
+        }
+    }
+    if (!hasFieldNames) {
+        return sortKey;
+    }
+
+    BSONObjBuilder builder;
+    for (BSONElement elem : sortKey) {
+        builder.appendAs(elem, "");
+    }
+    return builder.obj();
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
@@ -80,6 +104,11 @@ AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
         uassertStatusOK(metadata.writeToMetadata(&metadataBuilder));
         _metadataObj = metadataBuilder.obj();
     }
+
+    // An Ordering describes at most 32 fields. Longer sorts are merged by comparing BSON.
+    if (!_params.sort.isEmpty() && _params.sort.nFields() <= 32) {
+        _sortKeyOrdering = Ordering::make(_params.sort);
+    }
 }
 
 AsyncResultsMerger::~AsyncResultsMerger() {
@@ -130,6 +159,12 @@ bool AsyncResultsMerger::ready_inlock() {
         return true;
     }
 
+    if (!_status.isOK()) {
+        return true;
+    }
+
+    const bool hasSort = !_params.sort.isEmpty();
+
     for (const auto& remote : _remotes) {
         // First check whether any of the remotes reported an error.
         if (!remote.status.isOK()) {
@@ -137,15 +172,15 @@ bool AsyncResultsMerger::ready_inlock() {
             return true;
         }
 
-        // We don't return any results until we have received at least one response from each remote
-        // node. This is necessary for versioned commands: we have to ensure that we've properly
-        // established the shard version on each node before we can start returning results.
-        if (!remote.cursorId) {
+        // Unless unsorted results may be streamed, we don't return any results until we have
+        // received at least one response from each remote node. This is necessary for versioned
+        // commands: we have to ensure that we've properly established the shard version on each
+        // node before we can start returning results.
+        if (!remote.cursorId && (hasSort || !_params.streamUnsortedResults)) {
             return false;
         }
     }
 
-    const bool hasSort = !_params.sort.isEmpty();
     return hasSort ? readySorted_inlock() : readyUnsorted_inlock();
 }
 
@@ -211,8 +246,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    BSONObj front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    BSONObj front = popFront_inlock(smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -230,8 +264,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            BSONObj front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            BSONObj front = popFront_inlock(_gettingFromRemote);
 
             if (_params.isTailable && !_remotes[_gettingFromRemote].hasNext()) {
                 // The cursor is tailable and we're about to return the last buffered result. This
@@ -321,13 +354,51 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
     }
 
     // Schedule remote work on hosts for which we need more results.
-    for (size_t i = 0; i < _remotes.size(); ++i) {
+    auto scheduleStatus = scheduleBatchRequests_inlock();
+    if (!scheduleStatus.isOK()) {
+        return scheduleStatus;
+    }
+
+    auto eventStatus = _executor->makeEvent();
+    if (!eventStatus.isOK()) {
+        return eventStatus;
+    }
+    auto eventToReturn = eventStatus.getValue();
+    _currentEvent = eventToReturn;
+
+    // It's possible that after we told the caller we had no ready results but before the call to
+    // this method, new results became available. In this case we have to signal the event right
+    // away so that the caller will not block.
+    signalCurrentEventIfReady_inlock();
+
+    return eventToReturn;
+}
+
+Status AsyncResultsMerger::scheduleBatchRequests_inlock() {
+    // Bytes of the buffered results and of the batches already requested.
+    long long projectedBytes = _bufferedBytes;
+    bool anyBatchRequested = false;
+    for (const auto& remote : _remotes) {
+        if (remote.cbHandle.isValid()) {
+            projectedBytes += remote.lastBatchBytes;
+            anyBatchRequested = true;
+        }
+    }
+
+    // Start from the remote results are being returned from, so that batches deferred because of
+    // maxBufferedBytes are requested round robin.
+    for (size_t n = 0; n < _remotes.size(); ++n) {
+        const size_t i = (_gettingFromRemote + n) % _remotes.size();
         auto& remote = _remotes[i];
 
         // It is illegal to call this method if there is an error received from any shard.
         invariant(remote.status.isOK());
 
         if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+            if (!canAskForNextBatch_inlock(remote, projectedBytes, anyBatchRequested)) {
+                continue;
+            }
+
             // If we already have established a cursor with this remote, and there is no outstanding
             // request for which we have a valid callback handle, then schedule work to retrieve the
             // next batch.
@@ -335,22 +406,39 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
             if (!nextBatchStatus.isOK()) {
                 return nextBatchStatus;
             }
+
+            projectedBytes += remote.lastBatchBytes;
+            anyBatchRequested = true;
         }
     }
 
-    auto eventStatus = _executor->makeEvent();
-    if (!eventStatus.isOK()) {
-        return eventStatus;
+    return Status::OK();
+}
+
+bool AsyncResultsMerger::canAskForNextBatch_inlock(const RemoteCursorData& remote,
+                                                   long long projectedBytes,
+                                                   bool anyBatchRequested) {
+    // A sorted merge needs a batch from every remote, the initial command establishes the cursor
+    // and at least one batch must be requested in order to make progress.
+    if (!_params.sort.isEmpty() || !_params.maxBufferedBytes || !remote.cursorId ||
+        !anyBatchRequested) {
+        return true;
     }
-    auto eventToReturn = eventStatus.getValue();
-    _currentEvent = eventToReturn;
 
-    // It's possible that after we told the caller we had no ready results but before the call to
-    // this method, new results became available. In this case we have to signal the event right
-    // away so that the caller will not block.
-    signalCurrentEventIfReady_inlock();
+    return projectedBytes + remote.lastBatchBytes <= _params.maxBufferedBytes;
+}
 
-    return eventToReturn;
+BSONObj AsyncResultsMerger::popFront_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    BSONObj front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    if (!remote.sortKeyBuffer.empty()) {
+        remote.sortKeyBuffer.pop();
+    }
+
+    _bufferedBytes -= front.objsize();
+    return front;
 }
 
 StatusWith<CursorResponse> AsyncResultsMerger::parseCursorResponse(const BSONObj& responseObj,
@@ -469,8 +557,9 @@ void AsyncResultsMerger::handleBatchResponse(
             remote.status = Status::OK();
 
             // Clear the results buffer and cursor id.
-            std::queue<BSONObj> emptyBuffer;
-            std::swap(remote.docBuffer, emptyBuffer);
+            while (remote.hasNext()) {
+                popFront_inlock(remoteIndex);
+            }
             remote.cursorId = 0;
         }
 
@@ -482,6 +571,7 @@ void AsyncResultsMerger::handleBatchResponse(
     remote.cursorId = cursorResponse.getCursorId();
     remote.initialCmdObj = boost::none;
 
+    long long batchBytes = 0;
     for (const auto& obj : cursorResponse.getBatch()) {
         // If there's a sort, we're expecting the remote node to give us back a sort key.
         if (!_params.sort.isEmpty() &&
@@ -493,10 +583,21 @@ void AsyncResultsMerger::handleBatchResponse(
             return;
         }
 
+        if (_sortKeyOrdering) {
+            const KeyString sortKey(
+                stripFieldNames(obj[ClusterClientCursorParams::kSortKeyField].Obj()),
+                *_sortKeyOrdering);
+            remote.sortKeyBuffer.emplace(sortKey.getBuffer(), sortKey.getSize());
+        }
+
         remote.docBuffer.push(obj);
+        batchBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
+    _bufferedBytes += batchBytes;
+    remote.lastBatchBytes = batchBytes;
+
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
     if (!_params.sort.isEmpty() && !cursorResponse.getBatch().empty()) {
@@ -521,6 +622,17 @@ void AsyncResultsMerger::handleBatchResponse(
         }
     }
 
+    // Batches deferred by nextEvent() because of maxBufferedBytes are requested now if there is a
+    // waiter which this batch does not satisfy.
+    if (_currentEvent.isValid() && !ready_inlock()) {
+        // A failure to schedule belongs to another remote than the one which just answered, and
+        // is reported through _status so that the cursors of all remotes are still killed.
+        _status = scheduleBatchRequests_inlock();
+        if (!_status.isOK()) {
+            return;
+        }
+    }
+
     // ScopeGuard requires dismiss on success, but we want waiter to be signalled on success as
     // well as failure.
     signaller.Dismiss();
@@ -657,6 +769,13 @@ Status AsyncResultsMerger::RemoteCursorData::resolveShardIdToHostAndPort(
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    // Sort keys encoded as KeyStrings compare bytewise.
+    const auto& leftSortKeys = _remotes[lhs].sortKeyBuffer;
+    const auto& rightSortKeys = _remotes[rhs].sortKeyBuffer;
+    if (!leftSortKeys.empty() && !rightSortKeys.empty()) {
+        return leftSortKeys.front().compare(rightSortKeys.front()) > 0;
+    }
+
     const BSONObj& leftDoc = _remotes[lhs].docBuffer.front();
     const BSONObj& rightDoc = _remotes[rhs].docBuffer.front();
 
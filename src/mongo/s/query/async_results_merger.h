@@ -30,11 +30,13 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -62,7 +64,10 @@ class CursorResponse;
  * Task-scheduling behavior differs depending on whether there is a sort. If the result documents
  * must be sorted, we pass the sort through to the remote nodes and then merge the sorted streams.
  * This requires waiting until we have a response from every remote before returning results.
- * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
+ * Without a sort, we are ready to return results as soon as we have *any* response from a remote,
+ * and if the 'streamUnsortedResults' parameter is set, without waiting for the other remotes to
+ * establish their cursors. Also without a sort, the bytes of buffered and requested results are
+ * kept under 'maxBufferedBytes' by deferring requests for further batches.
  *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
@@ -222,6 +227,11 @@ private:
         boost::optional<CursorId> cursorId;
 
         std::queue<BSONObj> docBuffer;
+
+        // Sort keys of the documents in 'docBuffer', encoded as KeyStrings, if the results are
+        // merged by encoded sort key.
+        std::queue<std::string> sortKeyBuffer;
+
         executor::TaskExecutor::CallbackHandle cbHandle;
         Status status = Status::OK();
 
@@ -234,6 +244,9 @@ private:
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
 
+        // Size of the last batch received, used to project the size of the next one.
+        long long lastBatchBytes = 0;
+
     private:
         // For a cursor, which has shard id associated contains the exact host on which the remote
         // cursor resides.
@@ -324,6 +337,25 @@ private:
      */
     bool haveOutstandingBatchRequests_inlock();
 
+    /**
+     * Requests the next batch from the remotes which have no buffered results, are not exhausted
+     * and have no outstanding request, subject to 'maxBufferedBytes'.
+     */
+    Status scheduleBatchRequests_inlock();
+
+    /**
+     * Returns whether another batch may be requested from 'remote', given the projected bytes of
+     * results buffered or requested so far, and whether any other batch is being requested.
+     */
+    bool canAskForNextBatch_inlock(const RemoteCursorData& remote,
+                                   long long projectedBytes,
+                                   bool anyBatchRequested);
+
+    /**
+     * Removes the front document from the buffer of the remote at 'remoteIndex' and returns it.
+     */
+    BSONObj popFront_inlock(size_t remoteIndex);
+
     /**
      * Schedules a killCursors command to be run on all remote hosts that have open cursors.
      */
@@ -349,6 +381,13 @@ private:
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
 
+    // Set if there is a sort which can be encoded, in which case the sort key of each result is
+    // encoded as a KeyString when buffered, so that merging costs a memcmp per comparison.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // Total size of the documents buffered in '_remotes'.
+    long long _bufferedBytes = 0;
+
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
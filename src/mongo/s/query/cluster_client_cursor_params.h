@@ -137,6 +137,17 @@ struct ClusterClientCursorParams {
     // Whether the client indicated that it is willing to receive partial results in the case of an
     // unreachable host.
     bool isAllowPartialResults = false;
+
+    // Whether results may be returned, in the absence of a sort, from the remotes which have
+    // responded before every remote has responded. Remotes which have not yet responded to the
+    // initial command may then still fail it after results have been returned.
+    bool streamUnsortedResults = false;
+
+    // Limit on the bytes of results buffered from the remotes, including the projected size of
+    // outstanding batch requests, above which no further batches are requested until the buffered
+    // results are consumed. Only applies in the absence of a sort, since a sorted merge needs a
+    // batch from every remote. Zero means no limit.
+    long long maxBufferedBytes = 0;
 };
 
 }  // mongo
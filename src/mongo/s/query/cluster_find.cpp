@@ -43,6 +43,7 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
@@ -228,6 +229,8 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
     params.isTailable = query.getParsed().isTailable();
     params.isAwaitData = query.getParsed().isAwaitData();
     params.isAllowPartialResults = query.getParsed().isAllowPartialResults();
+    params.streamUnsortedResults = internalQueryStreamUnsortedShardResults.load();
+    params.maxBufferedBytes = internalQueryClusterCursorMaxBufferedBytes.load();
 
     // This is the batchSize passed to each subsequent getMore command issued by the cursor. We
     // usually use the batchSize associated with the initial find, but as it is illegal to send a
@@ -387,6 +390,10 @@ StatusWith<CursorId> ClusterFind::runQuery(OperationContext* txn,
             return status;
         }
 
+        // Results streamed from the shards which had already responded belong to the failed
+        // attempt, since the query is re-targeted from scratch.
+        results->clear();
+
         LOG(1) << "Received error status for query " << query.toStringShort() << " on attempt "
                << retries << " of " << kMaxStaleConfigRetries << ": " << status;
 
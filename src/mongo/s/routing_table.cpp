@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/routing_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "mongo/db/storage/key_string.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Shard key bounds compare field by field in ascending order, regardless of the key pattern.
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+int compareEncoded(StringData lhs, const KeyString& rhs) {
+    const size_t minSize = std::min(lhs.size(), rhs.getSize());
+    const int cmp = memcmp(lhs.rawData(), rhs.getBuffer(), minSize);
+    if (cmp) {
+        return cmp;
+    }
+    if (lhs.size() == rhs.getSize()) {
+        return 0;
+    }
+    return lhs.size() < rhs.getSize() ? -1 : 1;
+}
+
+bool hasFieldNames(const BSONObj& obj) {
+    BSONForEach(e, obj) {
+        if (e.fieldName()[0])
+            return true;
+    }
+    return false;
+}
+
+// KeyString reads the field names of a key as query bound discriminators, so shard keys and
+// chunk bounds are encoded without them, the way indexes store their keys.
+BSONObj stripFieldNames(const BSONObj& key) {
+    if (!hasFieldNames(key))
+        return key;
+
+    BSONObjBuilder bb;
+    BSONForEach(e, key) {
+        bb.appendAs(e, StringData());
+    }
+    return bb.obj();
+}
+
+}  // namespace
+
+void RoutingTable::encode(const BSONObj& key, KeyString* out) {
+    out->resetToKey(stripFieldNames(key), kAllAscending);
+}
+
+size_t RoutingTable::upperBound(const BSONObj& shardKey) const {
+    KeyString encodedKey;
+    encode(shardKey, &encodedKey);
+
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (compareEncoded(encodedMax(mid), encodedKey) > 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+RoutingTable::Builder::Builder(size_t expectedSize) : _table(new RoutingTable()) {
+    _table->_keyEnds.reserve(expectedSize);
+    _table->_shardIds.reserve(expectedSize);
+}
+
+void RoutingTable::Builder::append(const BSONObj& max, const ShardId& shardId) {
+    KeyString encodedMax;
+    encode(max, &encodedMax);
+    append(StringData(encodedMax.getBuffer(), encodedMax.getSize()), shardId);
+}
+
+void RoutingTable::Builder::append(StringData encodedMax, const ShardId& shardId) {
+    invariant(_table->_keys.size() + encodedMax.size() <= std::numeric_limits<uint32_t>::max());
+    _table->_keys.append(encodedMax.rawData(), encodedMax.size());
+    _table->_keyEnds.push_back(_table->_keys.size());
+    _table->_shardIds.push_back(shardId);
+}
+
+std::shared_ptr<const RoutingTable> RoutingTable::Builder::done() {
+    _table->_keys.shrink_to_fit();
+    return std::shared_ptr<const RoutingTable>(_table.release());
+}
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/s/client/shard.h"
+
+namespace mongo {
+
+class KeyString;
+
+/**
+ * Immutable routing table for a sharded collection. Maps consecutive shard key ranges, in
+ * ascending order and identified by their exclusive upper bound, to the shard which owns them.
+ *
+ * The upper bounds are stored pre-encoded as KeyStrings back to back in a single buffer, so a
+ * lookup is a binary search of memcmp comparisons over contiguous memory instead of a sequence of
+ * BSONObj comparisons through the nodes of a std::map. Tables are immutable once built and are
+ * meant to be shared between ChunkManager versions when the ranges they describe are unchanged.
+ */
+class RoutingTable {
+    MONGO_DISALLOW_COPYING(RoutingTable);
+
+public:
+    class Builder;
+
+    size_t size() const {
+        return _shardIds.size();
+    }
+
+    bool empty() const {
+        return _shardIds.empty();
+    }
+
+    /**
+     * Returns the index of the first range whose upper bound is greater than 'shardKey', that is,
+     * the range containing 'shardKey', or size() if there is none.
+     */
+    size_t upperBound(const BSONObj& shardKey) const;
+
+    /**
+     * Returns the encoded upper bound of the range at 'index'. Can be passed to Builder::append to
+     * reuse the encoding in a new table.
+     */
+    StringData encodedMax(size_t index) const {
+        const uint32_t begin = index ? _keyEnds[index - 1] : 0;
+        return StringData(_keys.data() + begin, _keyEnds[index] - begin);
+    }
+
+    const ShardId& shardId(size_t index) const {
+        return _shardIds[index];
+    }
+
+    /**
+     * Encodes a shard key or range bound in the form used by the table.
+     */
+    static void encode(const BSONObj& key, KeyString* out);
+
+private:
+    RoutingTable() = default;
+
+    // Encoded upper bounds of all ranges, concatenated.
+    std::string _keys;
+
+    // Offset in _keys one past the end of each range's upper bound.
+    std::vector<uint32_t> _keyEnds;
+
+    // Shard owning each range.
+    std::vector<ShardId> _shardIds;
+};
+
+/**
+ * Builds a RoutingTable from ranges appended in ascending order.
+ */
+class RoutingTable::Builder {
+    MONGO_DISALLOW_COPYING(Builder);
+
+public:
+    explicit Builder(size_t expectedSize = 0);
+
+    /**
+     * Appends the range ending at 'max', which must be greater than the previous range's upper
+     * bound.
+     */
+    void append(const BSONObj& max, const ShardId& shardId);
+
+    /**
+     * Same as above, for an upper bound which has already been encoded, e.g. by another table.
+     */
+    void append(StringData encodedMax, const ShardId& shardId);
+
+    std::shared_ptr<const RoutingTable> done();
+
+private:
+    std::unique_ptr<RoutingTable> _table;
+};
+
+}  // namespace mongo
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/routing_table.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::shared_ptr<const RoutingTable> makeTable() {
+    RoutingTable::Builder builder;
+    builder.append(BSON("a" << -100), "shard0");
+    builder.append(BSON("a" << 0), "shard1");
+    builder.append(BSON("a" << "abc"), "shard0");
+    builder.append(BSON("a" << MAXKEY), "shard2");
+    return builder.done();
+}
+
+TEST(RoutingTable, EmptyTable) {
+    auto table = RoutingTable::Builder().done();
+    ASSERT_TRUE(table->empty());
+    ASSERT_EQUALS(0U, table->upperBound(BSON("a" << 1)));
+}
+
+TEST(RoutingTable, UpperBoundFindsContainingRange) {
+    auto table = makeTable();
+    ASSERT_EQUALS(4U, table->size());
+
+    ASSERT_EQUALS(0U, table->upperBound(BSON("a" << MINKEY)));
+    ASSERT_EQUALS(0U, table->upperBound(BSON("a" << -101)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("a" << -100)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("a" << -0.5)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << 0)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << (1LL << 40))));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << "ab")));
+    ASSERT_EQUALS(3U, table->upperBound(BSON("a" << "abc")));
+    ASSERT_EQUALS(3U, table->upperBound(BSON("a" << OID())));
+    ASSERT_EQUALS(4U, table->upperBound(BSON("a" << MAXKEY)));
+
+    ASSERT_EQUALS("shard1", table->shardId(1));
+    ASSERT_EQUALS("shard2", table->shardId(3));
+}
+
+TEST(RoutingTable, NumericTypesCompareByValue) {
+    auto table = makeTable();
+    ASSERT_EQUALS(1U, table->upperBound(BSON("a" << -100.0)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("a" << -100LL)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << 0.0)));
+}
+
+TEST(RoutingTable, CompoundKeys) {
+    RoutingTable::Builder builder;
+    builder.append(BSON("a" << 1 << "b" << MINKEY), "shard0");
+    builder.append(BSON("a" << 1 << "b" << 10), "shard1");
+    builder.append(BSON("a" << MAXKEY << "b" << MAXKEY), "shard0");
+    auto table = builder.done();
+
+    ASSERT_EQUALS(0U, table->upperBound(BSON("a" << 0 << "b" << 100)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("a" << 1 << "b" << 5)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << 1 << "b" << 10)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("a" << 2 << "b" << MINKEY)));
+}
+
+TEST(RoutingTable, MultiCharacterFieldNames) {
+    RoutingTable::Builder builder;
+    builder.append(BSON("groupId" << 10 << "lastSeen" << MINKEY), "shard0");
+    builder.append(BSON("groupId" << 10 << "lastSeen" << 500), "shard1");
+    builder.append(BSON("groupId" << MAXKEY << "lastSeen" << MAXKEY), "shard2");
+    auto table = builder.done();
+
+    ASSERT_EQUALS(0U, table->upperBound(BSON("groupId" << 9 << "lastSeen" << 1000)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("groupId" << 10 << "lastSeen" << MINKEY)));
+    ASSERT_EQUALS(1U, table->upperBound(BSON("groupId" << 10 << "lastSeen" << 499)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("groupId" << 10 << "lastSeen" << 500)));
+    ASSERT_EQUALS(2U, table->upperBound(BSON("groupId" << "x" << "lastSeen" << 0)));
+
+    // Bounds with and without field names encode the same way.
+    KeyString named;
+    KeyString unnamed;
+    RoutingTable::encode(BSON("groupId" << 10 << "lastSeen" << 500), &named);
+    RoutingTable::encode(BSON("" << 10 << "" << 500), &unnamed);
+    ASSERT_EQUALS(0, named.compare(unnamed));
+}
+
+TEST(RoutingTable, AppendEncodedReusesBounds) {
+    auto table = makeTable();
+
+    RoutingTable::Builder builder(table->size());
+    for (size_t i = 0; i < table->size(); ++i) {
+        builder.append(table->encodedMax(i), table->shardId(i));
+    }
+    auto copy = builder.done();
+
+    ASSERT_EQUALS(table->size(), copy->size());
+    for (size_t i = 0; i < table->size(); ++i) {
+        ASSERT_EQUALS(table->encodedMax(i), copy->encodedMax(i));
+        ASSERT_EQUALS(table->shardId(i), copy->shardId(i));
+    }
+    ASSERT_EQUALS(2U, copy->upperBound(BSON("a" << 5)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,11 +32,16 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/client/multi_command_dispatch.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
@@ -44,7 +49,6 @@
 
 namespace mongo {
 
-using std::make_pair;
 using std::stringstream;
 using std::vector;
 
@@ -55,13 +59,19 @@ BatchWriteExec::BatchWriteExec(NSTargeter* targeter,
 
 namespace {
 
+// Maximum number of child batches which may be awaiting a response from a single host.  Each
+// pending batch holds its own ShardConnection, and the thread-local pool caches only one
+// connection per host, so raising this above 1 makes the pool hand out additional sharded
+// connections, which may block once the per-host in-use limit is reached.
+MONGO_EXPORT_SERVER_PARAMETER(maxPendingWriteBatchesPerHost, int, 1);
+
 //
-// Map which allows associating ConnectionString hosts with TargetedWriteBatches
-// This is needed since the dispatcher only returns hosts with responses.
+// Map which associates ConnectionString hosts with the TargetedWriteBatches sent to them, in the
+// order they were sent.  This is needed since the dispatcher only returns hosts with responses.
 //
 
-// TODO: Unordered map?
-typedef OwnedPointerMap<ConnectionString, TargetedWriteBatch> OwnedHostBatchMap;
+typedef std::map<ConnectionString, std::deque<std::unique_ptr<TargetedWriteBatch>>>
+    PendingHostBatchMap;
 }
 
 static void buildErrorFrom(const Status& status, WriteErrorDetail* error) {
@@ -99,11 +109,29 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
     BatchWriteOp batchOp;
     batchOp.initClientRequest(&clientRequest);
 
+    // Unordered batches are pipelined: remaining write ops are targeted and sent while earlier
+    // child batches are still out on the network, instead of once the whole round has returned.
+    const bool pipelined = !clientRequest.getOrdered();
+    const size_t maxPendingPerHost =
+        static_cast<size_t>(std::max(1, maxPendingWriteBatchesPerHost.load()));
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
     int numCompletedOps = 0;
     int numRoundsWithoutProgress = 0;
+    bool remoteMetadataChanging = false;
+
+    // Ordered batches are targeted once per round. Pipelined batches are targeted whenever the
+    // previously targeted child batches have been sent, unless a stale response did not change
+    // the targeter, in which case the stale write ops wait for the round to end.
+    bool targetedThisRound = false;
+    bool deferTargeting = false;
+
+    // Child batches which have been targeted but not sent, and child batches out on the network
+    OwnedPointerVector<TargetedWriteBatch> unsentBatchesOwned;
+    vector<TargetedWriteBatch*>& unsentBatches = unsentBatchesOwned.mutableVector();
+    PendingHostBatchMap pendingBatches;
 
     while (!batchOp.isFinished()) {
         //
@@ -130,176 +158,184 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerVector<TargetedWriteBatch> childBatchesOwned;
-        vector<TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableVector();
-
-        // If we've already had a targeting error, we've refreshed the metadata once and can
-        // record target errors definitively.
-        bool recordTargetErrors = refreshedTargeter;
-        Status targetStatus =
-            batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &childBatches);
-        if (!targetStatus.isOK()) {
-            // Don't do anything until a targeter refresh
-            _targeter->noteCouldNotTarget();
-            refreshedTargeter = true;
-            ++stats->numTargetErrors;
-            dassert(childBatches.size() == 0u);
+        if (unsentBatches.empty() && (pipelined ? !deferTargeting : !targetedThisRound)) {
+            targetedThisRound = true;
+
+            // If we've already had a targeting error, we've refreshed the metadata once and can
+            // record target errors definitively.
+            bool recordTargetErrors = refreshedTargeter;
+            Status targetStatus =
+                batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &unsentBatches);
+            if (!targetStatus.isOK()) {
+                // Don't do anything until a targeter refresh
+                _targeter->noteCouldNotTarget();
+                refreshedTargeter = true;
+                deferTargeting = true;
+                ++stats->numTargetErrors;
+                dassert(unsentBatches.size() == 0u);
+            }
         }
 
         //
-        // Send all child batches
+        // Send side
         //
 
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        bool remoteMetadataChanging = false;
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedHostBatchMap ownedPendingBatches;
-            OwnedHostBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        // Send every child batch whose host has room for another pending batch
+        for (vector<TargetedWriteBatch*>::iterator it = unsentBatches.begin();
+             it != unsentBatches.end();
+             ++it) {
+            //
+            // Collect the info needed to dispatch our targeted batch
+            //
+
+            TargetedWriteBatch* nextBatch = *it;
+
+            // Figure out what host we need to dispatch our targeted batch
+            ConnectionString shardHost;
+            Status resolveStatus =
+                _resolver->chooseWriteHost(txn, nextBatch->getEndpoint().shardName, &shardHost);
+            if (!resolveStatus.isOK()) {
+                ++stats->numResolveErrors;
+
+                // Record a resolve failure
+                // TODO: It may be necessary to refresh the cache if stale, or maybe just
+                // cancel and retarget the batch
+                WriteErrorDetail error;
+                buildErrorFrom(resolveStatus, &error);
+
+                LOG(4) << "unable to send write batch to " << shardHost.toString()
+                       << causedBy(resolveStatus.toString());
+
+                batchOp.noteBatchError(*nextBatch, error);
+
+                // We're done with this batch
+                // Clean up when we can't resolve a host
+                delete *it;
+                *it = NULL;
+                continue;
+            }
+
+            // If the host already has as many batches pending as allowed, wait until the next
+            // time
+            auto& hostBatches = pendingBatches[shardHost];
+            if (hostBatches.size() >= maxPendingPerHost)
+                continue;
 
             //
-            // Send side
+            // We now have all the info needed to dispatch the batch
             //
 
-            // Get as many batches as we can at once
-            for (vector<TargetedWriteBatch*>::iterator it = childBatches.begin();
-                 it != childBatches.end();
-                 ++it) {
-                //
-                // Collect the info needed to dispatch our targeted batch
-                //
-
-                TargetedWriteBatch* nextBatch = *it;
-                // If the batch is NULL, we sent it previously, so skip
-                if (nextBatch == NULL)
-                    continue;
-
-                // Figure out what host we need to dispatch our targeted batch
-                ConnectionString shardHost;
-                Status resolveStatus =
-                    _resolver->chooseWriteHost(txn, nextBatch->getEndpoint().shardName, &shardHost);
-                if (!resolveStatus.isOK()) {
-                    ++stats->numResolveErrors;
-
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    WriteErrorDetail error;
-                    buildErrorFrom(resolveStatus, &error);
-
-                    LOG(4) << "unable to send write batch to " << shardHost.toString()
-                           << causedBy(resolveStatus.toString());
-
-                    batchOp.noteBatchError(*nextBatch, error);
-
-                    // We're done with this batch
-                    // Clean up when we can't resolve a host
-                    delete *it;
-                    *it = NULL;
-                    --numToSend;
-                    continue;
-                }
+            BatchedCommandRequest request(clientRequest.getBatchType());
+            batchOp.buildBatchRequest(*nextBatch, &request);
 
-                // If we already have a batch for this host, wait until the next time
-                OwnedHostBatchMap::MapType::iterator pendingIt = pendingBatches.find(shardHost);
-                if (pendingIt != pendingBatches.end())
-                    continue;
+            // Internally we use full namespaces for request/response, but we send the
+            // command to a database with the collection name in the request.
+            NamespaceString nss(request.getNS());
+            request.setNS(nss);
 
-                //
-                // We now have all the info needed to dispatch the batch
-                //
+            LOG(4) << "sending write batch to " << shardHost.toString() << ": "
+                   << request.toString();
 
-                BatchedCommandRequest request(clientRequest.getBatchType());
-                batchOp.buildBatchRequest(*nextBatch, &request);
+            _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
 
-                // Internally we use full namespaces for request/response, but we send the
-                // command to a database with the collection name in the request.
-                NamespaceString nss(request.getNS());
-                request.setNS(nss);
+            // Recv-side is responsible for cleaning up the nextBatch when used
+            hostBatches.emplace_back(nextBatch);
+            *it = NULL;
+        }
 
-                LOG(4) << "sending write batch to " << shardHost.toString() << ": "
-                       << request.toString();
+        // Forget the batches which were sent or failed to resolve
+        unsentBatches.erase(std::remove(unsentBatches.begin(), unsentBatches.end(), nullptr),
+                            unsentBatches.end());
 
-                _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
+        // Send them all out
+        _dispatcher->sendAll();
 
-                // Indicate we're done by setting the batch to NULL
-                // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                // endpoints for the same host, so this should be pretty efficient without
-                // moving stuff around.
-                *it = NULL;
+        //
+        // Recv side
+        //
+
+        if (_dispatcher->numPending() > 0) {
+            // Get the response
+            ConnectionString shardHost;
+            BatchedCommandResponse response;
+            Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
+
+            // Get the TargetedWriteBatch to find where to put the response
+            PendingHostBatchMap::iterator pendingIt = pendingBatches.find(shardHost);
+            dassert(pendingIt != pendingBatches.end() && !pendingIt->second.empty());
+            std::unique_ptr<TargetedWriteBatch> batch = std::move(pendingIt->second.front());
+            pendingIt->second.pop_front();
+
+            bool staleResponse = false;
+
+            if (dispatchStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+
+                LOG(4) << "write results received from " << shardHost.toString() << ": "
+                       << response.toString();
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.insert(make_pair(shardHost, nextBatch));
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, response, &trackedErrors);
+
+                // Note if anything was stale
+                const vector<ShardError*>& staleErrors =
+                    trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+
+                if (staleErrors.size() > 0) {
+                    noteStaleResponses(staleErrors, _targeter);
+                    ++stats->numStaleBatches;
+                    staleResponse = true;
+                }
+
+                // Remember if the shard is actively changing metadata right now
+                if (isShardMetadataChanging(staleErrors)) {
+                    remoteMetadataChanging = true;
+                }
+
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
+                                   response.isElectionIdSet() ? response.getElectionId() : OID());
+            } else {
+                // Error occurred dispatching, note it
+
+                stringstream msg;
+                msg << "write results unavailable from " << shardHost.toString()
+                    << causedBy(dispatchStatus.toString());
+
+                WriteErrorDetail error;
+                buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+
+                LOG(4) << "unable to receive write results from " << shardHost.toString()
+                       << causedBy(dispatchStatus.toString());
+
+                batchOp.noteBatchError(*batch, error);
             }
 
-            // Send them all out
-            _dispatcher->sendAll();
-            numSent += pendingBatches.size();
+            // A pipelined batch retargets stale write ops without waiting for the rest of the
+            // round, as long as the refreshed metadata routes them differently.
+            if (pipelined && staleResponse && !batchOp.isFinished()) {
+                bool targeterChanged = false;
+                Status refreshStatus = _targeter->refreshIfNeeded(txn, &targeterChanged);
 
-            //
-            // Recv side
-            //
+                if (!refreshStatus.isOK()) {
+                    warning() << "could not refresh targeter" << causedBy(refreshStatus.reason());
+                }
 
-            while (_dispatcher->numPending() > 0) {
-                // Get the response
-                ConnectionString shardHost;
-                BatchedCommandResponse response;
-                Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
-
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(shardHost) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(shardHost)->second;
-
-                if (dispatchStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-
-                    LOG(4) << "write results received from " << shardHost.toString() << ": "
-                           << response.toString();
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, response, &trackedErrors);
-
-                    // Note if anything was stale
-                    const vector<ShardError*>& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-
-                    if (staleErrors.size() > 0) {
-                        noteStaleResponses(staleErrors, _targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    // Remember if the shard is actively changing metadata right now
-                    if (isShardMetadataChanging(staleErrors)) {
-                        remoteMetadataChanging = true;
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(
-                        shardHost,
-                        response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
-                        response.isElectionIdSet() ? response.getElectionId() : OID());
-                } else {
-                    // Error occurred dispatching, note it
-
-                    stringstream msg;
-                    msg << "write results unavailable from " << shardHost.toString()
-                        << causedBy(dispatchStatus.toString());
-
-                    WriteErrorDetail error;
-                    buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
-
-                    LOG(4) << "unable to receive write results from " << shardHost.toString()
-                           << causedBy(dispatchStatus.toString());
-
-                    batchOp.noteBatchError(*batch, error);
+                if (!targeterChanged) {
+                    deferTargeting = true;
                 }
             }
+
+            continue;
         }
 
+        // Nothing is pending, so every host had room for its batches
+        dassert(unsentBatches.empty());
+
         ++rounds;
         ++stats->numRounds;
 
@@ -333,6 +369,9 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
             numRoundsWithoutProgress = 0;
         }
         numCompletedOps = currCompletedOps;
+        remoteMetadataChanging = false;
+        targetedThisRound = false;
+        deferTargeting = false;
 
         if (numRoundsWithoutProgress > kMaxRoundsWithoutProgress) {
             stringstream msg;
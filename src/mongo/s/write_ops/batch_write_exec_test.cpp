@@ -80,6 +80,22 @@ public:
     unique_ptr<BatchWriteExec> exec;
 };
 
+/**
+ * Mock targeter whose refreshes report that the routing metadata changed, so stale write ops
+ * are immediately retargeted.
+ */
+class ChangingMockNSTargeter : public MockNSTargeter {
+public:
+    Status refreshIfNeeded(OperationContext* txn, bool* wasChanged) {
+        ++numRefreshes;
+        if (wasChanged)
+            *wasChanged = true;
+        return Status::OK();
+    }
+
+    int numRefreshes = 0;
+};
+
 //
 // Tests for the BatchWriteExec
 //
@@ -148,6 +164,60 @@ TEST(BatchWriteExecTests, SingleOpError) {
     ASSERT_EQUALS(stats.numRounds, 1);
 }
 
+TEST(BatchWriteExecTests, UnorderedManyOpsPipelined) {
+    //
+    // Unordered batch needing several child batches to the same shard completes in one round
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+
+    MockSingleShardBackend backend(&txn, nss);
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.setWriteConcern(BSONObj());
+    const int numDocs = static_cast<int>(BatchedCommandRequest::kMaxWriteBatchSize) * 5 / 2;
+    for (int i = 0; i < numDocs; i++) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << i));
+    }
+
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    backend.exec->executeBatch(&txn, request, &response, &stats);
+    ASSERT(response.getOk());
+
+    ASSERT_EQUALS(stats.numRounds, 1);
+}
+
+TEST(BatchWriteExecTests, OrderedManyOps) {
+    //
+    // Ordered batch needing several child batches to the same shard takes a round for each
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+
+    MockSingleShardBackend backend(&txn, nss);
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(true);
+    request.setWriteConcern(BSONObj());
+    const int numDocs = static_cast<int>(BatchedCommandRequest::kMaxWriteBatchSize) * 5 / 2;
+    for (int i = 0; i < numDocs; i++) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << i));
+    }
+
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    backend.exec->executeBatch(&txn, request, &response, &stats);
+    ASSERT(response.getOk());
+
+    ASSERT_EQUALS(stats.numRounds, 3);
+}
+
 //
 // Test retryable errors
 //
@@ -187,6 +257,95 @@ TEST(BatchWriteExecTests, StaleOp) {
     ASSERT_EQUALS(stats.numStaleBatches, 1);
 }
 
+TEST(BatchWriteExecTests, StaleOpRetargetedWhenTargeterChanged) {
+    //
+    // Unordered batch retargets a stale op as soon as a refresh changes the routing metadata,
+    // without waiting for the round to end
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+
+    // Insert request
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.setWriteConcern(BSONObj());
+    // Do single-target, single doc batch write op
+    request.getInsertRequest()->addToDocuments(BSON("x" << 1));
+
+    ShardEndpoint endpoint("shard", ChunkVersion::IGNORED());
+    vector<MockRange*> mockRanges;
+    mockRanges.push_back(new MockRange(endpoint, nss, BSON("x" << MINKEY), BSON("x" << MAXKEY)));
+    ChangingMockNSTargeter targeter;
+    targeter.init(mockRanges);
+
+    MockShardResolver resolver;
+    ConnectionString shardHost;
+    ASSERT_OK(resolver.chooseWriteHost(&txn, endpoint.shardName, &shardHost));
+
+    vector<MockWriteResult*> mockResults;
+    WriteErrorDetail error;
+    error.setErrCode(ErrorCodes::StaleShardVersion);
+    error.setErrMessage("mock stale error");
+    mockResults.push_back(new MockWriteResult(shardHost, error));
+
+    MockMultiWriteCommand dispatcher;
+    dispatcher.init(mockResults);
+
+    BatchWriteExec exec(&targeter, &resolver, &dispatcher);
+
+    // Execute request
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    exec.executeBatch(&txn, request, &response, &stats);
+    ASSERT(response.getOk());
+    ASSERT_EQUALS(response.getN(), 0);
+    ASSERT(!response.isErrDetailsSet());
+
+    ASSERT_EQUALS(stats.numStaleBatches, 1);
+    ASSERT_EQUALS(stats.numRounds, 1);
+    ASSERT_EQUALS(targeter.numRefreshes, 1);
+}
+
+TEST(BatchWriteExecTests, StaleOpDeferredWhenTargeterUnchanged) {
+    //
+    // Unordered batch waits for the next round to retry a stale op if the refresh didn't
+    // change the routing metadata
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+
+    // Insert request
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.setWriteConcern(BSONObj());
+    // Do single-target, single doc batch write op
+    request.getInsertRequest()->addToDocuments(BSON("x" << 1));
+
+    MockSingleShardBackend backend(&txn, nss);
+
+    vector<MockWriteResult*> mockResults;
+    WriteErrorDetail error;
+    error.setErrCode(ErrorCodes::StaleShardVersion);
+    error.setErrMessage("mock stale error");
+    mockResults.push_back(new MockWriteResult(backend.shardHost, error));
+
+    backend.setMockResults(mockResults);
+
+    // Execute request
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    backend.exec->executeBatch(&txn, request, &response, &stats);
+    ASSERT(response.getOk());
+    ASSERT(!response.isErrDetailsSet());
+
+    ASSERT_EQUALS(stats.numStaleBatches, 1);
+    ASSERT_EQUALS(stats.numRounds, 2);
+}
+
 TEST(BatchWriteExecTests, MultiStaleOp) {
     //
     // Retry op in exec multiple times b/c of stale config
@@ -0,0 +1,360 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor.h"
+
+#include <algorithm>
+#include <snappy.h>
+#include <zlib.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/stringutils.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+const char kCompressionFieldName[] = "compression";
+
+namespace {
+
+// Messages with smaller bodies are not worth the CPU time, e.g. most write acknowledgements.
+const int kMinCompressibleBodySize = 256;
+
+const MessageCompressorId kAllCompressors[] = {MessageCompressorId::kSnappy,
+                                               MessageCompressorId::kZlib};
+
+struct CompressorStats {
+    AtomicInt64 compressBytesIn;
+    AtomicInt64 compressBytesOut;
+    AtomicInt64 compressMicros;
+    AtomicInt64 decompressBytesIn;
+    AtomicInt64 decompressBytesOut;
+    AtomicInt64 decompressMicros;
+};
+
+CompressorStats compressorStats[3];
+
+stdx::mutex enabledCompressorsMutex;
+std::vector<MessageCompressorId> enabledCompressors;
+
+CompressorStats& statsFor(MessageCompressorId id) {
+    return compressorStats[static_cast<uint8_t>(id)];
+}
+
+size_t maxCompressedLength(MessageCompressorId id, size_t length) {
+    switch (id) {
+        case MessageCompressorId::kSnappy:
+            return snappy::MaxCompressedLength(length);
+        case MessageCompressorId::kZlib:
+            return ::compressBound(length);
+        case MessageCompressorId::kNoop:
+            return length;
+    }
+    MONGO_UNREACHABLE;
+}
+
+/**
+ * Compresses 'length' bytes from 'in' into 'out', which must hold at least
+ * maxCompressedLength() bytes. Returns the compressed length, or 0 on failure.
+ */
+size_t compressBuffer(MessageCompressorId id, const char* in, size_t length, char* out) {
+    switch (id) {
+        case MessageCompressorId::kSnappy: {
+            size_t outLength;
+            snappy::RawCompress(in, length, out, &outLength);
+            return outLength;
+        }
+        case MessageCompressorId::kZlib: {
+            uLongf outLength = ::compressBound(length);
+            int err = ::compress2(reinterpret_cast<Bytef*>(out),
+                                  &outLength,
+                                  reinterpret_cast<const Bytef*>(in),
+                                  length,
+                                  Z_DEFAULT_COMPRESSION);
+            return err == Z_OK ? outLength : 0;
+        }
+        case MessageCompressorId::kNoop:
+            memcpy(out, in, length);
+            return length;
+    }
+    MONGO_UNREACHABLE;
+}
+
+Status decompressBuffer(MessageCompressorId id,
+                        const char* in,
+                        size_t length,
+                        char* out,
+                        size_t outLength) {
+    switch (id) {
+        case MessageCompressorId::kSnappy: {
+            size_t actualLength;
+            if (!snappy::GetUncompressedLength(in, length, &actualLength) ||
+                actualLength != outLength || !snappy::RawUncompress(in, length, out)) {
+                return Status(ErrorCodes::BadValue, "invalid snappy compressed message");
+            }
+            return Status::OK();
+        }
+        case MessageCompressorId::kZlib: {
+            uLongf actualLength = outLength;
+            int err = ::uncompress(reinterpret_cast<Bytef*>(out),
+                                   &actualLength,
+                                   reinterpret_cast<const Bytef*>(in),
+                                   length);
+            if (err != Z_OK) {
+                return Status(ErrorCodes::ZLibError,
+                              str::stream() << "uncompress failed with " << err);
+            }
+            if (actualLength != outLength) {
+                return Status(ErrorCodes::BadValue, "invalid zlib compressed message length");
+            }
+            return Status::OK();
+        }
+        case MessageCompressorId::kNoop:
+            if (length != outLength) {
+                return Status(ErrorCodes::BadValue, "invalid uncompressed message length");
+            }
+            memcpy(out, in, length);
+            return Status::OK();
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace
+
+StringData messageCompressorName(MessageCompressorId id) {
+    switch (id) {
+        case MessageCompressorId::kNoop:
+            return "noop";
+        case MessageCompressorId::kSnappy:
+            return "snappy";
+        case MessageCompressorId::kZlib:
+            return "zlib";
+    }
+    MONGO_UNREACHABLE;
+}
+
+Status setEnabledMessageCompressors(StringData names) {
+    std::vector<MessageCompressorId> compressors;
+    if (names != "disabled") {
+        std::vector<std::string> tokens;
+        splitStringDelim(names.toString(), &tokens, ',');
+        for (const auto& token : tokens) {
+            if (token == "snappy") {
+                compressors.push_back(MessageCompressorId::kSnappy);
+            } else if (token == "zlib") {
+                compressors.push_back(MessageCompressorId::kZlib);
+            } else if (!token.empty()) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << "unknown network message compressor: " << token);
+            }
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(enabledCompressorsMutex);
+    enabledCompressors = std::move(compressors);
+    return Status::OK();
+}
+
+std::vector<MessageCompressorId> getEnabledMessageCompressors() {
+    stdx::lock_guard<stdx::mutex> lk(enabledCompressorsMutex);
+    return enabledCompressors;
+}
+
+void appendEnabledMessageCompressors(BSONObjBuilder* bob) {
+    auto compressors = getEnabledMessageCompressors();
+    if (compressors.empty()) {
+        return;
+    }
+    BSONArrayBuilder arr(bob->subarrayStart(kCompressionFieldName));
+    for (auto id : compressors) {
+        arr.append(messageCompressorName(id));
+    }
+}
+
+MessageCompressorId negotiateMessageCompressor(const BSONObj& isMasterReply) {
+    BSONElement remoteCompressors = isMasterReply[kCompressionFieldName];
+    if (remoteCompressors.type() != Array) {
+        return MessageCompressorId::kNoop;
+    }
+    for (auto id : getEnabledMessageCompressors()) {
+        for (auto&& elem : remoteCompressors.Obj()) {
+            if (elem.type() == String && elem.valueStringData() == messageCompressorName(id)) {
+                return id;
+            }
+        }
+    }
+    return MessageCompressorId::kNoop;
+}
+
+bool compressMessage(MessageCompressorId id, const Message& in, Message* out) {
+    invariant(out->empty());
+    if (id == MessageCompressorId::kNoop || in.operation() == dbCompressed) {
+        return false;
+    }
+
+    MsgData::View inView = in.singleData();
+    const int bodySize = inView.dataLen();
+    if (bodySize < kMinCompressibleBodySize) {
+        return false;
+    }
+
+    auto& stats = statsFor(id);
+    Timer timer;
+
+    const size_t maxSize = MsgData::MsgDataHeaderSize + kCompressedMessageHeaderSize +
+        maxCompressedLength(id, bodySize);
+    MsgData::View outView = reinterpret_cast<char*>(mongoMalloc(maxSize));
+    ScopeGuard guard = MakeGuard(free, outView.view2ptr());
+
+    char* compressedHeader = outView.data();
+    const size_t compressedSize = compressBuffer(id,
+                                                 inView.data(),
+                                                 bodySize,
+                                                 compressedHeader + kCompressedMessageHeaderSize);
+    if (compressedSize == 0 ||
+        compressedSize + kCompressedMessageHeaderSize >= static_cast<size_t>(bodySize)) {
+        return false;
+    }
+
+    DataView(compressedHeader).write(tagLittleEndian<int32_t>(inView.getNetworkOp()));
+    DataView(compressedHeader).write(tagLittleEndian<int32_t>(bodySize), sizeof(int32_t));
+    DataView(compressedHeader).write(static_cast<uint8_t>(id), 2 * sizeof(int32_t));
+
+    outView.setLen(MsgData::MsgDataHeaderSize + kCompressedMessageHeaderSize + compressedSize);
+    outView.setId(inView.getId());
+    outView.setResponseTo(inView.getResponseTo());
+    outView.setOperation(dbCompressed);
+
+    guard.Dismiss();
+    out->setData(outView.view2ptr(), true);
+
+    stats.compressBytesIn.addAndFetch(bodySize);
+    stats.compressBytesOut.addAndFetch(compressedSize);
+    stats.compressMicros.addAndFetch(timer.micros());
+    return true;
+}
+
+Status decompressMessage(const Message& in, Message* out, MessageCompressorId* compressorId) {
+    invariant(out->empty());
+    invariant(in.operation() == dbCompressed);
+
+    MsgData::View inView = in.singleData();
+    const int compressedSize = inView.dataLen() - kCompressedMessageHeaderSize;
+    if (compressedSize < 0) {
+        return Status(ErrorCodes::BadValue, "compressed message is too short");
+    }
+
+    ConstDataView compressedHeader(inView.data());
+    const int32_t originalOpcode = compressedHeader.read<LittleEndian<int32_t>>();
+    const int32_t uncompressedSize = compressedHeader.read<LittleEndian<int32_t>>(sizeof(int32_t));
+    const auto id =
+        static_cast<MessageCompressorId>(compressedHeader.read<uint8_t>(2 * sizeof(int32_t)));
+
+    if (uncompressedSize < 0 ||
+        static_cast<size_t>(uncompressedSize) > MaxMessageSizeBytes - MsgData::MsgDataHeaderSize) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "invalid uncompressed message size " << uncompressedSize);
+    }
+    if (originalOpcode == dbCompressed) {
+        return Status(ErrorCodes::BadValue, "compressed message wraps another compressed message");
+    }
+    if (static_cast<uint8_t>(id) > static_cast<uint8_t>(MessageCompressorId::kZlib)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "unknown message compressor " << static_cast<int>(id));
+    }
+    const auto enabled = getEnabledMessageCompressors();
+    if (std::find(enabled.begin(), enabled.end(), id) == enabled.end()) {
+        return Status(ErrorCodes::ProtocolError,
+                      str::stream() << "received a message compressed with "
+                                    << messageCompressorName(id)
+                                    << ", which is not enabled on this node");
+    }
+
+    auto& stats = statsFor(id);
+    Timer timer;
+
+    MsgData::View outView =
+        reinterpret_cast<char*>(mongoMalloc(MsgData::MsgDataHeaderSize + uncompressedSize));
+    ScopeGuard guard = MakeGuard(free, outView.view2ptr());
+
+    Status status = decompressBuffer(id,
+                                     inView.data() + kCompressedMessageHeaderSize,
+                                     compressedSize,
+                                     outView.data(),
+                                     uncompressedSize);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    outView.setLen(MsgData::MsgDataHeaderSize + uncompressedSize);
+    outView.setId(inView.getId());
+    outView.setResponseTo(inView.getResponseTo());
+    outView.setOperation(originalOpcode);
+
+    guard.Dismiss();
+    out->setData(outView.view2ptr(), true);
+    *compressorId = id;
+
+    stats.decompressBytesIn.addAndFetch(compressedSize);
+    stats.decompressBytesOut.addAndFetch(uncompressedSize);
+    stats.decompressMicros.addAndFetch(timer.micros());
+    return Status::OK();
+}
+
+void appendMessageCompressionStats(BSONObjBuilder* bob) {
+    BSONObjBuilder compression(bob->subobjStart(kCompressionFieldName));
+    for (auto id : kAllCompressors) {
+        const auto& stats = statsFor(id);
+        BSONObjBuilder compressor(compression.subobjStart(messageCompressorName(id)));
+        {
+            BSONObjBuilder b(compressor.subobjStart("compressor"));
+            b.appendNumber("bytesIn", stats.compressBytesIn.load());
+            b.appendNumber("bytesOut", stats.compressBytesOut.load());
+            b.appendNumber("micros", stats.compressMicros.load());
+        }
+        {
+            BSONObjBuilder b(compressor.subobjStart("decompressor"));
+            b.appendNumber("bytesIn", stats.decompressBytesIn.load());
+            b.appendNumber("bytesOut", stats.decompressBytesOut.load());
+            b.appendNumber("micros", stats.decompressMicros.load());
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+class Message;
+
+/**
+ * Algorithms that may be used to compress the body of an OP_COMPRESSED (dbCompressed) message.
+ * These values are sent over the wire and must never change.
+ */
+enum class MessageCompressorId : uint8_t {
+    kNoop = 0,
+    kSnappy = 1,
+    kZlib = 2,
+};
+
+/**
+ * Layout of an OP_COMPRESSED message, after the standard message header:
+ *
+ *     int32 originalOpcode    opcode of the wrapped message
+ *     int32 uncompressedSize  size of the wrapped message, excluding its header
+ *     uint8 compressorId      a MessageCompressorId
+ *     char  compressedMessage[...]
+ */
+const int kCompressedMessageHeaderSize = 2 * sizeof(int32_t) + sizeof(uint8_t);
+
+/**
+ * Name of the isMaster field listing the compressors a node accepts.
+ */
+extern const char kCompressionFieldName[];
+
+StringData messageCompressorName(MessageCompressorId id);
+
+/**
+ * Parses a comma separated list of compressor names ("snappy", "zlib", or "disabled") and makes
+ * it the list of compressors this process advertises and requests. Compression is disabled
+ * until this is called.
+ */
+Status setEnabledMessageCompressors(StringData names);
+
+std::vector<MessageCompressorId> getEnabledMessageCompressors();
+
+/**
+ * Appends the enabled compressors as the isMaster "compression" array. Appends nothing when
+ * compression is disabled.
+ */
+void appendEnabledMessageCompressors(BSONObjBuilder* bob);
+
+/**
+ * Returns the first enabled compressor that the remote node lists in its isMaster reply, or
+ * kNoop if there is none.
+ */
+MessageCompressorId negotiateMessageCompressor(const BSONObj& isMasterReply);
+
+/**
+ * Wraps 'in' into an OP_COMPRESSED message, copying its requestID and responseTo. Returns
+ * false and leaves 'out' empty if 'in' should be sent as is, because it is already compressed,
+ * is too small to be worth compressing, or did not get smaller.
+ */
+bool compressMessage(MessageCompressorId id, const Message& in, Message* out);
+
+/**
+ * Unwraps the OP_COMPRESSED message 'in' into 'out', restoring the original opcode. The id of
+ * the compressor used by the sender is stored in 'compressorId'. Returns ProtocolError if that
+ * compressor is not enabled on this node, since it can't have been negotiated.
+ */
+Status decompressMessage(const Message& in, Message* out, MessageCompressorId* compressorId);
+
+/**
+ * Appends the number of bytes in and out of each compressor, and the time spent compressing
+ * and decompressing, for serverStatus.
+ */
+void appendMessageCompressionStats(BSONObjBuilder* bob);
+
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2016 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
+
+namespace mongo {
+namespace {
+
+void buildMessage(Message* m, int operation, const std::string& body) {
+    m->setData(operation, body.data(), body.size());
+    m->header().setId(1234);
+    m->header().setResponseTo(5678);
+}
+
+void checkRoundTrip(MessageCompressorId id) {
+    ASSERT_OK(setEnabledMessageCompressors(messageCompressorName(id)));
+
+    std::string body;
+    for (int i = 0; i < 1000; ++i) {
+        body += "repetitive oplog entry payload ";
+    }
+
+    Message original;
+    buildMessage(&original, dbQuery, body);
+
+    Message compressed;
+    ASSERT_TRUE(compressMessage(id, original, &compressed));
+    ASSERT_EQUALS(dbCompressed, compressed.operation());
+    ASSERT_EQUALS(1234, static_cast<int>(compressed.header().getId()));
+    ASSERT_EQUALS(5678, static_cast<int>(compressed.header().getResponseTo()));
+    ASSERT_LESS_THAN(compressed.size(), original.size());
+
+    Message decompressed;
+    MessageCompressorId usedId;
+    ASSERT_OK(decompressMessage(compressed, &decompressed, &usedId));
+    ASSERT(id == usedId);
+    ASSERT_EQUALS(dbQuery, decompressed.operation());
+    ASSERT_EQUALS(original.size(), decompressed.size());
+    ASSERT_EQUALS(1234, static_cast<int>(decompressed.header().getId()));
+    ASSERT_EQUALS(5678, static_cast<int>(decompressed.header().getResponseTo()));
+    ASSERT_EQUALS(
+        0, memcmp(original.singleData().data(), decompressed.singleData().data(), body.size()));
+}
+
+TEST(MessageCompressor, SnappyRoundTrip) {
+    checkRoundTrip(MessageCompressorId::kSnappy);
+}
+
+TEST(MessageCompressor, ZlibRoundTrip) {
+    checkRoundTrip(MessageCompressorId::kZlib);
+}
+
+TEST(MessageCompressor, SmallMessagesAreNotCompressed) {
+    Message original;
+    buildMessage(&original, dbQuery, "tiny");
+
+    Message compressed;
+    ASSERT_FALSE(compressMessage(MessageCompressorId::kSnappy, original, &compressed));
+    ASSERT_TRUE(compressed.empty());
+}
+
+TEST(MessageCompressor, NoopDoesNotCompress) {
+    Message original;
+    buildMessage(&original, dbQuery, std::string(4096, 'x'));
+
+    Message compressed;
+    ASSERT_FALSE(compressMessage(MessageCompressorId::kNoop, original, &compressed));
+    ASSERT_TRUE(compressed.empty());
+}
+
+TEST(MessageCompressor, CorruptMessageIsRejected) {
+    ASSERT_OK(setEnabledMessageCompressors("snappy"));
+
+    Message original;
+    buildMessage(&original, dbQuery, std::string(4096, 'x'));
+
+    Message compressed;
+    ASSERT_TRUE(compressMessage(MessageCompressorId::kSnappy, original, &compressed));
+
+    // Claim a larger uncompressed size than the compressed data holds.
+    char* compressedHeader = compressed.singleData().data();
+    DataView(compressedHeader).write(tagLittleEndian<int32_t>(8192), sizeof(int32_t));
+
+    Message decompressed;
+    MessageCompressorId usedId;
+    Status status = decompressMessage(compressed, &decompressed, &usedId);
+    ASSERT_NOT_OK(status);
+    ASSERT_NOT_EQUALS(ErrorCodes::ProtocolError, status.code());
+    ASSERT_TRUE(decompressed.empty());
+}
+
+TEST(MessageCompressor, CompressorNotEnabledIsRejected) {
+    ASSERT_OK(setEnabledMessageCompressors("snappy"));
+
+    Message original;
+    buildMessage(&original, dbQuery, std::string(4096, 'x'));
+
+    Message compressed;
+    ASSERT_TRUE(compressMessage(MessageCompressorId::kZlib, original, &compressed));
+
+    Message decompressed;
+    MessageCompressorId usedId;
+    ASSERT_EQUALS(ErrorCodes::ProtocolError,
+                  decompressMessage(compressed, &decompressed, &usedId).code());
+    ASSERT_TRUE(decompressed.empty());
+
+    ASSERT_OK(setEnabledMessageCompressors("disabled"));
+    ASSERT_EQUALS(ErrorCodes::ProtocolError,
+                  decompressMessage(compressed, &decompressed, &usedId).code());
+}
+
+TEST(MessageCompressor, Negotiation) {
+    ASSERT_OK(setEnabledMessageCompressors("zlib,snappy"));
+
+    ASSERT(MessageCompressorId::kZlib ==
+           negotiateMessageCompressor(BSON("compression" << BSON_ARRAY("snappy"
+                                                                       << "zlib"))));
+    ASSERT(MessageCompressorId::kSnappy ==
+           negotiateMessageCompressor(BSON("compression" << BSON_ARRAY("snappy"))));
+    ASSERT(MessageCompressorId::kNoop == negotiateMessageCompressor(BSON("ismaster" << true)));
+
+    BSONObjBuilder bob;
+    appendEnabledMessageCompressors(&bob);
+    ASSERT_EQUALS(BSON("compression" << BSON_ARRAY("zlib"
+                                                   << "snappy")),
+                  bob.obj());
+
+    ASSERT_OK(setEnabledMessageCompressors("disabled"));
+    ASSERT(MessageCompressorId::kNoop ==
+           negotiateMessageCompressor(BSON("compression" << BSON_ARRAY("snappy"))));
+    ASSERT_NOT_OK(setEnabledMessageCompressors("lz4"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -199,6 +199,32 @@ bool MessagingPort::recv(Message& m) {
 
         guard.Dismiss();
         m.setData(md.view2ptr(), true);
+
+        if (m.operation() == dbCompressed) {
+            Message decompressed;
+            MessageCompressorId compressor;
+            Status status = decompressMessage(m, &decompressed, &compressor);
+            if (!status.isOK()) {
+                LOG(0) << "recv(): failed to decompress message from " << remote() << ": "
+                       << status;
+                m.reset();
+                return false;
+            }
+            // decompressMessage() only accepts compressors this process advertises in isMaster.
+            // Beyond that, a client only accepts the compressor it negotiated, and a server sticks
+            // to the first one its client used.
+            const bool compressorFixed =
+                _compressorNegotiated || _compressor != MessageCompressorId::kNoop;
+            if (compressorFixed && compressor != _compressor) {
+                LOG(0) << "recv(): " << remote() << " sent a message compressed with "
+                       << messageCompressorName(compressor)
+                       << ", which was not negotiated for this connection";
+                m.reset();
+                return false;
+            }
+            m = std::move(decompressed);
+            _compressor = compressor;
+        }
         return true;
 
     } catch (const SocketException& e) {
@@ -252,6 +278,16 @@ void MessagingPort::say(Message& toSend, int responseTo) {
     mmm(log() << "*  say()  thr:" << GetCurrentThreadId() << endl;)
         toSend.header().setId(nextMessageId());
     toSend.header().setResponseTo(responseTo);
+
+    // The caller's message is left as it is. Messages spread over several buffers are rare and
+    // are sent uncompressed rather than copied into one buffer first.
+    if (_compressor != MessageCompressorId::kNoop && toSend.buf()) {
+        Message compressed;
+        if (compressMessage(_compressor, toSend, &compressed)) {
+            compressed.send(*this, "say");
+            return;
+        }
+    }
     toSend.send(*this, "say");
 }
 
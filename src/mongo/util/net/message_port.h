@@ -34,6 +34,7 @@
 #include "mongo/config.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -113,6 +114,22 @@ public:
         return psock->isStillConnected();
     }
 
+    /**
+     * Compresses messages sent on this port with 'compressor' from now on, and only accepts
+     * compressed messages which use it. Set on the client side once the remote node has
+     * advertised support for it in its isMaster reply, or to kNoop if there was none in common.
+     * On the server side it is set when the first compressed message is received, so replies
+     * match requests.
+     */
+    void setCompressor(MessageCompressorId compressor) {
+        _compressor = compressor;
+        _compressorNegotiated = true;
+    }
+
+    MessageCompressorId getCompressor() const {
+        return _compressor;
+    }
+
     uint64_t getSockCreationMicroSec() const {
         return psock->getSockCreationMicroSec();
     }
@@ -121,6 +138,11 @@ private:
     // this is the parsed version of remote
     HostAndPort _remoteParsed;
 
+    MessageCompressorId _compressor = MessageCompressorId::kNoop;
+
+    // Whether setCompressor was called, which makes this the client side of the connection
+    bool _compressorNegotiated = false;
+
 public:
     static void closeAllSockets(unsigned tagMask = 0xffffffff);
 };